@@ -16,7 +16,6 @@
 
 #include "Actions/AddControlEvent.h"
 #include "Actions/EditAction.h"
-#include "Editors/ControllerEditor.h"
 #include "Midi/Track.h"
 #include "Midi/ControllerEvent.h"
 #include "Midi/Sequence.h"
@@ -88,7 +88,7 @@ void AddNote::perform()
         if (m_select)
         {
             // select last added note
-            m_track->selectNote(ALL_NOTES, false, true /* ignoreModifiers */);
+            m_track->selectNote(ALL_NOTES, false);
             tmp_note->setSelected(true);
         }
     }
@@ -21,6 +21,7 @@
 #include "Actions/DuplicateMeasures.h"
 #include "Actions/RemoveMeasures.h"
 #include "Midi/MeasureData.h"
+#include "Midi/NoteSnapshot.h"
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
 #include "UnitTest.h"
@@ -79,12 +80,14 @@ void DuplicateMeasures::perform()
         
         tr->setMeasureAmount( md->getMeasureAmount() + amount );
     
-        std::vector<Note> notesToDuplicate;
+        const int trackAmount = m_sequence->getTrackAmount();
+        
+        // one snapshot per track : only note values are gathered, notes are created when added back
+        std::vector<NoteSnapshot> notesToDuplicate(trackAmount);
         std::map<Track*, std::vector<ControllerEvent> > controllerEventsToDuplicate;
         std::vector<ControllerEvent> tempoEventsToDuplicate;
         
         // move all notes that are after given start tick by the necessary amount
-        const int trackAmount = m_sequence->getTrackAmount();
         for (int t=0; t<trackAmount; t++)
         {
             Track* track = m_sequence->getTrack(t);
@@ -99,9 +102,7 @@ void DuplicateMeasures::perform()
                     if (note->getTick() < stopDuplicatingAtTick)
                     {
                         // duplicate
-                        notesToDuplicate.push_back(Note(track, note->getPitchID(), note->getTick(),
-                                                        note->getEndTick(), note->getVolume(),
-                                                        note->getString()));
+                        notesToDuplicate[t].add(*note);
                     }
                     
                     note->setTick(note->getTick() + amountInTicks);
@@ -173,13 +174,17 @@ void DuplicateMeasures::perform()
             }//next
         }//endif
         
-        for (size_t n = 0; n < notesToDuplicate.size(); n++)
+        for (int t = 0; t < trackAmount; t++)
         {
-            notesToDuplicate[n].getParent()->addNote_import(notesToDuplicate[n].getPitchID(),
-                                                            notesToDuplicate[n].getTick(),
-                                                            notesToDuplicate[n].getEndTick(), 
-                                                            notesToDuplicate[n].getVolume(),
-                                                            notesToDuplicate[n].getString());
+            Track* track = m_sequence->getTrack(t);
+            const NoteSnapshot& notes = notesToDuplicate[t];
+            const int count = notes.size();
+            for (int n = 0; n < count; n++)
+            {
+                const NoteValues& values = notes.get(n);
+                track->addNote_import(values.m_pitch_ID, values.m_tick, values.m_end_tick,
+                                      values.m_volume, values.m_string);
+            }
         }
         
         for (std::map<Track*, std::vector<ControllerEvent> >::iterator it = controllerEventsToDuplicate.begin();
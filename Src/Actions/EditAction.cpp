@@ -15,10 +15,21 @@
  */
 
 #include "Actions/EditAction.h"
+#include "Actions/InsertEmptyMeasures.h"
+#include "Actions/RemoveMeasures.h"
+#include "Actions/ScaleTrack.h"
+#include "Actions/ScaleSong.h"
 #include "Midi/Track.h"
 #include "Midi/ControllerEvent.h"
+#include "Midi/MeasureData.h"
+#include "AriaCore.h"
+#include "ThreadPool.h"
+#include "UnitTest.h"
+#include "UnitTestUtils.h"
 
 //#include "GUI/GraphicalTrack.h"
+#include <algorithm>
+#include <map>
 #include <vector>
 
 using namespace AriaMaestosa;
@@ -65,6 +76,13 @@ void MultiTrackAction::setParentSequence(Sequence* parent, SequenceVisitor* visi
     m_visitor  = visitor;
 }
 
+// ----------------------------------------------------------------------------------------------------
+
+void MultiTrackAction::forEachTrack(IParallelTask* task)
+{
+    ThreadPool::getInstance()->parallelFor(m_sequence->getTrackAmount(), task);
+}
+
 
 // ----------------------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------------------
@@ -155,3 +173,287 @@ ControlEventRelocator::~ControlEventRelocator()
 {
 }
 
+
+// ----------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------
+
+namespace TestParallelActions
+{
+    /** @brief applies the same sequence-wide actions (then undoes them) on a new synthetic song */
+    Sequence* editSong(const bool parallel, const bool undo)
+    {
+        ThreadPool* pool = ThreadPool::getInstance();
+        const bool wasEnabled = pool->isEnabled();
+        pool->setEnabled(parallel);
+        
+        Sequence* seq = makeSyntheticSequence(16, 2000);
+        seq->setChannelManagementType(CHANNEL_MANUAL);
+        TestSequenceProvider provider(seq);
+        AriaMaestosa::setCurrentSequenceProvider(&provider);
+        
+        seq->action(new InsertEmptyMeasures(3 /* insert at */, 2 /* amount */));
+        seq->action(new RemoveMeasures(10 /* from */, 14 /* to */));
+        seq->action(new ScaleSong(1.5f, 0 /* relative to */));
+        
+        if (undo)
+        {
+            seq->undo();
+            seq->undo();
+            seq->undo();
+        }
+        
+        AriaMaestosa::setCurrentSequenceProvider(NULL);
+        pool->setEnabled(wasEnabled);
+        return seq;
+    }
+    
+    void requireSameSong(Sequence* serial, Sequence* parallel)
+    {
+        require_e(parallel->getTrackAmount(), ==, serial->getTrackAmount(), "Same amount of tracks");
+        require_e(parallel->getMeasureData()->getMeasureAmount(), ==,
+                  serial->getMeasureData()->getMeasureAmount(), "Same amount of measures");
+        
+        requireSameMidiSong(serial, parallel);
+    }
+    
+    UNIT_TEST( ParallelActionsTest )
+    {
+        {
+            OwnerPtr<Sequence> serial( editSong(false, false) );
+            OwnerPtr<Sequence> parallel( editSong(true, false) );
+            requireSameSong(serial, parallel);
+        }
+        {
+            OwnerPtr<Sequence> serial( editSong(false, true) );
+            OwnerPtr<Sequence> parallel( editSong(true, true) );
+            requireSameSong(serial, parallel);
+        }
+    }
+    
+    // ------------------------------------------------------------------------------------------------
+    
+    /** @brief the events of one track, copied out so the per-track reference can work on them */
+    struct NoteState
+    {
+        int m_tick, m_end, m_pitch, m_volume;
+        
+        bool operator<(const NoteState& other) const
+        {
+            if (m_tick  != other.m_tick)  return m_tick  < other.m_tick;
+            if (m_end   != other.m_end)   return m_end   < other.m_end;
+            if (m_pitch != other.m_pitch) return m_pitch < other.m_pitch;
+            return m_volume < other.m_volume;
+        }
+    };
+    
+    struct ControlState
+    {
+        int m_tick, m_controller;
+        wxFloat64 m_value;
+        
+        bool operator<(const ControlState& other) const
+        {
+            if (m_tick       != other.m_tick)       return m_tick       < other.m_tick;
+            if (m_controller != other.m_controller) return m_controller < other.m_controller;
+            return m_value < other.m_value;
+        }
+    };
+    
+    struct TrackState
+    {
+        std::vector<NoteState>    m_notes;
+        std::vector<ControlState> m_controls;
+    };
+    
+    std::vector<TrackState> captureTracks(Sequence* seq)
+    {
+        std::vector<TrackState> tracks(seq->getTrackAmount());
+        for (int t=0; t<seq->getTrackAmount(); t++)
+        {
+            Track* track = seq->getTrack(t);
+            for (int n=0; n<track->getNoteAmount(); n++)
+            {
+                const Note* note = track->getNote(n);
+                NoteState state = { note->getTick(), note->getEndTick(), note->getPitchID(), note->getVolume() };
+                tracks[t].m_notes.push_back(state);
+            }
+            for (int n=0; n<track->getControllerEventAmount(); n++)
+            {
+                const ControllerEvent* event = track->getControllerEvent(n, 0 /* any regular controller */);
+                ControlState state = { event->getTick(), event->getController(), event->getValue() };
+                tracks[t].m_controls.push_back(state);
+            }
+        }
+        return tracks;
+    }
+    
+    /** @brief what InsertEmptyMeasures did to each track, one track after the other, before it was parallel */
+    void referenceInsert(std::vector<TrackState>& tracks, const int afterTick, const int amountInTicks)
+    {
+        for (unsigned int t=0; t<tracks.size(); t++)
+        {
+            for (unsigned int n=0; n<tracks[t].m_notes.size(); n++)
+            {
+                NoteState& note = tracks[t].m_notes[n];
+                if (note.m_tick > afterTick)
+                {
+                    note.m_tick += amountInTicks;
+                    note.m_end  += amountInTicks;
+                }
+            }
+            for (unsigned int n=0; n<tracks[t].m_controls.size(); n++)
+            {
+                if (tracks[t].m_controls[n].m_tick > afterTick) tracks[t].m_controls[n].m_tick += amountInTicks;
+            }
+        }
+    }
+    
+    /** @brief what RemoveMeasures did to each track, one track after the other, before it was parallel */
+    void referenceRemove(std::vector<TrackState>& tracks, const int fromTick, const int toTick)
+    {
+        const int amountInTicks = toTick - fromTick - 1;
+        
+        for (unsigned int t=0; t<tracks.size(); t++)
+        {
+            std::vector<NoteState> notes;
+            for (unsigned int n=0; n<tracks[t].m_notes.size(); n++)
+            {
+                NoteState note = tracks[t].m_notes[n];
+                if (note.m_tick > fromTick and note.m_tick < toTick) continue;
+                if (note.m_tick >= toTick)
+                {
+                    note.m_tick -= amountInTicks;
+                    note.m_end  -= amountInTicks;
+                }
+                notes.push_back(note);
+            }
+            tracks[t].m_notes.swap(notes);
+            
+            std::map<int, wxFloat64> latest_value_by_controller;
+            std::vector<ControlState> controls;
+            for (unsigned int n=0; n<tracks[t].m_controls.size(); n++)
+            {
+                ControlState event = tracks[t].m_controls[n];
+                if (event.m_tick > fromTick and event.m_tick < toTick)
+                {
+                    latest_value_by_controller[event.m_controller] = event.m_value;
+                    continue;
+                }
+                if (event.m_tick >= toTick) event.m_tick -= amountInTicks;
+                controls.push_back(event);
+            }
+            
+            // controllers that had events in the removed area get their latest value at its end, unless
+            // there already is an event there
+            for (std::map<int, wxFloat64>::iterator it = latest_value_by_controller.begin();
+                 it != latest_value_by_controller.end(); it++)
+            {
+                bool found = false;
+                for (unsigned int n=0; n<controls.size(); n++)
+                {
+                    if (controls[n].m_tick == toTick - amountInTicks and controls[n].m_controller == it->first)
+                    {
+                        found = true;
+                    }
+                }
+                if (not found)
+                {
+                    ControlState event = { toTick - amountInTicks, it->first, it->second };
+                    controls.push_back(event);
+                }
+            }
+            tracks[t].m_controls.swap(controls);
+        }
+    }
+    
+    /** @brief what ScaleSong did to each track (a ScaleTrack each), one track after the other */
+    void referenceScale(std::vector<TrackState>& tracks, const float factor, const int relativeTo)
+    {
+        for (unsigned int t=0; t<tracks.size(); t++)
+        {
+            for (unsigned int n=0; n<tracks[t].m_notes.size(); n++)
+            {
+                NoteState& note = tracks[t].m_notes[n];
+                note.m_tick = (int)( (note.m_tick - relativeTo)*factor + relativeTo );
+                note.m_end  = (int)( (note.m_end  - relativeTo)*factor + relativeTo );
+            }
+        }
+    }
+    
+    /** @brief compares the events of each track; events at the same tick may be in any order */
+    void requireSameTracks(std::vector<TrackState> expected, Sequence* seq, const char* step)
+    {
+        std::vector<TrackState> actual = captureTracks(seq);
+        require_e(actual.size(), ==, expected.size(), step);
+        
+        for (unsigned int t=0; t<expected.size(); t++)
+        {
+            require(seq->getTrack(t)->checkControlEventsOrder(), step);
+            
+            std::sort(expected[t].m_notes.begin(), expected[t].m_notes.end());
+            std::sort(actual[t].m_notes.begin(),   actual[t].m_notes.end());
+            require_e(actual[t].m_notes.size(), ==, expected[t].m_notes.size(), step);
+            for (unsigned int n=0; n<expected[t].m_notes.size(); n++)
+            {
+                const NoteState& e = expected[t].m_notes[n];
+                const NoteState& a = actual[t].m_notes[n];
+                require(a.m_tick == e.m_tick and a.m_end == e.m_end and a.m_pitch == e.m_pitch and
+                        a.m_volume == e.m_volume, step);
+            }
+            
+            std::sort(expected[t].m_controls.begin(), expected[t].m_controls.end());
+            std::sort(actual[t].m_controls.begin(),   actual[t].m_controls.end());
+            require_e(actual[t].m_controls.size(), ==, expected[t].m_controls.size(), step);
+            for (unsigned int n=0; n<expected[t].m_controls.size(); n++)
+            {
+                const ControlState& e = expected[t].m_controls[n];
+                const ControlState& a = actual[t].m_controls[n];
+                require(a.m_tick == e.m_tick and a.m_controller == e.m_controller and a.m_value == e.m_value,
+                        step);
+            }
+        }
+    }
+    
+    UNIT_TEST( ParallelActionsMatchPerTrackReference )
+    {
+        ThreadPool* pool = ThreadPool::getInstance();
+        const bool wasEnabled = pool->isEnabled();
+        pool->setEnabled(true);
+        
+        OwnerPtr<Sequence> seq( makeSyntheticSequence(16, 2000) );
+        seq->setChannelManagementType(CHANNEL_MANUAL);
+        TestSequenceProvider provider(seq);
+        AriaMaestosa::setCurrentSequenceProvider(&provider);
+        
+        MeasureData* md = seq->getMeasureData();
+        std::vector<TrackState> expected = captureTracks(seq);
+        
+        referenceInsert(expected, md->firstTickInMeasure(3) - 1, 2*md->measureLengthInTicks(3));
+        seq->action(new InsertEmptyMeasures(3 /* insert at */, 2 /* amount */));
+        requireSameTracks(expected, seq, "InsertEmptyMeasures does what the per-track loop did");
+        
+        referenceRemove(expected, md->firstTickInMeasure(10) - 1, md->firstTickInMeasure(14));
+        seq->action(new RemoveMeasures(10 /* from */, 14 /* to */));
+        requireSameTracks(expected, seq, "RemoveMeasures does what the per-track loop did");
+        
+        referenceScale(expected, 1.5f, 0 /* relative to */);
+        seq->action(new ScaleSong(1.5f, 0 /* relative to */));
+        requireSameTracks(expected, seq, "ScaleSong does what the per-track loop did");
+        
+        seq->undo();
+        seq->undo();
+        seq->undo();
+        
+        // undoing does not take back the measures scaling added (it never did), so give the fresh song as
+        // many; everything else must be exactly as generated
+        OwnerPtr<Sequence> fresh( makeSyntheticSequence(16, 2000) );
+        fresh->setChannelManagementType(CHANNEL_MANUAL);
+        fresh->getMeasureData()->extendToTick(md->lastTickInMeasure(md->getMeasureAmount() - 1));
+        
+        requireSameTracks(captureTracks(fresh), seq, "Undo restores the generated song");
+        requireSameSong(fresh, seq);
+        
+        AriaMaestosa::setCurrentSequenceProvider(NULL);
+        pool->setEnabled(wasEnabled);
+    }
+}
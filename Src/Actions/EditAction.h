@@ -33,6 +33,7 @@ namespace AriaMaestosa
 {
     class Sequence;
     class SequenceVisitor;
+    class IParallelTask;
     
     /*
      * In the opposite situation, when it is easy to revert the changes, NoteRelocator is used.
@@ -157,6 +158,17 @@ namespace AriaMaestosa
             Sequence* m_sequence;
             OwnerPtr<SequenceVisitor> m_visitor;
 
+            /**
+              * @brief calls task->execute(t) for every track 't' of the sequence, spread over the threads
+              *        of the ThreadPool, and returns once all tracks are done
+              *
+              * Tracks hold their own notes and controller events, so per-track work can run concurrently
+              * as long as each call only modifies its own track (and what the action keeps for that
+              * track, allocated beforehand). Measure data, tempo and text events are shared by all
+              * tracks : update them on the calling thread, before or after.
+              */
+            void forEachTrack(IParallelTask* task);
+
         public:
             
             MultiTrackAction(wxString name);
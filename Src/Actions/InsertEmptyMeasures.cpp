@@ -23,11 +23,39 @@
 #include "Midi/MeasureData.h"
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
 #include "UnitTest.h"
+#include "UnitTestUtils.h"
 
 using namespace AriaMaestosa;
 using namespace AriaMaestosa::Action;
 
+namespace AriaMaestosa
+{
+    /** @brief moves the events of one track that are after a given tick, one parallelFor item per track */
+    class ShiftTrackTask : public IParallelTask
+    {
+        Sequence* m_sequence;
+        int m_after_tick;
+        int m_amount_in_ticks;
+        
+    public:
+        
+        ShiftTrackTask(Sequence* sequence, const int afterTick, const int amountInTicks)
+        {
+            m_sequence        = sequence;
+            m_after_tick      = afterTick;
+            m_amount_in_ticks = amountInTicks;
+        }
+        
+        virtual void execute(const int index)
+        {
+            m_sequence->getTrack(index)->shiftEventsAfter(m_after_tick, m_amount_in_ticks);
+        }
+    };
+}
+
 // --------------------------------------------------------------------------------------------------------
 
 InsertEmptyMeasures::InsertEmptyMeasures(int measureID, int amount) :
@@ -71,40 +99,9 @@ void InsertEmptyMeasures::perform()
         
         tr->setMeasureAmount( md->getMeasureAmount() + m_amount );
     
-        // move all notes that are after given start tick by the necessary amount
-        const int trackAmount = m_sequence->getTrackAmount();
-        for (int t=0; t<trackAmount; t++)
-        {
-            Track* track = m_sequence->getTrack(t);
-            
-            // ----------------- move note events -----------------
-            const int noteAmount = track->getNoteAmount();
-            for (int n=0; n<noteAmount; n++)
-            {
-                Note* note = track->getNote(n);
-                if (note->getTick() > afterTick)
-                {
-                    note->setTick(note->getTick() + amountInTicks);
-                    note->setEndTick(note->getEndTick() + amountInTicks);
-                }
-            }
-            // ----------------- move control events -----------------
-            
-            OwnerPtr<Track::TrackVisitor> tvisitor(m_visitor->getNewTrackVisitor(t));
-            ptr_vector<ControllerEvent>& ctrl = tvisitor->getControlEventVector();
-            
-            const int controlAmount = ctrl.size();
-            for (int n=0; n<controlAmount; n++)
-            {
-                if (ctrl[n].getTick() > afterTick)
-                {
-                    ctrl[n].setTick( ctrl[n].getTick() + amountInTicks );
-                }
-            }
-            
-            track->reorderNoteVector();
-            track->reorderNoteOffVector();
-        }
+        // move all notes and control events that are after given start tick by the necessary amount
+        ShiftTrackTask task(m_sequence, afterTick, amountInTicks);
+        forEachTrack(&task);
         
         // ----------------- move tempo events -----------------
         const int tempo_event_amount = m_sequence->getTempoEventAmount();
@@ -334,5 +331,124 @@ namespace InsertMeasuresTest
         provider.m_seq->undo();
         provider.verifyUndo();
     }
+    
+    // ----------------------------------------------------------------------------------------------------------
+    
+    UNIT_TEST(TestRemove)
+    {
+        TestSeqProvider provider;
+        Track* t = provider.m_seq->getTrack(0);
+        
+        // remove the second measure
+        provider.m_seq->action(new RemoveMeasures(1 /* from */, 2 /* to */));
+        
+        const int beatLen = provider.m_seq->ticksPerQuarterNote();
+        
+        require_e(t->getNoteAmount(), ==, 12, "the notes of the removed measure are gone");
+        require_e(t->getNoteOffVector().size(), ==, 12, "Note off vector is fine");
+        // (control events of all controllers are counted)
+        require_e(t->getControllerEventAmount(0), ==, 48, "control events of the removed measure are gone");
+        
+        for (int n=0; n<12; n++)
+        {
+            const int pitch = (n < 4 ? 100 + n : 104 + n);
+            require_e(t->getNote(n)->getTick(),    ==, n*beatLen, "notes after the removed measure were moved back");
+            require_e(t->getNote(n)->getPitchID(), ==, pitch,     "notes after the removed measure were moved back");
+            require_e(t->getNoteOffVector()[n].getEndTick(), ==, (n + 1)*beatLen - 1,
+                      "Note off vector is in order");
+        }
+        
+        provider.m_seq->undo();
+        
+        require_e(t->getNoteAmount(), ==, 16, "the number of events is fine on undo");
+        require_e(t->getControllerEventAmount(0), ==, 64, "control events were restored");
+        for (int n=0; n<16; n++)
+        {
+            require_e(t->getNote(n)->getTick(),    ==, n*beatLen, "notes were properly restored");
+            require_e(t->getNote(n)->getPitchID(), ==, 100 + n,   "notes were properly restored");
+            require_e(t->getNoteOffVector()[n].getEndTick(), ==, (n + 1)*beatLen - 1,
+                      "Note off vector was properly restored");
+        }
+    }
+    
+    // ----------------------------------------------------------------------------------------------------------
+    
+    /** checks the ticks and values of one controller's events, walking the (shared) control event vector */
+    void checkController(Track* t, const int controller, const int expectedAmount, const int* ticks,
+                         const int* values)
+    {
+        int found = 0;
+        for (int n=0; n<t->getControllerEventAmount(); n++)
+        {
+            ControllerEvent* event = t->getControllerEvent(n, controller);
+            if (event->getController() != controller) continue;
+            
+            require_e(found, <, expectedAmount, "no extra control events");
+            require_e(event->getTick(), ==, ticks[found], "control events are at the right tick");
+            require_e((int)event->getValue(), ==, values[found], "control events have the right value");
+            found++;
+        }
+        require_e(found, ==, expectedAmount, "no control event is missing");
+    }
+    
+    UNIT_TEST(TestRemoveWithControllersOutOfOrder)
+    {
+        // the provider imports all of controller 0, then all of controller 1, without reordering : the control
+        // event vector starts out of time order, and must come out of the action (and its undo) sorted
+        TestSeqProvider provider;
+        Track* t = provider.m_seq->getTrack(0);
+        
+        const int beatLen = provider.m_seq->ticksPerQuarterNote();
+        
+        provider.m_seq->action(new RemoveMeasures(1 /* from */, 2 /* to */));
+        
+        require_e(t->getControllerEventAmount(), ==, 48, "control events of the removed measure are gone");
+        require(t->checkControlEventsOrder(), "control events are in time order after the action");
+        
+        // 8 events per controller and per measure; the ones after the removed measure moved back by one
+        int ticks[32], values0[32], values1[32];
+        for (int n=0; n<24; n++)
+        {
+            const int original = (n < 8 ? n : n + 8);
+            ticks[n]   = (n*beatLen)/2;
+            values0[n] = 64 + original*2;
+            values1[n] = 64 - original*2;
+        }
+        checkController(t, 0, 24, ticks, values0);
+        checkController(t, 1, 24, ticks, values1);
+        
+        provider.m_seq->undo();
+        
+        require_e(t->getControllerEventAmount(), ==, 64, "control events were restored");
+        require(t->checkControlEventsOrder(), "control events are in time order after undo");
+        
+        for (int n=0; n<32; n++)
+        {
+            ticks[n]   = (n*beatLen)/2;
+            values0[n] = 64 + n*2;
+            values1[n] = 64 - n*2;
+        }
+        checkController(t, 0, 32, ticks, values0);
+        checkController(t, 1, 32, ticks, values1);
+    }
 }
 #endif
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( InsertAndRemoveMeasures )
+{
+    // insert a measure near the start of the song, then remove one, and undo both
+    BenchmarkSong song(bench, 60);
+    
+    TestSequenceProvider provider(song);
+    AriaMaestosa::setCurrentSequenceProvider(&provider);
+    
+    while (bench.next())
+    {
+        song->action(new InsertEmptyMeasures(1 /* insert at */, 1 /* amount */));
+        song->action(new RemoveMeasures(2 /* from */, 3 /* to */));
+        song->undo();
+        song->undo();
+    }
+}
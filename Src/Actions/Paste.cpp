@@ -25,6 +25,7 @@
 #include "GUI/GraphicalTrack.h"
 
 #include "Midi/MeasureData.h"
+#include "Midi/NoteSnapshot.h"
 #include "Midi/Track.h"
 #include "Midi/Sequence.h"
 
@@ -93,10 +94,10 @@ int Paste::getShiftForRegularPaste()
     
     // find if all track->m_notes will be visible in the location just calculated,
     // otherwise move them one more measure ahead (if measure is half-visible because of scrolling)
-    Note& first_note = *(Clipboard::getNote(0));
+    const NoteValues& first_note = Clipboard::getNote(0);
     
     // check if note is before visible area
-    while ((first_note.getTick() + first_note.getEndTick())/2 + shift <
+    while ((first_note.m_tick + first_note.m_end_tick)/2 + shift <
            gtrack->getSequence()->getXScrollInMidiTicks())
     {
         shift = md->firstTickInMeasure( md->measureAtTick( shift )+1 );
@@ -151,7 +152,7 @@ void Paste::perform()
     // find where track->m_notes begin if necessary
     if (m_at_mouse)
     {
-        beginning = Clipboard::getNote(0)->getTick();
+        beginning = Clipboard::getNote(0).m_tick;
     }
     int shift=0;
 
@@ -188,10 +189,10 @@ void Paste::perform()
 
         // find if first note will be visible in the location just calculated,
         // otherwise just go to regular pasting code, it will paste them within visible measures
-        Note& tmp = *Clipboard::getNote(0);
+        const NoteValues& tmp = Clipboard::getNote(0);
 
         // before visible area
-        if ((tmp.getTick() + tmp.getEndTick())/2 + shift < gtrack->getSequence()->getXScrollInMidiTicks())
+        if ((tmp.m_tick + tmp.m_end_tick)/2 + shift < gtrack->getSequence()->getXScrollInMidiTicks())
         {
             shift = getShiftForRegularPaste();
         }
@@ -199,7 +200,7 @@ void Paste::perform()
         // after visible area
         RelativeXCoord screen_width( Display::getWidth(), WINDOW, gtrack->getSequence() );
 
-        if ((tmp.getTick() + tmp.getEndTick())/2 + shift > screen_width.getRelativeTo(MIDI) )
+        if ((tmp.m_tick + tmp.m_end_tick)/2 + shift > screen_width.getRelativeTo(MIDI) )
         {
             shift = getShiftForRegularPaste();
         }
@@ -211,10 +212,11 @@ void Paste::perform()
     }
 
     // ---- add new notes
-    const int clipboardSize = Clipboard::getSize();
+    const NoteSnapshot& copied = Clipboard::getContents();
+    const int clipboardSize = copied.size();
     for (int n=0; n<clipboardSize; n++)
     {
-        Note* tmp = new Note( *(Clipboard::getNote(n)) );
+        Note* tmp = copied.createNote(n, m_track);
 
         if (needToScalePastedNotes)
         {
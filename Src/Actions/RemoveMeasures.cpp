@@ -23,6 +23,7 @@
 #include "Midi/TimeSigChange.h"
 #include "Midi/MeasureData.h"
 #include "AriaCore.h"
+#include "ThreadPool.h"
 
 #include <iostream>
 #include <map>
@@ -33,6 +34,65 @@ using namespace AriaMaestosa::Action;
 
 // ----------------------------------------------------------------------------------------------------------
 
+RemoveMeasures::RemoveTrackPartTask::RemoveTrackPartTask(RemoveMeasures* parent, const int fromTick,
+                                                         const int toTick, const bool undo)
+{
+    m_parent    = parent;
+    m_from_tick = fromTick;
+    m_to_tick   = toTick;
+    m_undo      = undo;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void RemoveMeasures::RemoveTrackPartTask::execute(const int index)
+{
+    RemovedTrackPart* removedBits = m_parent->removedTrackParts.get(index);
+    Track* track = removedBits->track;
+    
+    if (m_undo)
+    {
+        // add removed notes and control events again; the track takes them back, so the removed
+        // track part won't delete them
+        track->insertEventBlock(removedBits->removedNotes, removedBits->removedControlEvents);
+        return;
+    }
+    
+    // find the amount of ticks that will be removed. This will be used to move back notes located
+    // after the area that is removed.
+    const int amountInTicks = m_to_tick - m_from_tick - 1;
+    
+    // ------------------------ erase/move notes and control events ------------------------
+    // take out everything located in the area to be deleted, then move back what is after it
+    track->extractEventsInRange(m_from_tick, m_to_tick, removedBits->removedNotes,
+                                removedBits->removedControlEvents);
+    track->shiftEventsAfter(m_from_tick, -amountInTicks);
+    
+    std::map<int, wxFloat64> latest_value_by_controller;
+    
+    const int c_amount = removedBits->removedControlEvents.size();
+    for (int n=0; n<c_amount; n++)
+    {
+        const ControllerEvent& evt = removedBits->removedControlEvents[n];
+        latest_value_by_controller[evt.getController()] = evt.getValue();
+    }
+    
+    // if needed, insert a new event at the end of the deleted section with the latest value
+    // the controller had. This part is not undoable since the additional event doesn't hurt.
+    for (std::map<int, wxFloat64>::iterator it = latest_value_by_controller.begin();
+         it != latest_value_by_controller.end(); it++)
+    {
+         if (track->getControllerEventAt(m_to_tick - amountInTicks, it->first) == NULL)
+         {
+             wxFloat64 previousVal;
+             track->addControlEvent(new ControllerEvent(it->first, m_to_tick - amountInTicks, it->second),
+                                    &previousVal);
+         }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 RemoveMeasures::RemoveMeasures(int from_measure, int to_measure) :
     //I18N: (undoable) action name
     MultiTrackAction( _("remove measure(s)") )
@@ -61,29 +121,8 @@ void RemoveMeasures::undo()
     opposite_action.setParentSequence( m_sequence, m_visitor->clone() );
     opposite_action.perform();
     
-    const int rmtrackamount = removedTrackParts.size();
-    for (int rm=0; rm<rmtrackamount; rm++)
-    {
-        RemovedTrackPart* removedBits = removedTrackParts.get(rm);
-        
-        // add removed notes again
-        const int n_amount = removedBits->removedNotes.size();
-        for (int n=0; n<n_amount; n++)
-        {
-            removedBits->track->addNote( removedBits->removedNotes.get(n) );
-        }
-        // we are using the notes again, so make sure it won't delete them
-        removedBits->removedNotes.clearWithoutDeleting();
-        
-        // add removed control events again
-        const int c_amount = removedBits->removedControlEvents.size();
-        for (int n=0; n<c_amount; n++)
-        {
-            removedBits->track->addControlEvent( removedBits->removedControlEvents.get(n) );
-        }
-        // we are using the events again, so make sure it won't delete them
-        removedBits->removedControlEvents.clearWithoutDeleting();
-    }
+    RemoveTrackPartTask task(this, -1, -1, true /* undo */);
+    forEachTrack(&task);
     
     // add removed tempo events again
     const int s_amount = removedTempoEvents.size();
@@ -139,80 +178,18 @@ void RemoveMeasures::perform()
     // after the area that is removed.
     const int amountInTicks = toTick - fromTick - 1;
     
+    // allocate where each track keeps what was removed from it before the tracks are processed in parallel
     const int trackAmount = m_sequence->getTrackAmount();
     for (int t=0; t<trackAmount; t++)
     {
         RemovedTrackPart* removedBits = new RemovedTrackPart();
+        removedBits->track = m_sequence->getTrack(t);
         removedTrackParts.push_back( removedBits );
-        
-        Track* track = m_sequence->getTrack(t);
-        removedBits->track = track;
-        
-        OwnerPtr<Track::TrackVisitor> tvisitor(m_visitor->getNewTrackVisitor(t));
-        ptr_vector<Note>& notes = tvisitor->getNotesVector();
-        
-        // ------------------------ erase/move notes ------------------------
-        const int amount_n = notes.size();
-        for (int n=0; n<amount_n; n++)
-        {
-            Note* note = notes.get(n);
-            
-            // note is an area that is removed. remove it.
-            if (note->getTick() > fromTick and note->getTick() < toTick)
-            {
-                removedBits->removedNotes.push_back(note);
-                track->markNoteToBeRemoved(n);
-            }
-            // note is in after the removed area. move it back by necessary amound
-            else if (notes[n].getTick() >= toTick)
-            {
-                note->setTick( note->getTick() - amountInTicks);
-                note->setEndTick( note->getEndTick() - amountInTicks);
-            }
-        }
-        track->removeMarkedNotes();
-        
-        // ------------------------ erase/move control events ------------------------
-        
-        ptr_vector<ControllerEvent>& ctrl = tvisitor->getControlEventVector();
-        
-        std::map<int, wxFloat64> latest_value_by_controller;
-        
-        const int c_amount = ctrl.size();
-        for (int n=0; n<c_amount; n++)
-        {
-            // delete all controller events located in the area to be deleted
-            if (ctrl[n].getTick() > fromTick and ctrl[n].getTick() < toTick)
-            {
-                latest_value_by_controller[ctrl[n].getController()] = ctrl[n].getValue();
-                removedBits->removedControlEvents.push_back( ctrl.get(n) );
-                ctrl.markToBeRemoved(n);
-            }
-            // move all controller events that are after given start tick by the necessary amount
-            else if (ctrl[n].getTick() >= toTick)
-            {
-                ctrl[n].setTick(ctrl[n].getTick() - amountInTicks);
-            }
-        }
-        ctrl.removeMarked();
-        
-        // if needed, insert a new event at the end of the deleted section with the latest value
-        // the controller had. This part is not undoable since the additional event doesn't hurt.
-        for (std::map<int, wxFloat64>::iterator it = latest_value_by_controller.begin();
-             it != latest_value_by_controller.end(); it++)
-        {
-             if (track->getControllerEventAt(toTick - amountInTicks, it->first) == NULL)
-             {
-                 wxFloat64 previousVal;
-                 track->addControlEvent(new ControllerEvent(it->first, toTick - amountInTicks, it->second),
-                                        &previousVal);
-             }
-        }
-        
-        track->reorderNoteVector();
-        track->reorderNoteOffVector();
     }
     
+    RemoveTrackPartTask task(this, fromTick, toTick, false /* undo */);
+    forEachTrack(&task);
+    
     
     // ------------------------ erase/move tempo events ------------------------
     const int s_amount = m_sequence->getTempoEventAmount();
@@ -18,6 +18,7 @@
 #define _rmmeas_
 
 #include "Actions/EditAction.h"
+#include "ThreadPool.h"
 
 namespace AriaMaestosa
 {
@@ -43,6 +44,19 @@ namespace AriaMaestosa
                 virtual ~RemovedTrackPart();
             };
             
+            /** @brief removes (or on undo, puts back) the events of one track, one parallelFor item per track */
+            class RemoveTrackPartTask : public IParallelTask
+            {
+                RemoveMeasures* m_parent;
+                int  m_from_tick;
+                int  m_to_tick;
+                bool m_undo;
+                
+            public:
+                RemoveTrackPartTask(RemoveMeasures* parent, const int fromTick, const int toTick, const bool undo);
+                virtual void execute(const int index);
+            };
+            
             friend class AriaMaestosa::Track;
             int m_from_measure, m_to_measure;
             
@@ -17,13 +17,39 @@
 #include "Actions/ScaleTrack.h"
 #include "Actions/ScaleSong.h"
 #include "Actions/EditAction.h"
+#include "Midi/MeasureData.h"
 #include "Midi/Track.h"
 #include "Midi/Sequence.h"
+#include "ThreadPool.h"
 
 #include <wx/intl.h>
 
 using namespace AriaMaestosa::Action;
 
+namespace AriaMaestosa
+{
+    /** @brief scales (or on undo, restores) the notes of one track, one parallelFor item per track */
+    class ScaleTrackTask : public IParallelTask
+    {
+        ptr_vector<ScaleTrack>& m_actions;
+        std::vector<int>&       m_last_ticks;
+        bool                    m_undo;
+        
+    public:
+        
+        ScaleTrackTask(ptr_vector<ScaleTrack>& actions, std::vector<int>& lastTicks, const bool undo) :
+            m_actions(actions), m_last_ticks(lastTicks)
+        {
+            m_undo = undo;
+        }
+        
+        virtual void execute(const int index)
+        {
+            if (m_undo) m_actions[index].undo();
+            else        m_last_ticks[index] = m_actions[index].scaleNotes();
+        }
+    };
+}
 
 ScaleSong::ScaleSong(float factor, int relative_to) :
     //I18N: (undoable) action name
@@ -45,17 +71,30 @@ void ScaleSong::perform()
         Action::ScaleTrack* action = new Action::ScaleTrack(m_factor, m_relative_to, false);
         
         action->setParentTrack(m_sequence->getTrack(t), m_visitor->getNewTrackVisitor(t));
-        action->perform();
         actions.push_back(action);
     }
+    
+    // the tracks are scaled in parallel; the measures, shared by all tracks, are extended afterwards
+    std::vector<int> last_ticks(trackAmount, -1);
+    ScaleTrackTask task(actions, last_ticks, false /* undo */);
+    forEachTrack(&task);
+    
+    int last_tick = -1;
+    for (int t=0; t<trackAmount; t++)
+    {
+        if (last_ticks[t] > last_tick) last_tick = last_ticks[t];
+    }
+    
+    MeasureData* md = m_sequence->getMeasureData();
+    if (last_tick > md->getTotalTickAmount())
+    {
+        md->extendToTick(last_tick);
+    }
 }
 
 void ScaleSong::undo()
 {
-    const int amount = actions.size();
-    for (int a=0; a<amount; a++)
-    {
-        actions[a].undo();
-    }
+    std::vector<int> unused;
+    ScaleTrackTask task(actions, unused, true /* undo */);
+    forEachTrack(&task);
 }
-
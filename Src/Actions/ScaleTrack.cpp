@@ -61,6 +61,19 @@ void ScaleTrack::undo()
 // ----------------------------------------------------------------------------------------------------------
 
 void ScaleTrack::perform()
+{
+    const int last_tick = scaleNotes();
+    
+    MeasureData* md = m_track->getSequence()->getMeasureData();
+    if (last_tick > md->getTotalTickAmount())
+    {        
+        md->extendToTick(last_tick);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int ScaleTrack::scaleNotes()
 {
     ASSERT(m_track != NULL);
     
@@ -88,15 +101,10 @@ void ScaleTrack::perform()
         
     }//next
     
-    MeasureData* md = m_track->getSequence()->getMeasureData();
-    if (last_tick > md->getTotalTickAmount())
-    {        
-        md->extendToTick(last_tick);
-    }
-    
-    
     m_track->reorderNoteVector();
     m_track->reorderNoteOffVector();
+    
+    return last_tick;
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -44,6 +44,14 @@ namespace AriaMaestosa
             
             ScaleTrack(float factor, int relative_to, bool selectionOnly);
             void perform();
+            
+            /**
+              * @brief does what 'perform' does, except extending the measures to fit the scaled notes
+              *        (measure data is shared by all tracks, see ScaleSong)
+              * @return the tick where the last scaled note ends, or -1 if no note was scaled
+              */
+            int scaleNotes();
+            
             void undo();
             virtual ~ScaleTrack();
         };
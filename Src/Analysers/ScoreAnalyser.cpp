@@ -17,9 +17,10 @@
 #include "Analysers/ScoreAnalyser.h"
 
 #include "AriaCore.h"
-#include "Editors/ScoreEditor.h"
 #include "Midi/MeasureData.h"
 #include "Midi/Sequence.h"
+#include "Benchmark.h"
+#include "UnitTestUtils.h"
 
 #include <cmath>
 #include <math.h>
@@ -48,7 +49,7 @@ public:
         m_max_level = -999;
     }
     
-    void calculateLevel(std::vector<NoteRenderInfo>& m_note_render_info, ScoreMidiConverter* converter)
+    void calculateLevel(std::vector<NoteRenderInfo>& m_note_render_info)
     {
         for (int i=m_first_id;i<=m_last_id; i++)
         {
@@ -79,16 +80,12 @@ public:
         m_mid_level = (int)round( (m_min_level + m_max_level)/2.0 );
     }
 
-    void doBeam(std::vector<NoteRenderInfo>& m_note_render_info, ScoreEditor* editor)
+    void doBeam(std::vector<NoteRenderInfo>& m_note_render_info, Sequence* seq)
     {
-        ASSERT( editor != NULL );
+        ASSERT( seq != NULL );
         
         if (m_last_id == m_first_id) return; // note alone, no beaming to perform
 
-        ScoreMidiConverter* converter = editor->getScoreMidiConverter();
-        //const int y_step = editor->getYStep();
-
-        Sequence* seq = editor->getSequence();
         MeasureData* md = seq->getMeasureData();
         
         // check for number of "beamable" notes and split if current amount is not acceptable with the current time sig
@@ -153,21 +150,21 @@ public:
                 // dumb split
                 BeamGroup first_half(m_analyser, m_first_id, m_first_id + max_amount_of_notes_beamed_toghether - 1);
                 BeamGroup second_half(m_analyser, m_first_id + max_amount_of_notes_beamed_toghether, m_last_id);
-                first_half.doBeam(m_note_render_info, editor);
-                second_half.doBeam(m_note_render_info, editor);
+                first_half.doBeam(m_note_render_info, seq);
+                second_half.doBeam(m_note_render_info, seq);
             }
             else
             {
                 BeamGroup first_half(m_analyser, m_first_id, split_at_id - 1);
                 BeamGroup second_half(m_analyser, split_at_id, m_last_id);
-                first_half.doBeam(m_note_render_info, editor);
-                second_half.doBeam(m_note_render_info, editor);
+                first_half.doBeam(m_note_render_info, seq);
+                second_half.doBeam(m_note_render_info, seq);
             }
 
             return;
         }
 
-        calculateLevel(m_note_render_info, converter);
+        calculateLevel(m_note_render_info);
 
         m_note_render_info[m_first_id].m_beam_show_above = m_analyser->stemUp(m_mid_level);
         m_note_render_info[m_first_id].m_beam = true;
@@ -410,9 +407,9 @@ void NoteRenderInfo::setY(const int newY)
 #pragma mark Score Analyser (public)
 #endif
 
-ScoreAnalyser::ScoreAnalyser(Editor* parent, int stemPivot)
+ScoreAnalyser::ScoreAnalyser(Sequence* sequence, int stemPivot)
 {
-    m_editor = parent;
+    m_sequence = sequence;
     m_stem_pivot = stemPivot;
 
     stem_height = 5.2;
@@ -430,8 +427,7 @@ void ScoreAnalyser::addToVector( NoteRenderInfo& renderInfo )
 
 void ScoreAnalyser::addToVector( NoteRenderInfo& renderInfo, const bool recursion )
 {
-    Sequence* seq = m_editor->getSequence();
-    MeasureData* md = seq->getMeasureData();
+    MeasureData* md = m_sequence->getMeasureData();
 
     // check if note lasts more than one measure. If so we need to divide it in 2.
     if (renderInfo.m_measure_end > renderInfo.m_measure_begin) 
@@ -475,7 +471,7 @@ void ScoreAnalyser::addToVector( NoteRenderInfo& renderInfo, const bool recursio
     
     // find how to draw notes. how many flags, dotted, triplet, etc.
     // if note duration is unknown it will be split 
-    const int beat = seq->ticksPerQuarterNote();
+    const int beat = m_sequence->ticksPerQuarterNote();
     const float relativeLength = renderInfo.getTickLength() / (float)(beat*4);
     
     renderInfo.m_stem_type = (stemUp(renderInfo.getLevel()) ? STEM_UP : STEM_DOWN);
@@ -607,7 +603,7 @@ void ScoreAnalyser::analyseNoteInfo()
 ScoreAnalyser* ScoreAnalyser::getSubset(const int fromTick, const int toTick) const
 {
     ScoreAnalyser* out = new ScoreAnalyser();
-    out->m_editor        = m_editor;
+    out->m_sequence      = m_sequence;
     out->m_stem_pivot    = m_stem_pivot;
     out->min_stem_height = min_stem_height;
     out->stem_height     = stem_height;
@@ -670,7 +666,7 @@ void ScoreAnalyser::putInTimeOrder()
 
 void ScoreAnalyser::findAndMergeChords()
 {
-    const int beatLen = m_editor->getSequence()->ticksPerQuarterNote();
+    const int beatLen = m_sequence->ticksPerQuarterNote();
     
     /*
      * start by merging notes playing at the same time (chords)
@@ -820,7 +816,7 @@ const bool VERBOSE_ABOUT_TRIPLETS = false;
 void ScoreAnalyser::processTriplets()
 {
     const int visibleNoteAmount = m_note_render_info.size();
-    const int beatLen = m_editor->getSequence()->ticksPerQuarterNote();
+    const int beatLen = m_sequence->ticksPerQuarterNote();
     
     for (int i=0; i<visibleNoteAmount; i++)
     {
@@ -997,7 +993,7 @@ void ScoreAnalyser::processTriplets()
 void ScoreAnalyser::processNoteBeam()
 {
     const int visibleNoteAmount = m_note_render_info.size();
-    const int beatLen = m_editor->getSequence()->ticksPerQuarterNote();
+    const int beatLen = m_sequence->ticksPerQuarterNote();
     
     // beaming
     // all beam information is stored in the first note of the serie.
@@ -1050,7 +1046,7 @@ void ScoreAnalyser::processNoteBeam()
                 if (i > first_of_serie)
                 {
                     BeamGroup beam(this, first_of_serie, i);
-                    beam.doBeam(m_note_render_info, dynamic_cast<ScoreEditor*>(m_editor));
+                    beam.doBeam(m_note_render_info, m_sequence);
                 }
 
                 // reset
@@ -1067,3 +1063,18 @@ void ScoreAnalyser::processNoteBeam()
 }
     
 // -----------------------------------------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( ScoreAnalyserPasses )
+{
+    // all notes of the song at once, i.e. as if the whole song was visible (e.g. when printing)
+    BenchmarkSong song(bench);
+    ScoreAnalyser analyser(song, 36);
+    
+    while (bench.next())
+    {
+        fillScoreAnalyser(&analyser, song->getTrack(0));
+        analyser.analyseNoteInfo();
+    }
+}
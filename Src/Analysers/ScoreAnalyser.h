@@ -36,7 +36,7 @@
 namespace AriaMaestosa
 {
     class MeasureData;
-    class Editor;
+    class Sequence;
     
     enum STEM
     {
@@ -238,7 +238,7 @@ namespace AriaMaestosa
         friend class BeamGroup;
         
         // REMEMBER: on adding new members, don't forget to update the cloning code in 'getSubset'
-        Editor* m_editor;
+        Sequence* m_sequence;
         int m_stem_pivot;
         
         float stem_height;
@@ -253,7 +253,8 @@ namespace AriaMaestosa
         
         SortableVector<NoteRenderInfo> m_note_render_info;
         
-        ScoreAnalyser(Editor* parent, int stemPivot);
+        /** @param sequence the sequence the analysed notes belong to (for its measures and resolution) */
+        ScoreAnalyser(Sequence* sequence, int stemPivot);
         
         virtual ~ScoreAnalyser() {}
         
@@ -20,6 +20,9 @@
 
 #include "Midi/MeasureData.h"
 #include "Midi/Sequence.h"
+#include "Analysers/ScoreAnalyser.h"
+#include "Benchmark.h"
+#include "UnitTestUtils.h"
 
 #include <algorithm>
 
@@ -348,4 +351,20 @@ std::vector<SilenceInfo> AriaMaestosa::SilenceAnalyser::findSilences(const Seque
     return g_silences_ticks;
 }
 
+// ----------------------------------------------------------------------------------------------------------
 
+BENCHMARK( FindSilences )
+{
+    BenchmarkSong song(bench);
+    ScoreAnalyser analyser(song, 36);
+    fillScoreAnalyser(&analyser, song->getTrack(0));
+    analyser.analyseNoteInfo();
+    
+    const int lastMeasure = song->getMeasureData()->getMeasureAmount() - 1;
+    
+    while (bench.next())
+    {
+        std::vector<SilenceInfo> silences = findSilences(song, &analyser, 0, lastMeasure, 0);
+        bench.keep(silences.size());
+    }
+}
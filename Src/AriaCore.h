@@ -18,12 +18,12 @@
 #ifndef __ARIA_CORE_H__
 #define __ARIA_CORE_H__
 
-#include "Editors/RelativeXCoord.h"
 #include "Utils.h"
 
 class wxMenu;
 class wxDC;
 class wxFont;
+class wxString;
 #include <wx/defs.h>
 
 enum PlayDuringEditMode
@@ -52,6 +52,7 @@ namespace AriaMaestosa
     class DrumPicker;
     class InstrumentPicker;
     class GraphicalSequence;
+    class RelativeXCoord;
     
     extern bool okToLog;
     
@@ -73,6 +74,25 @@ namespace AriaMaestosa
     
     bool isPlaybackMode();
     
+    /**
+      * @brief Interface for whatever can show messages to the user (the GUI uses message boxes)
+      */
+    class IMessageDisplay
+    {
+    public:
+        virtual ~IMessageDisplay() {}
+        
+        virtual void showMessage(const wxString& message) = 0;
+    };
+    
+    void setMessageDisplay(IMessageDisplay* display);
+    
+    /**
+      * @brief Tell something to the user. Without a message display (e.g. in AriaBatch, which has
+      *        no GUI), the message is printed to stderr.
+      */
+    void showMessage(const wxString& message);
+    
     namespace Core
     {
         void activateRenderLoop(bool on);
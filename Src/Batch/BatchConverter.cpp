@@ -0,0 +1,302 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "Batch/BatchConverter.h"
+
+#include "IO/AriaFileWriter.h"
+#include "IO/MidiFileReader.h"
+#include "Midi/CommonMidiUtils.h"
+#include "Midi/MeasureData.h"
+#include "Midi/Sequence.h"
+#include "Midi/Track.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+
+#include "jdksmidi/multitrack.h"
+
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
+
+#include <cstdio>
+#include <set>
+
+using namespace AriaMaestosa;
+
+namespace AriaMaestosa
+{
+    wxMutex g_load_mutex;
+    
+    /** @brief converts the jobs of a BatchConverter, one job per parallelFor item */
+    class ConvertTask : public IParallelTask
+    {
+        BatchConverter* m_converter;
+        
+    public:
+        
+        ConvertTask(BatchConverter* converter)
+        {
+            m_converter = converter;
+        }
+        
+        virtual void execute(const int index)
+        {
+            m_converter->convert(index);
+        }
+    };
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BatchConverter::Job::Job(const wxString& input) : m_input(input)
+{
+    m_output_format = FORMAT_UNKNOWN;
+    m_success       = false;
+    m_track_count   = 0;
+    m_note_count    = 0;
+    
+    for (int n=0; n<PHASE_COUNT; n++) m_phase_time[n] = -1;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+BatchConverter::BatchConverter()
+{
+    m_target_format = FORMAT_UNKNOWN;
+    m_benchmark     = false;
+    m_write_output  = true;
+    m_total_time    = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BatchConverter::FileFormat BatchConverter::getFormatOf(const wxString& path)
+{
+    const wxString ext = wxFileName(path).GetExt().Lower();
+    
+    if (ext == wxT("aria"))                        return FORMAT_ARIA;
+    if (ext == wxT("mid") or ext == wxT("midi"))   return FORMAT_MIDI;
+    return FORMAT_UNKNOWN;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const char* BatchConverter::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case PHASE_LOAD:    return "load";
+        case PHASE_COMPILE: return "compile";
+        case PHASE_SAVE:    return "save";
+        default:            return "?";
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool BatchConverter::addInput(const wxString& path)
+{
+    if (getFormatOf(path) == FORMAT_UNKNOWN)
+    {
+        fprintf(stderr, "[BatchConverter] Don't know how to open '%s' (expected .aria, .mid or .midi)\n",
+                (const char*)path.utf8_str());
+        return false;
+    }
+    
+    m_jobs.push_back(new Job(path));
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void BatchConverter::prepareJob(Job* job)
+{
+    const FileFormat inputFormat = getFormatOf(job->m_input);
+    
+    if (m_target_format != FORMAT_UNKNOWN) job->m_output_format = m_target_format;
+    else job->m_output_format = (inputFormat == FORMAT_ARIA ? FORMAT_MIDI : FORMAT_ARIA);
+    
+    wxFileName output(job->m_input);
+    output.SetExt(job->m_output_format == FORMAT_ARIA ? wxT("aria") : wxT("mid"));
+    if (not m_output_dir.IsEmpty()) output.SetPath(m_output_dir);
+    
+    job->m_output = output.GetFullPath();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void BatchConverter::convert(const int jobId)
+{
+    Job* job = m_jobs.get(jobId);
+    
+    // each file gets its own sequence, nothing is shared between jobs once it's loaded
+    OwnerPtr<Sequence> sequenceOwner;
+    Sequence* sequence;
+    
+    wxStopWatch timer;
+    
+    // ---- load
+    bool success;
+    {
+        wxMutexLocker lock(g_load_mutex);
+        timer.Start(); // don't count the time spent waiting for other jobs
+        
+        sequenceOwner = new Sequence(NULL, NULL, NULL, NULL, false);
+        sequence = sequenceOwner;
+        
+        if (getFormatOf(job->m_input) == FORMAT_ARIA)
+        {
+            success = loadAriaFile(sequence, job->m_input);
+        }
+        else
+        {
+            std::set<wxString> warnings;
+            success = loadMidiFile(sequence, job->m_input, warnings);
+            
+            for (std::set<wxString>::iterator it = warnings.begin(); it != warnings.end(); it++)
+            {
+                fprintf(stderr, "[BatchConverter] %s : %s\n", (const char*)job->m_input.utf8_str(),
+                        (const char*)it->utf8_str());
+            }
+        }
+        job->m_phase_time[PHASE_LOAD] = timer.Time();
+    }
+    
+    if (not success)
+    {
+        fprintf(stderr, "[BatchConverter] Failed to load '%s'\n", (const char*)job->m_input.utf8_str());
+        return;
+    }
+    
+    job->m_track_count = sequence->getTrackAmount();
+    for (int n=0; n<job->m_track_count; n++)
+    {
+        job->m_note_count += sequence->getTrack(n)->getNoteAmount();
+    }
+    
+    // ---- compile to MIDI in memory (benchmark only; exporting does it again as part of saving)
+    if (m_benchmark)
+    {
+        const int firstMeasure = sequence->getMeasureData()->getFirstMeasure();
+        sequence->getMeasureData()->setFirstMeasure(0);
+        
+        timer.Start();
+        jdksmidi::MIDIMultiTrack tracks;
+        int length = -1, start = -1, numTracks = -1;
+        makeJDKMidiSequence(sequence, tracks, false, &length, &start, &numTracks, false);
+        job->m_phase_time[PHASE_COMPILE] = timer.Time();
+        
+        sequence->getMeasureData()->setFirstMeasure(firstMeasure);
+    }
+    
+    // ---- save
+    if (m_write_output)
+    {
+        timer.Start();
+        if (job->m_output_format == FORMAT_ARIA) success = saveAriaFile(sequence, job->m_output);
+        else                                     success = exportMidiFile(sequence, job->m_output);
+        job->m_phase_time[PHASE_SAVE] = timer.Time();
+        
+        if (not success)
+        {
+            fprintf(stderr, "[BatchConverter] Failed to write '%s'\n", (const char*)job->m_output.utf8_str());
+            return;
+        }
+    }
+    
+    job->m_success = true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool BatchConverter::run()
+{
+    const int count = m_jobs.size();
+    
+    for (int n=0; n<count; n++)
+    {
+        prepareJob(m_jobs.get(n));
+        
+        // never overwrite one of the files we are reading from
+        for (int j=0; j<count; j++)
+        {
+            if (wxFileName(m_jobs[n].m_output) == wxFileName(m_jobs[j].m_input))
+            {
+                fprintf(stderr, "[BatchConverter] '%s' would overwrite an input file, use another output "
+                        "directory\n", (const char*)m_jobs[n].m_output.utf8_str());
+                return false;
+            }
+        }
+    }
+    
+    wxStopWatch timer;
+    ConvertTask task(this);
+    ThreadPool::getInstance()->parallelFor(count, &task);
+    m_total_time = timer.Time();
+    
+    bool success = true;
+    for (int n=0; n<count; n++)
+    {
+        if (not m_jobs[n].m_success) success = false;
+    }
+    return success;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void BatchConverter::printReport() const
+{
+    const int count = m_jobs.size();
+    
+    long totals[PHASE_COUNT] = { 0 };
+    int  noteTotal = 0;
+    int  failures  = 0;
+    
+    printf("%-40s %8s %8s %8s %8s %10s\n", "file", getPhaseName(PHASE_LOAD), getPhaseName(PHASE_COMPILE),
+           getPhaseName(PHASE_SAVE), "tracks", "notes");
+    
+    for (int n=0; n<count; n++)
+    {
+        const Job& job = m_jobs[n];
+        
+        printf("%-40s", (const char*)wxFileName(job.m_input).GetFullName().utf8_str());
+        for (int p=0; p<PHASE_COUNT; p++)
+        {
+            if (job.m_phase_time[p] < 0)
+            {
+                printf(" %8s", "-");
+            }
+            else
+            {
+                printf(" %8ld", job.m_phase_time[p]);
+                totals[p] += job.m_phase_time[p];
+            }
+        }
+        printf(" %8i %10i%s\n", job.m_track_count, job.m_note_count, job.m_success ? "" : "  FAILED");
+        
+        noteTotal += job.m_note_count;
+        if (not job.m_success) failures++;
+    }
+    
+    printf("%-40s", "total (ms, summed over files)");
+    for (int p=0; p<PHASE_COUNT; p++) printf(" %8ld", totals[p]);
+    printf(" %8s %10i\n", "", noteTotal);
+    
+    printf("%i file(s), %i failed, %ld ms wall time on %i thread(s)\n", count, failures, m_total_time,
+           ThreadPool::getInstance()->isEnabled() ? ThreadPool::getInstance()->getThreadCount() : 1);
+}
@@ -0,0 +1,139 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef __BATCH_CONVERTER_H__
+#define __BATCH_CONVERTER_H__
+
+#include "ptr_vector.h"
+
+#include <wx/string.h>
+#include <wx/thread.h>
+
+namespace AriaMaestosa
+{
+    
+    /**
+      * Loading a file goes through code written for the (single threaded) GUI : creating tracks reads the
+      * preferences, instrument and drum kit tables are lazily filled, the current sequence provider is
+      * global, etc. Nothing of it is locked, so whoever loads (or creates) a sequence outside the main
+      * thread must hold this mutex while doing so; compiling and saving only touch their own sequence.
+      */
+    extern wxMutex g_load_mutex;
+    
+    /**
+      * @brief converts .aria files to .mid and back without any GUI, several files at once.
+      *
+      * Used by the headless 'AriaBatch' program (see BatchMain.cpp). Each file gets its own
+      * Sequence, and files are spread across the ThreadPool. Only compiling and saving actually
+      * run in parallel : files are loaded one at a time (see g_load_mutex). In benchmark mode
+      * every phase of every file is timed and an additional in-memory MIDI compilation phase is run, so that
+      * the output can be compared from one build to the next.
+      */
+    class BatchConverter
+    {
+    public:
+        
+        enum FileFormat
+        {
+            FORMAT_UNKNOWN,
+            FORMAT_ARIA,
+            FORMAT_MIDI
+        };
+        
+        enum Phase
+        {
+            PHASE_LOAD,
+            PHASE_COMPILE,
+            PHASE_SAVE,
+            
+            PHASE_COUNT
+        };
+        
+        /** @brief one input file, with its conversion results */
+        struct Job
+        {
+            wxString   m_input;
+            wxString   m_output;
+            FileFormat m_output_format;
+            
+            bool m_success;
+            int  m_track_count;
+            int  m_note_count;
+            
+            /** Time spent in each phase, in milliseconds; -1 if the phase was not run */
+            long m_phase_time[PHASE_COUNT];
+            
+            Job(const wxString& input);
+        };
+        
+    private:
+        
+        ptr_vector<Job, HOLD> m_jobs;
+        
+        /** Format to convert to; FORMAT_UNKNOWN means "the other one" */
+        FileFormat m_target_format;
+        
+        /** Where output files go; empty means next to the input file */
+        wxString m_output_dir;
+        
+        bool m_benchmark;
+        bool m_write_output;
+        
+        long m_total_time;
+        
+        void prepareJob(Job* job);
+        
+    public:
+        
+        BatchConverter();
+        
+        /** @return the format of a file, based on its extension */
+        static FileFormat getFormatOf(const wxString& path);
+        
+        static const char* getPhaseName(Phase phase);
+        
+        void setTargetFormat(FileFormat format)      { m_target_format = format;     }
+        void setOutputDirectory(const wxString& dir) { m_output_dir    = dir;        }
+        void setBenchmarkMode(bool benchmark)        { m_benchmark     = benchmark;  }
+        
+        /** @brief when off, files are loaded (and compiled in benchmark mode) but nothing is written */
+        void setWriteOutput(bool write)              { m_write_output  = write;      }
+        
+        /** @return false if the file is of a format that cannot be converted */
+        bool addInput(const wxString& path);
+        
+        int getJobCount() const               { return m_jobs.size(); }
+        const Job& getJob(const int id) const { return m_jobs[id];    }
+        
+        /**
+          * @brief convert a single file; called for each job by 'run', possibly from a worker thread
+          */
+        void convert(const int jobId);
+        
+        /**
+          * @brief convert all files that were added
+          * @return whether all conversions succeeded
+          */
+        bool run();
+        
+        /** @brief print per-file and per-phase timings to stdout */
+        void printReport() const;
+    };
+    
+}
+
+#endif
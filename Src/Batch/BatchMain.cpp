@@ -0,0 +1,199 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+/**
+  * Entry point of 'AriaBatch', the headless converter/benchmark driver (build it with 'scons batch').
+  * This file is only compiled into that program; in the regular Aria build ARIA_BATCH is not
+  * defined and it is empty.
+  */
+
+#ifdef ARIA_BATCH
+
+#include "AriaCore.h"
+#include "Batch/BatchConverter.h"
+#include "Benchmark.h"
+#include "PreferencesData.h"
+#include "Singleton.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <wx/app.h>
+#include <wx/init.h>
+#include <wx/string.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace AriaMaestosa;
+
+static void printUsage()
+{
+    printf("Usage: AriaBatch [options] file1 [file2 ...]\n"
+           "       AriaBatch --benchmarks [--filter <name>] [--json <file>] [--warmup N] [--reps N]\n"
+           "\n"
+           "Converts .aria files to .mid and .mid/.midi files to .aria, several files at once.\n"
+           "\n"
+           "Options:\n"
+           "  --to aria|mid     convert all files to this format (default: the other format)\n"
+           "  --out <dir>       write output files to this directory (default: next to the input)\n"
+           "  --jobs 1          convert files one at a time instead of in parallel (files are\n"
+           "                    always loaded one at a time, only compiling and writing overlap)\n"
+           "  --bench           print per-file, per-phase timings; also times MIDI compilation\n"
+           "  --no-write        load (and with --bench, compile) only, don't write any output\n"
+           "  --trace <file>    record a Chrome trace (chrome://tracing) of the run to this file;\n"
+           "                    setting the ARIA_TRACE environment variable does the same\n"
+           "  --help            show this message\n"
+           "\n"
+           "Benchmarks (only available when built with 'scons batch benchmarks=1'):\n"
+           "  --benchmarks      run the BENCHMARK suite on synthetic songs of 1k, 10k and 100k notes\n"
+           "  --filter <name>   only run benchmarks whose name contains this\n"
+           "  --json <file>     also write results to this file, one JSON object per line\n"
+           "  --warmup N        untimed runs before measuring (default: 2)\n"
+           "  --reps N          timed runs (default: 10)\n");
+}
+
+// ------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    // A console app instance : wx base services (threads, files, config) get initialized, but no
+    // toolkit, display or OpenGL context is ever created
+    wxAppConsole::SetInstance( new wxAppConsole() );
+    wxInitializer initializer(argc, argv);
+    if (not initializer.IsOk())
+    {
+        fprintf(stderr, "[AriaBatch] Failed to initialize wxWidgets\n");
+        return 1;
+    }
+    
+    okToLog = false;
+    Core::setPlayDuringEdit(PLAY_NEVER);
+    PreferencesData::getInstance()->init();
+    
+    BatchConverter converter;
+    bool benchmark = false;
+    bool parallel  = true;
+    
+    bool        runBenchmarks = false;
+    std::string benchmarkFilter;
+    std::string benchmarkJson;
+    int         benchmarkWarmup = 2;
+    int         benchmarkReps   = 10;
+    
+    for (int n=1; n<argc; n++)
+    {
+        const wxString arg(argv[n], wxConvUTF8);
+        
+        if (arg == wxT("--help"))
+        {
+            printUsage();
+            return 0;
+        }
+        else if (arg == wxT("--bench"))
+        {
+            benchmark = true;
+        }
+        else if (arg == wxT("--benchmarks"))
+        {
+            runBenchmarks = true;
+        }
+        else if (arg == wxT("--filter") and n+1 < argc)
+        {
+            benchmarkFilter = argv[++n];
+        }
+        else if (arg == wxT("--json") and n+1 < argc)
+        {
+            benchmarkJson = argv[++n];
+        }
+        else if (arg == wxT("--warmup") and n+1 < argc)
+        {
+            benchmarkWarmup = std::max(0, atoi(argv[++n]));
+        }
+        else if (arg == wxT("--reps") and n+1 < argc)
+        {
+            benchmarkReps = std::max(1, atoi(argv[++n]));
+        }
+        else if (arg == wxT("--no-write"))
+        {
+            converter.setWriteOutput(false);
+        }
+        else if (arg == wxT("--to") and n+1 < argc)
+        {
+            const wxString format(argv[++n], wxConvUTF8);
+            if      (format == wxT("aria")) converter.setTargetFormat(BatchConverter::FORMAT_ARIA);
+            else if (format == wxT("mid"))  converter.setTargetFormat(BatchConverter::FORMAT_MIDI);
+            else
+            {
+                fprintf(stderr, "[AriaBatch] Unknown format '%s'\n", argv[n]);
+                return 1;
+            }
+        }
+        else if (arg == wxT("--out") and n+1 < argc)
+        {
+            converter.setOutputDirectory( wxString(argv[++n], wxConvUTF8) );
+        }
+        else if (arg == wxT("--trace") and n+1 < argc)
+        {
+            Tracer::start(argv[++n]);
+        }
+        else if (arg == wxT("--jobs") and n+1 < argc)
+        {
+            parallel = (atoi(argv[++n]) != 1);
+        }
+        else if (arg.StartsWith(wxT("--")))
+        {
+            fprintf(stderr, "[AriaBatch] Unknown option '%s'\n", argv[n]);
+            printUsage();
+            return 1;
+        }
+        else if (not converter.addInput(arg))
+        {
+            return 1;
+        }
+    }
+    
+    if (not Tracer::isEnabled()) Tracer::startFromEnvironment();
+    
+    if (runBenchmarks)
+    {
+        const bool ran = BenchmarkCase::runAll(benchmarkFilter, benchmarkJson, benchmarkWarmup, benchmarkReps);
+        if (Tracer::isEnabled()) Tracer::stop();
+        SingletonBase::deleteAll();
+        return (ran ? 0 : 1);
+    }
+    
+    if (converter.getJobCount() == 0)
+    {
+        printUsage();
+        return 1;
+    }
+    
+    converter.setBenchmarkMode(benchmark);
+    ThreadPool::getInstance()->setEnabled(parallel);
+    
+    const bool success = converter.run();
+    if (benchmark) converter.printReport();
+    
+    if (Tracer::isEnabled()) Tracer::stop();
+    SingletonBase::deleteAll();
+    
+    return (success ? 0 : 2);
+}
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <vector>
+
+namespace BenchmarkList
+{
+    /** allocated on first use, since benchmarks register themselves during static initialization */
+    std::vector<BenchmarkCase*>& get()
+    {
+        static std::vector<BenchmarkCase*>* list = new std::vector<BenchmarkCase*>();
+        return *list;
+    }
+
+    /** song sizes (in notes) every benchmark is run with */
+    const int SIZES[] = { 1000, 10000, 100000 };
+    const int SIZE_COUNT = 3;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BenchmarkContext::BenchmarkContext(const int size, const int warmup, const int repetitions)
+{
+    m_size        = size;
+    m_warmup      = warmup;
+    m_repetitions = repetitions;
+    m_iteration   = 0;
+    m_running     = false;
+    m_started_at  = 0;
+    m_elapsed     = 0;
+    m_kept        = 0;
+
+    m_clock.Start();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+long long BenchmarkContext::now()
+{
+#if wxCHECK_VERSION(2,9,3)
+    return m_clock.TimeInMicro().GetValue();
+#else
+    return (long long)m_clock.Time() * 1000;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool BenchmarkContext::next()
+{
+    if (m_iteration > 0)
+    {
+        pause();
+        if (m_iteration > m_warmup) m_samples.push_back(m_elapsed);
+    }
+
+    if (m_iteration == m_warmup + m_repetitions) return false;
+
+    m_elapsed = 0;
+    m_iteration++;
+    resume();
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void BenchmarkContext::pause()
+{
+    if (not m_running) return;
+
+    m_elapsed += now() - m_started_at;
+    m_running = false;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void BenchmarkContext::resume()
+{
+    if (m_running) return;
+
+    m_started_at = now();
+    m_running = true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+BenchmarkCase::BenchmarkCase(const char* name, const char* filePath)
+{
+    m_name = name;
+
+    // keep the path relative to the source directory, like unit test groups
+    m_file = filePath;
+    const size_t src = m_file.rfind("Src/");
+    if (src != std::string::npos) m_file = m_file.substr(src + 4);
+
+    BenchmarkList::get().push_back(this);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool BenchmarkCase::runAll(const std::string& filter, const std::string& jsonPath, const int warmup,
+                           const int repetitions)
+{
+    std::vector<BenchmarkCase*>& list = BenchmarkList::get();
+    if (list.empty())
+    {
+        fprintf(stderr, "Error: benchmarks were not compiled into this binary (build with 'scons batch benchmarks=1')\n");
+        return false;
+    }
+
+    FILE* json = NULL;
+    if (not jsonPath.empty())
+    {
+        json = fopen(jsonPath.c_str(), "w");
+        if (json == NULL) fprintf(stderr, "[Benchmark] Cannot write to '%s'\n", jsonPath.c_str());
+    }
+
+    printf("%-32s %8s %12s %12s %12s %12s\n", "benchmark", "notes", "min (ms)", "median (ms)", "p95 (ms)",
+           "mean (ms)");
+
+    int count = 0;
+    for (unsigned int n=0; n<list.size(); n++)
+    {
+        if (not filter.empty() and list[n]->getName().find(filter) == std::string::npos) continue;
+
+        for (int s=0; s<BenchmarkList::SIZE_COUNT; s++)
+        {
+            BenchmarkContext bench(BenchmarkList::SIZES[s], warmup, repetitions);
+            list[n]->run(bench);
+
+            std::vector<long long> samples = bench.getSamples();
+            if (samples.empty())
+            {
+                fprintf(stderr, "[Benchmark] %s took no samples, does it loop on bench.next()?\n",
+                        list[n]->getName().c_str());
+                continue;
+            }
+            std::sort(samples.begin(), samples.end());
+
+            const int amount = samples.size();
+            long long sum = 0;
+            for (int i=0; i<amount; i++) sum += samples[i];
+
+            const long long minimum = samples[0];
+            const long long median  = (amount % 2 == 1 ? samples[amount/2] :
+                                                         (samples[amount/2 - 1] + samples[amount/2])/2);
+            const long long p95     = samples[std::max(0, (int)std::ceil(amount*0.95) - 1)];
+            const long long mean    = sum / amount;
+
+            printf("%-32s %8i %12.3f %12.3f %12.3f %12.3f\n", list[n]->getName().c_str(), bench.getSize(),
+                   minimum/1000.0, median/1000.0, p95/1000.0, mean/1000.0);
+            fflush(stdout);
+
+            if (json != NULL)
+            {
+                fprintf(json, "{\"benchmark\": \"%s\", \"file\": \"%s\", \"notes\": %i, \"warmup\": %i, "
+                              "\"repetitions\": %i, \"min_us\": %lld, \"median_us\": %lld, \"p95_us\": %lld, "
+                              "\"mean_us\": %lld}\n",
+                        list[n]->getName().c_str(), list[n]->getFile().c_str(), bench.getSize(), warmup,
+                        amount, minimum, median, p95, mean);
+            }
+        }
+        count++;
+    }
+
+    if (json != NULL) fclose(json);
+
+    if (count == 0) fprintf(stderr, "[Benchmark] No benchmark matches '%s'\n", filter.c_str());
+    return count > 0;
+}
@@ -0,0 +1,91 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <string>
+#include <vector>
+#include <wx/stopwatch.h>
+
+/**
+  * State of one benchmark run, seen as 'bench' inside a BENCHMARK body. The body prepares its data,
+  * then loops on 'bench.next()'; every pass through the loop is one sample. The first passes are
+  * warmup and are not recorded. Setup that must not be timed goes between 'pause()' and 'resume()'.
+  * Results of the timed work are handed to 'keep()' so that the compiler can't optimize the work away.
+  *
+  *     BENCHMARK( Foo )
+  *     {
+  *         BenchmarkSong song(bench, 10);
+  *         while (bench.next())
+  *         {
+  *             bench.keep( song->foo() );
+  *         }
+  *     }
+  */
+class BenchmarkContext
+{
+    int m_size;
+    int m_warmup;
+    int m_repetitions;
+    int m_iteration;
+
+    bool m_running;
+    wxStopWatch m_clock;
+    long long m_started_at;
+    long long m_elapsed;
+
+    std::vector<long long> m_samples;
+
+    /** Sum of all values passed to 'keep', volatile so that computing them can't be skipped */
+    volatile long long m_kept;
+
+    long long now();
+
+public:
+    BenchmarkContext(const int size, const int warmup, const int repetitions);
+
+    /** @return the amount of notes the song used by this run should contain */
+    int getSize() const { return m_size; }
+
+    /** @brief ends the current sample (if any) and starts the next one; false once all samples are taken */
+    bool next();
+
+    void pause();
+    void resume();
+
+    /** @brief uses 'value' (the result of the benchmarked work), so that the work isn't optimized away */
+    void keep(const long long value) { m_kept = m_kept + value; }
+
+    /** @return the duration of each recorded sample, in microseconds */
+    const std::vector<long long>& getSamples() const { return m_samples; }
+};
+
+class BenchmarkCase
+{
+    std::string m_name;
+    std::string m_file;
+public:
+    BenchmarkCase(const char* name, const char* filePath);
+    virtual ~BenchmarkCase() {}
+    virtual void run(BenchmarkContext& bench) = 0;
+
+    const std::string& getName() const { return m_name; }
+    const std::string& getFile() const { return m_file; }
+
+    /**
+      * @brief runs every benchmark whose name contains 'filter' (all if empty), on songs of 1k, 10k
+      *        and 100k notes, and prints min/median/p95/mean for each
+      * @param jsonPath if not empty, results are also written there, one JSON object per line
+      * @return false if no benchmark was run
+      */
+    static bool runAll(const std::string& filter, const std::string& jsonPath, const int warmup,
+                       const int repetitions);
+};
+
+#ifdef ARIA_BENCHMARKS
+#define BENCHMARK( NAME ) class NAME##_benchmark : public BenchmarkCase { public: NAME##_benchmark(const char* name, const char* filename) : BenchmarkCase(name, filename){} void run(BenchmarkContext& bench); }; \
+                          static NAME##_benchmark benchmark_##NAME = NAME##_benchmark( #NAME, __FILE__ ); void NAME##_benchmark::run(BenchmarkContext& bench)
+#else
+// same trick as UNIT_TEST : benchmarks are only compiled in when asked for ('scons batch benchmarks=1')
+#define BENCHMARK( NAME ) template<typename T> void NAME ## _uninstantiated_benchmark(BenchmarkContext& bench)
+#endif
+
+#endif
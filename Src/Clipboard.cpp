@@ -15,29 +15,28 @@
  */
 
 #include "Clipboard.h"
-#include "ptr_vector.h"
 #include "Midi/Note.h"
+#include "Midi/NoteSnapshot.h"
 
 namespace AriaMaestosa
 {
 
     /**
-      * The clipboard will always delete notes you give it.
-      * When you get notes from the Clipboard, or add notes to it,
-      * always make a copy of the Note object using the copy constructor.
+      * The clipboard keeps the values of the notes you give it, not the Note objects.
+      * Use NoteSnapshot::createNote to get real notes back when pasting.
       */    
     namespace Clipboard
     {
 
-        /** a vector to store copied notes */
-        ptr_vector<Note> clipboard;
+        /** the copied notes */
+        NoteSnapshot clipboard;
         
         /** store beat length of copied notes, in case you want to copy from a song to another with different beat lengths */
         int beat_length = 960;
 
         void clear()
         {
-            clipboard.clearAndDeleteAll();
+            clipboard.clear();
         }
         void setBeatLength(const int beat_length_arg)
         {
@@ -48,9 +47,9 @@ namespace AriaMaestosa
             return beat_length;
         }
 
-        void add(Note* n)
+        void add(const Note& n)
         {
-            clipboard.push_back(n);
+            clipboard.add(n);
         }
 
         int getSize()
@@ -58,12 +57,17 @@ namespace AriaMaestosa
             return clipboard.size();
         }
 
-        Note* getNote( int index )
+        const NoteValues& getNote( int index )
         {
             ASSERT_E(index, >=, 0);
             ASSERT_E(index, <, clipboard.size());
 
-            return &clipboard[index];
+            return clipboard.get(index);
+        }
+
+        const NoteSnapshot& getContents()
+        {
+            return clipboard;
         }
 
     }
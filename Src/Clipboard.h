@@ -21,13 +21,18 @@
 namespace AriaMaestosa
 {
     class Note;
+    class NoteSnapshot;
+    struct NoteValues;
     
     namespace Clipboard
     {
         void  clear();
-        void  add(Note* n);
+        void  add(const Note& n);
         int   getSize();
-        Note* getNote( int index );
+        const NoteValues& getNote( int index );
+        
+        /** @return the copied notes */
+        const NoteSnapshot& getContents();
         
         void  setBeatLength(const int beat_length_arg);
         int   getBeatLength();
@@ -0,0 +1,78 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "Dialogs/FileDialog.h"
+
+#include "Utils.h"
+
+#include <wx/filedlg.h>
+#include <wx/utils.h>
+#include <wx/app.h>
+
+namespace AriaMaestosa {
+
+#ifdef __WXOSX_COCOA__
+bool g_have_answer = false;
+wxString g_answer;
+void sheetCallback(wxWindowModalDialogEvent& evt)
+{
+    if (evt.GetReturnCode() == wxID_OK)
+    {
+        g_answer = ((wxFileDialog*)evt.GetDialog())->GetPath();
+    }
+    else
+    {
+        g_answer = wxT("");
+    }
+    g_have_answer = true;
+}
+#endif
+
+wxString showFileDialog(wxWindow* parent,
+                        wxString message,
+                        wxString defaultDir,
+                        wxString filename,
+                        wxString wildcard,
+                        bool save)
+{
+    wxFileDialog* dialog = new wxFileDialog(parent, message, defaultDir, filename, wildcard, (save?wxFD_SAVE:wxFD_OPEN));
+    
+#ifdef __WXOSX_COCOA__
+    g_have_answer = false;
+    dialog->Bind(wxEVT_WINDOW_MODAL_DIALOG_CLOSED, &sheetCallback);
+    dialog->ShowWindowModal();
+    
+    // FIXME: that's ugly :)
+    while (not g_have_answer)
+    {
+        wxYield();
+        wxMilliSleep(10);
+    }
+    return g_answer;
+#else
+    int answer = dialog->ShowModal();
+    
+    wxString path = dialog->GetPath();
+    dialog->Destroy();
+    
+    if (answer != wxID_OK) return wxT("");
+
+    return path;
+#endif
+}
+
+}
@@ -16,6 +16,7 @@
 
 
 #include "Dialogs/Preferences.h"
+#include "Dialogs/FileDialog.h"
 
 #include <iostream>
 
@@ -436,6 +437,7 @@ void PreferencesDialog::show()
 void PreferencesDialog::okClicked(wxCommandEvent& evt)
 {
     updateValuesFromWidgets();
+    m_data->refreshCachedValues();
     m_data->save();
     wxDialog::EndModal(wxID_OK);
     
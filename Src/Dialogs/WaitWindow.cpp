@@ -152,7 +152,8 @@ namespace AriaMaestosa
         
         void setProgress(int progress)
         {
-            waitWindow->setProgress( progress );
+            // layout also runs without any window shown, e.g. when exporting from the command line
+            if (waitWindow != NULL) waitWindow->setProgress( progress );
         }
         
         void hide()
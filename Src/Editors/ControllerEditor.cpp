@@ -35,7 +35,9 @@
 #include "Midi/Track.h"
 #include "Pickers/ControllerChoice.h"
 #include "Pickers/InstrumentPicker.h"
+#include "PerformanceStats.h"
 #include "Renderers/RenderAPI.h"
+#include "Tracer.h"
 
 #include <string>
 #include <cmath>
@@ -52,6 +54,34 @@
 
 using namespace AriaMaestosa;
 
+/** @brief renders the text of a text event (lyrics, ...), attached to the event as its view */
+class TextEventString : public ITextEventView
+{
+    AriaRenderString m_string;
+    
+public:
+    
+    TextEventString(TextEvent* evt) : m_string(evt->getTextModel(), false)
+    {
+    }
+    
+    AriaRenderString& getString() { return m_string; }
+    
+    /** @return the render string of the given event, created the first time the event is drawn */
+    static AriaRenderString& getRenderString(TextEvent* evt)
+    {
+        TextEventString* view = dynamic_cast<TextEventString*>(evt->getView());
+        if (view == NULL)
+        {
+            view = new TextEventString(evt);
+            evt->setView(view);
+        }
+        return view->getString();
+    }
+};
+
+// ----------------------------------------------------------------------------------------------------------
+
 class ControlChangeInput : public wxMiniFrame
 {
     ControllerEditor* m_parent;
@@ -321,7 +351,8 @@ void ControllerEditor::renderEvents()
             if (xloc - x_scroll > Editor::getEditorXStart() - 100)
             {
                 TextEvent* evt = dynamic_cast<TextEvent*>(tmp);
-                evt->getText().bind();
+                AriaRenderString& text = TextEventString::getRenderString(evt);
+                text.bind();
                 AriaRender::color(0,0,0);
                 
                 int y;
@@ -356,7 +387,7 @@ void ControllerEditor::renderEvents()
                 AriaRender::images();
                 
                 
-                evt->getText().render(xloc - x_scroll + 6, y);
+                text.render(xloc - x_scroll + 6, y);
             }
         }
         else if (currentController == PSEUDO_CONTROLLER_INSTRUMENT_CHANGE)
@@ -474,6 +505,8 @@ void ControllerEditor::renderEvents()
 void ControllerEditor::render(RelativeXCoord mousex_current, int mousey_current,
                               RelativeXCoord mousex_initial, int mousey_initial, bool focus)
 {
+    TRACE_ZONE("ControllerEditor::render");
+    PerformanceStats::ScopedTimer statsTimer(PerformanceStats::CONTROLLER_RENDER);
     AriaRender::beginScissors(LEFT_EDGE_X, getEditorYStart(), m_width - RIGHT_SCISSOR, m_height);
     
     // -------------------------------- background ----------------------------
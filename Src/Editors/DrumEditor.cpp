@@ -33,7 +33,9 @@
 #include "Pickers/DrumPicker.h"
 #include "PreferencesData.h"
 #include "Renderers/Drawable.h"
+#include "PerformanceStats.h"
 #include "Renderers/RenderAPI.h"
+#include "Tracer.h"
 
 #include "AriaCore.h"
 
@@ -267,6 +269,8 @@ DrumEditor::DrumEditor(GraphicalTrack* track) : Editor(track)
     m_clicked_on_note      = false;
     m_last_clicked_note    = -1;
     m_show_used_drums_only = false;
+    m_drum_rows_revision    = -1;
+    m_drum_rows_note_amount = 0;
 
     useDefaultDrumSet();
     Editor::useInstantNotes();
@@ -611,6 +615,54 @@ int DrumEditor::getYForDrum(const int given_drumID)
 }
 
 
+// ----------------------------------------------------------------------------------------------------------
+
+void DrumEditor::updateDrumRows()
+{
+    const int noteAmount = m_track->getNoteAmount();
+    if (m_drum_rows_revision == m_track->getNotesRevision() and m_drum_rows_note_amount == noteAmount)
+    {
+        return;
+    }
+
+    TRACE_ZONE("DrumEditor::updateDrumRows");
+
+    for (int key=0; key<128; key++) m_drum_rows[key].clear();
+
+    // notes of the track are in tick order, so each row is too
+    for (int n=0; n<noteAmount; n++)
+    {
+        const int pitch = m_track->getNotePitchID(n);
+        ASSERT_E(pitch, >=, 0);
+        ASSERT_E(pitch, <, 128);
+
+        DrumRowNote note;
+        note.m_tick    = m_track->getNoteStartInMidiTicks(n);
+        note.m_note_id = n;
+        m_drum_rows[pitch].push_back(note);
+    }
+
+    m_drum_rows_revision    = m_track->getNotesRevision();
+    m_drum_rows_note_amount = noteAmount;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int DrumEditor::findFirstNoteInRow(const int midiKey, const int tick) const
+{
+    const std::vector<DrumRowNote>& row = m_drum_rows[midiKey];
+
+    int first = 0;
+    int last  = row.size();
+    while (first < last)
+    {
+        const int middle = (first + last) / 2;
+        if (row[middle].m_tick < tick) first = middle + 1;
+        else                           last  = middle;
+    }
+    return first;
+}
+
 // ----------------------------------------------------------------------------------------------------------
 // ---------------------------------------------  EDITOR  ---------------------------------------------------
 // ----------------------------------------------------------------------------------------------------------
@@ -621,23 +673,28 @@ int DrumEditor::getYForDrum(const int given_drumID)
 
 NoteSearchResult DrumEditor::noteAt(RelativeXCoord x, const int y, int& noteID)
 {
-    const int noteAmount = m_track->getNoteAmount();
-    for (int n=0; n<noteAmount; n++)
-    {
-        const int drumx = m_graphical_track->getNoteStartInPixels(n) - m_gsequence->getXScrollInPixels();
+    const int drumID = getDrumAtY(y);
+    if (drumID == -1 or m_drums[drumID].m_section) return FOUND_NOTHING;
 
-        ASSERT(m_track->getNotePitchID(n)>0);
-        ASSERT(m_track->getNotePitchID(n)<128);
+    updateDrumRows();
 
-        const int drumIDInVector = m_midi_key_to_vector_ID[ m_track->getNotePitchID(n) ];
-        if (drumIDInVector == -1) continue;
+    const int midiKey = m_drums[drumID].m_midi_key;
+    const std::vector<DrumRowNote>& row = m_drum_rows[midiKey];
+    const int   x_edit  = x.getRelativeTo(EDITOR);
+    const int   pscroll = m_gsequence->getXScrollInPixels();
+    const float zoom    = m_gsequence->getZoom();
+
+    // a note can be clicked up to 5 pixels after its start
+    const int noteCount = row.size();
+    for (int i=findFirstNoteInRow(midiKey, (int)((x_edit - 6 + pscroll)/zoom) - 1); i<noteCount; i++)
+    {
+        const int n     = row[i].m_note_id;
+        const int drumx = (int)( (float)row[i].m_tick * zoom ) - pscroll;
 
-        const int drumy = getYForDrum(drumIDInVector);
+        if (drumx >= x_edit + 1) break;
 
-        if (x.getRelativeTo(EDITOR) > drumx-1 and x.getRelativeTo(EDITOR) < drumx+5 and
-            y > drumy and y < drumy+Y_STEP)
+        if (x_edit > drumx-1 and x_edit < drumx+5)
         {
-
             noteID = n;
 
             if (m_track->isNoteSelected(n) and not Display::isSelectLessPressed())
@@ -652,7 +709,7 @@ NoteSearchResult DrumEditor::noteAt(RelativeXCoord x, const int y, int& noteID)
 
         }
 
-    }//next note
+    }//next note in row
 
     return FOUND_NOTHING;
 }
@@ -740,32 +797,34 @@ void DrumEditor::moveNote(Note& note, const int relativeX, const int relativeY)
 void DrumEditor::selectNotesInRect(RelativeXCoord& mousex_current, int mousey_current,
                                    RelativeXCoord& mousex_initial, int mousey_initial)
 {
-    const int count = m_track->getNoteAmount();
-    for (int n=0; n<count; n++)
+    updateDrumRows();
+
+    const int mouse_x_min = std::min(mousex_current.getRelativeTo(EDITOR), mousex_initial.getRelativeTo(EDITOR));
+    const int mouse_x_max = std::max(mousex_current.getRelativeTo(EDITOR), mousex_initial.getRelativeTo(EDITOR));
+    const int mouse_y_min = std::min(mousey_current, mousey_initial);
+    const int mouse_y_max = std::max(mousey_current, mousey_initial);
+    const int   pscroll   = m_gsequence->getXScrollInPixels();
+    const float zoom      = m_gsequence->getZoom();
+
+    // every note must be visited, to unselect those outside the rectangle; going row by row means the
+    // position of each row is only looked up once
+    for (int midiKey=0; midiKey<128; midiKey++)
     {
-        const int drumx = m_graphical_track->getNoteStartInPixels(n) - m_gsequence->getXScrollInPixels();
-
-        ASSERT(m_track->getNotePitchID(n)>0);
-        ASSERT(m_track->getNotePitchID(n)<128);
-
-        const int drumIDInVector= m_midi_key_to_vector_ID[ m_track->getNotePitchID(n) ];
+        const int drumIDInVector = m_midi_key_to_vector_ID[midiKey];
         if (drumIDInVector == -1) continue;
 
         const int drumy = getYForDrum(drumIDInVector) + 5;
+        const bool rowInRect = (drumy > mouse_y_min and drumy < mouse_y_max);
 
-        if (drumx > std::min(mousex_current.getRelativeTo(EDITOR), mousex_initial.getRelativeTo(EDITOR)) and
-            drumx < std::max(mousex_current.getRelativeTo(EDITOR), mousex_initial.getRelativeTo(EDITOR)) and
-            drumy > std::min(mousey_current, mousey_initial) and
-            drumy < std::max(mousey_current, mousey_initial))
-        {
-            m_graphical_track->selectNote(n, true);
-        }
-        else
+        const std::vector<DrumRowNote>& row = m_drum_rows[midiKey];
+        const int noteCount = row.size();
+        for (int i=0; i<noteCount; i++)
         {
-            m_graphical_track->selectNote(n, false);
+            const int drumx = (int)( (float)row[i].m_tick * zoom ) - pscroll;
+            m_graphical_track->selectNote(row[i].m_note_id,
+                                          rowInRect and drumx > mouse_x_min and drumx < mouse_x_max);
         }
-
-    }//next note
+    }//next row
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -878,6 +937,8 @@ void DrumEditor::mouseUp(RelativeXCoord mousex_current, const int mousey_current
 void DrumEditor::render(RelativeXCoord mousex_current, int mousey_current,
                         RelativeXCoord mousex_initial, int mousey_initial, bool focus)
 {
+    TRACE_ZONE("DrumEditor::render");
+    PerformanceStats::ScopedTimer statsTimer(PerformanceStats::DRUM_RENDER);
     AriaRender::beginScissors(LEFT_EDGE_X, getEditorYStart(), m_width - RIGHT_SCISSOR, m_height);
 
     drawVerticalMeasureLines(getEditorYStart(), getYEnd());
@@ -905,43 +966,58 @@ void DrumEditor::render(RelativeXCoord mousex_current, int mousey_current,
     const int mouse_y1 = std::min(mousey_current, mousey_initial);
     const int mouse_y2 = std::max(mousey_current, mousey_initial);
     
-    const int noteAmount = m_track->getNoteAmount();
-    for (int n=0; n<noteAmount; n++)
-    {
-        const int drumx = m_graphical_track->getNoteStartInPixels(n) - m_gsequence->getXScrollInPixels() +
-                          Editor::getEditorXStart();
+    updateDrumRows();
 
-        // don't draw notes that won't visible
-        if (drumx < 0)       continue;
-        if (drumx > m_width) break;
+    const int   noteAmount = m_track->getNoteAmount();
+    const int   xOffset    = Editor::getEditorXStart() - m_gsequence->getXScrollInPixels();
+    const float zoom       = m_gsequence->getZoom();
 
-        ASSERT(m_track->getNotePitchID(n) >= 0);
-        ASSERT(m_track->getNotePitchID(n) < 128);
+    // first tick whose note can be visible (notes start at x >= 0)
+    const int firstVisibleTick = (int)( -xOffset / zoom ) - 1;
 
-        const int drumIDInVector = m_midi_key_to_vector_ID[ m_track->getNotePitchID(n) ];
-        
-        if (drumIDInVector == -1) continue;
+    int drawnNotes = 0;
+    for (int drumID=0; drumID<drumAmount; drumID++)
+    {
+        if (m_drums[drumID].m_section) continue;
 
-        const float volume = m_track->getNoteVolume(n)/127.0;
-        const int drumy = getYForDrum(drumIDInVector);
+        // rows of collapsed sections are not shown, rows out of view don't need to be drawn
+        const int drumy = getYForDrum(drumID);
+        if (drumy == -1 or drumy + Y_STEP < getEditorYStart() or drumy > getYEnd()) continue;
 
-        if (m_selecting and drumx > mouse_x1 and drumx < mouse_x2 and drumy + 5 > mouse_y1 and drumy + 5 < mouse_y2)
-        {
-            AriaRender::color(0.94f, 1.0f, 0.0f);
-        }
-        else if (m_track->isNoteSelected(n) and focus)
+        const int midiKey = m_drums[drumID].m_midi_key;
+        const std::vector<DrumRowNote>& row = m_drum_rows[midiKey];
+        const int noteCount = row.size();
+        for (int i=findFirstNoteInRow(midiKey, firstVisibleTick); i<noteCount; i++)
         {
-            AriaRender::color((1-volume)*1, (1-(volume/2))*1, 0);
-        }
-        else
-        {
-            AriaRender::color((1-volume)*0.9, (1-volume)*0.9, (1-volume)*0.9);
-        }
+            const int n     = row[i].m_note_id;
+            const int drumx = (int)( (float)row[i].m_tick * zoom ) + xOffset;
 
-        AriaRender::triangle(drumx,     drumy,
-                             drumx,     drumy+Y_STEP,
-                             drumx+5,   drumy+5);
-    }
+            // don't draw notes that won't visible
+            if (drumx < 0)       continue;
+            if (drumx > m_width) break;
+            drawnNotes++;
+
+            const float volume = m_track->getNoteVolume(n)/127.0;
+
+            if (m_selecting and drumx > mouse_x1 and drumx < mouse_x2 and drumy + 5 > mouse_y1 and drumy + 5 < mouse_y2)
+            {
+                AriaRender::color(0.94f, 1.0f, 0.0f);
+            }
+            else if (m_track->isNoteSelected(n) and focus)
+            {
+                AriaRender::color((1-volume)*1, (1-(volume/2))*1, 0);
+            }
+            else
+            {
+                AriaRender::color((1-volume)*0.9, (1-volume)*0.9, (1-volume)*0.9);
+            }
+
+            AriaRender::triangle(drumx,     drumy,
+                                 drumx,     drumy+Y_STEP,
+                                 drumx+5,   drumy+5);
+        }//next note in row
+    }//next row
+    PerformanceStats::countNotes(drawnNotes, noteAmount);
 
 
     // ------------------------- mouse drag (preview) ------------------------
@@ -987,29 +1063,30 @@ void DrumEditor::render(RelativeXCoord mousex_current, int mousey_current,
         }
         else
         {
-            // move a bunch of notes
+            // move a bunch of notes ; only those that will be in view once moved need a preview
+            const int firstPreviewTick = (int)( (-xOffset - x_steps_to_move) / zoom ) - 1;
 
-            for (int n=0; n<noteAmount; n++)
+            for (int midiKey=0; midiKey<128; midiKey++)
             {
-                if (not m_track->isNoteSelected(n)) continue;
-
-                const int drumx = m_graphical_track->getNoteStartInPixels(n) -
-                                  m_gsequence->getXScrollInPixels() +
-                                  Editor::getEditorXStart();
-
-                ASSERT_E(m_track->getNotePitchID(n), >, 0);
-                ASSERT_E(m_track->getNotePitchID(n), <, 128);
-
-                const int drumIDInVector = m_midi_key_to_vector_ID[ m_track->getNotePitchID(n) ];
-                
+                const int drumIDInVector = m_midi_key_to_vector_ID[midiKey];
                 if (drumIDInVector == -1) continue;
 
                 const int drumy = getYForDrum(drumIDInVector);
 
-                AriaRender::triangle(drumx+x_steps_to_move,         drumy + y_steps_to_move*Y_STEP,
-                                     drumx+x_steps_to_move,         drumy + (y_steps_to_move+1)*Y_STEP,
-                                     drumx + 5 + x_steps_to_move,   drumy + Y_STEP/2 + y_steps_to_move*Y_STEP);
-            } // next note
+                const std::vector<DrumRowNote>& row = m_drum_rows[midiKey];
+                const int noteCount = row.size();
+                for (int i=findFirstNoteInRow(midiKey, firstPreviewTick); i<noteCount; i++)
+                {
+                    const int drumx = (int)( (float)row[i].m_tick * zoom ) + xOffset;
+                    if (drumx + x_steps_to_move > m_width) break;
+
+                    if (not m_track->isNoteSelected(row[i].m_note_id)) continue;
+
+                    AriaRender::triangle(drumx+x_steps_to_move,         drumy + y_steps_to_move*Y_STEP,
+                                         drumx+x_steps_to_move,         drumy + (y_steps_to_move+1)*Y_STEP,
+                                         drumx + 5 + x_steps_to_move,   drumy + Y_STEP/2 + y_steps_to_move*Y_STEP);
+                } // next note in row
+            } // next row
 
 
         }
@@ -56,6 +56,28 @@ namespace AriaMaestosa
         /** says where each midiKey is located in the vector. */
         int m_midi_key_to_vector_ID[128];
 
+        /** A note of the track, as stored in the drum row index */
+        struct DrumRowNote
+        {
+            int m_tick;
+            int m_note_id;
+        };
+
+        /**
+          * Drum row index : for each MIDI key, the notes of the track with this pitch, in tick order ;
+          * so that drawing or hit-testing a row only looks at the notes of this row that are in view.
+          * Rebuilt when the track's notes revision changes.
+          */
+        std::vector<DrumRowNote> m_drum_rows[128];
+        int m_drum_rows_revision;
+        int m_drum_rows_note_amount;
+
+        /** @brief rebuilds m_drum_rows if the notes of the track changed since it was built */
+        void updateDrumRows();
+
+        /** @return index in m_drum_rows[midiKey] of the first note at or after 'tick' */
+        int findFirstNoteInRow(const int midiKey, const int tick) const;
+
     public:
         
         DrumEditor(GraphicalTrack* track);
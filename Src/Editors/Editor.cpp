@@ -501,7 +501,7 @@ void Editor::mouseDown(RelativeXCoord x, int y)
             }
             else if (Display::isSelectMorePressed())
             {
-                m_track->selectNote(m_last_clicked_note, not m_track->isNoteSelected(m_last_clicked_note), true);
+                m_track->selectNote(m_last_clicked_note, not m_track->isNoteSelected(m_last_clicked_note));
             }
             
             // 'noteAt' set 'm_last_clicked_note' to the ID of the note that was clicked. However at this point
@@ -972,17 +972,17 @@ void Editor::processKeyPress(int keycode, bool commandDown, bool shiftDown)
         
         if (idSelectedNote != -1)
         {
-            m_track->selectNote(ALL_NOTES, false, true);
+            m_track->selectNote(ALL_NOTES, false);
             
             if (shiftDown)
             {
                 if (idSelectedNote > 0)
-                    m_track->selectNote(idSelectedNote - 1, true, true);
+                    m_track->selectNote(idSelectedNote - 1, true);
             }
             else
             {
                 if (idSelectedNote < m_track->getNoteAmount() - 1)
-                    m_track->selectNote(idSelectedNote + 1, true, true);
+                    m_track->selectNote(idSelectedNote + 1, true);
             }
             
             Display::render();
@@ -30,7 +30,9 @@
 #include "Midi/Track.h"
 #include "Pickers/TuningPicker.h"
 #include "PreferencesData.h"
+#include "PerformanceStats.h"
 #include "Renderers/RenderAPI.h"
+#include "Tracer.h"
 #include "Singleton.h"
 #include <cstddef>
 
@@ -65,6 +67,9 @@ GuitarEditor::GuitarEditor(GraphicalTrack* track) : Editor(track)
     m_mouse_is_in_editor = false;
     m_clicked_on_note    = false;
     m_last_clicked_note  = -1;
+
+    m_tablature_revision     = -1;
+    m_tablature_longest_note = 0;
     
 #ifdef LARGE_FONTS
     m_y_step = 15;
@@ -95,9 +100,59 @@ GuitarEditor::~GuitarEditor()
 
 // ----------------------------------------------------------------------------------------------------------
 
+void GuitarEditor::updateTablature()
+{
+    if (m_tablature_revision == m_track->getNotesRevision() and
+        (int)m_tablature.size() == m_track->getNoteAmount())
+    {
+        return;
+    }
+
+    TRACE_ZONE("GuitarEditor::updateTablature");
+
+    const int noteAmount = m_track->getNoteAmount();
+    m_tablature.resize(noteAmount);
+    m_tablature_longest_note = 0;
+
+    for (int n=0; n<noteAmount; n++)
+    {
+        TablatureNote& note = m_tablature[n];
+        note.m_start_tick = m_track->getNoteStartInMidiTicks(n);
+        note.m_end_tick   = m_track->getNoteEndInMidiTicks(n);
+        note.m_string     = m_track->getNoteString(n);
+        note.m_fret       = m_track->getNoteFret(n);
+
+        m_tablature_longest_note = std::max(m_tablature_longest_note, note.m_end_tick - note.m_start_tick);
+    }
+
+    m_tablature_revision = m_track->getNotesRevision();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int GuitarEditor::findFirstVisibleNote(const int fromTick) const
+{
+    // notes are sorted by start tick; no note starting before this can reach 'fromTick'
+    const int earliestStart = fromTick - m_tablature_longest_note;
+
+    int first = 0;
+    int last  = m_tablature.size();
+    while (first < last)
+    {
+        const int middle = (first + last) / 2;
+        if (m_tablature[middle].m_start_tick < earliestStart) first = middle + 1;
+        else                                                  last  = middle;
+    }
+    return first;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 void GuitarEditor::render(RelativeXCoord mousex_current, int mousey_current,
                           RelativeXCoord mousex_initial, int mousey_initial, bool focus)
 {
+    TRACE_ZONE("GuitarEditor::render");
+    PerformanceStats::ScopedTimer statsTimer(PerformanceStats::GUITAR_RENDER);
 
     if (not ImageProvider::imagesLoaded()) return;
 
@@ -129,7 +184,8 @@ void GuitarEditor::render(RelativeXCoord mousex_current, int mousey_current,
     }
 
     // ---------------------- draw notes ----------------------------
-    const int noteAmount = m_track->getNoteAmount();
+    updateTablature();
+    const int noteAmount = m_tablature.size();
     
     const bool mouseValid = (mousex_current.isValid() and mousex_initial.isValid());
     
@@ -138,22 +194,33 @@ void GuitarEditor::render(RelativeXCoord mousex_current, int mousey_current,
     const int mouse_y1 = std::min(mousey_current, mousey_initial);
     const int mouse_y2 = std::max(mousey_current, mousey_initial);
     
-    for (int n=0; n<noteAmount; n++)
+    const int   pscroll = m_gsequence->getXScrollInPixels();
+    const float zoom    = m_gsequence->getZoom();
+
+    for (int n=0; n<2; n++)
     {
-        const int pscroll = m_gsequence->getXScrollInPixels();
-        int x1 = m_graphical_track->getNoteStartInPixels(n) - pscroll;
-        int x2 = m_graphical_track->getNoteEndInPixels(n)   - pscroll;
+        m_fret_numbers[n].clear();
+        m_fret_numbers_x[n].clear();
+        m_fret_numbers_y[n].clear();
+    }
+
+    AriaRender::primitives();
+
+    int drawnNotes = 0;
+    for (int n=findFirstVisibleNote((int)(pscroll/zoom) - 1); n<noteAmount; n++)
+    {
+        const TablatureNote& note = m_tablature[n];
+        int x1 = (int)( (float)note.m_start_tick * zoom ) - pscroll;
+        int x2 = (int)( (float)note.m_end_tick   * zoom ) - pscroll;
 
-        
         // don't draw notes that won't visible
         if (x2 < 0    )   continue;
         if (x1 > m_width) break;
+        drawnNotes++;
 
-        AriaRender::primitives();
-        
-        const int tick   = m_track->getNoteStartInMidiTicks(n);
-        const int string = m_track->getNoteString(n);
-        const int fret   = m_track->getNoteFret(n);
+        const int tick   = note.m_start_tick;
+        const int string = note.m_string;
+        const int fret   = note.m_fret;
         const int y = getEditorYStart()+first_string_position+string*m_y_step;
 
         float volume = m_track->getNoteVolume(n)/127.0;
@@ -217,25 +284,17 @@ void GuitarEditor::render(RelativeXCoord mousex_current, int mousey_current,
                                  x1 + 18, y + 3,
                                  x1 + 13, y - 8);
             }
-            
-            AriaRender::images();
-
-            // if note color is too dark, draw the fret number in white
-            if ((not m_track->isNoteSelected(n) or not focus) and volume > 0.5 and not isInSelection)
-            {
-                AriaRender::color(1, 1, 1);
-            }
-            else
-            {
-                AriaRender::color(0, 0, 0);
-            }
 
+            // fret numbers are drawn later, all at once ; if note color is too dark, draw the
+            // fret number in white
+            const int textColor = ((not m_track->isNoteSelected(n) or not focus) and volume > 0.5 and
+                                   not isInSelection) ? 0 : 1;
+            m_fret_numbers[textColor].push_back(fret);
+            m_fret_numbers_x[textColor].push_back(x1);
 #ifdef __WXMSW__
-            AriaRender::renderNumber(fret, x1, y + 5);
+            m_fret_numbers_y[textColor].push_back(y + 5);
 #else
-            // FIXME: draw twice to make it more visible...
-            AriaRender::renderNumber(fret, x1, y + 4);
-            AriaRender::renderNumber(fret, x1, y + 4);
+            m_fret_numbers_y[textColor].push_back(y + 4);
 #endif
         }
         else
@@ -248,6 +307,25 @@ void GuitarEditor::render(RelativeXCoord mousex_current, int mousey_current,
         lastNoteTick[string] = tick;
         
     }//next
+    PerformanceStats::countNotes(drawnNotes, noteAmount);
+
+    AriaRender::images();
+    for (int n=0; n<2; n++)
+    {
+        if (m_fret_numbers[n].empty()) continue;
+
+        if (n == 0) AriaRender::color(1, 1, 1);
+        else        AriaRender::color(0, 0, 0);
+
+        const int count = m_fret_numbers[n].size();
+        AriaRender::renderNumbers(&m_fret_numbers[n][0], &m_fret_numbers_x[n][0], &m_fret_numbers_y[n][0],
+                                  count);
+#ifndef __WXMSW__
+        // FIXME: draw twice to make it more visible...
+        AriaRender::renderNumbers(&m_fret_numbers[n][0], &m_fret_numbers_x[n][0], &m_fret_numbers_y[n][0],
+                                  count);
+#endif
+    }
 
     AriaRender::primitives();
 
@@ -21,6 +21,7 @@
 #include "Editors/Editor.h"
 #include "Editors/RelativeXCoord.h"
 #include <wx/intl.h>
+#include <vector>
 
 namespace AriaMaestosa
 {
@@ -35,7 +36,36 @@ namespace AriaMaestosa
       */
     class GuitarEditor : public Editor
     {
-        
+        /** Tablature data of one note, as needed to draw it */
+        struct TablatureNote
+        {
+            int m_start_tick;
+            int m_end_tick;
+            int m_string;
+            int m_fret;
+        };
+
+        /**
+          * String and fret of each note of the track (same order as the notes of the track), kept
+          * between frames; rebuilt when the track's notes revision changes (edits, undo, tuning)
+          */
+        std::vector<TablatureNote> m_tablature;
+        int m_tablature_revision;
+
+        /** Length of the longest note in m_tablature, to find the first visible note by bisection */
+        int m_tablature_longest_note;
+
+        /** Fret numbers of the frame being rendered, drawn all at once after the notes (white, black) */
+        std::vector<int> m_fret_numbers[2];
+        std::vector<int> m_fret_numbers_x[2];
+        std::vector<int> m_fret_numbers_y[2];
+
+        /** @brief rebuilds m_tablature if the notes of the track changed since it was built */
+        void updateTablature();
+
+        /** @return index of the first note that may be visible when the editor starts at 'fromTick' */
+        int findFirstVisibleNote(const int fromTick) const;
+
     public:
         
         GuitarEditor(GraphicalTrack* track);
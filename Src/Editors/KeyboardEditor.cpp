@@ -36,7 +36,9 @@
 #include "Midi/Track.h"
 #include "Pickers/KeyPicker.h"
 #include "Renderers/Drawable.h"
+#include "PerformanceStats.h"
 #include "Renderers/RenderAPI.h"
+#include "Tracer.h"
 #include "Utils.h"
 #include "PreferencesData.h"
 
@@ -191,10 +193,11 @@ NoteSearchResult KeyboardEditor::noteAt(RelativeXCoord x, const int y, int& note
     const int x_edit = x.getRelativeTo(EDITOR);
 
     const int noteAmount = m_track->getNoteAmount();
+    NotePixelBatches pixels(m_graphical_track, noteAmount);
     for (int n=0; n<noteAmount; n++)
     {
-        const int x1 = m_graphical_track->getNoteStartInPixels(n) - m_gsequence->getXScrollInPixels();
-        const int x2 = m_graphical_track->getNoteEndInPixels(n)   - m_gsequence->getXScrollInPixels();
+        const int x1 = pixels.getStart(n) - m_gsequence->getXScrollInPixels();
+        const int x2 = pixels.getEnd(n)   - m_gsequence->getXScrollInPixels();
         const int y1 = m_track->getNotePitchID(n)*m_y_step + getEditorYStart() - getYScrollInPixels();
 
         if (x_edit > x1 and x_edit < x2 and y > y1 and y < y1+12)
@@ -230,10 +233,11 @@ void KeyboardEditor::selectNotesInRect(RelativeXCoord& mousex_current, int mouse
     const int xscroll = m_gsequence->getXScrollInPixels();
     
     const int count = m_track->getNoteAmount();
+    NotePixelBatches pixels(m_graphical_track, count);
     for (int n=0; n<count; n++)
     {
-        int x1        = m_graphical_track->getNoteStartInPixels(n);
-        int x2        = m_graphical_track->getNoteEndInPixels(n);
+        int x1        = pixels.getStart(n);
+        int x2        = pixels.getEnd(n);
         int from_note = m_track->getNotePitchID(n);
         const int y   = levelToY(from_note);
 
@@ -407,13 +411,15 @@ void KeyboardEditor::scrollNotesIntoView()
 void KeyboardEditor::render(RelativeXCoord mousex_current, int mousey_current,
                             RelativeXCoord mousex_initial, int mousey_initial, bool focus)
 {
+    TRACE_ZONE("KeyboardEditor::render");
+    PerformanceStats::ScopedTimer statsTimer(PerformanceStats::KEYBOARD_RENDER);
     AriaColor ariaColor;
     bool showNoteNames;
     
     if (not ImageProvider::imagesLoaded()) return;
     
     // Get preferences here
-    showNoteNames = PreferencesData::getInstance()->getBoolValue(SETTING_ID_SHOW_NOTE_NAMES, true);
+    showNoteNames = PreferencesData::getInstance()->getBoolValue(SETTING_KEY_SHOW_NOTE_NAMES);
 
     AriaRender::beginScissors(LEFT_EDGE_X, getEditorYStart(), m_width - RIGHT_SCISSOR, m_height);
 
@@ -493,11 +499,12 @@ void KeyboardEditor::render(RelativeXCoord mousex_current, int mousey_current,
             ariaColor = pickColor(colorIndex);
         
             // render the notes
+            NotePixelBatches pixels(otherGTrack, noteAmount);
             for (int n=0; n<noteAmount; n++)
             {
                 int x,y;
-                int x1 = otherGTrack->getNoteStartInPixels(n) - m_gsequence->getXScrollInPixels();
-                int x2 = otherGTrack->getNoteEndInPixels(n)   - m_gsequence->getXScrollInPixels();
+                int x1 = pixels.getStart(n) - m_gsequence->getXScrollInPixels();
+                int x2 = pixels.getEnd(n)   - m_gsequence->getXScrollInPixels();
 
                 // don't draw notes that won't be visible
                 if (x2 < 0)       continue;
@@ -535,15 +542,18 @@ void KeyboardEditor::render(RelativeXCoord mousex_current, int mousey_current,
     const int mouse_y_max = std::max(mousey_current, mousey_initial);
 
     const int noteAmount = m_track->getNoteAmount();
+    NotePixelBatches pixels(m_graphical_track, noteAmount);
+    int drawnNotes = 0;
     for (int n=0; n<noteAmount; n++)
     {
         int x;
-        const int x1 = m_graphical_track->getNoteStartInPixels(n) - pscroll;
-        const int x2 = m_graphical_track->getNoteEndInPixels(n)   - pscroll;
+        const int x1 = pixels.getStart(n) - pscroll;
+        const int x2 = pixels.getEnd(n)   - pscroll;
 
         // don't draw notes that won't be visible
         if (x2 < 0)       continue;
         if (x1 > m_width) break;
+        drawnNotes++;
 
         const int pitch = m_track->getNotePitchID(n);
         const int level = pitch;
@@ -584,6 +594,7 @@ void KeyboardEditor::render(RelativeXCoord mousex_current, int mousey_current,
             AriaRender::renderString(getNoteName(pitch), x+1, y2 + 1, x2 + getEditorXStart() - x + 1);
         }
     }
+    PerformanceStats::countNotes(drawnNotes, noteAmount);
 
 
     AriaRender::primitives();
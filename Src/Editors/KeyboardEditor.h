@@ -22,6 +22,7 @@
 
 #include "Editors/Editor.h"
 #include "Editors/RelativeXCoord.h"
+#include "Renderers/RenderAPI.h"
 #include "Utils.h"
 
 namespace AriaMaestosa
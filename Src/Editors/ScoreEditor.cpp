@@ -32,7 +32,9 @@
 #include "PreferencesData.h"
 #include "Renderers/Drawable.h"
 #include "Renderers/ImageBase.h"
+#include "PerformanceStats.h"
 #include "Renderers/RenderAPI.h"
+#include "Tracer.h"
 
 #include "AriaCore.h"
 
@@ -411,7 +413,7 @@ ScoreEditor::ScoreEditor(GraphicalTrack* track) : Editor(track)
     m_f_clef = true;
     m_clicked_note = -1;
 
-    const int scoreView = PreferencesData::getInstance()->getIntValue("scoreview");
+    const int scoreView = PreferencesData::getInstance()->getIntValue(SETTING_KEY_SCORE_VIEW);
     m_musical_notation_enabled = (scoreView == 0 or scoreView == 1);
     m_linear_notation_enabled  = (scoreView == 0 or scoreView == 2);
 
@@ -419,8 +421,8 @@ ScoreEditor::ScoreEditor(GraphicalTrack* track) : Editor(track)
 
     m_converter->updateConversionData();
 
-    m_g_clef_analyser = new ScoreAnalyser(this, m_converter->getScoreCenterCLevel()-5);
-    m_f_clef_analyser = new ScoreAnalyser(this, m_converter->getScoreCenterCLevel()+6);
+    m_g_clef_analyser = new ScoreAnalyser(m_sequence, m_converter->getScoreCenterCLevel()-5);
+    m_f_clef_analyser = new ScoreAnalyser(m_sequence, m_converter->getScoreCenterCLevel()+6);
 
     setYStep( Y_STEP_HEIGHT );
 
@@ -891,6 +893,8 @@ void renderSilence(const Sequence* seq, const int duration, const int tick, cons
 void ScoreEditor::render(RelativeXCoord mousex_current, int mousey_current,
                          RelativeXCoord mousex_initial, int mousey_initial, bool focus)
 {
+    TRACE_ZONE("ScoreEditor::render");
+    PerformanceStats::ScopedTimer statsTimer(PerformanceStats::SCORE_RENDER);
     TrackRenderContext ctx;
     AriaColor ariaColor;
     bool renderSilences;
@@ -1249,6 +1253,7 @@ void ScoreEditor::renderTrack(Track* track, const TrackRenderContext& ctx, bool
     
     // render pass 1. draw linear notation if relevant, gather information and do initial rendering for
     // musical notation
+    int drawnNotes = 0;
     for (int n=0; n<noteAmount; n++)
     {
         PitchSign note_sign;
@@ -1270,6 +1275,7 @@ void ScoreEditor::renderTrack(Track* track, const TrackRenderContext& ctx, bool
         // don't consider notes that won't be visible
         if (x2 < ctx.first_x_to_consider) continue;
         if (x1 > ctx.last_x_to_consider)  break;
+        drawnNotes++;
 
         if (m_linear_notation_enabled)
         {
@@ -1393,6 +1399,7 @@ void ScoreEditor::renderTrack(Track* track, const TrackRenderContext& ctx, bool
             } // end if both G and F clefs
         } // end if musical notation enabled
     } // next note
+    PerformanceStats::countNotes(drawnNotes, noteAmount);
     
     
     if (m_g_clef)
@@ -0,0 +1,223 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "PreferencesData.h"
+
+#include <wx/font.h>
+#include <wx/settings.h>
+
+// The fonts are declared along with the preferences, but only the GUI uses them
+
+// For now fonts are not configurable and do not appear in the config file but eventually this could be done
+
+// FIXME: find why fonts are so different on OSX
+
+wxFont AriaMaestosa::getDrumNamesFont()
+{
+#ifdef __WXMAC__
+    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMSW__)
+    return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(7, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+
+wxFont AriaMaestosa::getNoteNamesFont()
+{
+#ifdef LARGE_FONTS
+    #ifdef __WXMAC__
+        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#else
+    #ifdef __WXMAC__
+        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(7, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#endif
+}
+
+
+
+wxFont AriaMaestosa::getInstrumentNameFont()
+{
+#ifdef __WXMAC__
+    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMSW__)
+    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(9,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getSequenceFilenameFont()
+{
+#ifdef __WXMAC__
+    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getTrackNameFont()
+{
+#ifdef __WXMAC__
+    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMSW__)
+    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getControllerFont()
+{
+#ifdef LARGE_FONTS
+    #ifdef __WXMAC__
+        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#else
+    #ifdef __WXMAC__
+        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#endif
+}
+
+wxFont AriaMaestosa::getStringNameFont()
+{
+#ifdef LARGE_FONTS
+    #ifdef __WXMAC__
+        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#else
+    #ifdef __WXMAC__
+        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #elif defined(__WXMSW__)
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#endif
+}
+
+
+wxFont AriaMaestosa::getTimeSigPrintFont()
+{
+#ifdef __WXMSW__
+    // FIXME: See http://trac.wxwidgets.org/ticket/14136
+    // fonts are too small on Windows
+    return wxFont(17,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+#elif defined(__WXMAC__)
+    return wxFont(150,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+#else
+    return wxFont(100,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+#endif
+}
+
+wxFont AriaMaestosa::getPrintTabHeaderFont()
+{
+#ifdef __WXMSW__
+    // FIXME: See http://trac.wxwidgets.org/ticket/14136
+    // fonts are too small on Windows
+    return wxFont(18, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMAC__)
+    return wxFont(85, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(65,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getPrintFont()
+{
+#ifdef __WXMSW__
+    // FIXME: See http://trac.wxwidgets.org/ticket/14136
+    // fonts are too small on Windows
+    return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMAC__)
+    return wxFont(75, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont(50,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getPrintTitleFont()
+{
+#ifdef __WXMSW__
+    // FIXME: See http://trac.wxwidgets.org/ticket/14136
+    // fonts are too small on Windows
+    return wxFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD  );
+#else
+    return wxFont(130, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD  );
+#endif
+}
+
+wxFont AriaMaestosa::getPrintSubtitleFont()
+{
+#ifdef __WXMSW__
+    // FIXME: See http://trac.wxwidgets.org/ticket/14136
+    // fonts are too small on Windows
+    return wxFont(13, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#elif defined(__WXMAC__)
+    return wxFont (90,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont (60,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
+wxFont AriaMaestosa::getNumberFont()
+{
+#ifdef LARGE_FONTS
+    return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    #if defined(__WXMAC__)
+        return wxSystemSettings::GetFont(wxSYS_SYSTEM_FONT);
+    #elif defined(__WXGTK__)
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #else
+        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    #endif
+#endif
+}
+
+wxFont AriaMaestosa::getWelcomeMenuFont()
+{
+#ifdef __WXMAC__
+    return wxFont (18,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#else
+    return wxFont (17,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+#endif
+}
+
@@ -18,12 +18,19 @@
 #include "GUI/GraphicalSequence.h"
 #include "GUI/MainFrame.h"
 #include "GUI/MainPane.h"
+#include "IO/MidiFileReader.h"
 #include "Midi/MeasureData.h"
+#include "Midi/Players/PlatformMidiManager.h"
 #include "Midi/Sequence.h"
 #include "PreferencesData.h"
 
 #include "irrXML/irrXML.h"
 
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/msgdlg.h>
+#include <wx/wfstream.h>
+
 using namespace AriaMaestosa;
 
 // ----------------------------------------------------------------------------------------------------------
@@ -134,7 +141,7 @@ const GraphicalTrack* GraphicalSequence::getGraphicsFor(const Track* t) const
 
 void GraphicalSequence::copy()
 {
-    m_sequence->copy();
+    getCurrentTrack()->copy();
     x_scroll_upon_copying = m_x_scroll_in_pixels;
 }
 
@@ -260,7 +267,7 @@ int GraphicalSequence::getTotalHeight() const
 #pragma mark Render
 #endif
 
-void GraphicalSequence::renderTracks(int currentTick, RelativeXCoord mousex, int mousey, int mousey_initial, int from_y)
+void GraphicalSequence::renderTracks(RelativeXCoord mousex, int mousey, int mousey_initial, int from_y)
 {
     const int draggedTrack = getMainFrame()->getMainPane()->getDraggedTrackID();
     
@@ -279,7 +286,7 @@ void GraphicalSequence::renderTracks(int currentTick, RelativeXCoord mousex, int
         {
             Track* track = m_sequence->getTrack(n);
             track->setId(n);
-            y = getGraphicsFor(track)->render(y, currentTick, (n == currentTrack));
+            y = getGraphicsFor(track)->render(y, (n == currentTrack));
         }
         
     }
@@ -350,6 +357,22 @@ void GraphicalSequence::renderTracks(int currentTick, RelativeXCoord mousex, int
     
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+void GraphicalSequence::renderPlaybackLines(const int currentTick, const int minY, const int maxY)
+{
+    // while reordering, only track headers are drawn
+    if (getMainFrame()->getMainPane()->getDraggedTrackID() != -1) return;
+    
+    RelativeXCoord tick(currentTick, MIDI, this);
+    const int x = tick.getRelativeTo(WINDOW);
+    
+    const int trackAmount = m_gtracks.size();
+    for (int n=0; n<trackAmount; n++)
+    {
+        m_gtracks[n].renderPlaybackLine(x, minY, maxY);
+    }
+}
 
 // ----------------------------------------------------------------------------------------------------------
 // ------------------------------------------------ Mouse Rvents --------------------------------------------
@@ -462,6 +485,54 @@ void GraphicalSequence::selectNone()
 // ------------------------------------------------ I/O -----------------------------------------------------
 // ----------------------------------------------------------------------------------------------------------
 
+#if 0
+#pragma mark -
+#pragma mark Playback
+#endif
+
+// FIXME: MainFrame handles the rest of playback start/stop, why have SOME of it here???
+void GraphicalSequence::spacePressed()
+{
+    if (not PlatformMidiManager::get()->isPlaying() and not PlatformMidiManager::get()->isRecording())
+    {
+        if (isPlaybackMode())
+        {
+            return;
+        }
+
+        if (m_sequence->m_playback_listener != NULL) m_sequence->m_playback_listener->onEnterPlaybackMode();
+
+        int startTick = -1;
+        bool success = PlatformMidiManager::get()->playSelected(m_sequence, &startTick);
+        m_sequence->setPlaybackStartTick( startTick );
+
+        // FIXME: there's MainFrame::playback_mode AND MainPane::enterPlayLoop/exitPlayLoop. Fix this MESS
+        if (not success or startTick == -1) // failure
+        {
+            Display::exitPlayLoop();
+        }
+        else
+        {
+            Display::enterPlayLoop();
+        }
+
+    }
+    else
+    {
+        if (m_sequence->m_playback_listener != NULL) m_sequence->m_playback_listener->onLeavePlaybackMode();
+
+        PlatformMidiManager* midi = PlatformMidiManager::get();
+        if (midi->isRecording()) midi->stopRecording();
+        midi->stop();
+        
+        if (m_sequence->m_seq_data_listener != NULL) m_sequence->m_seq_data_listener->onSequenceDataChanged();
+    }
+
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
 #if 0
 #pragma mark -
 #pragma mark I/O
@@ -475,7 +546,7 @@ void GraphicalSequence::saveToFile(wxFileOutputStream& fileout)
               wxT("\" zoom=\"")          + to_wxString(m_zoom_percent) +
               wxT("\">\n"), fileout);
     
-    m_sequence->saveToFile(fileout);
+    m_sequence->saveToFile(fileout, this);
     
     writeData(wxT("</seqview>\n"), fileout);
 }
@@ -601,6 +672,8 @@ bool GraphicalSequence::readFromFile(irr::io::IrrXMLReader* xml)
         } // end switch
     } // end while
     
+    parseBackgroundTracks();
+    
     // It's important to set zoom last because beat resolution has not yet been set at the time we read the zoom value
     if (zoom != -1)
     {
@@ -624,3 +697,82 @@ bool GraphicalSequence::readFromFile(irr::io::IrrXMLReader* xml)
 
 // ----------------------------------------------------------------------------------------------------------
 
+void GraphicalSequence::parseBackgroundTracks()
+{
+    for (int n=0; n<m_gtracks.size(); n++)
+    {
+        GraphicalTrack* graphicalTrack = m_gtracks.get(n);
+        graphicalTrack->getEditorFor(SCORE)->addBackgroundTracks();
+        graphicalTrack->getEditorFor(GUITAR)->addBackgroundTracks();
+        graphicalTrack->getEditorFor(DRUM)->addBackgroundTracks();
+        graphicalTrack->getEditorFor(KEYBOARD)->addBackgroundTracks();
+        graphicalTrack->getEditorFor(CONTROLLER)->addBackgroundTracks();
+    }
+}
+
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+#if 0
+#pragma mark -
+#pragma mark Files
+#endif
+
+void AriaMaestosa::saveAriaFile(GraphicalSequence* sequence, wxString filepath)
+{
+    // do not override a file previously there. If a file was there, move it to a different name and do not delete
+    // it until we know the new file was successfully saved
+    wxString temp_name = filepath + wxT("~");
+    const bool overriding_file = wxFileExists(filepath);
+    if (overriding_file) wxRenameFile( filepath, temp_name, false );
+    
+    wxFileOutputStream file( filepath );
+    sequence->saveToFile(file);
+    
+    if (overriding_file) wxRemoveFile( temp_name );
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool AriaMaestosa::loadAriaFile(GraphicalSequence* sequence, wxString filepath)
+{
+    wxFFile file(filepath);
+    if (not file.IsOpened())
+    {
+        wxMessageBox(wxString::Format( _("Could not open file '%s' for reading"),
+                     (const char*)filepath.utf8_str() ) );
+        return false;
+    }
+    
+    irr::io::IrrXMLReader* xml = irr::io::createIrrXMLReaderMapped(file.fp());
+    
+    if (xml == NULL)
+    {
+        wxMessageBox(wxString::Format( _("Could not open file '%s' for reading"),
+                     (const char*)filepath.utf8_str() ) );
+        return false;
+    }
+    
+    if (not sequence->readFromFile(xml))
+    {
+        std::cout << "LOADING SEQUENCE FAILED" << std::endl;
+        delete xml;
+        return false;
+    }
+    
+    delete xml;
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool AriaMaestosa::loadMidiFile(GraphicalSequence* gseq, wxString filepath, std::set<wxString>& warnings)
+{
+    if (not loadMidiFile(gseq->getModel(), filepath, warnings)) return false;
+    
+    gseq->setZoom(100);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
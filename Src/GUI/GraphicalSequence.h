@@ -22,12 +22,13 @@
 #include "Midi/Sequence.h"
 #include "ptr_vector.h"
 #include <math.h> // for "round"
+#include <set>
 
 namespace AriaMaestosa
 {
     class MainPane;
 
-    class GraphicalSequence : public ITrackSetListener
+    class GraphicalSequence : public ITrackSetListener, public ISequenceView
     {
         OwnerPtr<Sequence> m_sequence;
         OwnerPtr<MeasureBar>  m_measure_bar;
@@ -52,6 +53,9 @@ namespace AriaMaestosa
         int reorderYScroll;
         
         void createViewForTrack(Track* t);
+        
+        /** @brief let the editors of each track know what background tracks they show, once all are loaded */
+        void parseBackgroundTracks();
 
         AriaRenderString m_name_renderer;
         
@@ -105,7 +109,13 @@ namespace AriaMaestosa
          */    
         int   getTotalHeight() const;
         
-        void renderTracks(int currentTick, RelativeXCoord mousex, int mousey, int mousey_initial, int from_y);
+        void renderTracks(RelativeXCoord mousex, int mousey, int mousey_initial, int from_y);
+        
+        /**
+          * @brief draws the line that follows playback over each track, where they were last rendered by
+          *        'renderTracks'. Only the part between minY and maxY is drawn.
+          */
+        void renderPlaybackLines(const int currentTick, const int minY, const int maxY);
         
         /** @brief called repeatedly when mouse is held down */
         void mouseHeldDown(RelativeXCoord mousex_current, int mousey_current,
@@ -149,12 +159,29 @@ namespace AriaMaestosa
         /** @brief Implement callback from ITrackSetListener */
         virtual void onTrackRemoved(Track* t);
         
+        /** @brief Implement callback from ISequenceView */
+        virtual ITrackView* getTrackView(Track* t) { return getGraphicsFor(t); }
+        
+        /** @brief start playing the selection, or stop playback if it's playing */
+        void spacePressed();
+        
         void copy();
         
         void saveToFile(wxFileOutputStream& fileout);
         bool readFromFile(irr::io::IrrXMLReader* xml);
     };
     
+    // the overloads for sequences without a view are in IO/AriaFileWriter.h and IO/MidiFileReader.h
+    
+    /** @ingroup io */
+    bool loadAriaFile(GraphicalSequence* sequence, wxString filepath);
+    
+    /** @ingroup io */
+    void saveAriaFile(GraphicalSequence* sequence, wxString filepath);
+    
+    /** @ingroup io */
+    bool loadMidiFile(GraphicalSequence* sequence, wxString filepath, std::set<wxString>& warnings);
+    
 }
 
 
@@ -15,7 +15,13 @@
  */
 
 
+#include <algorithm>
 #include <iostream>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include <wx/numdlg.h>
 #include <wx/wfstream.h>
 #include <wx/textdlg.h>
@@ -24,6 +30,10 @@
 #include "GUI/GraphicalTrack.h"
 
 #include "AriaCore.h"
+#include "Benchmark.h"
+#include "Clipboard.h"
+#include "UnitTest.h"
+#include "UnitTestUtils.h"
 #include "Actions/SetAccidentalSign.h"
 #include "Editors/KeyboardEditor.h"
 #include "Editors/Editor.h"
@@ -409,6 +419,10 @@ GraphicalTrack::GraphicalTrack(Track* track, GraphicalSequence* seq, MagneticGri
     
     m_height = 128;
     
+    m_from_y         = -1;
+    m_to_y           = -1;
+    m_editors_from_y = -1;
+    
     // create widgets
     m_components = new WidgetLayoutManager();
     
@@ -505,6 +519,21 @@ GraphicalTrack::~GraphicalTrack()
 {
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+// declared in Track.h; the model has no knowledge of the GUI, so these are implemented along with it
+GraphicalTrack* Track::getGraphics()
+{
+    return getMainFrame()->getCurrentGraphicalSequence()->getGraphicsFor(this);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const GraphicalTrack* Track::getGraphics() const
+{
+    return getMainFrame()->getCurrentGraphicalSequence()->getGraphicsFor(this);
+}
+
 // ----------------------------------------------------------------------------------------------------------
     
 void GraphicalTrack::createEditors()
@@ -1313,6 +1342,103 @@ int GraphicalTrack::getNoteEndInPixels(const int id) const
 
 // ---------------------------------------------------------------------------------------------------------------
 
+void GraphicalTrack::getNotesInPixels(const int firstNote, const int count, int* x1, int* x2) const
+{
+    m_track->getNoteTicks(firstNote, count, x1, x2);
+
+    const float zoom = m_gsequence->getZoom();
+    ticksToPixels(x1, count, zoom);
+    ticksToPixels(x2, count, zoom);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+
+void GraphicalTrack::ticksToPixels(int* values, const int count, const float zoom)
+{
+    int n = 0;
+
+    // conversion to float rounds like the scalar cast, and conversion back truncates like it, so all
+    // paths give the same pixels
+#if defined(__AVX__)
+    const __m256 zoom8 = _mm256_set1_ps(zoom);
+    for (; n + 8 <= count; n += 8)
+    {
+        const __m256 ticks = _mm256_cvtepi32_ps( _mm256_loadu_si256((const __m256i*)(values + n)) );
+        _mm256_storeu_si256( (__m256i*)(values + n), _mm256_cvttps_epi32(_mm256_mul_ps(ticks, zoom8)) );
+    }
+#elif defined(__SSE2__)
+    const __m128 zoom4 = _mm_set1_ps(zoom);
+    for (; n + 4 <= count; n += 4)
+    {
+        const __m128 ticks = _mm_cvtepi32_ps( _mm_loadu_si128((const __m128i*)(values + n)) );
+        _mm_storeu_si128( (__m128i*)(values + n), _mm_cvttps_epi32(_mm_mul_ps(ticks, zoom4)) );
+    }
+#endif
+
+    // the rest (or everything, without SIMD)
+    for (; n < count; n++)
+    {
+        values[n] = (int)( (float)values[n] * zoom );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+
+void GraphicalTrack::copy()
+{
+    Sequence* sequence = m_track->getSequence();
+    
+    Clipboard::clear();
+    Clipboard::setBeatLength(sequence->ticksPerQuarterNote());
+
+    const int noteAmount = m_track->getNoteAmount();
+    
+    int tickOfFirstSelectedNote=-1;
+    for (int n=0; n<noteAmount; n++)
+    {
+        if (not m_track->isNoteSelected(n)) continue;
+
+        // find tickOfFirstSelectedNote of the first note
+        const int tick = m_track->getNoteStartInMidiTicks(n);
+        if (tick < tickOfFirstSelectedNote or tickOfFirstSelectedNote==-1)
+        {
+            tickOfFirstSelectedNote = tick;
+        }
+    }//next
+
+    // remove all empty measures before notes, so that they appear in the current measure when pasting
+    MeasureData* md = sequence->getMeasureData();
+    const int lastMeasureStart = md->firstTickInMeasure( md->measureAtTick(tickOfFirstSelectedNote) );
+
+    Editor* editor = getFocusedEditor();
+
+    // place all selected notes into clipboard. The clipboard only keeps their values, so they are
+    // fixed up on a temporary copy instead of being allocated
+    for (int n=0; n<noteAmount; n++)
+    {
+        if (not m_track->isNoteSelected(n)) continue;
+
+        Note tmp(*m_track->getNote(n));
+
+        // if in guitar mode, make sure string/fret and note match
+        if (m_track->isNotationTypeEnabled(GUITAR))
+        {
+            tmp.checkIfStringAndFretMatchNote(false);
+        }
+        else
+        {
+            tmp.checkIfStringAndFretMatchNote(true);
+        }
+
+        editor->moveNote(tmp, -lastMeasureStart, 0);
+        Clipboard::add(tmp);
+    }//next
+
+    sequence->setNoteShiftWhenNoScrolling( lastMeasureStart );
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+
 void GraphicalTrack::selectNote(const int id, const bool selected, bool ignoreModifiers)
 {    
     ASSERT(id != SELECTED_NOTES); // not supported in this function
@@ -1334,9 +1460,18 @@ void GraphicalTrack::selectNote(const int id, const bool selected, bool ignoreMo
         }
     }
     
-    if (not done_for_controller)
+    if (done_for_controller) return;
+    
+    // if no modifier is pressed, don't do any special checks
+    if (ignoreModifiers or (not Display::isSelectMorePressed() and not Display::isSelectLessPressed()))
     {
-        m_track->selectNote(id, selected, ignoreModifiers);
+        m_track->selectNote(id, selected);
+    }
+    else if (id != ALL_NOTES and selected)
+    {
+        // otherwise, check key modifiers and set value accordingly
+        if      (Display::isSelectMorePressed()) m_track->selectNote(id, true);
+        else if (Display::isSelectLessPressed()) m_track->selectNote(id, false);
     }
 }
 
@@ -1752,7 +1887,7 @@ void GraphicalTrack::renderHeader(const int x, const int y, const bool closed, c
 
 // ----------------------------------------------------------------------------------------------------------
 
-int GraphicalTrack::render(const int y, const int currentTick, const bool focus)
+int GraphicalTrack::render(const int y, const bool focus)
 {
     
     if (not ImageProvider::imagesLoaded()) return 0;
@@ -1789,7 +1924,7 @@ int GraphicalTrack::render(const int y, const int currentTick, const bool focus)
     const int editor_height = (m_to_y - editor_from_y - 5);
     int editor_to_y = editor_from_y; //editor_from_y + editor_height;
 
-    const int original_editor_from_y = editor_from_y;
+    m_editors_from_y = editor_from_y;
     
     if (m_track->isNotationTypeEnabled(SCORE))
     {
@@ -1903,25 +2038,6 @@ int GraphicalTrack::render(const int y, const int currentTick, const bool focus)
         }
         
         
-        // --------------------------------------------------
-        // render playback progress line
-        
-        AriaRender::primitives();
-        
-        if (currentTick != -1 and not Display::leftArrow() and not Display::rightArrow())
-        {
-            AriaRender::color(0.8, 0, 0);
-            
-            RelativeXCoord tick(currentTick, MIDI, m_gsequence);
-            const int x_coord = tick.getRelativeTo(WINDOW);
-            
-            AriaRender::lineWidth(1);
-            
-            AriaRender::line(x_coord, original_editor_from_y,
-                             x_coord, m_to_y - 5);
-            
-        }
-        
         // --------------------------------------------------
         // render track borders
         
@@ -1976,6 +2092,23 @@ int GraphicalTrack::render(const int y, const int currentTick, const bool focus)
     return m_to_y;
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+void GraphicalTrack::renderPlaybackLine(const int x, const int minY, const int maxY)
+{
+    if (m_docked or m_collapsed or m_from_y == -1) return;
+    
+    const int y1 = std::max(m_editors_from_y, minY);
+    const int y2 = std::min(m_to_y - 5, maxY);
+    if (y1 >= y2) return;
+    
+    AriaRender::primitives();
+    AriaRender::color(0.8, 0, 0);
+    AriaRender::lineWidth(1);
+    AriaRender::line(x, y1, x, y2);
+}
+
+// ----------------------------------------------------------------------------------------------------------
 
 // Handles TAB keyboard shortcut 
 void GraphicalTrack::switchDivider(int index)
@@ -2438,9 +2571,135 @@ bool GraphicalTrack::readFromFile(irr::io::IrrXMLReader* xml)
             
         }
     }
-
+    else if (strcmp("drumkit", xml->getNodeName()) == 0)
+    {
+        const char* collapse = xml->getAttributeValue("collapseView");
+        if (collapse != NULL and strcmp(collapse, "true") == 0)
+        {
+            m_drum_editor->setShowOnlyUsedDrums(true);
+        }
+    }
+    // TODO: for backwards compatibility only, eventually remove
+    else if (strcmp("controller", xml->getNodeName()) == 0)
+    {
+        const char* id = xml->getAttributeValue("id");
+        if (id != NULL) m_controller_editor->setController(atoi(id));
+    }
     
     return true;
 }
 
 // ----------------------------------------------------------------------------------------------------------
+
+void GraphicalTrack::onTrackLoaded()
+{
+    // now that we have the set of notes, we can collapse the view if needed
+    if (m_drum_editor->showOnlyUsedDrums()) m_drum_editor->useCustomDrumSet();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+NotePixelBatches::NotePixelBatches(const GraphicalTrack* gtrack, const int noteAmount)
+{
+    m_gtrack      = gtrack;
+    m_note_amount = noteAmount;
+    m_first       = 0;
+    m_count       = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void NotePixelBatches::load(const int id)
+{
+    ASSERT_E(id, >=, 0);
+    ASSERT_E(id, <, m_note_amount);
+
+    m_first = id;
+    m_count = std::min(BATCH_SIZE, m_note_amount - id);
+    m_gtrack->getNotesInPixels(m_first, m_count, m_x1, m_x2);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+namespace TestGraphicalTrack
+{
+    using namespace AriaMaestosa;
+
+    UNIT_TEST(TestTicksToPixels)
+    {
+        const float zooms[] = { 0.0625f, 0.1f, 0.3333f, 1.0f, 2.75f };
+
+        // 37 values, so that every SIMD path also has a remainder to do the scalar way
+        int ticks[37];
+        int pixels[37];
+        for (int z=0; z<5; z++)
+        {
+            for (int n=0; n<37; n++)
+            {
+                ticks[n]  = n*n*977 + n*13;
+                pixels[n] = ticks[n];
+            }
+
+            GraphicalTrack::ticksToPixels(pixels, 37, zooms[z]);
+
+            for (int n=0; n<37; n++)
+            {
+                require_e(pixels[n], ==, (int)( (float)ticks[n] * zooms[z] ),
+                          "Batch conversion gives the same pixels as converting notes one at a time");
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( NoteTicksToPixelsOneByOne )
+{
+    // what 'getNoteStartInPixels' / 'getNoteEndInPixels' do, for each note of the song
+    BenchmarkSong song(bench);
+    Track* track = song->getTrack(0);
+    const int noteAmount = track->getNoteAmount();
+    const float zoom = 0.1f;
+
+    while (bench.next())
+    {
+        int checksum = 0;
+        for (int n=0; n<noteAmount; n++)
+        {
+            checksum += (int)( (float)track->getNoteStartInMidiTicks(n) * zoom );
+            checksum += (int)( (float)track->getNoteEndInMidiTicks(n)   * zoom );
+        }
+        bench.keep(checksum);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( NoteTicksToPixelsBatched )
+{
+    // what 'getNotesInPixels' does, one batch of NotePixelBatches::BATCH_SIZE notes at a time
+    BenchmarkSong song(bench);
+    Track* track = song->getTrack(0);
+    const int noteAmount = track->getNoteAmount();
+    const float zoom = 0.1f;
+
+    int x1[NotePixelBatches::BATCH_SIZE];
+    int x2[NotePixelBatches::BATCH_SIZE];
+
+    while (bench.next())
+    {
+        int checksum = 0;
+        for (int first=0; first<noteAmount; first += NotePixelBatches::BATCH_SIZE)
+        {
+            const int count = std::min(NotePixelBatches::BATCH_SIZE, noteAmount - first);
+            track->getNoteTicks(first, count, x1, x2);
+            GraphicalTrack::ticksToPixels(x1, count, zoom);
+            GraphicalTrack::ticksToPixels(x2, count, zoom);
+            for (int n=0; n<count; n++) checksum += x1[n] + x2[n];
+        }
+        bench.keep(checksum);
+    }
+}
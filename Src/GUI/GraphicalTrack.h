@@ -57,7 +57,8 @@ namespace AriaMaestosa
       * @brief The graphical part of a track (the data being held in Track)
       * @ingroup gui
       */
-    class GraphicalTrack : public ITrackListener, public IInstrumentChoiceListener, public IDrumChoiceListener
+    class GraphicalTrack : public ITrackListener, public ITrackView, public IInstrumentChoiceListener,
+                           public IDrumChoiceListener
     {
         int m_height;
         int m_last_mouse_y;
@@ -109,6 +110,11 @@ namespace AriaMaestosa
          */
         int m_to_y;
         
+        /** Y coord on the current display where the first editor of this track starts (this is updated
+         * on each rendering).
+         */
+        int m_editors_from_y;
+        
         OwnerPtr<MagneticGridPicker>  m_grid;
 
         ptr_vector<Editor, REF> m_all_editors;
@@ -140,7 +146,17 @@ namespace AriaMaestosa
         
         void renderHeader(const int x, const int y, const bool close, const bool focus=false);
         
-        int render(const int y, const int currentTick, bool focus);
+        /**
+          * @brief renders the track, except for the playback line (see renderPlaybackLine)
+          * @return the Y coord at which the next track starts
+          */
+        int render(const int y, bool focus);
+        
+        /**
+          * @brief draws the line that follows playback over the editors of this track, where it was last
+          *        rendered. Only the part between minY and maxY is drawn.
+          */
+        void renderPlaybackLine(const int x, const int minY, const int maxY);
         void setCollapsed(const bool collapsed);
         void setHeight(const int height);
         void maximizeHeight(bool maximize=true);
@@ -240,6 +256,19 @@ namespace AriaMaestosa
         
         int getNoteStartInPixels(const int id) const;
         int getNoteEndInPixels(const int id) const;
+
+        /**
+          * @brief start and end (in pixels, not scrolled) of notes [firstNote, firstNote + count), the
+          *        same values 'getNoteStartInPixels' and 'getNoteEndInPixels' would give, for all notes
+          *        in one pass ; 'x1' and 'x2' must have room for 'count' values
+          */
+        void getNotesInPixels(const int firstNote, const int count, int* x1, int* x2) const;
+
+        /**
+          * @brief converts 'count' ticks to pixels in place, (int)(tick * zoom) ; uses SSE2 or AVX
+          *        when the compiler targets them
+          */
+        static void ticksToPixels(int* values, const int count, const float zoom);
                 
         void onTrackRemoved(Track* t);
         
@@ -254,11 +283,51 @@ namespace AriaMaestosa
         
         void scrollKeyboardEditorNotesIntoView();
 
-        // serialization
-        void saveToFile(wxFileOutputStream& fileout);
-        bool readFromFile(irr::io::IrrXMLReader* xml);
+        /** @brief put the selected notes of this track in the clipboard */
+        void copy();
+        
+        // serialization, implementing ITrackView
+        virtual void saveToFile(wxFileOutputStream& fileout);
+        virtual bool readFromFile(irr::io::IrrXMLReader* xml);
+        virtual void onTrackLoaded();
         
     };
+
+    /**
+      * @brief walks the notes of a track in order, converting their start and end to pixels (not
+      *        scrolled) a batch at a time with GraphicalTrack::getNotesInPixels ; meant for the render
+      *        loops of editors, which go through notes in order and stop at the end of the view
+      */
+    class NotePixelBatches
+    {
+    public:
+        static const int BATCH_SIZE = 256;
+
+    private:
+        const GraphicalTrack* m_gtrack;
+        int m_note_amount;
+        int m_first;
+        int m_count;
+        int m_x1[BATCH_SIZE];
+        int m_x2[BATCH_SIZE];
+
+        void load(const int id);
+
+    public:
+        NotePixelBatches(const GraphicalTrack* gtrack, const int noteAmount);
+
+        int getStart(const int id)
+        {
+            if (id < m_first or id >= m_first + m_count) load(id);
+            return m_x1[id - m_first];
+        }
+
+        int getEnd(const int id)
+        {
+            if (id < m_first or id >= m_first + m_count) load(id);
+            return m_x2[id - m_first];
+        }
+    };
     
 }
 
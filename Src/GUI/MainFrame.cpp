@@ -588,19 +588,19 @@ void MainFrame::init(const wxArrayString& filesToOpen, bool fileInCommandLine)
     printf("*** %i %i\n", s.GetWidth(), s.GetHeight());
      
     PreferencesData* pd = PreferencesData::getInstance();
-    if (pd->getBoolValue(SETTING_ID_REMEMBER_WINDOW_POS, false))
+    if (pd->getBoolValue(SETTING_KEY_REMEMBER_WINDOW_POS))
     {
         wxSize screenSize = wxGetDisplaySize();
         
-        int x = pd->getIntValue(SETTING_ID_WINDOW_X);
-        int y = pd->getIntValue(SETTING_ID_WINDOW_Y);
+        int x = pd->getIntValue(SETTING_KEY_WINDOW_X);
+        int y = pd->getIntValue(SETTING_KEY_WINDOW_Y);
         if (x < 0) x = 0;
         if (y < 0) y = 0;
         
-        int w = pd->getIntValue(SETTING_ID_WINDOW_W);
+        int w = pd->getIntValue(SETTING_KEY_WINDOW_W);
         if (w < 400) w = 400;
         
-        int h = pd->getIntValue(SETTING_ID_WINDOW_H);
+        int h = pd->getIntValue(SETTING_KEY_WINDOW_H);
         if (h < 400) h = 400;
         
         if (x >= screenSize.GetWidth()) x = 0;
@@ -861,11 +861,11 @@ void MainFrame::onShow(wxShowEvent& evt)
     }
     
     
-    if ( pd->getBoolValue(SETTING_ID_LOAD_LAST_SESSION, false) && !m_file_in_command_line )
+    if ( pd->getBoolValue(SETTING_KEY_LOAD_LAST_SESSION) && !m_file_in_command_line )
     {
         int currentSequenceId;
         
-        currentSequenceId = pd->getIntValue(SETTING_ID_LAST_CURRENT_SEQUENCE);
+        currentSequenceId = pd->getIntValue(SETTING_KEY_LAST_CURRENT_SEQUENCE);
         if (currentSequenceId<m_sequences.size())
         {
             setCurrentSequence(currentSequenceId);
@@ -2408,7 +2408,7 @@ void MainFrame::saveWindowPos()
     PreferencesData* pd;
     
     pd = PreferencesData::getInstance();
-    if (pd->getBoolValue(SETTING_ID_REMEMBER_WINDOW_POS, false))
+    if (pd->getBoolValue(SETTING_KEY_REMEMBER_WINDOW_POS))
     {
         pd->setValue(SETTING_ID_WINDOW_X, to_wxString(GetPosition().x));
         pd->setValue(SETTING_ID_WINDOW_Y, to_wxString(GetPosition().y));
@@ -28,6 +28,7 @@
 #include "Dialogs/AboutDialog.h"
 #include "Dialogs/SongPropertiesDialog.h"
 #include "Dialogs/CustomNoteSelectDialog.h"
+#include "Dialogs/FileDialog.h"
 #include "Dialogs/Preferences.h"
 #include "Dialogs/PrintSetupDialog.h"
 #include "Dialogs/ScaleDialog.h"
@@ -250,7 +251,7 @@ void MainFrame::initMenuBar()
                                                 _("E&xpanded time sig management"),
                                                 MainFrame::menuEvent_expandedMeasuresSelected );
 
-    m_follow_playback_menu_item->Check( PreferencesData::getInstance()->getBoolValue("followPlayback", false) );
+    m_follow_playback_menu_item->Check( PreferencesData::getInstance()->getBoolValue(SETTING_KEY_FOLLOW_PLAYBACK) );
 
     wxMenu* channelMode_menu = new wxMenu();
 
@@ -289,7 +290,7 @@ void MainFrame::initMenuBar()
     m_settings_menu->QUICK_ADD_MENU(wxID_PREFERENCES, _("&Preferences..."),
                                     MainFrame::menuEvent_preferences);
 
-    const int playValue = PreferencesData::getInstance()->getIntValue("playDuringEdit");
+    const int playValue = PreferencesData::getInstance()->getIntValue(SETTING_KEY_PLAY_DURING_EDIT);
     if (playValue == PLAY_ON_CHANGE)   m_play_during_edits_onchange->Check();
     else if (playValue == PLAY_ALWAYS) m_play_during_edits_always->Check();
     else if (playValue == PLAY_NEVER)  m_play_during_edits_never->Check();
@@ -931,7 +932,7 @@ void MainFrame::menuEvent_snapToGrid(wxCommandEvent& evt)
 
 void MainFrame::menuEvent_undo(wxCommandEvent& evt)
 {
-    getCurrentSequence()->undo();
+    if (not getCurrentSequence()->undo()) wxBell();
 }
 
 // -----------------------------------------------------------------------------------------------------------
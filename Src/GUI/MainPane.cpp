@@ -46,7 +46,9 @@
 #include "Pickers/MagneticGridPicker.h"
 #include "Pickers/InstrumentPicker.h"
 #include "Pickers/DrumPicker.h"
+#include "PerformanceStats.h"
 #include "PreferencesData.h"
+#include "Tracer.h"
 #include "Editors/RelativeXCoord.h"
 #include "Editors/KeyboardEditor.h"
 
@@ -177,6 +179,9 @@ MainPane::MainPane(wxWindow* parent, int* args) :
     m_mouse_down_timer = new MouseDownTimer(this);
 
     m_scroll_to_playback_position = false;
+    m_frame_cache_valid           = false;
+    m_playback_frame_pending      = false;
+    m_full_render_requested       = false;
     
     m_have_plus_cursor = false;
 
@@ -252,10 +257,17 @@ void MainPane::paintEvent(wxPaintEvent& evt)
     
     Display::renderDC = &mydc;
 
+    // only the playback position moved since the last frame : draw it over the cached frame
+    const bool overlayOnly = (m_playback_frame_pending and not m_full_render_requested);
+    m_playback_frame_pending = false;
+    m_full_render_requested  = false;
+    
     beginFrame();
-    if (do_render()) endFrame();
+    if (overlayOnly ? renderFromFrameCache() : do_render()) endFrame();
     else { printf("***** do_render returned false!!\n"); }
     Display::renderDC = NULL;
+    
+    PerformanceStats::endFrame();
 }
 
 // -----------------------------------------------------------------------------------------------------------
@@ -273,6 +285,22 @@ void MainPane::renderNow()
      */
     Refresh();
 }
+
+// -----------------------------------------------------------------------------------------------------------
+
+void MainPane::Refresh(bool eraseBackground, const wxRect* rect)
+{
+    m_full_render_requested = true;
+    RenderPane::Refresh(eraseBackground, rect);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void MainPane::refreshPlaybackOverlay()
+{
+    m_playback_frame_pending = true;
+    RenderPane::Refresh();
+}
         
 // -----------------------------------------------------------------------------------------------------------
 
@@ -508,8 +536,12 @@ MainPane::WelcomeResult MainPane::drawWelcomeMenu()
 
 bool MainPane::do_render()
 {
+    TRACE_ZONE("MainPane::do_render");
+    PerformanceStats::ScopedTimer frameTimer(PerformanceStats::FRAME_TIME);
     MainFrame* mf = getMainFrame();
     
+    m_frame_cache_valid = false;
+    
     if (not ImageProvider::imagesLoaded())  return false;
     
     if (mf->getSequenceAmount() == 0)
@@ -542,8 +574,7 @@ bool MainPane::do_render()
     m_mouse_x_initial.setSequence(gseq);
     m_mouse_x_current.setSequence(gseq);
     
-    gseq->renderTracks(m_current_tick,
-                       m_mouse_x_current,
+    gseq->renderTracks(m_mouse_x_current,
                        m_mouse_y_current,
                        m_mouse_y_initial,
                        25 + gseq->getMeasureBar()->getMeasureBarHeight());
@@ -652,14 +683,6 @@ bool MainPane::do_render()
     
     gseq->getMeasureBar()->render(MEASURE_BAR_Y);
 
-    // -------------------------- update timer -------------------------
-    if (PlatformMidiManager::get()->isPlaying())
-    {
-        int time = getTimeAtTick(getCurrentTick(), gseq->getModel());
-        wxString duration_label = wxString::Format(wxT("%i:%.2i"), (int)(time/60), time%60);
-        getMainFrame()->setStatusText(duration_label);
-    }
-    
     // -------------------------- draw dock -------------------------
     AriaRender::primitives();
     const int docksize = gseq->getDockedTrackAmount();
@@ -712,6 +735,83 @@ bool MainPane::do_render()
 
 
 
+    // If loop enabled, show loop end measure with red line and triangle
+    if (gseq->getModel()->isLoopEnabled())
+    {
+        const int XStart = Editor::getEditorXStart();
+        const int XEnd = getWidth();
+        
+        AriaRender::primitives();
+        AriaRender::lineWidth(2);
+        AriaRender::color(0.8, 0, 0);
+        
+        MeasureData* md = gseq->getModel()->getMeasureData();
+        int loop_end_tick = md->lastTickInMeasure( md->getLoopEndMeasure() );
+        RelativeXCoord coord_loop_end(loop_end_tick, MIDI, gseq);
+        
+        if (coord_loop_end.getRelativeTo(WINDOW) >= XStart and
+            coord_loop_end.getRelativeTo(WINDOW) <= XEnd)
+        {
+            const int tick_x = coord_loop_end.getRelativeTo(WINDOW);
+            AriaRender::line(tick_x, MEASURE_BAR_Y + 1,
+                             tick_x, MEASURE_BAR_Y + 20);
+            
+            AriaRender::triangle(tick_x, MEASURE_BAR_Y + 14,
+                                 tick_x, MEASURE_BAR_Y + 20,
+                                 tick_x - 6, MEASURE_BAR_Y + 20);
+        }
+    }
+    
+    AriaRender::lineWidth(1);
+    
+    // while playing, keep what was drawn so far; the next frames only need to draw the playback
+    // position over it, as long as nothing else changes
+    if (m_current_tick != -1)
+    {
+        AriaRender::saveFrameCache();
+        m_frame_cache_valid = true;
+    }
+    
+    renderPlaybackOverlay(gseq);
+    
+    if (PerformanceStats::isEnabled()) renderStatsOverlay();
+    
+    return true;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+bool MainPane::renderFromFrameCache()
+{
+    {
+        TRACE_ZONE("MainPane::renderFromFrameCache");
+        PerformanceStats::ScopedTimer frameTimer(PerformanceStats::FRAME_TIME);
+        
+        GraphicalSequence* gseq = getMainFrame()->getCurrentGraphicalSequence();
+        if (gseq != NULL and m_frame_cache_valid and AriaRender::restoreFrameCache())
+        {
+            renderPlaybackOverlay(gseq);
+            if (PerformanceStats::isEnabled()) renderStatsOverlay();
+            return true;
+        }
+    }
+    
+    // the cached frame is gone (e.g. the window was resized), draw everything
+    return do_render();
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void MainPane::renderPlaybackOverlay(GraphicalSequence* gseq)
+{
+    // -------------------------- update timer -------------------------
+    if (PlatformMidiManager::get()->isPlaying())
+    {
+        int time = getTimeAtTick(getCurrentTick(), gseq->getModel());
+        wxString duration_label = wxString::Format(wxT("%i:%.2i"), (int)(time/60), time%60);
+        getMainFrame()->setStatusText(duration_label);
+    }
+    
     // -------------------------- red line that follows playback, red arrows --------------------------
     bool playing = (m_current_tick != -1);
 
@@ -731,6 +831,7 @@ bool MainPane::do_render()
     const int XStart = Editor::getEditorXStart();
     const int XEnd = getWidth();
 
+    AriaRender::primitives();
     AriaRender::lineWidth(2);
     AriaRender::color(0.8, 0, 0);
 
@@ -788,29 +889,90 @@ bool MainPane::do_render()
         m_right_arrow = true;
     }
 
-    // If loop enabled, show loop end measure with red line and triangle
-    if (gseq->getModel()->isLoopEnabled())
+    // -------------------------- red line across tracks --------------------------
+    if (playing and not m_left_arrow and not m_right_arrow)
     {
-        MeasureData* md = gseq->getModel()->getMeasureData();
-        int loop_end_tick = md->lastTickInMeasure( md->getLoopEndMeasure() );
-        RelativeXCoord coord_loop_end(loop_end_tick, MIDI, gseq);
-        
-        if (coord_loop_end.getRelativeTo(WINDOW) >= XStart and
-            coord_loop_end.getRelativeTo(WINDOW) <= XEnd)
+        gseq->renderPlaybackLines(m_current_tick, 25 + gseq->getMeasureBar()->getMeasureBarHeight(),
+                                  getHeight() - gseq->getDockHeight());
+    }
+    
+    AriaRender::lineWidth(1);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void MainPane::renderStatsOverlay()
+{
+    // the labels never change; only numbers are rendered each frame, since they are drawn from a
+    // pre-rendered set of digits
+    const int METRIC_LABELS = 0;
+    const int COLUMN_LABELS = PerformanceStats::METRIC_COUNT;
+    const int FPS_LABEL     = COLUMN_LABELS + 4;
+    
+    if (m_stats_labels.size() == 0)
+    {
+        for (int n=0; n<PerformanceStats::METRIC_COUNT; n++)
         {
-            const int tick_x = coord_loop_end.getRelativeTo(WINDOW);
-            AriaRender::line(tick_x, MEASURE_BAR_Y + 1,
-                             tick_x, MEASURE_BAR_Y + 20);
-            
-            AriaRender::triangle(tick_x, MEASURE_BAR_Y + 14,
-                                 tick_x, MEASURE_BAR_Y + 20,
-                                 tick_x - 6, MEASURE_BAR_Y + 20);
+            const wxString name(PerformanceStats::getName((PerformanceStats::Metric)n), wxConvUTF8);
+            m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(name), true));
         }
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("p50")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("p95")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("p99")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("max (ms)")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("fps")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("notes drawn")), true));
+        m_stats_labels.push_back(new AriaRenderString(new Model<wxString>(wxT("notes culled")), true));
     }
     
-    AriaRender::lineWidth(1);
+    const int ROW_HEIGHT   = 15;
+    const int COLUMN_WIDTH = 60;
+    const int rows         = PerformanceStats::METRIC_COUNT + 4;
+    const int x            = getWidth() - 130 - COLUMN_WIDTH*4;
+    int       y            = MEASURE_BAR_Y + EXPANDED_MEASURE_BAR_H + 10;
     
-    return true;
+    AriaRender::primitives();
+    AriaRender::color(1, 1, 0.9, 0.85);
+    AriaRender::rect(x - 5, y - 5, getWidth() - 10, y + rows*ROW_HEIGHT + 5);
+    
+    AriaRender::images();
+    AriaRender::color(0, 0, 0);
+    
+    y += ROW_HEIGHT;
+    for (int c=0; c<4; c++)
+    {
+        m_stats_labels[COLUMN_LABELS + c].bind();
+        m_stats_labels[COLUMN_LABELS + c].render(x + 120 + c*COLUMN_WIDTH, y);
+    }
+    
+    char buffer[32];
+    for (int n=0; n<PerformanceStats::METRIC_COUNT; n++)
+    {
+        y += ROW_HEIGHT;
+        m_stats_labels[METRIC_LABELS + n].bind();
+        m_stats_labels[METRIC_LABELS + n].render(x, y);
+        
+        const LatencyHistogram& histogram = PerformanceStats::getLastWindow((PerformanceStats::Metric)n);
+        if (histogram.getCount() == 0) continue;
+        
+        const long long values[4] = { histogram.getPercentile(50), histogram.getPercentile(95),
+                                      histogram.getPercentile(99), histogram.getMax() };
+        for (int c=0; c<4; c++)
+        {
+            sprintf(buffer, "%.2f", values[c]/1000.0);
+            AriaRender::renderNumber(buffer, x + 120 + c*COLUMN_WIDTH, y);
+        }
+    }
+    
+    const int counters[3] = { PerformanceStats::getFramesPerSecond(), PerformanceStats::getNotesDrawn(),
+                              PerformanceStats::getNotesCulled() };
+    for (int n=0; n<3; n++)
+    {
+        y += ROW_HEIGHT;
+        m_stats_labels[FPS_LABEL + n].bind();
+        m_stats_labels[FPS_LABEL + n].render(x, y);
+        AriaRender::renderNumber(counters[n], x + 120, y);
+    }
 }
 
 // -----------------------------------------------------------------------------------------------------------
@@ -1337,7 +1499,7 @@ void MainPane::keyPressed(wxKeyEvent& evt)
     // ---------------- play selected notes -----------------
     if (keyCode == WXK_SPACE)
     {
-        seq->spacePressed();
+        gseq->spacePressed();
     }
     
 #ifdef _MORE_DEBUG_CHECKS
@@ -1576,6 +1738,7 @@ void MainPane::playbackRenderLoop()
     // only draw if it has changed
     if (m_last_tick != startTick + currentTick)
     {
+        const int previousScroll = gseq->getXScrollInPixels();
         
         // if user has clicked on a little red arrow
         if (m_scroll_to_playback_position)
@@ -1610,8 +1773,17 @@ void MainPane::playbackRenderLoop()
         
         setCurrentTick( startTick + currentTick );
         
-        RelativeXCoord tick(m_current_tick, MIDI, gseq);
-        Display::render();
+        // when only the playback position moved, there is no need to draw the tracks again (when
+        // recording, notes are being added to them)
+        if (gseq->getXScrollInPixels() == previousScroll and
+            not PlatformMidiManager::get()->isRecording())
+        {
+            refreshPlaybackOverlay();
+        }
+        else
+        {
+            Display::render();
+        }
         m_last_tick = startTick + currentTick;
     }
 
@@ -29,6 +29,7 @@
 #endif
 
 #include "Renderers/RenderAPI.h"
+#include "ptr_vector.h"
 
 #include <vector>
 
@@ -40,6 +41,7 @@ namespace AriaMaestosa
     
     class MouseDownTimer;
     class MainFrame;
+    class GraphicalSequence;
 
     /**
       * @ingroup gui
@@ -99,6 +101,15 @@ namespace AriaMaestosa
 
         bool m_scroll_to_playback_position;
 
+        /** Whether the renderer holds a copy of the last frame, minus the playback overlay */
+        bool m_frame_cache_valid;
+
+        /** Set when the next paint only needs to move the playback position */
+        bool m_playback_frame_pending;
+
+        /** Set by every 'Refresh' (so by anything but 'refreshPlaybackOverlay'); wins over 'm_playback_frame_pending' */
+        bool m_full_render_requested;
+
         ClickArea m_click_area;
 
         /** if click_area == CLICK_TRACK, contains the ID of the track */
@@ -120,10 +131,25 @@ namespace AriaMaestosa
         AriaRenderString m_help_label;
         AriaRenderString m_quit_label;
 
+        /** Labels of the statistics overlay, created the first time it is shown */
+        ptr_vector<AriaRenderString, HOLD> m_stats_labels;
+        
         bool do_render();
         
+        /**
+          * @brief draws the frame cached by the last 'do_render' call, with the playback overlay over it.
+          *        Falls back to 'do_render' if there is no usable cached frame.
+          */
+        bool renderFromFrameCache();
+        
+        /** @brief draws what follows playback : the red line and arrows, and the playback timer */
+        void renderPlaybackOverlay(GraphicalSequence* gseq);
+        
         WelcomeResult drawWelcomeMenu();
         
+        /** @brief draws frame times and latencies on top of everything (when started with '--stats') */
+        void renderStatsOverlay();
+        
         AriaRenderString m_star;
         
         bool     m_have_plus_cursor;
@@ -220,6 +246,18 @@ namespace AriaMaestosa
         
         void renderNow();
         
+        /**
+          * @brief schedules a complete render. Every refresh of the pane goes through here (whoever calls
+          *        it), so that content changes during playback are never hidden behind the cached frame.
+          */
+        virtual void Refresh(bool eraseBackground = true, const wxRect* rect = NULL);
+        
+        /**
+          * @brief like 'renderNow', but only the playback position changed since the last frame. If any
+          *        other refresh is requested before the paint happens, everything is drawn anyway.
+          */
+        void refreshPlaybackOverlay();
+        
         // ---- rendering
         bool isVisible() const { return m_is_visible; }
         void paintEvent(wxPaintEvent& evt);
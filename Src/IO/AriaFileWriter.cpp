@@ -16,59 +16,136 @@
 
 #include "AriaFileWriter.h"
 
-#include "GUI/GraphicalSequence.h"
+#include "IO/IOUtils.h"
 #include "Midi/Sequence.h"
+#include "Tracer.h"
+#include "Benchmark.h"
+#include "UnitTest.h"
+#include "UnitTestUtils.h"
 
 #include <wx/string.h>
 #include <wx/wfstream.h>
-#include <wx/msgdlg.h>
+#include <wx/filename.h>
 #include "irrXML/irrXML.h"
 
+#include <cstring>
+#include <iostream>
+
 namespace AriaMaestosa
 {
     
-    void saveAriaFile(GraphicalSequence* sequence, wxString filepath)
+    bool saveAriaFile(Sequence* sequence, wxString filepath)
     {
-        // do not override a file previously there. If a file was there, move it to a different name and do not delete
-        // it until we know the new file was successfully saved
-        wxString temp_name = filepath + wxT("~");
-        const bool overriding_file = wxFileExists(filepath);
-        if (overriding_file) wxRenameFile( filepath, temp_name, false );
-        
+        TRACE_ZONE("saveAriaFile");
         wxFileOutputStream file( filepath );
-        sequence->saveToFile(file);
+        if (not file.IsOk())
+        {
+            std::cerr << "[saveAriaFile] Could not open file '" << filepath.utf8_str() << "' for writing" << std::endl;
+            return false;
+        }
         
-        if (overriding_file) wxRemoveFile( temp_name );
+        writeData("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", file);
+        writeData(wxT("<seqview xscroll=\"0\" yscroll=\"0\" zoom=\"100\">\n"), file);
+        sequence->saveToFile(file, NULL);
+        writeData(wxT("</seqview>\n"), file);
+        
+        return file.IsOk();
     }
     
-    bool loadAriaFile(GraphicalSequence* sequence, wxString filepath)
+    bool loadAriaFile(Sequence* sequence, wxString filepath)
     {
+        TRACE_ZONE("loadAriaFile");
         wxFFile file(filepath);
         if (not file.IsOpened())
         {
-            wxMessageBox(wxString::Format( _("Could not open file '%s' for reading"),
-                         (const char*)filepath.utf8_str() ) );
+            std::cerr << "[loadAriaFile] Could not open file '" << filepath.utf8_str() << "' for reading" << std::endl;
             return false;
         }
         
-        irr::io::IrrXMLReader* xml = irr::io::createIrrXMLReader(file.fp());
-        
+        irr::io::IrrXMLReader* xml = irr::io::createIrrXMLReaderMapped(file.fp());
         if (xml == NULL)
         {
-            wxMessageBox(wxString::Format( _("Could not open file '%s' for reading"),
-                         (const char*)filepath.utf8_str() ) );
+            std::cerr << "[loadAriaFile] Could not open file '" << filepath.utf8_str() << "' for reading" << std::endl;
             return false;
         }
         
-        if (not sequence->readFromFile(xml))
+        // the <seqview> wrapper only holds view data, all we want is the <sequence> element
+        bool success = false;
+        while (xml->read())
         {
-            std::cout << "LOADING SEQUENCE FAILED" << std::endl;
-            delete xml;
-            return false;
+            if (xml->getNodeType() == irr::io::EXN_ELEMENT and strcmp("sequence", xml->getNodeName()) == 0)
+            {
+                success = sequence->readFromFile(xml, NULL);
+                break;
+            }
         }
         
+        if (not success) std::cout << "LOADING SEQUENCE FAILED" << std::endl;
+        
         delete xml;
-        return true;
+        return success;
+    }
+    
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+using namespace AriaMaestosa;
+
+UNIT_TEST( HeadlessAriaRoundTripTest )
+{
+    OwnerPtr<Sequence> original( makeSyntheticSequence(4, 200) );
+    original->setChannelManagementType(CHANNEL_MANUAL);
+    
+    const wxString path = wxFileName::CreateTempFileName(wxT("aria_utest"));
+    require(saveAriaFile((Sequence*)original, path), "The file could be written without a GUI");
+    
+    OwnerPtr<Sequence> reloaded( new Sequence(NULL, NULL, NULL, NULL, false) );
+    const bool loaded = loadAriaFile((Sequence*)reloaded, path);
+    wxRemoveFile(path);
+    require(loaded, "The file could be read without a GUI");
+    
+    require_e(reloaded->getTrackAmount(), ==, original->getTrackAmount(), "Track amount was preserved");
+    
+    // compare what actually matters : the MIDI data both sequences produce
+    requireSameMidiSong(original, reloaded);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( SaveAriaFile )
+{
+    BenchmarkSong song(bench, 10);
+    const wxString path = wxFileName::CreateTempFileName(wxT("aria_bench"));
+    
+    while (bench.next())
+    {
+        saveAriaFile(song, path);
+    }
+    
+    wxRemoveFile(path);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( LoadAriaFile )
+{
+    const wxString path = wxFileName::CreateTempFileName(wxT("aria_bench"));
+    {
+        BenchmarkSong song(bench, 10);
+        saveAriaFile(song, path);
+    }
+    
+    while (bench.next())
+    {
+        bench.pause();
+        OwnerPtr<Sequence> seq( new Sequence(NULL, NULL, NULL, NULL, false) );
+        bench.resume();
+        
+        bench.keep( loadAriaFile((Sequence*)seq, path) );
+        
+        bench.pause(); // don't time the deletion of the sequence
     }
     
+    wxRemoveFile(path);
 }
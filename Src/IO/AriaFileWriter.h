@@ -23,13 +23,23 @@
 namespace AriaMaestosa
 {
     
-    class GraphicalSequence; // forward
+    class Sequence;
     
-    /** @ingroup io */
-    bool loadAriaFile(GraphicalSequence* sequence, wxString filepath);
+    // the overloads for sequences that have a view are declared along with GraphicalSequence
     
-    /** @ingroup io */
-    void saveAriaFile(GraphicalSequence* sequence, wxString filepath);
+    /**
+      * @ingroup io
+      * @brief Load an .aria file into a sequence that has no view. View data (scroll, zoom, editor
+      *        sizes) is skipped and errors go to stderr instead of message boxes.
+      */
+    bool loadAriaFile(Sequence* sequence, wxString filepath);
+    
+    /**
+      * @ingroup io
+      * @brief Save a sequence that has no view; a default view is written so the file opens normally
+      * @return whether the file could be written
+      */
+    bool saveAriaFile(Sequence* sequence, wxString filepath);
     
 }
 
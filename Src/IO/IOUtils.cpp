@@ -25,8 +25,6 @@
 #include <wx/wfstream.h>
 #include <wx/stdpaths.h>
 #include <wx/filename.h>
-#include <wx/msgdlg.h>
-#include <wx/filedlg.h>
 #include <iostream>
 #include <stdlib.h>
 
@@ -67,7 +65,7 @@ void assertFailed(wxString message)
     bug1 = 5 / bug1;
 #endif
 
-    wxMessageBox( message );
+    showMessage( message );
     exit(1);
 }
 
@@ -118,56 +116,6 @@ long atoi_u(wxString s)
     }
 }
 
-#ifdef __WXOSX_COCOA__
-bool g_have_answer = false;
-wxString g_answer;
-void sheetCallback(wxWindowModalDialogEvent& evt)
-{
-    if (evt.GetReturnCode() == wxID_OK)
-    {
-        g_answer = ((wxFileDialog*)evt.GetDialog())->GetPath();
-    }
-    else
-    {
-        g_answer = wxT("");
-    }
-    g_have_answer = true;
-}
-#endif
-
-wxString showFileDialog(wxWindow* parent,
-                        wxString message,
-                        wxString defaultDir,
-                        wxString filename,
-                        wxString wildcard,
-                        bool save)
-{
-    wxFileDialog* dialog = new wxFileDialog(parent, message, defaultDir, filename, wildcard, (save?wxFD_SAVE:wxFD_OPEN));
-    
-#ifdef __WXOSX_COCOA__
-    g_have_answer = false;
-    dialog->Bind(wxEVT_WINDOW_MODAL_DIALOG_CLOSED, &sheetCallback);
-    dialog->ShowWindowModal();
-    
-    // FIXME: that's ugly :)
-    while (not g_have_answer)
-    {
-        wxYield();
-        wxMilliSleep(10);
-    }
-    return g_answer;
-#else
-    int answer = dialog->ShowModal();
-    
-    wxString path = dialog->GetPath();
-    dialog->Destroy();
-    
-    if (answer != wxID_OK) return wxT("");
-
-    return path;
-#endif
-}
-
 wxString getResourcePrefix()
 {
     try // someone got an exception on OpenSUSE
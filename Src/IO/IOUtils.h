@@ -23,7 +23,6 @@
 #include <wx/string.h>
 
 class wxFileOutputStream;
-class wxWindow;
 
 namespace AriaMaestosa
 {
@@ -55,10 +54,6 @@ namespace AriaMaestosa
     /** @ingroup io */
     wxString extract_path(wxString str);
     
-    /** @ingroup io */
-    wxString showFileDialog(wxWindow* parent, wxString message, wxString defaultDir,
-                            wxString filename, wxString wildcard, bool save);
-    
     /** Returns the path to the directory where resource files are located. The returned path
       * always contains a trailing '/', i.e. you can do getResourcePrefix() + "somefile.png"
       * @ingroup ip
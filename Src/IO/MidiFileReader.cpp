@@ -15,7 +15,6 @@
  */
 
 #include "AriaCore.h"
-#include "GUI/GraphicalSequence.h"
 #include "IO/MidiFileReader.h"
 #include "IO/IOUtils.h"
 #include "Midi/CommonMidiUtils.h"
@@ -23,6 +22,9 @@
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
 #include "PreferencesData.h"
+#include "Tracer.h"
+#include "Benchmark.h"
+#include "UnitTestUtils.h"
 
 #include "jdksmidi/world.h"
 #include "jdksmidi/track.h"
@@ -35,6 +37,7 @@
 #include <cmath>
 #include <string>
 #include <wx/intl.h>
+#include <wx/filename.h>
 
 class AriaMIDIFileReadMultiTrack : public jdksmidi::MIDIFileReadMultiTrack
 {
@@ -50,10 +53,9 @@ public:
     }
 };
 
-bool AriaMaestosa::loadMidiFile(GraphicalSequence* gseq, wxString filepath, std::set<wxString>& warnings)
+bool AriaMaestosa::loadMidiFile(Sequence* sequence, wxString filepath, std::set<wxString>& warnings)
 {
-    Sequence* sequence = gseq->getModel();
-    
+    TRACE_ZONE("loadMidiFile");
     OwnerPtr<Sequence::Import> import(sequence->startImport());
 
     // the stream used to read the input file
@@ -554,7 +556,7 @@ bool AriaMaestosa::loadMidiFile(GraphicalSequence* gseq, wxString filepath, std:
             else
             {
                 // set default editor
-                switch (PreferencesData::getInstance()->getIntValue(SETTING_ID_DEFAULT_EDITOR))
+                switch (PreferencesData::getInstance()->getIntValue(SETTING_KEY_DEFAULT_EDITOR))
                 {
                     case 2:
                         ariaTrack->setNotationType(GUITAR, true);
@@ -672,19 +674,43 @@ bool AriaMaestosa::loadMidiFile(GraphicalSequence* gseq, wxString filepath, std:
     std::cout << "[loadMidiFile] song length = " << measureAmount_i << " measures, last_event_tick="
               << lastEventTick << ", beat length = " << sequence->ticksPerQuarterNote() << std::endl;
 
-    gseq->setZoom(100);
-
     if (measureAmount_i < 1) measureAmount_i = 1;
 
     {
         ScopedMeasureTransaction tr(md->startTransaction());
         tr->setMeasureAmount( measureAmount_i );
     }
-    
-    gseq->setZoom(100);
 
     sequence->clearUndoStack();
 
     return true;
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+using namespace AriaMaestosa;
+
+BENCHMARK( LoadMidiFile )
+{
+    wxString path;
+    {
+        BenchmarkSong song(bench, 10);
+        song->setChannelManagementType(CHANNEL_MANUAL);
+        path = wxFileName::CreateTempFileName(wxT("aria_bench"));
+        exportMidiFile(song, path);
+    }
+    
+    while (bench.next())
+    {
+        bench.pause();
+        OwnerPtr<Sequence> seq( new Sequence(NULL, NULL, NULL, NULL, false) );
+        std::set<wxString> warnings;
+        bench.resume();
+        
+        bench.keep( loadMidiFile((Sequence*)seq, path, warnings) );
+        
+        bench.pause(); // don't time the deletion of the sequence
+    }
+    
+    wxRemoveFile(path);
+}
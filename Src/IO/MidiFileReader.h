@@ -23,10 +23,13 @@
 namespace AriaMaestosa
 {
     
-    class GraphicalSequence;
+    class Sequence;
     
-    /** @ingroup io */
-    bool loadMidiFile(GraphicalSequence* sequence, wxString filepath, std::set<wxString>& warnings);
+    /** @ingroup io
+      * @brief Load a midi file into a sequence (the overload for sequences that have a view is declared
+      *        along with GraphicalSequence)
+      */
+    bool loadMidiFile(Sequence* sequence, wxString filepath, std::set<wxString>& warnings);
     
 }
 
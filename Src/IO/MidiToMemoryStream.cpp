@@ -16,6 +16,8 @@
 
 #include "IO/MidiToMemoryStream.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sys/stat.h>
@@ -24,54 +26,81 @@ using namespace AriaMaestosa;
 
 MidiToMemoryStream::MidiToMemoryStream() : MIDIFileWriteStream()
 {
-    pos=0;
-    length = 0;
+    m_data     = NULL;
+    m_capacity = 0;
+    m_pos      = 0;
+    m_length   = 0;
 }
 
 
 long MidiToMemoryStream::Seek( const long pos_add, const int whence )
 {
 
-    if (whence == SEEK_SET) pos = pos_add; // i think this one is the only once used
-    else if (whence == SEEK_CUR) pos += pos_add;
-    else if (whence == SEEK_END) pos = length-2;
+    if (whence == SEEK_SET) m_pos = pos_add; // i think this one is the only once used
+    else if (whence == SEEK_CUR) m_pos += pos_add;
+    else if (whence == SEEK_END) m_pos = m_length-2;
 
     return 0;
 }
 
-int MidiToMemoryStream::WriteChar( const int c )
+bool MidiToMemoryStream::makeRoom(const int amount)
 {
-
-    if (pos==length)
+    const int needed = m_pos + amount;
+    if (needed > m_capacity)
     {
-        data.push_back(c);
-        length++;
-    }
-    else
-    {
-        data[pos] = c;
+        int capacity = (m_capacity < 4096 ? 4096 : m_capacity*2);
+        while (capacity < needed) capacity *= 2;
+
+        // on failure, the old buffer is still valid (and still ours to free)
+        char* data = (char*)realloc(m_data, capacity);
+        if (data == NULL) return false;
+
+        m_data     = data;
+        m_capacity = capacity;
     }
-    pos++;
+
+    // if we seeked past the end, what's in between is zeroes
+    if (m_pos > m_length) memset(m_data + m_length, 0, m_pos - m_length);
+    return true;
+}
+
+int MidiToMemoryStream::WriteChar( const int c )
+{
+    if (not makeRoom(1)) return -1;
+    m_data[m_pos++] = c;
+    if (m_pos > m_length) m_length = m_pos;
     return 1;
 }
 
-int MidiToMemoryStream::getDataLength()
+int MidiToMemoryStream::WriteBytes( const unsigned char* buf, const int len )
+{
+    if (not makeRoom(len)) return -1;
+    memcpy(m_data + m_pos, buf, len);
+    m_pos += len;
+    if (m_pos > m_length) m_length = m_pos;
+    return 0;
+}
+
+int MidiToMemoryStream::getDataLength() const
 {
-    return length;
+    return m_length;
 }
 
-void MidiToMemoryStream::storeMidiData(char* midiData)
+char* MidiToMemoryStream::releaseMidiData()
 {
+    char* data = m_data;
 
-    for (int n=0; n<length; n++)
-    {
-        midiData[n] = data[n];
-    }
+    m_data     = NULL;
+    m_capacity = 0;
+    m_pos      = 0;
+    m_length   = 0;
 
+    return data;
 }
 
 MidiToMemoryStream::~MidiToMemoryStream()
 {
+    free(m_data);
 }
 
 
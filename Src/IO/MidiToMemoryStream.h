@@ -35,12 +35,21 @@ namespace AriaMaestosa
     /**
      * libjdkmidi by default can only save midi bytes to a file.
      * So i wrote this "fake stream" that captures the bytes and stores them in memory rather than to a file.
+     * The bytes are kept in a malloc'ed buffer that grows geometrically, and that the caller can take
+     * over once writing is done.
      * @ingroup io
      */
     class MidiToMemoryStream : public jdksmidi::MIDIFileWriteStream
     {
-        std::vector<char> data;
-        int pos, length;
+        char* m_data;
+        int m_capacity;
+        int m_pos, m_length;
+        
+        /**
+          * @brief make room for 'amount' bytes at the current position
+          * @return false if memory could not be allocated (the data written so far is kept)
+          */
+        bool makeRoom(const int amount);
         
     public:
         LEAK_CHECK();
@@ -50,8 +59,14 @@ namespace AriaMaestosa
         
         long Seek( const long pos, const int whence );
         int  WriteChar( const int c );
-        int  getDataLength();
-        void storeMidiData(char* midiData);
+        int  WriteBytes( const unsigned char* buf, const int len );
+        int  getDataLength() const;
+        
+        /**
+         * @brief hand the bytes written so far over to the caller, who must free() them
+         *        (the stream is empty afterwards)
+         */
+        char* releaseMidiData();
     };
     
 }
@@ -0,0 +1,316 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "IO/SmfWriter.h"
+
+#include "jdksmidi/world.h"
+#include "jdksmidi/midi.h"
+#include "jdksmidi/msg.h"
+#include "jdksmidi/sysex.h"
+
+#include <cstring>
+
+using namespace AriaMaestosa;
+
+namespace SmfWriterConstants
+{
+    /** 'MTrk' and the (yet unknown) chunk length */
+    const unsigned char TRACK_HEADER[8] = { 'M', 'T', 'r', 'k', 0, 0, 0, 0 };
+
+    /** Most channel events take one byte of delta-time, a status byte (often omitted) and two data bytes */
+    const int BYTES_PER_EVENT = 4;
+}
+
+using namespace SmfWriterConstants;
+
+// ----------------------------------------------------------------------------------------------------------
+
+SmfTrackWriter::SmfTrackWriter()
+{
+    clear();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::clear()
+{
+    m_bytes.assign(TRACK_HEADER, TRACK_HEADER + 8);
+    m_track_time     = 0;
+    m_end_time       = 0;
+    m_running_status = 0;
+    m_closed         = false;
+    m_out_of_order   = false;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::reserve(const int eventAmount)
+{
+    m_bytes.reserve(m_bytes.size() + eventAmount*BYTES_PER_EVENT);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::writeVariableNum(unsigned long n)
+{
+    // 7 bits per byte, most significant first, all bytes but the last with their high bit set
+    unsigned char buffer[5];
+    int count = 0;
+    buffer[count++] = (unsigned char)(n & 0x7F);
+    while ((n >>= 7) > 0)
+    {
+        buffer[count++] = (unsigned char)((n & 0x7F) | 0x80);
+    }
+
+    while (count > 0) m_bytes.push_back(buffer[--count]);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::writeDeltaTime(const unsigned long absTime)
+{
+    long delta = absTime - m_track_time;
+    if (delta < 0)
+    {
+        m_out_of_order = true;
+        delta = 0;
+    }
+
+    writeVariableNum(delta);
+    m_track_time = absTime;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::writeMeta(const unsigned long time, const unsigned char type, const unsigned char* data,
+                               const int length)
+{
+    writeDeltaTime(time);
+    m_bytes.push_back(jdksmidi::META_EVENT);
+    m_bytes.push_back(type);
+    writeVariableNum(length);
+    m_bytes.insert(m_bytes.end(), data, data + length);
+    m_running_status = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool SmfTrackWriter::putEvent(const jdksmidi::MIDITimedBigMessage& msg)
+{
+    // same rules as jdksmidi::MIDIFileWriteMultiTrack : no-ops are not written, and nothing after
+    // the end of data
+    if (m_closed or msg.IsNoOp()) return true;
+
+    const unsigned long time = msg.GetTime();
+
+    if (msg.IsDataEnd())
+    {
+        m_closed   = true;
+        m_end_time = time;
+        return true;
+    }
+
+    if (msg.IsMetaEvent())
+    {
+        // meta events with a sysex buffer attached (text) hold their raw data in it
+        if (msg.GetSysEx() != NULL)
+        {
+            writeMeta(time, msg.GetMetaType(), msg.GetSysEx()->GetBuf(), msg.GetSysEx()->GetLengthSE());
+        }
+        else if (msg.IsTempo())
+        {
+            const unsigned char data[3] = { msg.GetByte2(), msg.GetByte3(), msg.GetByte4() };
+            writeMeta(time, msg.GetByte1(), data, 3);
+        }
+        else if (msg.IsKeySig())
+        {
+            const unsigned char data[2] = { (unsigned char)msg.GetKeySigSharpFlats(),
+                                            msg.GetKeySigMajorMinor() };
+            writeMeta(time, jdksmidi::META_KEYSIG, data, 2);
+        }
+        else if (msg.IsTimeSig())
+        {
+            // numerator, denominator power, clocks per metronome click, 32nd notes per quarter note
+            const unsigned char data[4] = { msg.GetByte2(), msg.GetByte4(), msg.GetByte5(), msg.GetByte6() };
+            writeMeta(time, jdksmidi::META_TIMESIG, data, 4);
+        }
+        else
+        {
+            const int length = msg.GetDataLength();
+            if (length > 5) return true; // not a valid meta event
+
+            const unsigned char data[5] = { msg.GetByte2(), msg.GetByte3(), msg.GetByte4(), msg.GetByte5(),
+                                            msg.GetByte6() };
+            writeMeta(time, msg.GetByte1(), data, length);
+        }
+        return true;
+    }
+
+    if (msg.IsSystemExclusive() and msg.GetSysEx() != NULL)
+    {
+        const int length = msg.GetSysEx()->GetLengthSE();
+        const unsigned char* data = msg.GetSysEx()->GetBuf();
+
+        writeDeltaTime(time);
+        m_bytes.push_back(msg.GetStatus());
+        writeVariableNum(length);
+        m_bytes.insert(m_bytes.end(), data, data + length);
+        m_running_status = 0;
+        return true;
+    }
+
+    // channel events
+    const int length = msg.GetLengthMSG();
+    if (length > 0)
+    {
+        writeDeltaTime(time);
+
+        const unsigned char status = msg.GetStatus();
+        if (status != m_running_status)
+        {
+            m_bytes.push_back(status);
+            m_running_status = status;
+        }
+
+        if (length > 1) m_bytes.push_back(msg.GetByte1());
+        if (length > 2) m_bytes.push_back(msg.GetByte2());
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool SmfTrackWriter::putTextEvent(const int time, const int metaType, const char* text, const int length)
+{
+    if (m_closed) return true;
+
+    writeMeta(time, metaType, (const unsigned char*)text, length);
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfTrackWriter::finish()
+{
+    unsigned long endTime = (m_closed ? m_end_time : m_track_time);
+    if (endTime == 0) endTime = m_track_time;
+
+    writeMeta(endTime, jdksmidi::META_END_OF_TRACK, NULL, 0);
+
+    const unsigned long length = m_bytes.size() - 8;
+    m_bytes[4] = (unsigned char)((length >> 24) & 0xFF);
+    m_bytes[5] = (unsigned char)((length >> 16) & 0xFF);
+    m_bytes[6] = (unsigned char)((length >> 8)  & 0xFF);
+    m_bytes[7] = (unsigned char)( length        & 0xFF);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+SmfWriter::SmfWriter(const int trackAmount, const int division)
+{
+    for (int n=0; n<trackAmount; n++)
+    {
+        m_tracks.push_back(new SmfTrackWriter());
+    }
+
+    m_header[0] = 'M';
+    m_header[1] = 'T';
+    m_header[2] = 'h';
+    m_header[3] = 'd';
+
+    // length of the header data
+    m_header[4] = 0;
+    m_header[5] = 0;
+    m_header[6] = 0;
+    m_header[7] = 6;
+
+    // format and track amount, filled by 'finish'
+    m_header[8]  = 0;
+    m_header[9]  = 0;
+    m_header[10] = 0;
+    m_header[11] = 0;
+
+    m_header[12] = (unsigned char)((division >> 8) & 0xFF);
+    m_header[13] = (unsigned char)( division       & 0xFF);
+
+    m_track_amount = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool SmfWriter::finish(const int trackAmount)
+{
+    ASSERT_E(trackAmount, <=, getTrackAmount());
+
+    m_track_amount = trackAmount;
+
+    const int format = (trackAmount > 1 ? 1 : 0);
+    m_header[8]  = (unsigned char)((format >> 8) & 0xFF);
+    m_header[9]  = (unsigned char)( format       & 0xFF);
+    m_header[10] = (unsigned char)((trackAmount >> 8) & 0xFF);
+    m_header[11] = (unsigned char)( trackAmount       & 0xFF);
+
+    bool orderOK = true;
+    for (int n=0; n<trackAmount; n++)
+    {
+        m_tracks[n].finish();
+        if (not m_tracks[n].isOrderOK()) orderOK = false;
+    }
+    return orderOK;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int SmfWriter::getLength() const
+{
+    int length = 0;
+    for (int n=0; n<getPieceAmount(); n++)
+    {
+        length += getPieceLength(n);
+    }
+    return length;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void SmfWriter::copyTo(unsigned char* dest) const
+{
+    for (int n=0; n<getPieceAmount(); n++)
+    {
+        const int length = getPieceLength(n);
+        memcpy(dest, getPiece(n), length);
+        dest += length;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const unsigned char* SmfWriter::getPiece(const int id) const
+{
+    if (id == 0) return m_header;
+    return m_tracks[id - 1].getChunk();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int SmfWriter::getPieceLength(const int id) const
+{
+    if (id == 0) return HEADER_LENGTH;
+    return m_tracks[id - 1].getChunkLength();
+}
+
+// ----------------------------------------------------------------------------------------------------------
@@ -0,0 +1,129 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __SMF_WRITER_H__
+#define __SMF_WRITER_H__
+
+#include "Midi/MidiEventSink.h"
+#include "Utils.h"
+#include "ptr_vector.h"
+
+#include <vector>
+
+namespace AriaMaestosa
+{
+
+    /**
+      * @brief encodes the events of one track straight into the bytes of a standard midi file track chunk
+      *
+      * Delta-times and running status are computed as events come in, exactly like
+      * jdksmidi::MIDIFileWrite does, so no event is ever stored; the chunk only takes as much memory as
+      * its encoded size.
+      * @ingroup io
+      */
+    class SmfTrackWriter : public IMidiEventSink
+    {
+        /** The whole chunk, 'MTrk' header included */
+        std::vector<unsigned char> m_bytes;
+
+        unsigned long m_track_time;
+        unsigned long m_end_time;
+        unsigned char m_running_status;
+
+        /** Set once a 'data end' event was met, all later events are ignored */
+        bool m_closed;
+
+        /** Set when an event came before the previous one */
+        bool m_out_of_order;
+
+        void writeVariableNum(unsigned long n);
+        void writeDeltaTime(unsigned long absTime);
+        void writeMeta(unsigned long time, unsigned char type, const unsigned char* data, int length);
+
+    public:
+        LEAK_CHECK();
+
+        SmfTrackWriter();
+
+        virtual void reserve(const int eventAmount);
+        virtual bool putEvent(const jdksmidi::MIDITimedBigMessage& msg);
+        virtual bool putTextEvent(const int time, const int metaType, const char* text, const int length);
+        virtual void clear();
+
+        /** @brief adds the end of track event and fills in the chunk length; put no event afterwards */
+        void finish();
+
+        /** @return whether events were put in time order (otherwise they were written at the same time as
+          *         the event before them) */
+        bool isOrderOK() const { return not m_out_of_order; }
+
+        const unsigned char* getChunk() const { return &m_bytes[0]; }
+        int getChunkLength() const { return m_bytes.size(); }
+    };
+
+    /**
+      * @brief builds a standard midi file out of several SmfTrackWriter
+      *
+      * Each track is encoded in its own buffer (so tracks can be compiled concurrently) and the buffers
+      * are only put together once, when the file is written out.
+      * @ingroup io
+      */
+    class SmfWriter
+    {
+        ptr_vector<SmfTrackWriter> m_tracks;
+
+        enum { HEADER_LENGTH = 14 };
+        unsigned char m_header[HEADER_LENGTH];
+
+        /** Amount of tracks that make it to the file, set by 'finish' */
+        int m_track_amount;
+
+    public:
+        LEAK_CHECK();
+
+        /**
+          * @param trackAmount how many tracks are available to put events in
+          * @param division    ticks per quarter note
+          */
+        SmfWriter(const int trackAmount, const int division);
+
+        int getTrackAmount() const { return m_tracks.size(); }
+        SmfTrackWriter* getTrack(const int id) { return m_tracks.get(id); }
+
+        /**
+          * @brief close the file; only the first 'trackAmount' tracks are written to it
+          * @return false if events of some track were out of order
+          */
+        bool finish(const int trackAmount);
+
+        /** @return the size, in bytes, of the file (only valid after 'finish') */
+        int getLength() const;
+
+        /** @brief copy the whole file to 'dest', which must hold at least 'getLength()' bytes */
+        void copyTo(unsigned char* dest) const;
+
+        /**
+          * @brief the file is made of the header followed by one chunk per track ; use these to write it
+          *        out piece by piece without assembling it in memory first
+          */
+        int getPieceAmount() const { return m_track_amount + 1; }
+        const unsigned char* getPiece(const int id) const;
+        int getPieceLength(const int id) const;
+    };
+
+}
+
+#endif
@@ -17,14 +17,18 @@
 
 #include "IO/IOUtils.h"
 #include "IO/MidiToMemoryStream.h"
-#include "GUI/GraphicalTrack.h"
-#include "Dialogs/WaitWindow.h"
+#include "IO/SmfWriter.h"
 #include "Midi/CommonMidiUtils.h"
 #include "Midi/MeasureData.h"
+#include "Midi/MidiEventSink.h"
 #include "Midi/Players/PlatformMidiManager.h"
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
 #include "UnitTest.h"
+#include "UnitTestUtils.h"
 #include "ptr_vector.h"
 
 #include "jdksmidi/world.h"
@@ -37,11 +41,15 @@
 #include "jdksmidi/msg.h"
 #include "jdksmidi/sysex.h"
 
+#include <wx/ffile.h>
 #include <wx/intl.h>
 #include <wx/timer.h>
-#include <wx/msgdlg.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 
 /*
@@ -94,54 +102,68 @@
 namespace AriaMaestosa
 {
     void addTimeSigFromVector(int n, int amount, MeasureData* measureData,
-                              jdksmidi::MIDIMultiTrack& tracks, int substract_ticks);
+                              IMidiEventSink* metaTrack, int substract_ticks);
     void addTempoEventFromSequenceVector(int n, int amount, Sequence* sequence,
-                                        jdksmidi::MIDIMultiTrack& tracks, int substract_ticks);
+                                        IMidiEventSink* metaTrack, int substract_ticks);
     void addTextEventFromSequenceVector(int n, Sequence* sequence,
-                                        jdksmidi::MIDIMultiTrack& tracks, int substract_ticks);
+                                        IMidiEventSink* metaTrack, int substract_ticks);
+    bool addMetaEvents(Sequence* sequence, IMidiEventSink* metaTrack, int substract_ticks, bool playing);
+    bool compileSequence(Sequence* sequence, std::vector<IMidiEventSink*>& tracks, bool selectionOnly,
+                         /*out*/int* songLengthInTicks, /*out*/int* startTick, /*out*/ int* numTracks,
+                         bool playing);
+    bool compileSequenceToSmf(Sequence* sequence, SmfWriter& writer, bool selectionOnly,
+                              /*out*/int* songLengthInTicks, /*out*/int* startTick, bool playing);
+    int  nextAutoChannel(int channel, ChannelManagementType type, bool* overflow);
+    void showTooManyChannelsWarning(bool* alreadyShown);
 }
 
 // ----------------------------------------------------------------------------------------------------------
 
 bool AriaMaestosa::exportMidiFile(Sequence* sequence, wxString filepath)
 {
+    TRACE_ZONE("exportMidiFile");
     // when we're saving, we always want song to start at first measure, so temporarly switch
     // firstMeasure to 0, and set it back in the end
     const int firstMeasureValue = sequence->getMeasureData()->getFirstMeasure();
     sequence->getMeasureData()->setFirstMeasure(0);
     
-    jdksmidi::MIDIMultiTrack tracks;
-    int length = -1, start = -1, numTracks = -1;
-    makeJDKMidiSequence(sequence, tracks, false, &length, &start, &numTracks, false);
+    // events are encoded into the bytes of the file as the tracks are compiled
+    SmfWriter writer(sequence->getTrackAmount() + 2, sequence->ticksPerQuarterNote());
+    int length = -1, start = -1;
+    const bool success = compileSequenceToSmf(sequence, writer, false, &length, &start, false);
     
-#ifdef __WXMSW__
-    jdksmidi::MIDIFileWriteStreamFileName file_stream( (const wchar_t*)filepath.wc_str() );
-#else
-    jdksmidi::MIDIFileWriteStreamFileName file_stream( (const char*)filepath.mb_str(wxConvUTF8) );
-#endif
-
-    jdksmidi::MIDIFileWriteMultiTrack writer2(
-                                             &tracks,
-                                             &file_stream
-                                             );
+    sequence->getMeasureData()->setFirstMeasure(firstMeasureValue);
     
-    // write the output file
-    if (not writer2.Write(numTracks, sequence->ticksPerQuarterNote()))
+    if (not success)
     {
         fprintf(stderr, "[exportMidiFile] Error writing midi file\n");
         return false;
     }
     
-    sequence->getMeasureData()->setFirstMeasure(firstMeasureValue);
+    wxFFile file(filepath, wxT("wb"));
+    if (not file.IsOpened())
+    {
+        fprintf(stderr, "[exportMidiFile] Could not open file for writing\n");
+        return false;
+    }
     
-    return true;
+    for (int n=0; n<writer.getPieceAmount(); n++)
+    {
+        const size_t pieceLength = writer.getPieceLength(n);
+        if (file.Write(writer.getPiece(n), pieceLength) != pieceLength)
+        {
+            fprintf(stderr, "[exportMidiFile] Error writing midi file\n");
+            return false;
+        }
+    }
     
+    return true;
 }
 
 // ----------------------------------------------------------------------------------------------------------
 
 void AriaMaestosa::addTimeSigFromVector(int n, int amount, MeasureData* measureData,
-                                        jdksmidi::MIDIMultiTrack& tracks, int substract_ticks)
+                                        IMidiEventSink* metaTrack, int substract_ticks)
 {
     jdksmidi::MIDITimedBigMessage m;
     int measure = measureData->getTimeSig(n).getMeasure();
@@ -169,7 +191,7 @@ void AriaMaestosa::addTimeSigFromVector(int n, int amount, MeasureData* measureD
     float denom = (float)log(measureData->getTimeSig(n).getDenom())/(float)log(2);
     m.SetTimeSig( measureData->getTimeSig(n).getNum(), (int)denom );
     
-    if (not tracks.GetTrack(0)->PutEvent(m))
+    if (not metaTrack->putEvent(m))
     {
         std::cerr << "Error adding time sig event" << std::endl;
         return;
@@ -179,7 +201,7 @@ void AriaMaestosa::addTimeSigFromVector(int n, int amount, MeasureData* measureD
 // ----------------------------------------------------------------------------------------------------------
 
 void AriaMaestosa::addTempoEventFromSequenceVector(int n, int amount, Sequence* sequence,
-                                                   jdksmidi::MIDIMultiTrack& tracks, int substract_ticks)
+                                                   IMidiEventSink* metaTrack, int substract_ticks)
 {
     jdksmidi::MIDITimedBigMessage m;
     
@@ -203,7 +225,7 @@ void AriaMaestosa::addTempoEventFromSequenceVector(int n, int amount, Sequence*
     double tempo = convertTempoBendToBPM(sequence->getTempoEvent(n)->getValue()) * 32.0;
     m.SetTempo32(tempo);
     
-    if (not tracks.GetTrack(0)->PutEvent( m ))
+    if (not metaTrack->putEvent( m ))
     {
         std::cerr << "Error adding tempo event" << std::endl;
         return;
@@ -213,14 +235,10 @@ void AriaMaestosa::addTempoEventFromSequenceVector(int n, int amount, Sequence*
 // ----------------------------------------------------------------------------------------------------------
 
 void AriaMaestosa::addTextEventFromSequenceVector(int n, Sequence* sequence,
-                                                  jdksmidi::MIDIMultiTrack& tracks, int substract_ticks)
+                                                  IMidiEventSink* metaTrack, int substract_ticks)
 {
-    jdksmidi::MIDITimedBigMessage m;
-    
     const TextEvent* evt = sequence->getTextEvents().getConst(n);
     
-    m.SetTime( evt->getTick() );
-    
     char type;
     
     if (evt->getController() == PSEUDO_CONTROLLER_LYRICS)
@@ -233,20 +251,9 @@ void AriaMaestosa::addTextEventFromSequenceVector(int n, Sequence* sequence,
         return;
     }
     
-    m.SetText( evt->getText().getModel()->getValue().size(), type);
-    
-    wxCharBuffer buffer = evt->getText().getModel()->getValue().ToUTF8();
+    wxCharBuffer buffer = evt->getTextValue().ToUTF8();
     
-    jdksmidi::MIDISystemExclusive* sysex = new jdksmidi::MIDISystemExclusive();
-    for (const char* c = buffer.data(); *c != 0; c++)
-    {
-        sysex->PutByte(*c);
-        //m.GetSysEx()->PutByte(*c);
-    }
-    m.CopySysEx(sysex);
-    delete sysex;
-    
-    if (not tracks.GetTrack(0)->PutEvent( m ))
+    if (not metaTrack->putTextEvent(evt->getTick(), type, buffer.data(), strlen(buffer.data())))
     {
         std::cerr << "Error adding text event" << std::endl;
         return;
@@ -374,119 +381,33 @@ UNIT_TEST( MergeTest )
 
 // ----------------------------------------------------------------------------------------------------------
 
-bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTrack& tracks, bool selectionOnly,
-                                       /*out*/int* songLengthInTicks, /*out*/int* startTick,
-                                       /*out*/ int* numTracks, bool playing)
+int AriaMaestosa::nextAutoChannel(int channel, ChannelManagementType type, bool* overflow)
 {
-    int trackLength = -1;
-    int channel     = 0;
-    
-    int substract_ticks;
-    const bool addMetronome = (sequence->playWithMetronome() and playing);
-    
-    tracks.SetClksPerBeat( sequence->ticksPerQuarterNote() );
-    
-    MeasureData* md = sequence->getMeasureData();
-    
-    bool tooManyChannelsMessageShown = false;
-    
-    const int past_end_time = (playing and not sequence->isLoopEnabled() ? sequence->ticksPerQuarterNote()*4 : 0);
-    
-    if (selectionOnly)
-    {
-        //  ---- add events to tracks
-        trackLength = sequence->getCurrentTrack()->addMidiEvents(tracks.GetTrack(sequence->getCurrentTrackID() + 1),
-                                                                 channel,
-                                                                 md->getFirstMeasure(),
-                                                                 true,
-                                                                 *startTick );
-        
-        substract_ticks = *startTick;
-        
-        if (trackLength == -1) return false; // nothing to play in track (empty track - play nothing)
-        
-        if (sequence->isLoopEnabled())
-        {
-            // when looping, stop at the measure marked as loop end
-            *songLengthInTicks = md->lastTickInMeasure(md->getLoopEndMeasure()) - substract_ticks;
-        }
-        else
-        {
-            // Add some time at the end for notes to fade out
-            *songLengthInTicks = trackLength + sequence->ticksPerQuarterNote()*2;
-        }
-    }
-    else
+    if (channel > 15 and type == CHANNEL_AUTO)
     {
-        // play from beginning
-        (*startTick) = -1;
-        
-        const int trackAmount = sequence->getTrackAmount();
-        for (int n=0; n<trackAmount; n++)
-        {
-            bool drum_track = (sequence->getTrack(n)->isNotationTypeEnabled(DRUM));
-            
-            int trackFirstNote = -1;
-            
-            if (n+1 < tracks.GetNumTracks())
-            {
-                trackLength = sequence->getTrack(n)->addMidiEvents(tracks.GetTrack(n+1), (drum_track ? 9 : channel),
-                                                                   md->getFirstMeasure(), false,
-                                                                   trackFirstNote );
-            }
-            else
-            {
-                if (not tooManyChannelsMessageShown)
-                {
-                    if (WaitWindow::isShown()) WaitWindow::hide();
-                    wxMessageBox(_("WARNING: this song has too many\nchannels, expect unpredictable output"));
-                    std::cout << "WARNING: this song has too many channels, expect unpredictable output" << std::endl;
-                    tooManyChannelsMessageShown = true;
-                }
-                trackLength = sequence->getTrack(n)->addMidiEvents(tracks.GetTrack(1), (drum_track ? 9 : channel),
-                                                                   md->getFirstMeasure(), false,
-                                                                   trackFirstNote );
-            }
-            
-            if ((trackFirstNote<(*startTick) and trackFirstNote != -1) or (*startTick) == -1)
-            {
-                (*startTick) = trackFirstNote;
-            }
-            
-            
-            if (trackLength == -1) continue; // nothing to play in track (empty track - skip it)
-            if (trackLength > *songLengthInTicks) *songLengthInTicks = trackLength;
-            
-            if (not drum_track)
-            {
-                if (channel > 15 and sequence->getChannelManagementType() == CHANNEL_AUTO)
-                {
-                    if (not tooManyChannelsMessageShown)
-                    {
-                        if (WaitWindow::isShown()) WaitWindow::hide();
-                        wxMessageBox(_("WARNING: this song has too many\nchannels, expect unpredictable output"));
-                        std::cout << "WARNING: this song has too many channels, expect unpredictable output" << std::endl;
-                        tooManyChannelsMessageShown = true;
-                    }
-                    channel = 0;
-                }
-                channel++; if (channel==9) channel++;
-            }
-        }
-        
-        if (sequence->isLoopEnabled())
-        {
-            // when looping, stop at the measure marked as loop end
-            *songLengthInTicks = md->lastTickInMeasure(md->getLoopEndMeasure()) - *startTick;
-        }
-        
-        substract_ticks = *startTick;
-        
+        *overflow = true;
+        channel = 0;
     }
+    channel++; if (channel==9) channel++;
+    return channel;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void AriaMaestosa::showTooManyChannelsWarning(bool* alreadyShown)
+{
+    if (*alreadyShown) return;
     
-    
-    if (*songLengthInTicks < 1) return false; // nothing to play at all (empty song - play nothing)
-    *numTracks = sequence->getTrackAmount()+1;
+    showMessage(_("WARNING: this song has too many\nchannels, expect unpredictable output"));
+    *alreadyShown = true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool AriaMaestosa::addMetaEvents(Sequence* sequence, IMidiEventSink* metaTrack, int substract_ticks,
+                                 bool playing)
+{
+    MeasureData* md = sequence->getMeasureData();
     
     // ---- default tempo
     
@@ -495,7 +416,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         m.SetTime( 0 );
         m.SetTempo32( sequence->getTempo() * 32 ); // tempo stored as bpm * 32, giving 1/32 bpm resolution
         
-        if (not tracks.GetTrack(0)->PutEvent( m ))
+        if (not metaTrack->putEvent( m ))
         {
             std::cerr << "Error adding tempo event" << std::endl;
             return false;
@@ -525,7 +446,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         // TODO : handle mode (major or minor)
         m.SetKeySig(amount,0);
    
-        if (not tracks.GetTrack(0)->PutEvent( m ))
+        if (not metaTrack->putEvent( m ))
         {
             std::cerr << "Error adding key signature event" << std::endl;
             return false;
@@ -539,19 +460,10 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         // copyright
         if (not sequence->getCopyright().IsEmpty())
         {
-            jdksmidi::MIDITimedBigMessage m;
-            
-            m.SetText( 2 );
-            m.SetByte1( 2 );
-            
             wxCharBuffer copyrightBuffer = sequence->getCopyright().ToUTF8();
-            int len = strlen(copyrightBuffer.data());
-            jdksmidi::MIDISystemExclusive sysex((unsigned char*)copyrightBuffer.data(), len, len, false);
-            
-            m.CopySysEx( &sysex );
-            m.SetTime( 0 );
             
-            if (not tracks.GetTrack(0)->PutEvent( m ))
+            if (not metaTrack->putTextEvent(0, jdksmidi::META_COPYRIGHT, copyrightBuffer.data(),
+                                            strlen(copyrightBuffer.data())))
             {
                 std::cerr << "Error adding copyright sysex event" << std::endl;
                 return false;
@@ -562,18 +474,10 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         if (not sequence->getInternalName().IsEmpty())
         {
             
-            jdksmidi::MIDITimedBigMessage m;
-            m.SetText( 3 );
-            m.SetByte1( 3 );
-            
             wxCharBuffer nameBuffer = sequence->getInternalName().ToUTF8();
-            int len = strlen(nameBuffer.data());
-            jdksmidi::MIDISystemExclusive sysex((unsigned char*)nameBuffer.data(), len, len, false);
             
-            m.CopySysEx( &sysex );
-            m.SetTime( 0 );
-            
-            if (not tracks.GetTrack(0)->PutEvent( m ))
+            if (not metaTrack->putTextEvent(0, jdksmidi::META_TRACK_NAME, nameBuffer.data(),
+                                            strlen(nameBuffer.data())))
             {
                 std::cerr << "Error adding songname sysex event" << std::endl;
                 return false;
@@ -595,12 +499,12 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             int i;
             int m_count;
             MeasureData* m_md;
-            jdksmidi::MIDIMultiTrack& m_tracks;
+            IMidiEventSink* m_meta_track;
             int m_substract_ticks;
             
         public:
             
-            TimeSigSource(MeasureData* pmd, jdksmidi::MIDIMultiTrack& ptracks, int psubstract_ticks) : m_tracks(ptracks)
+            TimeSigSource(MeasureData* pmd, IMidiEventSink* pmetaTrack, int psubstract_ticks) : m_meta_track(pmetaTrack)
             {
                 i = 0;
                 m_count = pmd->getTimeSigAmount();
@@ -620,7 +524,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             }
             virtual void pop()
             {
-                addTimeSigFromVector(i, m_count, m_md, m_tracks, m_substract_ticks);
+                addTimeSigFromVector(i, m_count, m_md, m_meta_track, m_substract_ticks);
                 i++;
             }
         };
@@ -629,12 +533,12 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             int i;
             int m_count;
             Sequence* m_seq;
-            jdksmidi::MIDIMultiTrack& m_tracks;
+            IMidiEventSink* m_meta_track;
             int m_substract_ticks;
             
         public:
             
-            TempoEvtSource(Sequence* seq, jdksmidi::MIDIMultiTrack& ptracks, int psubstract_ticks) : m_tracks(ptracks)
+            TempoEvtSource(Sequence* seq, IMidiEventSink* pmetaTrack, int psubstract_ticks) : m_meta_track(pmetaTrack)
             {
                 i = 0;
                 m_count = seq->getTempoEventAmount();
@@ -654,7 +558,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             }
             virtual void pop()
             {
-                addTempoEventFromSequenceVector(i, m_count, m_seq, m_tracks, m_substract_ticks);
+                addTempoEventFromSequenceVector(i, m_count, m_seq, m_meta_track, m_substract_ticks);
                 i++;
             }
         };
@@ -663,12 +567,12 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             int i;
             int m_count;
             Sequence* m_seq;
-            jdksmidi::MIDIMultiTrack& m_tracks;
+            IMidiEventSink* m_meta_track;
             int m_substract_ticks;
             
         public:
             
-            TextEvtSource(Sequence* seq, jdksmidi::MIDIMultiTrack& ptracks, int psubstract_ticks) : m_tracks(ptracks)
+            TextEvtSource(Sequence* seq, IMidiEventSink* pmetaTrack, int psubstract_ticks) : m_meta_track(pmetaTrack)
             {
                 i = 0;
                 m_count = seq->getTextEvents().size();
@@ -688,16 +592,16 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             }
             virtual void pop()
             {
-                addTextEventFromSequenceVector(i, m_seq, m_tracks, m_substract_ticks);
+                addTextEventFromSequenceVector(i, m_seq, m_meta_track, m_substract_ticks);
                 i++;
             }
         };
         
         {
             ptr_vector<IMergeSource> sources;
-            sources.push_back( new TimeSigSource(md, tracks, substract_ticks) );
-            sources.push_back( new TempoEvtSource(sequence, tracks, substract_ticks) );
-            sources.push_back( new TextEvtSource(sequence, tracks, substract_ticks) );
+            sources.push_back( new TimeSigSource(md, metaTrack, substract_ticks) );
+            sources.push_back( new TempoEvtSource(sequence, metaTrack, substract_ticks) );
+            sources.push_back( new TextEvtSource(sequence, metaTrack, substract_ticks) );
             merge( sources );
         }
     }
@@ -707,11 +611,232 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         const int amount = sequence->getTempoEventAmount();
         for (int n=0; n<amount; n++)
         {
-            addTempoEventFromSequenceVector(n, amount, sequence, tracks, substract_ticks);
+            addTempoEventFromSequenceVector(n, amount, sequence, metaTrack, substract_ticks);
         }
     }
     
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+namespace AriaMaestosa
+{
+    /** Per-track state of makeJDKMidiSequence */
+    struct TrackExportInfo
+    {
+        bool drum;
+        
+        /** Channel the track was compiled with */
+        int channel;
+        
+        /** As returned by Track::addMidiEvents */
+        int length;
+        int firstNote;
+        
+        TrackExportInfo()
+        {
+            drum      = false;
+            channel   = 0;
+            length    = -1;
+            firstNote = -1;
+        }
+    };
+    
+    /**
+      * Compiles track 'n' of the sequence into MIDI track 'n+1'; the last item builds the tempo/meta
+      * track 0. All items write to distinct MIDITracks and only read from the sequence.
+      */
+    class TrackExportTask : public IParallelTask
+    {
+        Sequence* m_sequence;
+        std::vector<IMidiEventSink*>& m_tracks;
+        std::vector<TrackExportInfo>& m_info;
+        int m_track_amount;
+        int m_substract_ticks;
+        bool m_playing;
+        bool m_meta_ok;
+        
+    public:
+        
+        TrackExportTask(Sequence* sequence, std::vector<IMidiEventSink*>& tracks, std::vector<TrackExportInfo>& info,
+                        int trackAmount, int substract_ticks, bool playing) : m_tracks(tracks), m_info(info)
+        {
+            m_sequence        = sequence;
+            m_track_amount    = trackAmount;
+            m_substract_ticks = substract_ticks;
+            m_playing         = playing;
+            m_meta_ok         = false;
+        }
+        
+        virtual void execute(const int index)
+        {
+            TRACE_ZONE("makeJDKMidiSequence track");
+            if (index == m_track_amount)
+            {
+                m_meta_ok = addMetaEvents(m_sequence, m_tracks[0], m_substract_ticks, m_playing);
+                return;
+            }
+            
+            TrackExportInfo& info = m_info[index];
+            info.length = m_sequence->getTrack(index)->addMidiEvents(m_tracks[index+1], info.channel,
+                                                                     m_sequence->getMeasureData()->getFirstMeasure(),
+                                                                     false, info.firstNote);
+        }
+        
+        bool isMetaTrackOK() const { return m_meta_ok; }
+    };
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool AriaMaestosa::compileSequence(Sequence* sequence, std::vector<IMidiEventSink*>& tracks, bool selectionOnly,
+                                   /*out*/int* songLengthInTicks, /*out*/int* startTick,
+                                   /*out*/ int* numTracks, bool playing)
+{
+    int trackLength = -1;
+    int channel     = 0;
     
+    int substract_ticks;
+    const bool addMetronome = (sequence->playWithMetronome() and playing);
+    
+    MeasureData* md = sequence->getMeasureData();
+    
+    bool tooManyChannelsMessageShown = false;
+    
+    /** whether the tempo/meta track (track 0) was already built alongside the other tracks */
+    bool metaTrackDone = false;
+    
+    const int past_end_time = (playing and not sequence->isLoopEnabled() ? sequence->ticksPerQuarterNote()*4 : 0);
+    
+    if (selectionOnly)
+    {
+        //  ---- add events to tracks
+        trackLength = sequence->getCurrentTrack()->addMidiEvents(tracks[sequence->getCurrentTrackID() + 1],
+                                                                 channel,
+                                                                 md->getFirstMeasure(),
+                                                                 true,
+                                                                 *startTick );
+        
+        substract_ticks = *startTick;
+        
+        if (trackLength == -1) return false; // nothing to play in track (empty track - play nothing)
+        
+        if (sequence->isLoopEnabled())
+        {
+            // when looping, stop at the measure marked as loop end
+            *songLengthInTicks = md->lastTickInMeasure(md->getLoopEndMeasure()) - substract_ticks;
+        }
+        else
+        {
+            // Add some time at the end for notes to fade out
+            *songLengthInTicks = trackLength + sequence->ticksPerQuarterNote()*2;
+        }
+    }
+    else
+    {
+        // play from beginning
+        (*startTick) = -1;
+        
+        const int trackAmount = sequence->getTrackAmount();
+        const int firstTick = md->firstTickInMeasure(md->getFirstMeasure());
+        
+        // Tracks share no mutable state, so each is compiled into its own MIDITrack concurrently, along
+        // with the tempo/meta track. Channels are handed out in track order though, and a track that
+        // ends up producing nothing does not take one; so guess them from the 'played' state, and
+        // recompile (below) the rare tracks for which the guess turns out to be wrong.
+        std::vector<TrackExportInfo> info(trackAmount);
+        {
+            int guessedChannel = 0;
+            bool overflow = false;
+            for (int n=0; n<trackAmount; n++)
+            {
+                info[n].drum    = sequence->getTrack(n)->isNotationTypeEnabled(DRUM);
+                info[n].channel = (info[n].drum ? 9 : guessedChannel);
+                if (not info[n].drum and sequence->getTrack(n)->isPlayed())
+                {
+                    guessedChannel = nextAutoChannel(guessedChannel, sequence->getChannelManagementType(),
+                                                     &overflow);
+                }
+            }
+        }
+        
+        // tracks beyond what the multitrack can hold all go to track 1; these are appended serially below
+        const int parallelAmount = std::min(trackAmount, (int)tracks.size() - 1);
+        
+        TrackExportTask task(sequence, tracks, info, parallelAmount, firstTick, playing);
+        ThreadPool::getInstance()->parallelFor(parallelAmount + 1, &task);
+        
+        for (int n=0; n<trackAmount; n++)
+        {
+            const bool drum_track = info[n].drum;
+            const int  trackChannel = (drum_track ? 9 : channel);
+            
+            if (n < parallelAmount)
+            {
+                if (trackChannel != info[n].channel)
+                {
+                    tracks[n+1]->clear();
+                    info[n].firstNote = -1;
+                    info[n].length = sequence->getTrack(n)->addMidiEvents(tracks[n+1], trackChannel,
+                                                                          md->getFirstMeasure(), false,
+                                                                          info[n].firstNote);
+                }
+            }
+            else
+            {
+                showTooManyChannelsWarning(&tooManyChannelsMessageShown);
+                info[n].firstNote = -1;
+                info[n].length = sequence->getTrack(n)->addMidiEvents(tracks[1], trackChannel,
+                                                                      md->getFirstMeasure(), false,
+                                                                      info[n].firstNote);
+            }
+            
+            const int trackFirstNote = info[n].firstNote;
+            trackLength = info[n].length;
+            
+            if ((trackFirstNote<(*startTick) and trackFirstNote != -1) or (*startTick) == -1)
+            {
+                (*startTick) = trackFirstNote;
+            }
+            
+            
+            if (trackLength == -1) continue; // nothing to play in track (empty track - skip it)
+            if (trackLength > *songLengthInTicks) *songLengthInTicks = trackLength;
+            
+            if (not drum_track)
+            {
+                bool overflow = false;
+                channel = nextAutoChannel(channel, sequence->getChannelManagementType(), &overflow);
+                if (overflow) showTooManyChannelsWarning(&tooManyChannelsMessageShown);
+            }
+        }
+        
+        // the meta track was built assuming playback starts at the first measure; in the odd case
+        // where no track could confirm that, build it again from the actual start
+        metaTrackDone = (task.isMetaTrackOK() and *startTick == firstTick);
+        if (not metaTrackDone) tracks[0]->clear();
+        
+        if (sequence->isLoopEnabled())
+        {
+            // when looping, stop at the measure marked as loop end
+            *songLengthInTicks = md->lastTickInMeasure(md->getLoopEndMeasure()) - *startTick;
+        }
+        
+        substract_ticks = *startTick;
+        
+    }
+    
+    
+    if (*songLengthInTicks < 1)
+    {
+        // nothing to play at all (empty song - play nothing)
+        if (metaTrackDone) tracks[0]->clear();
+        return false;
+    }
+    *numTracks = sequence->getTrackAmount()+1;
+    
+    if (not metaTrackDone and not addMetaEvents(sequence, tracks[0], substract_ticks, playing)) return false;
     
     // ---- add dummy event after the actual end to ensure it doesn't stop playing too quickly
     // adds event way after actual stop point, to make sure song the midi player will reach the last actual note before stopping
@@ -727,9 +852,9 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         const int count = sequence->getTrackAmount();
         for (int n=0; n<count; n++)
         {
-            if (n+1 < tracks.GetNumTracks())
+            if (n+1 < (int)tracks.size())
             {
-                if (not tracks.GetTrack(n+1)->PutEvent( m ))
+                if (not tracks[n+1]->putEvent( m ))
                 {
                     std::cerr << "Error adding dummy end midi event!" << std::endl;
                 }
@@ -738,7 +863,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             {
                 std::cerr << "Too many tracks, expect unpredictable output" << std::endl;
 
-                if (not tracks.GetTrack(1)->PutEvent( m ))
+                if (not tracks[1]->putEvent( m ))
                 {
                     std::cerr << "Error adding dummy end midi event!" << std::endl;
                 }
@@ -803,7 +928,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             const int count = sequence->getTrackAmount();
             for (int n=0; n<count; n++)
             {
-                if (not tracks.GetTrack(n+1)->PutEvent( m ))
+                if (not tracks[n+1]->putEvent( m ))
                 {
                     std::cerr << "Error adding dummy end midi event!" << std::endl;
                 }
@@ -822,23 +947,15 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
         
         // FIXME: if the user adds lots of tracks, just using the last track here may not be safe.
         const int metronomeTrackId = sequence->getTrackAmount() + 1; //tracks.GetNumTracks() - 1;
-        jdksmidi::MIDITrack* metronomeTrack = tracks.GetTrack(metronomeTrackId);
+        IMidiEventSink* metronomeTrack = tracks[metronomeTrackId];
         
         *numTracks = *numTracks + 1;
         
         // set track name
         {
-            jdksmidi::MIDITimedBigMessage m;
-            m.SetText( 3 );
-            m.SetByte1( 3 );
-            
-            jdksmidi::MIDISystemExclusive sysex((unsigned char*)"Metronome",
-                                               strlen("Metronome")+1, strlen("Metronome")+1, false);
-            
-            m.CopySysEx( &sysex );
-            m.SetTime( 0 );
-            
-            if (not metronomeTrack->PutEvent( m ))
+            // the name is written with its terminating null
+            if (not metronomeTrack->putTextEvent(0, jdksmidi::META_TRACK_NAME, "Metronome",
+                                                 strlen("Metronome")+1))
             {
                 std::cout << "Error adding metronome track name event" << std::endl;
                 ASSERT(FALSE);
@@ -852,7 +969,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             m.SetTime( 0 );
             m.SetControlChange( channel, 7, 127 );
             
-            if (not metronomeTrack->PutEvent( m ))
+            if (not metronomeTrack->putEvent( m ))
             {
                 std::cerr << "Error adding metronome track volume event" << std::endl;
                 ASSERT(false);
@@ -888,7 +1005,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
             m.SetTime((int)tick);
             m.SetNoteOn( 9 /* channel */, metronomeInstrument, metronomeVolume );
             
-            if (not metronomeTrack->PutEvent( m ))
+            if (not metronomeTrack->putEvent( m ))
             {
                 std::cerr << "Error adding metronome midi event!" << std::endl;
             }
@@ -900,7 +1017,7 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
                 m2.SetTime((int)tick);
                 m2.SetNoteOn( 9 /* channel */, 81 /* triangle */, metronomeVolume );
                 
-                if (not metronomeTrack->PutEvent(m2))
+                if (not metronomeTrack->putEvent(m2))
                 {
                     std::cerr << "Error adding metronome midi event!" << std::endl;
                 }
@@ -914,35 +1031,64 @@ bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTr
 
 // ----------------------------------------------------------------------------------------------------------
 
-void AriaMaestosa::allocAsMidiBytes(Sequence* sequence, bool selectionOnly, /*out*/int* songlength,
-                                    /*out*/int* startTick, /*out*/char** midiSongData, /*out*/int* datalength,
-                                    bool playing)
+bool AriaMaestosa::makeJDKMidiSequence(Sequence* sequence, jdksmidi::MIDIMultiTrack& tracks, bool selectionOnly,
+                                       /*out*/int* songLengthInTicks, /*out*/int* startTick,
+                                       /*out*/ int* numTracks, bool playing)
 {
-    int numTracks = -1;
+    TRACE_ZONE("makeJDKMidiSequence");
+    tracks.SetClksPerBeat( sequence->ticksPerQuarterNote() );
     
-    jdksmidi::MIDIMultiTrack tracks;
+    ptr_vector<JDKTrackSink> sinks;
+    std::vector<IMidiEventSink*> trackSinks;
+    for (int n=0; n<tracks.GetNumTracks(); n++)
+    {
+        sinks.push_back( new JDKTrackSink(tracks.GetTrack(n)) );
+        trackSinks.push_back( sinks.get(n) );
+    }
     
-    makeJDKMidiSequence(sequence, tracks, selectionOnly, songlength, startTick, &numTracks, playing);
+    return compileSequence(sequence, trackSinks, selectionOnly, songLengthInTicks, startTick, numTracks, playing);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool AriaMaestosa::compileSequenceToSmf(Sequence* sequence, SmfWriter& writer, bool selectionOnly,
+                                        /*out*/int* songLengthInTicks, /*out*/int* startTick, bool playing)
+{
+    TRACE_ZONE("compileSequenceToSmf");
+    std::vector<IMidiEventSink*> trackSinks;
+    for (int n=0; n<writer.getTrackAmount(); n++)
+    {
+        trackSinks.push_back( writer.getTrack(n) );
+    }
     
-    // create the output stream
-    OwnerPtr<MidiToMemoryStream>  out_stream;
-    out_stream = new MidiToMemoryStream();
+    int numTracks = -1;
+    compileSequence(sequence, trackSinks, selectionOnly, songLengthInTicks, startTick, &numTracks, playing);
     
-    jdksmidi::MIDIFileWriteMultiTrack writer(
-                                            &tracks,
-                                            out_stream
-                                            );
+    // an empty song still makes a valid (empty) file
+    if (numTracks < 0) numTracks = 0;
+    
+    return writer.finish(numTracks);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void AriaMaestosa::allocAsMidiBytes(Sequence* sequence, bool selectionOnly, /*out*/int* songlength,
+                                    /*out*/int* startTick, /*out*/char** midiSongData, /*out*/int* datalength,
+                                    bool playing)
+{
+    // one more track than the sequence for the tempo track, and another for the metronome
+    SmfWriter writer(sequence->getTrackAmount() + 2, sequence->ticksPerQuarterNote());
     
     // write the output data
-    if ( !writer.Write( numTracks, sequence->ticksPerQuarterNote() ) )
+    if (not compileSequenceToSmf(sequence, writer, selectionOnly, songlength, startTick, playing))
     {
         fprintf( stderr, "[allocAsMidiBytes] Error writing midi file\n");
         return;
     }
     
-    (*midiSongData) = (char*)malloc(out_stream->getDataLength());
-    out_stream->storeMidiData( (*midiSongData) );
-    *datalength = out_stream->getDataLength();
+    *datalength = writer.getLength();
+    (*midiSongData) = (char*)malloc(*datalength);
+    writer.copyTo( (unsigned char*)(*midiSongData) );
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -1038,3 +1184,144 @@ int AriaMaestosa::getTimeAtTick(int tick, const Sequence* seq)
     return (int)round(song_duration);
 }
 
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( ParallelExportTest )
+{
+    OwnerPtr<Sequence> seq( makeSyntheticSequence(8, 500) );
+    
+    TestSequenceProvider provider(seq);
+    AriaMaestosa::setCurrentSequenceProvider(&provider);
+    
+    // avoid the "too many channels" dialog, we're only interested in the events
+    seq->setChannelManagementType(CHANNEL_MANUAL);
+    
+    ThreadPool* pool = ThreadPool::getInstance();
+    const bool wasEnabled = pool->isEnabled();
+    
+    jdksmidi::MIDIMultiTrack serialTracks;
+    int serialLength = -1, serialStart = -1, serialNumTracks = -1;
+    
+    pool->setEnabled(false);
+    const bool serialOK = makeJDKMidiSequence(seq, serialTracks, false, &serialLength, &serialStart,
+                                              &serialNumTracks, false);
+    
+    jdksmidi::MIDIMultiTrack parallelTracks;
+    int parallelLength = -1, parallelStart = -1, parallelNumTracks = -1;
+    
+    pool->setEnabled(true);
+    const bool parallelOK = makeJDKMidiSequence(seq, parallelTracks, false, &parallelLength, &parallelStart,
+                                                &parallelNumTracks, false);
+    pool->setEnabled(wasEnabled);
+    
+    AriaMaestosa::setCurrentSequenceProvider(NULL);
+    
+    require(serialOK and parallelOK, "Export succeeded");
+    require_e(parallelLength,    ==, serialLength,    "Song length is the same in both modes");
+    require_e(parallelStart,     ==, serialStart,     "Start tick is the same in both modes");
+    require_e(parallelNumTracks, ==, serialNumTracks, "Track amount is the same in both modes");
+    
+    requireSameMidiTracks(serialTracks, parallelTracks, serialNumTracks);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( MakeJDKMidiSequence )
+{
+    BenchmarkSong song(bench, 10);
+    song->setChannelManagementType(CHANNEL_MANUAL);
+    
+    while (bench.next())
+    {
+        jdksmidi::MIDIMultiTrack tracks;
+        int length = -1, start = -1, numTracks = -1;
+        bench.keep( makeJDKMidiSequence(song, tracks, false, &length, &start, &numTracks, false) );
+        
+        bench.pause(); // don't time the destruction of 'tracks'
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( MakeJDKMidiSequenceSerial )
+{
+    // same as above, without the thread pool, to see what compiling tracks concurrently brings
+    BenchmarkSong song(bench, 10);
+    song->setChannelManagementType(CHANNEL_MANUAL);
+    
+    ThreadPool* pool = ThreadPool::getInstance();
+    const bool wasEnabled = pool->isEnabled();
+    pool->setEnabled(false);
+    
+    while (bench.next())
+    {
+        jdksmidi::MIDIMultiTrack tracks;
+        int length = -1, start = -1, numTracks = -1;
+        bench.keep( makeJDKMidiSequence(song, tracks, false, &length, &start, &numTracks, false) );
+        
+        bench.pause(); // don't time the destruction of 'tracks'
+    }
+    
+    pool->setEnabled(wasEnabled);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( SmfExportTest )
+{
+    // midi bytes encoded straight from the tracks must be exactly what libjdkmidi writes for the same song
+    OwnerPtr<Sequence> seq( makeSyntheticSequence(8, 500) );
+    
+    TestSequenceProvider provider(seq);
+    AriaMaestosa::setCurrentSequenceProvider(&provider);
+    
+    seq->setChannelManagementType(CHANNEL_MANUAL);
+    
+    for (int pass=0; pass<2; pass++)
+    {
+        const bool playing = (pass == 1);
+        
+        jdksmidi::MIDIMultiTrack tracks;
+        int jdkLength = -1, jdkStart = -1, numTracks = -1;
+        makeJDKMidiSequence(seq, tracks, false, &jdkLength, &jdkStart, &numTracks, playing);
+        
+        MidiToMemoryStream stream;
+        jdksmidi::MIDIFileWriteMultiTrack writer(&tracks, &stream);
+        require(writer.Write(numTracks, seq->ticksPerQuarterNote()), "libjdkmidi could write the song");
+        
+        const int expectedLength = stream.getDataLength();
+        char* expected = stream.releaseMidiData();
+        
+        int length = -1, start = -1, dataLength = -1;
+        char* data = NULL;
+        allocAsMidiBytes(seq, false, &length, &start, &data, &dataLength, playing);
+        
+        require(data != NULL, "The song could be encoded");
+        require_e(length, ==, jdkLength, "Song length is the same with both writers");
+        require_e(start,  ==, jdkStart,  "Start tick is the same with both writers");
+        require_e(dataLength, ==, expectedLength, "Both writers produce files of the same size");
+        require(memcmp(data, expected, dataLength) == 0, "Both writers produce the same bytes");
+        
+        free(data);
+        free(expected);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( AllocAsMidiBytes )
+{
+    BenchmarkSong song(bench, 10);
+    song->setChannelManagementType(CHANNEL_MANUAL);
+    
+    while (bench.next())
+    {
+        int length = -1, start = -1, dataLength = -1;
+        char* data = NULL;
+        allocAsMidiBytes(song, false, &length, &start, &data, &dataLength, false);
+        
+        bench.keep(dataLength);
+        free(data);
+    }
+}
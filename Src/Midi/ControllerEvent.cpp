@@ -17,6 +17,7 @@
 #include "Midi/ControllerEvent.h"
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
+#include "ObjectPool.h"
 
 #include "irrXML/irrXML.h"
 
@@ -33,6 +34,34 @@ ControllerEvent::ControllerEvent(unsigned short controller, int tick, wxFloat64
 
 // ----------------------------------------------------------------------------------------------------------
 
+namespace ControllerEventPool
+{
+    typedef ObjectPool<sizeof(ControllerEvent)> Pool;
+    
+    /** Never deleted : events held by static objects may still be deleted while the program exits */
+    Pool& get()
+    {
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+}
+
+void* ControllerEvent::operator new(size_t size)
+{
+    if (size != sizeof(ControllerEvent)) return ::operator new(size);
+    return ControllerEventPool::get().allocate();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ControllerEvent::operator delete(void* event, size_t size)
+{
+    if (size != sizeof(ControllerEvent)) ::operator delete(event);
+    else                                 ControllerEventPool::get().release(event);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 void ControllerEvent::setTick(int i)
 {
     m_tick = i;
@@ -67,10 +96,10 @@ void ControllerEvent::saveToFile(wxFileOutputStream& fileout)
 bool ControllerEvent::readFromFile(irr::io::IrrXMLReader* xml)
 {
     // ---- read "type"
-    const char* type = xml->getAttributeValue("type");
-    if (type != NULL)
+    int type;
+    if (xml->getAttributeValueAsInt("type", type))
     {
-        m_controller = atoi(type);
+        m_controller = type;
     }
     else
     {
@@ -80,12 +109,7 @@ bool ControllerEvent::readFromFile(irr::io::IrrXMLReader* xml)
     }
 
     // ---- read "tick"
-    const char* tick_c = xml->getAttributeValue("tick");
-    if (tick_c != NULL)
-    {
-        m_tick = atoi(tick_c);
-    }
-    else
+    if (not xml->getAttributeValueAsInt("tick", m_tick))
     {
         m_tick = 0;
         std::cout << "Missing info from file: controller tick" << std::endl;
@@ -115,7 +139,7 @@ void TextEvent::saveToFile(wxFileOutputStream& fileout)
     writeData( wxT("  <controlevent type=\"") + to_wxString(m_controller) , fileout );
     writeData( wxT("\" tick=\"")              + to_wxString(m_tick)       , fileout );
     
-    wxString val = m_text.getModel()->getValue();
+    wxString val = m_text->getValue();
     val.Replace( wxT("\r\n"), wxT("\n") );
     val.Replace( wxT("\n"), wxT("&#xD;") );
     val.Replace( wxT("\r"), wxT("&#xD;") );
@@ -127,10 +151,10 @@ void TextEvent::saveToFile(wxFileOutputStream& fileout)
 bool TextEvent::readFromFile(irr::io::IrrXMLReader* xml)
 {
     // ---- read "type"
-    const char* type = xml->getAttributeValue("type");
-    if (type != NULL)
+    int type;
+    if (xml->getAttributeValueAsInt("type", type))
     {
-        m_controller = atoi(type);
+        m_controller = type;
     }
     else
     {
@@ -140,12 +164,7 @@ bool TextEvent::readFromFile(irr::io::IrrXMLReader* xml)
     }
     
     // ---- read "tick"
-    const char* tick_c = xml->getAttributeValue("tick");
-    if (tick_c != NULL)
-    {
-        m_tick = atoi(tick_c);
-    }
-    else
+    if (not xml->getAttributeValueAsInt("tick", m_tick))
     {
         m_tick = 0;
         std::cout << "Missing info from file: text event tick" << std::endl;
@@ -156,7 +175,7 @@ bool TextEvent::readFromFile(irr::io::IrrXMLReader* xml)
     const char* value_c = xml->getAttributeValue("value");
     if (value_c != NULL)
     {
-        m_text.getModel()->setValue(wxString(value_c, wxConvUTF8));
+        m_text->setValue(wxString(value_c, wxConvUTF8));
     }
     else
     {
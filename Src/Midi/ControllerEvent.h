@@ -18,8 +18,8 @@
 #define _ControllerEvent_
 
 #include "Utils.h"
-#include "Renderers/RenderAPI.h"
 #include <math.h>
+#include <wx/string.h>
 
 class wxFileOutputStream;
 // forward
@@ -67,6 +67,13 @@ namespace AriaMaestosa
         ControllerEvent(unsigned short controller, int tick, wxFloat64 value);
         virtual ~ControllerEvent() {}
         
+        /**
+          * Controller events are allocated from an ObjectPool rather than one by one from the heap
+          * (except subclasses, which are of another size)
+          */
+        static void* operator new(size_t size);
+        static void  operator delete(void* event, size_t size);
+        
         unsigned short getController() const { return m_controller; }
         int            getTick      () const { return m_tick;       }
         
@@ -146,29 +153,47 @@ namespace AriaMaestosa
         virtual bool readFromFile(irr::io::IrrXMLReader* xml);
     };
     
+    /**
+      * @brief whatever the GUI attaches to a text event to display it (the model knows nothing more)
+      * @ingroup midi
+      */
+    class ITextEventView
+    {
+    public:
+        virtual ~ITextEventView() {}
+    };
+    
     /** For now text events are stored like controller events, except they have a string and
       * not a numeric value
       */
     class TextEvent : public ControllerEvent
     {
-        AriaRenderString m_text;
+        OwnerPtr< Model<wxString> > m_text;
+        
+        /** declared after m_text so that it is destroyed first, since it may be listening to it */
+        OwnerPtr<ITextEventView> m_view;
         
     public:
         
         TextEvent(unsigned short controller, int tick, wxString text) :
                 ControllerEvent(controller, tick, -1),
-                m_text(new Model<wxString>(text), true)
+                m_text(new Model<wxString>(text))
         {
         }
         
         virtual ~TextEvent() {}
         
-        const AriaRenderString& getText() const { return m_text;                        }
-        AriaRenderString&       getText()       { return m_text;                        }
+        Model<wxString>* getTextModel()         { return m_text;              }
+        
+        const wxString getTextValue()     const { return m_text->getValue();  }
+        
+        void setText(const wxString& t)         { m_text->setValue( t );      }
         
-        const wxString getTextValue()     const { return m_text.getModel()->getValue(); }
+        /** @return the view attached with 'setView', or NULL */
+        ITextEventView* getView()               { return m_view;              }
         
-        void setText(const wxString& t)         { m_text.getModel()->setValue( t ); }
+        /** @brief attach a view to this event; the event takes ownership of it */
+        void setView(ITextEventView* view)      { m_view = view;              }
         
         // ---- serialization
         virtual void saveToFile(wxFileOutputStream& fileout);
@@ -20,6 +20,8 @@
 #include "Midi/Sequence.h"
 #include "Midi/Track.h"
 #include "Midi/TimeSigChange.h"
+#include "Benchmark.h"
+#include "UnitTestUtils.h"
 
 #include <iostream>
 #include "irrXML/irrXML.h"
@@ -159,7 +161,7 @@ void MeasureData::selectNotesInSelectedMeasures()
             const int note_tick = track->getNoteStartInMidiTicks(n);
             
             // note is within selection range? if so, select it, else unselect it.
-            track->selectNote(n, m_measure_info[measureAtTick(note_tick)].selected , true);
+            track->selectNote(n, m_measure_info[measureAtTick(note_tick)].selected);
         }
     }
 }
@@ -888,3 +890,31 @@ float MeasureData::getBeatSize(int numerator, int denominator) const
     return 4.0/(float)denominator;
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( MeasureAtTick )
+{
+    // one lookup per note, in a song that alternates between 4/4 and 3/4 every 16 measures
+    BenchmarkSong song(bench);
+    MeasureData* md = song->getMeasureData();
+    {
+        ScopedMeasureTransaction tr(md->startTransaction());
+        for (int measure=16; measure<md->getMeasureAmount(); measure += 16)
+        {
+            tr->addTimeSigChange(measure, (measure/16) % 2 == 1 ? 3 : 4, 4);
+        }
+    }
+    
+    Track* track = song->getTrack(0);
+    const int noteAmount = track->getNoteAmount();
+    
+    while (bench.next())
+    {
+        int checksum = 0;
+        for (int n=0; n<noteAmount; n++)
+        {
+            checksum += md->measureAtTick( track->getNoteStartInMidiTicks(n) );
+        }
+        bench.keep(checksum);
+    }
+}
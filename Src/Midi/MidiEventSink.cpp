@@ -0,0 +1,54 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "Midi/MidiEventSink.h"
+
+#include "jdksmidi/world.h"
+#include "jdksmidi/track.h"
+#include "jdksmidi/msg.h"
+
+using namespace AriaMaestosa;
+
+// ----------------------------------------------------------------------------------------------------------
+
+void JDKTrackSink::reserve(const int eventAmount)
+{
+    // the track array otherwise doubles its way up, moving every event each time
+    m_track->Reserve(m_track->GetNumEvents() + eventAmount);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool JDKTrackSink::putEvent(const jdksmidi::MIDITimedBigMessage& msg)
+{
+    return m_track->PutEvent(msg);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool JDKTrackSink::putTextEvent(const int time, const int metaType, const char* text, const int length)
+{
+    return m_track->PutTextEvent(time, metaType, text, length);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void JDKTrackSink::clear()
+{
+    m_track->Clear();
+}
+
+// ----------------------------------------------------------------------------------------------------------
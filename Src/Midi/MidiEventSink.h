@@ -0,0 +1,80 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __MIDI_EVENT_SINK_H__
+#define __MIDI_EVENT_SINK_H__
+
+namespace jdksmidi
+{
+    class MIDITimedBigMessage;
+    class MIDITrack;
+}
+
+namespace AriaMaestosa
+{
+
+    /**
+      * @brief receives the MIDI events of one track as they are compiled from an Aria track, in time order
+      *
+      * The message passed to 'putEvent' is only valid for the duration of the call; sinks that keep events
+      * around must copy (or encode) them.
+      * @ingroup midi
+      */
+    class IMidiEventSink
+    {
+    public:
+        virtual ~IMidiEventSink() {}
+
+        /** @brief hint that about 'eventAmount' more events are about to be put */
+        virtual void reserve(const int eventAmount) {}
+
+        /** @return false if the event could not be added */
+        virtual bool putEvent(const jdksmidi::MIDITimedBigMessage& msg) = 0;
+
+        /**
+          * @brief adds a text meta event (lyrics, copyright, names...) of 'length' bytes; the text is copied
+          *        once, straight to where the sink keeps it
+          * @return false if the event could not be added
+          */
+        virtual bool putTextEvent(const int time, const int metaType, const char* text, const int length) = 0;
+
+        /** @brief forget all events put so far */
+        virtual void clear() = 0;
+    };
+
+    /**
+      * @brief sink that stores events into a libjdkmidi track, for the libjdkmidi sequencer
+      * @ingroup midi
+      */
+    class JDKTrackSink : public IMidiEventSink
+    {
+        jdksmidi::MIDITrack* m_track;
+
+    public:
+
+        JDKTrackSink(jdksmidi::MIDITrack* track) : m_track(track)
+        {
+        }
+
+        virtual void reserve(const int eventAmount);
+        virtual bool putEvent(const jdksmidi::MIDITimedBigMessage& msg);
+        virtual bool putTextEvent(const int time, const int metaType, const char* text, const int length);
+        virtual void clear();
+    };
+
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include "Midi/Note.h"
 #include "Midi/Players/PlatformMidiManager.h"
 #include "Midi/Sequence.h"
+#include "ObjectPool.h"
 #include "Utils.h"
 #include "UnitTest.h"
 
@@ -59,6 +60,33 @@ Note::~Note()
 
 // ----------------------------------------------------------------------------------------------------------
 
+namespace NotePool
+{
+    typedef ObjectPool<sizeof(Note)> Pool;
+    
+    /** Never deleted : notes held by static objects may still be deleted while the program exits */
+    Pool& get()
+    {
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+}
+
+void* Note::operator new(size_t size)
+{
+    ASSERT_E(size, ==, sizeof(Note));
+    return NotePool::get().allocate();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Note::operator delete(void* note)
+{
+    NotePool::get().release(note);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 int Note::getString()
 {
     if (string == -1) findStringAndFretFromNote();
@@ -280,10 +308,12 @@ void Note::saveToFile(wxFileOutputStream& fileout)
 
 bool Note::readFromFile(irr::io::IrrXMLReader* xml)
 {
-    const char* pitch_c = xml->getAttributeValue("pitch");
-    if (pitch_c != NULL)
+    // numbers are parsed straight from the file text, notes being by far the most numerous elements
+    int value;
+    
+    if (xml->getAttributeValueAsInt("pitch", value))
     {
-        m_pitch_ID = atoi( pitch_c );
+        m_pitch_ID = value;
     }
     else
     {
@@ -292,44 +322,30 @@ bool Note::readFromFile(irr::io::IrrXMLReader* xml)
         return false;
     }
 
-    const char* start_c = xml->getAttributeValue("start");
-    if (start_c != NULL)
-    {
-        m_start_tick = atoi(start_c);
-    }
-    else
+    if (not xml->getAttributeValueAsInt("start", m_start_tick))
     {
         m_start_tick = 0;
         std::cerr << "ERROR: Missing info from file: note start" << std::endl;
         return false;
     }
 
-    const char* end_c = xml->getAttributeValue("end");
-    if (end_c != NULL)
-    {
-        m_end_tick = atoi(end_c);
-    }
-    else
+    if (not xml->getAttributeValueAsInt("end", m_end_tick))
     {
         m_end_tick = 0;
         std::cout << "ERROR: Missing info from file: note end" << std::endl;
         return false;
     }
 
-    const char* volume_c = xml->getAttributeValue("volume");
-    if (volume_c != NULL) m_volume = atoi(volume_c);
-    else                  m_volume = 80;
+    if (xml->getAttributeValueAsInt("volume", value)) m_volume = value;
+    else                                              m_volume = 80;
 
-    const char* accsign_c = xml->getAttributeValue("accidentalsign");
-    if (accsign_c != NULL) m_preferred_accidental_sign = atoi(accsign_c);
+    if (xml->getAttributeValueAsInt("accidentalsign", value)) m_preferred_accidental_sign = value;
 
-    const char* fret_c = xml->getAttributeValue("fret");
-    if (fret_c != NULL) fret = atoi(fret_c);
-    else                fret = -1;
+    if (xml->getAttributeValueAsInt("fret", value)) fret = value;
+    else                                            fret = -1;
 
-    const char* string_c = xml->getAttributeValue("string");
-    if (string_c!=NULL) string = atoi(string_c);
-    else                string = -1;
+    if (xml->getAttributeValueAsInt("string", value)) string = value;
+    else                                              string = -1;
 
     const char* selected_c = xml->getAttributeValue("selected");
     if (selected_c != NULL)
@@ -444,6 +460,32 @@ bool Note::findNoteName(const int pitchID, Note12* note_12, int* octave)
 }
 
 
+UNIT_TEST( TestNotePool )
+{
+    ObjectPool<sizeof(Note), 4> pool;
+    
+    void* objects[10];
+    for (int n=0; n<10; n++) objects[n] = pool.allocate();
+    
+    // the thread takes slots a slab (4 slots here) at a time
+    require_e(pool.getLiveCount(), ==, 12, "Allocations are counted, with the slots the thread keeps");
+    require_e(pool.getSlabCount(), ==, 3,  "Slabs are added as needed");
+    require((char*)objects[1] - (char*)objects[0] >= (int)sizeof(Note) and objects[1] > objects[0],
+            "Objects allocated in a row are next to each other");
+    
+    pool.release(objects[3]);
+    require(pool.allocate() == objects[3], "Released objects are reused");
+    
+    for (int n=0; n<10; n++) pool.release(objects[n]);
+    require_e(pool.getLiveCount(), ==, 4, "Past two batches, released slots go back to the pool");
+    
+    pool.releaseThreadCache();
+    require_e(pool.getLiveCount(), ==, 0, "Releases are counted");
+    require_e(pool.getSlabCount(), ==, 1, "Slabs are given back once the pool is empty");
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 UNIT_TEST( TestFindNoteName )
 {
     Note12 note;
@@ -167,6 +167,10 @@ namespace AriaMaestosa
         Note(Track* parent, const int pitchID=-1, const int startTick=-1, const int endTick=-1, const int volume=-1, const int string=-1, const int fret=-1); // guitar mode only
         ~Note();
         
+        /** Notes are allocated from an ObjectPool rather than one by one from the heap */
+        static void* operator new(size_t size);
+        static void  operator delete(void* note);
+        
         void setParent(Track* parent);
         Track* getParent() { return m_track; }
         
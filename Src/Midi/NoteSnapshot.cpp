@@ -0,0 +1,108 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "Midi/NoteSnapshot.h"
+#include "Midi/Note.h"
+#include "Midi/Sequence.h"
+#include "Midi/Track.h"
+
+#include "Benchmark.h"
+#include "UnitTest.h"
+#include "UnitTestUtils.h"
+
+using namespace AriaMaestosa;
+
+// ----------------------------------------------------------------------------------------------------------
+
+NoteValues::NoteValues(const Note& note)
+{
+    m_tick     = note.getTick();
+    m_end_tick = note.getEndTick();
+    m_pitch_ID = note.getPitchID();
+    m_volume   = note.getVolume();
+    m_string   = note.getStringConst();
+    m_fret     = note.getFretConst();
+    m_preferred_accidental_sign = note.getPreferredAccidentalSign();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+Note* NoteSnapshot::createNote(const int index, Track* parent) const
+{
+    ASSERT_E(index, >=, 0);
+    ASSERT_E(index, <, size());
+
+    const NoteValues& values = get(index);
+    Note* note = new Note(parent, values.m_pitch_ID, values.m_tick, values.m_end_tick, values.m_volume,
+                          values.m_string, values.m_fret);
+    note->setPreferredAccidentalSign(values.m_preferred_accidental_sign);
+    return note;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+namespace TestNoteSnapshot
+{
+    using namespace AriaMaestosa;
+
+    UNIT_TEST( NoteSnapshotTest )
+    {
+        const int count = 300;
+
+        NoteSnapshot snapshot;
+        for (int n=0; n<count; n++)
+        {
+            Note note(NULL, 40 + n%60, n*100, n*100 + 50, 80, -1, -1);
+            snapshot.add(note);
+        }
+        require_e(snapshot.size(), ==, count, "All notes were added");
+        require_e(snapshot.get(count-1).m_end_tick, ==, (count-1)*100 + 50, "Notes keep their values");
+
+        NoteSnapshot copy = snapshot;
+        snapshot.clear();
+        require_e(snapshot.size(), ==, 0, "The snapshot was cleared");
+        require_e(copy.size(), ==, count, "A copy outlives the original");
+
+        OwnerPtr<Note> note(copy.createNote(2, NULL));
+        require_e(note->getTick(), ==, 200, "Notes are created with the snapshot values");
+        require_e(note->getPitchID(), ==, 42, "Notes are created with the snapshot values");
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( SnapshotNotes )
+{
+    // what copying a large selection to the clipboard costs
+    BenchmarkSong song(bench, 16);
+
+    while (bench.next())
+    {
+        NoteSnapshot snapshot;
+        const int trackAmount = song->getTrackAmount();
+        for (int t=0; t<trackAmount; t++)
+        {
+            Track* track = song->getTrack(t);
+            const int noteAmount = track->getNoteAmount();
+            for (int n=0; n<noteAmount; n++) snapshot.add(*track->getNote(n));
+        }
+
+        bench.keep(snapshot.get(snapshot.size() - 1).m_tick);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef __NOTE_SNAPSHOT_H__
+#define __NOTE_SNAPSHOT_H__
+
+#include <vector>
+
+namespace AriaMaestosa
+{
+    class Note;
+    class Track;
+
+    /**
+      * @brief the values of a note, without its track, selection state or pool allocation
+      * @ingroup midi
+      */
+    struct NoteValues
+    {
+        int   m_tick;
+        int   m_end_tick;
+        short m_pitch_ID;
+        short m_volume;
+        short m_string;
+        short m_fret;
+        short m_preferred_accidental_sign;
+
+        NoteValues(const Note& note);
+    };
+
+    /**
+      * @brief a list of note values, e.g. the notes copied to the clipboard
+      * @ingroup midi
+      *
+      * Notes in a snapshot are plain values in one array : no Note object is allocated until
+      * createNote is called.
+      *
+      * Snapshots are not shared : copying one copies the values. Only the clipboard and
+      * DuplicateMeasures use them. Duplicate, DeleteSelected and the undo records keep (or move) the
+      * Note objects of the track themselves, and never hold a second copy that could be shared.
+      */
+    class NoteSnapshot
+    {
+        std::vector<NoteValues> m_values;
+
+    public:
+
+        void clear() { m_values.clear(); }
+
+        /** @brief appends the values of 'note' at the end of this snapshot */
+        void add(const Note& note) { m_values.push_back(NoteValues(note)); }
+
+        int size() const { return m_values.size(); }
+
+        const NoteValues& get(const int index) const { return m_values[index]; }
+
+        /**
+          * @brief creates a new note from the values at 'index'
+          * @return a new note, that the caller owns
+          */
+        Note* createNote(const int index, Track* parent) const;
+    };
+
+}
+
+#endif
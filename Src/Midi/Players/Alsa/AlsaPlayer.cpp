@@ -33,6 +33,7 @@
 #include "IO/MidiToMemoryStream.h"
 #include "IO/IOUtils.h"
 #include "Dialogs/WaitWindow.h"
+#include "Dialogs/FileDialog.h"
 
 #include <iostream>
 #include <pthread.h>
@@ -250,7 +251,7 @@ public:
         
         context = new MidiContext();
         
-        const bool launchFluidSynth = (PreferencesData::getInstance()->getBoolValue("launchFluidSynth", false));
+        const bool launchFluidSynth = (PreferencesData::getInstance()->getBoolValue(SETTING_KEY_LAUNCH_FLUIDSYNTH));
         
         if (not context->openDevice(launchFluidSynth))
         {
@@ -506,7 +507,7 @@ public:
                                                        wxSize(460, 200), wxDEFAULT_DIALOG_STYLE|wxRESIZE_BORDER|wxCLOSE_BOX)
         {
             PreferencesData* prefs = PreferencesData::getInstance();
-            g_export_engine = (AudioExportEngine)prefs->getIntValue(SETTING_ID_AUDIO_EXPORT_ENGINE);
+            g_export_engine = (AudioExportEngine)prefs->getIntValue(SETTING_KEY_AUDIO_EXPORT_ENGINE);
             g_fluisynth_soundfont = prefs->getValue(SETTING_ID_FLUIDSYNTH_SOUNDFONT_PATH);
             
             wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
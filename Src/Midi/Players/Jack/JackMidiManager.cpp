@@ -103,6 +103,8 @@ public:
 	void play(jdksmidi::MIDIMultiTrack* tracks, uint64_t frame = 0)
 	{
 		jdksmidi::MIDISequencer* tmp = new jdksmidi::MIDISequencer(tracks);
+		// the jack callback seeks on every cycle; it must not build anything itself
+		tmp->BuildCheckpoints();
 		{
 			ScopedLocker lock(&m_mutex);
 			std::swap(tmp, m_sequencer);
@@ -20,11 +20,12 @@
 #include "Actions/AddControlEvent.h"
 #include "Actions/Record.h"
 #include "Midi/Players/PlatformMidiManager.h"
+#include "PerformanceStats.h"
 #include "PreferencesData.h"
+#include "Tracer.h"
 #include "ptr_vector.h"
 #include "Utils.h"
 #include <wx/intl.h>
-#include <wx/msgdlg.h>
 
 #include "RtMidi.h"
 
@@ -39,7 +40,8 @@ PlatformMidiManager::PlatformMidiManager()
 {
     m_recording = false;
     m_record_action = NULL;
-    m_playthrough = PreferencesData::getInstance()->getBoolValue(SETTING_ID_PLAYTHROUGH, true);
+    m_record_queue_since = 0;
+    m_playthrough = PreferencesData::getInstance()->getBoolValue(SETTING_KEY_PLAYTHROUGH);
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -62,7 +64,7 @@ PlatformMidiManager* PlatformMidiManager::get()
     if (g_all_midi_managers == NULL)
     {
         // FIXME: instead of aborting, fire a no-op driver
-        wxMessageBox(_("Bad binary, no MIDI driver was compiled in!"));
+        showMessage(_("Bad binary, no MIDI driver was compiled in!"));
         fprintf(stderr, "Bad binary, no MIDI driver was compiled in!");
         exit(1);
     }
@@ -145,6 +147,8 @@ void PlatformMidiManager::recordCallback(double deltatime, std::vector<unsigned
                                          void *userData)
 {
     // ---- this function is invoked from a thread!!
+    TRACE_THREAD_NAME("midi input");
+    TRACE_ZONE("PlatformMidiManager::recordCallback");
     
     PlatformMidiManager* self = (PlatformMidiManager*)userData;
     
@@ -196,14 +200,13 @@ void PlatformMidiManager::recordCallback(double deltatime, std::vector<unsigned
                         
                         if (self->m_record_action != NULL)
                         {
-                            wxMutexLocker lock(self->m_record_action_queue_lock);
                             int channel = self->m_record_target->getChannel();
                             // TODO: remove 131 - value old crap
-                            self->m_record_action_queue.push_back(new Action::AddNote((channel == 9 ? value : 131 - value),
-                                                                                      n.m_note_on_tick,
-                                                                                      now_tick,
-                                                                                      n.m_velocity,
-                                                                                      false));
+                            self->queueRecordAction(new Action::AddNote((channel == 9 ? value : 131 - value),
+                                                                        n.m_note_on_tick,
+                                                                        now_tick,
+                                                                        n.m_velocity,
+                                                                        false));
                         }
                     }
                 }
@@ -220,9 +223,8 @@ void PlatformMidiManager::recordCallback(double deltatime, std::vector<unsigned
                 // FIXME: when is m_record_action null?
                 if (self->m_record_action != NULL)
                 {
-                    wxMutexLocker lock(self->m_record_action_queue_lock);
-                    self->m_record_action_queue.push_back(new Action::AddControlEvent(now_tick, val,
-                                                                                      PSEUDO_CONTROLLER_PITCH_BEND));
+                    self->queueRecordAction(new Action::AddControlEvent(now_tick, val,
+                                                                        PSEUDO_CONTROLLER_PITCH_BEND));
                 }
                 
                 // FIXME: we are in a thread, not all players may be thread-safe!!
@@ -234,10 +236,9 @@ void PlatformMidiManager::recordCallback(double deltatime, std::vector<unsigned
             case 0xB0:
                 if (self->m_record_action != NULL)
                 {
-                    wxMutexLocker lock(self->m_record_action_queue_lock);
-                    self->m_record_action_queue.push_back(new Action::AddControlEvent(now_tick,
-                                                                                      127 - value2 /* value */,
-                                                                                      value /* controller ID */));
+                    self->queueRecordAction(new Action::AddControlEvent(now_tick,
+                                                                        127 - value2 /* value */,
+                                                                        value /* controller ID */));
                 }
                 
                 // FIXME: we are in a thread, not all players may be thread-safe!!
@@ -263,6 +264,18 @@ void PlatformMidiManager::recordCallback(double deltatime, std::vector<unsigned
 
 // ----------------------------------------------------------------------------------------------------------
 
+void PlatformMidiManager::queueRecordAction(Action::SingleTrackAction* action)
+{
+    wxMutexLocker lock(m_record_action_queue_lock);
+    if (m_record_action_queue.size() == 0 and PerformanceStats::isEnabled())
+    {
+        m_record_queue_since = PerformanceStats::now();
+    }
+    m_record_action_queue.push_back(action);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 void PlatformMidiManager::processRecordQueue()
 {
     if (m_record_action == NULL) return;
@@ -275,6 +288,11 @@ void PlatformMidiManager::processRecordQueue()
         m_record_action->action(m_record_action_queue.get(n));
     }
     m_record_action_queue.clearWithoutDeleting();
+    
+    if (count > 0 and PerformanceStats::isEnabled())
+    {
+        PerformanceStats::add(PerformanceStats::RECORD_LATENCY, PerformanceStats::now() - m_record_queue_since);
+    }
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -288,7 +306,7 @@ bool PlatformMidiManager::startRecording(wxString outputPort, Track* target)
     unsigned int nPorts = m_midi_input->getPortCount();
     if (nPorts == 0)
     {
-        wxMessageBox(_("Sorry, no MIDI input port is available"));
+        showMessage(_("Sorry, no MIDI input port is available"));
         return false;
     }
     
@@ -316,7 +334,7 @@ bool PlatformMidiManager::startRecording(wxString outputPort, Track* target)
     
     if (portId == -1)
     {
-        wxMessageBox( _("Sorry, failed to open the selected MIDI input port") );
+        showMessage( _("Sorry, failed to open the selected MIDI input port") );
         return false;
     }
     
@@ -335,8 +353,8 @@ bool PlatformMidiManager::startRecording(wxString outputPort, Track* target)
         m_recording = false;
         delete m_midi_input;
         m_midi_input = NULL;
-        wxMessageBox( wxString(_("Sorry, failed to open the selected MIDI input port")) + wxT("\n") +
-                      wxString(e.what(), wxConvUTF8) );
+        showMessage( wxString(_("Sorry, failed to open the selected MIDI input port")) + wxT("\n") +
+                     wxString(e.what(), wxConvUTF8) );
         return false;
     }
     // Set our callback function.  This should be done immediately after
@@ -95,6 +95,12 @@ namespace AriaMaestosa
         
         wxMutex m_record_action_queue_lock;
         
+        /** When the oldest action of m_record_action_queue was received (see PerformanceStats::now) */
+        long long m_record_queue_since;
+        
+        /** @brief adds an action to m_record_action_queue; called from the MIDI input thread */
+        void queueRecordAction(Action::SingleTrackAction* action);
+        
     public:
         
         DECLARE_MAGIC_NUMBER();
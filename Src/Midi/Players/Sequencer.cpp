@@ -21,6 +21,8 @@
 #include "Midi/CommonMidiUtils.h"
 #include "Midi/Sequence.h"
 #include "Midi/Players/PlatformMidiManager.h"
+#include "PerformanceStats.h"
+#include "Tracer.h"
 
 #include "jdksmidi/world.h"
 #include "jdksmidi/multitrack.h"
@@ -181,6 +183,8 @@ void AriaSequenceTimer::run(jdksmidi::MIDISequencer* jdksequencer, const int son
         return;
     }
     //std::cout << "  * AriaSequenceTimer::run" << std::endl;
+    TRACE_THREAD_NAME("sequencer");
+    TRACE_ZONE("AriaSequenceTimer::run");
 
     //std::cout << "trying to play " << seq->suggestFileName().mb_str() << std::endl;
 
@@ -228,6 +232,15 @@ void AriaSequenceTimer::run(jdksmidi::MIDISequencer* jdksequencer, const int son
         // process all events that need to be done by the current tick
         while (next_event_time <= total_millis)
         {
+            TRACE_ZONE("AriaSequenceTimer::event");
+            
+            if (PerformanceStats::isEnabled())
+            {
+                // how late the event goes out compared to when it should have (at the timer's
+                // millisecond resolution)
+                PerformanceStats::add(PerformanceStats::PLAYBACK_LATENCY,
+                                      (long long)((timer->get_elapsed_millis() - next_event_time)*1000));
+            }
             if (not jdksequencer->GetNextEvent( &ev_track, &ev ))
             {
                 if (not PlatformMidiManager::get()->isRecording() and not m_seq->isLoopEnabled())
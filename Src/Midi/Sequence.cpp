@@ -22,27 +22,22 @@ const int CURRENT_FILE_VERSION = 4;
 #include "AriaCore.h"
 
 #include "Actions/EditAction.h"
-#include "Actions/Paste.h"
 #include "Actions/Record.h"
 #include "Actions/ScaleTrack.h"
 #include "Actions/ScaleSong.h"
 #include "Actions/SnapNotesToGrid.h"
 
 // FIXME(DESIGN) : data classes shouldn't refer to GUI classes
-#include "Dialogs/WaitWindow.h"
 
 #include "IO/IOUtils.h"
 #include "Midi/CommonMidiUtils.h"
 #include "Midi/MeasureData.h"
 #include "Midi/Players/PlatformMidiManager.h"
 #include "Midi/Track.h"
-#include "GUI/GraphicalTrack.h"
 #include "PreferencesData.h"
 #include "Utils.h"
 
 #include <wx/intl.h>
-#include <wx/utils.h>
-#include <wx/msgdlg.h>
 #include "irrXML/irrXML.h"
 
 using namespace AriaMaestosa;
@@ -58,7 +53,7 @@ Sequence::Sequence(IPlaybackModeListener* playbackListener, IActionStackListener
     m_tempo                     = 120;
     m_importing                 = false;
     m_loop_enabled              = false;
-    m_follow_playback           = PreferencesData::getInstance()->getBoolValue("followPlayback", false);
+    m_follow_playback           = PreferencesData::getInstance()->getBoolValue(SETTING_KEY_FOLLOW_PLAYBACK);
     m_playback_listener         = playbackListener;
     m_action_stack_listener     = actionStackListener;
     m_seq_data_listener         = sequenceDataListener;
@@ -471,6 +466,7 @@ void Sequence::action( Action::MultiTrackAction* actionObj)
     addToUndoStack( actionObj );
     actionObj->setParentSequence(this, new SequenceVisitor(this));
     actionObj->perform();
+    for (int n=0; n<tracks.size(); n++) tracks[n].notesChanged();
     
     if (m_action_stack_listener != NULL) m_action_stack_listener->onActionStackChanged();
     
@@ -500,24 +496,23 @@ void Sequence::addToUndoStack( Action::EditAction* actionObj )
 
 // ----------------------------------------------------------------------------------------------------------
 
-void Sequence::undo()
+bool Sequence::undo()
 {
     if (undoStack.size() < 1)
     {
         // nothing to undo
-        wxBell();
-        return;
+        return false;
     }
 
     Action::EditAction* lastAction = undoStack.get( undoStack.size() - 1 );
     if (not lastAction->canUndoNow())
     {
-        wxBell();
-        return;
+        return false;
     }
     
     lastAction->undo();
     undoStack.erase( undoStack.size() - 1 );
+    for (int n=0; n<tracks.size(); n++) tracks[n].notesChanged();
 
     if (m_seq_data_listener != NULL) m_seq_data_listener->onSequenceDataChanged();
     
@@ -705,49 +700,6 @@ void Sequence::setCurrentTrack(Track* track)
 #pragma mark Playback
 #endif
 
-// FIXME: I doubt this method goes here. Sequence is primarly a data class.
-// and MainFrame handles the rest of playback start/stop, why have SOME of it here???
-void Sequence::spacePressed()
-{
-    if (not PlatformMidiManager::get()->isPlaying() and not PlatformMidiManager::get()->isRecording())
-    {
-        if (isPlaybackMode())
-        {
-            return;
-        }
-
-        if (m_playback_listener != NULL) m_playback_listener->onEnterPlaybackMode();
-
-        int startTick = -1;
-        bool success = PlatformMidiManager::get()->playSelected(this, &startTick);
-        setPlaybackStartTick( startTick );
-
-        // FIXME: there's MainFrame::playback_mode AND MainPane::enterPlayLoop/exitPlayLoop. Fix this MESS
-        if (not success or startTick == -1) // failure
-        {
-            Display::exitPlayLoop();
-        }
-        else
-        {
-            Display::enterPlayLoop();
-        }
-
-    }
-    else
-    {
-        if (m_playback_listener != NULL) m_playback_listener->onLeavePlaybackMode();
-
-        PlatformMidiManager* midi = PlatformMidiManager::get();
-        if (midi->isRecording()) midi->stopRecording();
-        midi->stop();
-        
-        if (m_seq_data_listener != NULL) m_seq_data_listener->onSequenceDataChanged();
-    }
-
-}
-
-// --------------------------------------------------------------------------------------------------
-
 void Sequence::setPlaybackStartTick(int newValue)
 {
     m_playback_start_tick = newValue;
@@ -762,12 +714,6 @@ void Sequence::setPlaybackStartTick(int newValue)
 #pragma mark Copy/Paste
 #endif
 
-void Sequence::copy()
-{
-    tracks[currentTrack].copy();
-}
-
-// ----------------------------------------------------------------------------------------------------------
 /*
 void Sequence::paste()
 {
@@ -792,7 +738,7 @@ void Sequence::pasteAtMouse()
 #pragma mark I/O
 #endif
 
-void Sequence::saveToFile(wxFileOutputStream& fileout)
+void Sequence::saveToFile(wxFileOutputStream& fileout, ISequenceView* view)
 {
 
     writeData(wxT("<sequence"), fileout );
@@ -852,7 +798,7 @@ void Sequence::saveToFile(wxFileOutputStream& fileout)
     // ---- tracks
     for (int n=0; n<tracks.size(); n++)
     {
-        tracks[n].saveToFile(fileout);
+        tracks[n].saveToFile(fileout, view == NULL ? NULL : view->getTrackView(tracks.get(n)));
     }
     
     writeData(wxT("</sequence>"), fileout );
@@ -862,7 +808,7 @@ void Sequence::saveToFile(wxFileOutputStream& fileout)
 
 // ----------------------------------------------------------------------------------------------------------
 
-bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
+bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, ISequenceView* view)
 {
     m_importing = true;
     
@@ -900,10 +846,9 @@ bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
         if (fileFormatVersion != NULL)
         {
             fileversion = atoi( (char*)fileFormatVersion );
-            if (fileversion > CURRENT_FILE_VERSION )
+            if (fileversion > CURRENT_FILE_VERSION)
             {
-                if (WaitWindow::isShown()) WaitWindow::hide();
-                wxMessageBox( _("Warning : you are opening a file saved with a version of\nAria Maestosa more recent than the version you currently have.\nIt may not open correctly.") );
+                showMessage( _("Warning : you are opening a file saved with a version of\nAria Maestosa more recent than the version you currently have.\nIt may not open correctly.") );
             }
         }
         const char* measureAmount_c = xml->getAttributeValue("measureAmount");
@@ -1045,7 +990,10 @@ bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                         Track* newTrack = new Track(this);
                         addTrack( newTrack );
                         
-                        if (not newTrack->readFromFile(xml, gseq)) return false;
+                        if (not newTrack->readFromFile(xml, view == NULL ? NULL : view->getTrackView(newTrack)))
+                        {
+                            return false;
+                        }
                     }
                     
                     // ---------- copyright ------
@@ -1157,8 +1105,6 @@ bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
     m_importing = false;
     if (m_seq_data_listener != NULL) m_seq_data_listener->onSequenceDataChanged();
 
-    parseBackgroundTracks();
-    
     updateTrackPlayingStatus();
 
     ASSERT(invariant());
@@ -1167,22 +1113,6 @@ bool Sequence::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
 
 }
 
-void Sequence::parseBackgroundTracks()
-{
-    GraphicalTrack* graphicalTrack;
- 
-    for (int n=0; n<tracks.size(); n++)
-    {
-        graphicalTrack = tracks[n].getGraphics();
-        graphicalTrack->getEditorFor(SCORE)->addBackgroundTracks();
-        graphicalTrack->getEditorFor(GUITAR)->addBackgroundTracks();
-        graphicalTrack->getEditorFor(DRUM)->addBackgroundTracks();
-        graphicalTrack->getEditorFor(KEYBOARD)->addBackgroundTracks();
-        graphicalTrack->getEditorFor(CONTROLLER)->addBackgroundTracks();
-    }
-}
-
-
 bool Sequence::invariant()
 {
     if (m_tempo_events.size() > 1)
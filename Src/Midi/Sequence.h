@@ -86,6 +86,19 @@ namespace AriaMaestosa
         virtual void onTrackAdded(Track* t) = 0;
         virtual void onTrackRemoved(Track* t) = 0;
     };
+    
+    /**
+      * @brief Interface for the view of a sequence, so that what it needs saved in .aria files can be
+      *        saved and read along with the sequence (the GUI implements it; without a GUI, there is none)
+      */
+    class ISequenceView
+    {
+    public:
+        virtual ~ISequenceView() {}
+        
+        /** @return the view of the given track of this sequence */
+        virtual ITrackView* getTrackView(Track* track) = 0;
+    };
 
     class SequenceVisitor;
     
@@ -108,8 +121,6 @@ namespace AriaMaestosa
          */
         void  addTempoEvent_import( ControllerEvent* evt );
         
-        void parseBackgroundTracks();
-        
         int m_tempo;
         int m_quarterNoteResolution;
 
@@ -133,8 +144,6 @@ namespace AriaMaestosa
         /** Whether a metronome should be heard during playback */
         bool m_play_with_metronome;
         
-        void copy();
-        
         // TODO: get rif of friendship?
         friend class GraphicalSequence;
         friend class Action::AddControllerSlide;
@@ -236,8 +245,11 @@ namespace AriaMaestosa
             return undoStack.get(undoStack.size() - 1);
         }
         
-        /** @brief undo the Action at the top of the undo stack */
-        void undo();
+        /**
+          * @brief undo the Action at the top of the undo stack
+          * @return false if there was nothing that could be undone
+          */
+        bool undo();
         
         /** @return the name of the Action at the top of the undo stack */
         wxString getTopActionName() const;
@@ -254,8 +266,6 @@ namespace AriaMaestosa
         wxString suggestFileName() const;
         wxString suggestTitle() const;
         
-        void spacePressed();
-        
         /** @return the number of tracks in this sequence */
         int getTrackAmount() const { return tracks.size(); }
         
@@ -447,11 +457,17 @@ namespace AriaMaestosa
         
         // ---- serialization
         
-        /** Called when saving \<Sequence\> ... \</Sequence\> in .aria file */
-        void saveToFile(wxFileOutputStream& fileout);
+        /**
+          * Called when saving \<Sequence\> ... \</Sequence\> in .aria file.
+          * @param view the view of this sequence, or NULL when saving without a GUI
+          */
+        void saveToFile(wxFileOutputStream& fileout, ISequenceView* view);
         
-        /** Called when reading \<sequence\> ... \</sequence\> in .aria file */
-        bool readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq);
+        /**
+          * Called when reading \<sequence\> ... \</sequence\> in .aria file.
+          * @param view the view of this sequence, or NULL when loading without a GUI
+          */
+        bool readFromFile(irr::io::IrrXMLReader* xml, ISequenceView* view);
 
     };
     
@@ -15,33 +15,29 @@
  */
 
 #include "Utils.h"
-#include "Clipboard.h"
 #include "AriaCore.h"
 
 #include "Actions/EditAction.h"
 #include "Actions/UpdateGuitarTuning.h"
 
-// FIXME(DESIGN) : data classes shouldn't refer to GUI classes
-#include "GUI/GraphicalTrack.h"
-#include "GUI/MainFrame.h"
-#include "Editors/ControllerEditor.h"
-#include "Editors/DrumEditor.h"
-
 #include "IO/IOUtils.h"
 #include "Midi/Track.h"
 #include "Midi/Sequence.h"
 #include "Midi/ControllerEvent.h"
 #include "Midi/DrumChoice.h"
 #include "Midi/MeasureData.h"
+#include "Midi/MidiEventSink.h"
 #include "PreferencesData.h"
+#include "Benchmark.h"
+#include "UnitTestUtils.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "jdksmidi/world.h"
 #include "jdksmidi/track.h"
 
 #include <wx/intl.h>
-#include <wx/utils.h>
 #include "irrXML/irrXML.h"
 #include <wx/stopwatch.h>
 
@@ -58,6 +54,7 @@ Track::Track(Sequence* sequence)
 
     m_magnetic_grid = new MagneticGrid();
     
+    m_notes_revision = 0;
     m_volume = 100;
     m_muted = false;
     m_soloed = false;
@@ -69,7 +66,7 @@ Track::Track(Sequence* sequence)
     }
 
     // set default editor
-    switch (PreferencesData::getInstance()->getIntValue(SETTING_ID_DEFAULT_EDITOR))
+    switch (PreferencesData::getInstance()->getIntValue(SETTING_KEY_DEFAULT_EDITOR))
     {
         case 2:
             m_editor_mode[GUITAR] = true;
@@ -151,24 +148,13 @@ void Track::action( Action::SingleTrackAction* actionObj)
     actionObj->setParentTrack(this, new TrackVisitor(this));
     m_sequence->addToUndoStack( actionObj );
     actionObj->perform();
+    notesChanged();
     
     ASSERT(m_sequence->invariant());
 }
 
 // ----------------------------------------------------------------------------------------------------------
 
-GraphicalTrack* Track::getGraphics()
-{
-    return getMainFrame()->getCurrentGraphicalSequence()->getGraphicsFor(this);
-}
-
-// ----------------------------------------------------------------------------------------------------------
-
-const GraphicalTrack* Track::getGraphics() const
-{
-    return getMainFrame()->getCurrentGraphicalSequence()->getGraphicsFor(this);
-}
-
 
 // =======================================================================================================
 // ======================================= Add/Remove Notes ==============================================
@@ -182,6 +168,8 @@ const GraphicalTrack* Track::getGraphics() const
 
 bool Track::addNote(Note* note, bool check_for_overlapping_notes)
 {
+    notesChanged();
+
     // if we're importing, just push it to the end, we know they're in time order
     if (m_sequence->isImportMode())
     {
@@ -330,6 +318,7 @@ void Track::setNoteEnd_import(const int tick, const int noteID)
     ASSERT_E(noteID,>=,0);
 
     m_notes[noteID].setEndTick(tick);
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -349,7 +338,7 @@ void Track::removeNote(const int id)
     }
 
     m_notes.erase(id);
-
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -376,6 +365,7 @@ void Track::markNoteToBeRemoved(const int id)
     }
 
     m_notes.markToBeRemoved(id);
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -387,6 +377,7 @@ void Track::removeMarkedNotes()
 
     m_notes.removeMarked();
     m_note_off.removeMarked();
+    notesChanged();
 
 #ifdef _MORE_DEBUG_CHECKS
     if (m_notes.size() != m_note_off.size())
@@ -407,6 +398,7 @@ int getNoteTick(Note* note)
 void Track::reorderNoteVector()
 {
     m_notes.insertionSort(getNoteTick);
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -423,9 +415,174 @@ void Track::reorderNoteOffVector()
 
 // ----------------------------------------------------------------------------------------------------------
 
+namespace ShiftEventsHelpers
+{
+    bool noteStartsBefore(const Note* a, const Note* b)
+    {
+        return a->getTick() < b->getTick();
+    }
+
+    bool noteEndsBefore(const Note* a, const Note* b)
+    {
+        return a->getEndTick() < b->getEndTick();
+    }
+
+    bool eventComesBefore(const ControllerEvent* a, const ControllerEvent* b)
+    {
+        return a->getTick() < b->getTick();
+    }
+
+    /** @return the index of the first note of 'notes' (sorted by start) that starts after 'tick' */
+    int firstNoteAfter(const std::vector<Note*>& notes, const int tick)
+    {
+        int from = 0;
+        int to   = notes.size();
+        while (from < to)
+        {
+            const int middle = (from + to) / 2;
+            if (notes[middle]->getTick() > tick) to = middle;
+            else                                 from = middle + 1;
+        }
+        return from;
+    }
+}
+
+using namespace ShiftEventsHelpers;
+
 void Track::reorderControlVector()
 {
-    m_control_events.insertionSort();
+    // imported events come in time order per controller, but one controller after the other; a stable
+    // sort puts them together in n log n (and keeps events at the same tick in the order they were added)
+    std::vector<ControllerEvent*>& events = m_control_events.contentsVector;
+    std::stable_sort(events.begin(), events.end(), eventComesBefore);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Track::shiftEventsAfter(const int afterTick, const int amountInTicks)
+{
+    if (amountInTicks == 0) return;
+
+    // the note offs of notes that will move stay in order, and so do those of notes that won't;
+    // once the notes are moved, the two only need to be merged back together
+    std::vector<Note*>& noteOff = m_note_off.contentsVector;
+    std::vector<Note*> staying;
+    std::vector<Note*> moved;
+    staying.reserve(noteOff.size());
+    moved.reserve(noteOff.size());
+    const int noteOffAmount = noteOff.size();
+    for (int n=0; n<noteOffAmount; n++)
+    {
+        if (noteOff[n]->getTick() > afterTick) moved.push_back(noteOff[n]);
+        else                                   staying.push_back(noteOff[n]);
+    }
+
+    // moving all notes that start after a given tick by the same amount keeps them in order :
+    // only the moved part needs to be visited
+    std::vector<Note*>& notes = m_notes.contentsVector;
+    const int noteAmount = notes.size();
+    for (int n=firstNoteAfter(notes, afterTick); n<noteAmount; n++)
+    {
+        notes[n]->setTick(notes[n]->getTick() + amountInTicks);
+        notes[n]->setEndTick(notes[n]->getEndTick() + amountInTicks);
+    }
+
+    std::merge(staying.begin(), staying.end(), moved.begin(), moved.end(), noteOff.begin(), noteEndsBefore);
+
+    // control events of different controllers are not always kept in time order with each other
+    // (see 'addControlEvent_import'), so don't rely on it here
+    std::vector<ControllerEvent*>& events = m_control_events.contentsVector;
+    const int eventAmount = events.size();
+    for (int n=0; n<eventAmount; n++)
+    {
+        if (events[n]->getTick() > afterTick) events[n]->setTick(events[n]->getTick() + amountInTicks);
+    }
+
+    notesChanged();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Track::extractEventsInRange(const int fromTick, const int toTick, ptr_vector<Note>& notes,
+                                 ptr_vector<ControllerEvent>& controlEvents)
+{
+    // notes are sorted by start, so the ones to remove are all next to each other
+    std::vector<Note*>& allNotes = m_notes.contentsVector;
+    const int firstNote = firstNoteAfter(allNotes, fromTick);
+    const int lastNote  = firstNoteAfter(allNotes, toTick - 1);
+
+    if (lastNote > firstNote)
+    {
+        notes.contentsVector.insert(notes.contentsVector.end(), allNotes.begin() + firstNote,
+                                    allNotes.begin() + lastNote);
+        allNotes.erase(allNotes.begin() + firstNote, allNotes.begin() + lastNote);
+
+        std::vector<Note*>& noteOff = m_note_off.contentsVector;
+        int keptNoteOffs = 0;
+        const int noteOffAmount = noteOff.size();
+        for (int n=0; n<noteOffAmount; n++)
+        {
+            const int tick = noteOff[n]->getTick();
+            if (tick <= fromTick or tick >= toTick) noteOff[keptNoteOffs++] = noteOff[n];
+        }
+        noteOff.resize(keptNoteOffs);
+    }
+
+    std::vector<ControllerEvent*>& allEvents = m_control_events.contentsVector;
+    int kept = 0;
+    const int eventAmount = allEvents.size();
+    for (int n=0; n<eventAmount; n++)
+    {
+        const int tick = allEvents[n]->getTick();
+        if (tick <= fromTick or tick >= toTick) allEvents[kept++] = allEvents[n];
+        else                                    controlEvents.push_back(allEvents[n]);
+    }
+    allEvents.resize(kept);
+
+    notesChanged();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Track::insertEventBlock(ptr_vector<Note>& notes, ptr_vector<ControllerEvent>& controlEvents)
+{
+    // both sides are in time order, so one merge puts everything in place
+    std::vector<Note*>& blockNotes = notes.contentsVector;
+    if (not blockNotes.empty())
+    {
+        std::vector<Note*>& allNotes = m_notes.contentsVector;
+        std::vector<Note*> merged(allNotes.size() + blockNotes.size());
+        std::merge(allNotes.begin(), allNotes.end(), blockNotes.begin(), blockNotes.end(), merged.begin(),
+                   noteStartsBefore);
+        allNotes.swap(merged);
+
+        std::vector<Note*> blockNoteOff(blockNotes);
+        std::stable_sort(blockNoteOff.begin(), blockNoteOff.end(), noteEndsBefore);
+
+        std::vector<Note*>& noteOff = m_note_off.contentsVector;
+        merged.resize(noteOff.size() + blockNoteOff.size());
+        std::merge(noteOff.begin(), noteOff.end(), blockNoteOff.begin(), blockNoteOff.end(), merged.begin(),
+                   noteEndsBefore);
+        noteOff.swap(merged);
+
+        // the track owns them again
+        notes.clearWithoutDeleting();
+    }
+
+    // control events of different controllers are not always in time order with each other (see
+    // 'addControlEvent_import'), so they can't be merged; the block is appended and everything is sorted
+    // once. The sort is stable : at the same tick, the track's events stay before the block's.
+    std::vector<ControllerEvent*>& blockEvents = controlEvents.contentsVector;
+    if (not blockEvents.empty())
+    {
+        std::vector<ControllerEvent*>& allEvents = m_control_events.contentsVector;
+        allEvents.insert(allEvents.end(), blockEvents.begin(), blockEvents.end());
+        std::stable_sort(allEvents.begin(), allEvents.end(), eventComesBefore);
+
+        controlEvents.clearWithoutDeleting();
+    }
+
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -503,6 +660,21 @@ int Track::getNoteEndInMidiTicks(const int id) const
 
 // ----------------------------------------------------------------------------------------------------------
 
+void Track::getNoteTicks(const int firstNote, const int count, int* startTicks, int* endTicks) const
+{
+    ASSERT_E(firstNote,>=,0);
+    ASSERT_E(firstNote + count,<=,m_notes.size());
+
+    for (int n=0; n<count; n++)
+    {
+        const Note& note = m_notes[firstNote + n];
+        startTicks[n] = note.getTick();
+        endTicks[n]   = note.getEndTick();
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
 int Track::getNotePitchID(const int id) const
 {
     ASSERT_E(id,>=,0);
@@ -692,59 +864,25 @@ int Track::getFirstSelectedNote() const
 
 // ----------------------------------------------------------------------------------------------------------
 
-void Track::selectNote(const int id, const bool selected, bool ignoreModifiers)
+void Track::selectNote(const int id, const bool selected)
 {
     ASSERT(id != SELECTED_NOTES); // not supported in this function
 
-    if (not ignoreModifiers and not Display::isSelectMorePressed() and
-        not Display::isSelectLessPressed())
-    {
-        ignoreModifiers = true; // if no modifier is pressed, don't do any special checks
-    }
-
     // ---- select/deselect all notes
     if (id == ALL_NOTES)
     {
-        // FIXME: controller ediors checks don't belong here
-        /*
-        if (m_editor_mode != CONTROLLER)
+        const int count = m_notes.size();
+        for (int n=0; n<count; n++)
         {
-         */
-
-            if (ignoreModifiers)
-            {
-                const int count = m_notes.size();
-                for (int n=0; n<count; n++)
-                {
-                    m_notes[n].setSelected(selected);
-                }//next
-            }//end if
-
-        /*
-        }// end if
-         */
+            m_notes[n].setSelected(selected);
+        }//next
     }
     else  // ---- select/deselect one specific note
     {
-
         ASSERT_E(id,>=,0);
         ASSERT_E(id,<,m_notes.size());
 
-        // if we ignore +/- key modifiers, just set the value right away
-        if (ignoreModifiers)
-        {
-            m_notes[id].setSelected(selected);
-        }
-        else
-        {
-            // otherwise, check key modifiers and set value accordingly
-            if (selected)
-            {
-                if      (Display::isSelectMorePressed()) m_notes[id].setSelected(true);
-                else if (Display::isSelectLessPressed()) m_notes[id].setSelected(not selected);
-            }
-        }//end if
-
+        m_notes[id].setSelected(selected);
     }//end if
 }
 
@@ -766,6 +904,7 @@ void Track::updateNotesForGuitarEditor()
     {
         m_notes[n].checkIfStringAndFretMatchNote(true);
     }
+    notesChanged();
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -812,62 +951,6 @@ int Track::snapMidiTickToGrid(int tick, bool isNoteStart, bool is_ceil)
     return origin_tick + (int)(round((float)(tick - origin_tick)/ticklen)*ticklen);
 }
 
-// -------------------------------------------------------------------------------------------------------
-
-void Track::copy()
-{
-    // FIXME: controller editor checks don't belong here
-    /*
-    if (m_editor_mode == CONTROLLER)
-    {
-        wxBell();
-        return; // no copy/paste in controller mode
-    }
-     */
-
-    Clipboard::clear();
-    Clipboard::setBeatLength(m_sequence->ticksPerQuarterNote());
-
-    int tickOfFirstSelectedNote=-1;
-    // place all selected notes into clipboard
-    for (int n=0; n<m_notes.size(); n++)
-    {
-        if (!m_notes[n].isSelected()) continue;
-
-        Note* tmp=new Note(m_notes[n]);
-        Clipboard::add(tmp);
-
-        // if in guitar mode, make sure string/fret and note match
-        if (m_editor_mode[GUITAR])
-        {
-            Clipboard::getNote( Clipboard::getSize()-1 )->checkIfStringAndFretMatchNote(false);
-        }
-        else
-        {
-            Clipboard::getNote( Clipboard::getSize()-1 )->checkIfStringAndFretMatchNote(true);
-        }
-
-        // find tickOfFirstSelectedNote of the first note
-        if (m_notes[n].getTick() < tickOfFirstSelectedNote or tickOfFirstSelectedNote==-1)
-        {
-            tickOfFirstSelectedNote=m_notes[n].getTick();
-        }
-
-    }//next
-
-    // remove all empty measures before notes, so that they appear in the current measure when pasting
-    MeasureData* md = m_sequence->getMeasureData();
-    const int lastMeasureStart = md->firstTickInMeasure( md->measureAtTick(tickOfFirstSelectedNote) );
-
-    const int clipboard_size = Clipboard::getSize();
-    for (int n=0; n<clipboard_size; n++)
-    {
-        getGraphics()->getFocusedEditor()->moveNote(*Clipboard::getNote(n), -lastMeasureStart, 0);
-    }
-
-    m_sequence->setNoteShiftWhenNoScrolling( lastMeasureStart );
-}
-
 
 // =======================================================================================================
 // ============================================ Get/Set ==================================================
@@ -1244,6 +1327,7 @@ void Track::onGuitarTuningUpdated(GuitarTuning* tuning, const bool userTriggered
         Action::UpdateGuitarTuning actionObj;
         actionObj.setParentTrack(this, new TrackVisitor(this));
         actionObj.perform();
+        notesChanged();
     }
 }
 
@@ -1358,7 +1442,7 @@ ControllerEvent* Track::getControllerEventAt(int tick, int idController)
 
 // ----------------------------------------------------------------------------------------------------------
 
-int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
+int Track::addMidiEvents(IMidiEventSink* sink,
                          int channel,
                          int firstMeasure,
                          bool selectionOnly,
@@ -1392,14 +1476,6 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
     int firstNoteStartTick = -1;
     int selectedNoteAmount = 0;
 
-    for (int n=0; n<m_notes.size(); n++)
-    {
-        if (m_notes[n].getLength() <= 1)
-        {
-            fprintf(stderr, "EMPTY NOTE\n");
-        }
-    }
-
     if (selectionOnly)
     {
         const int noteAmount = m_notes.size();
@@ -1432,7 +1508,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime( 0 );
         m.SetControlChange( channel, 0, 0 );
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cerr << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1441,7 +1517,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime( 0 );
         m.SetControlChange( channel, 32, 0 );
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cout << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1458,7 +1534,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime(0);
         m.SetControlChange(channel, 0x65, 0);
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cerr << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1467,7 +1543,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime(0);
         m.SetControlChange(channel, 0x64, 0);
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cout << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1477,7 +1553,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime(0);
         m.SetControlChange(channel, 0x06, 24); // 24 semi-tones
         
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cout << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1486,7 +1562,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime(0);
         m.SetControlChange(channel, 0x26, 0);
         
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cout << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1502,7 +1578,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         if (m_editor_mode[DRUM]) m.SetProgramChange( channel, getDrumKit() );
         else                     m.SetProgramChange( channel, getInstrument() );
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cerr << "Error adding instrument at track beginning!" << std::endl;
         }
@@ -1511,11 +1587,6 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
     // set track name
     {
 
-        jdksmidi::MIDITimedBigMessage m;
-        m.SetText( 3 );
-        m.SetByte1( 3 );
-
-
         wxString track_name = m_track_name->getValue();
 
         /* This doesn't work under Linux: no track name seen in MIDI track
@@ -1524,11 +1595,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         */
         
         wxCharBuffer nameBuffer = track_name.ToUTF8();
-        int len = strlen(nameBuffer.data());
-        jdksmidi::MIDISystemExclusive sysex((unsigned char*)nameBuffer.data(), len, len, false);
-        m.CopySysEx( &sysex );
-        m.SetTime( 0 );
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putTextEvent(0, jdksmidi::META_TRACK_NAME, nameBuffer.data(), strlen(nameBuffer.data())))
         {
             std::cout << "Error adding event" << std::endl;
             ASSERT(FALSE);
@@ -1542,7 +1609,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
         m.SetTime( 0 );
         m.SetControlChange( channel, 7, SCHAR_MAX);
 
-        if (not midiTrack->PutEvent( m ))
+        if (not sink->putEvent( m ))
         {
             std::cerr << "Error adding event" << std::endl;
             ASSERT(false);
@@ -1576,6 +1643,8 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
     // if muted and drums, return now
     if (!m_played and m_editor_mode[DRUM] and not selectionOnly) return -1;
 
+    sink->reserve(noteOnAmount + noteOffAmount + controllerAmount);
+
     //std::cout << "-------------------- TRACK -------------" << std::endl;
     
     if (DEBUG_NOTE_ORDER) printf("---------------- Track <%s> ----------------\n",
@@ -1649,7 +1718,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
                     last_event_tick = m_notes[note_on_id].getEndTick();
                 }
 
-                if (not midiTrack->PutEvent( m ))
+                if (not sink->putEvent( m ))
                 {
                     std::cerr << "Error adding midi event!" << std::endl;
                 }
@@ -1680,7 +1749,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
                 // find track end
                 if (time > last_event_tick) last_event_tick = time;
 
-                if (not midiTrack->PutEvent( m ))
+                if (not sink->putEvent( m ))
                 {
                     std::cerr << "Error adding midi event!" << std::endl;
                 }
@@ -1766,7 +1835,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
 
                     m.SetPitchBend(channel, pitchBendVal);
 
-                    if (not midiTrack->PutEvent(m)) { std::cout << "Error adding midi event!" << std::endl; }
+                    if (not sink->putEvent(m)) { std::cout << "Error adding midi event!" << std::endl; }
                 }
                 control_evt_id++;
             }
@@ -1780,7 +1849,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
 
                     if (DEBUG_NOTE_ORDER) printf("[DEBUG_NOTE_ORDER] %i (program change)\n", time);
 
-                    if (not midiTrack->PutEvent( m ))
+                    if (not sink->putEvent( m ))
                     {
                         std::cerr << "Error adding midi event!" << std::endl;
                     }
@@ -1801,7 +1870,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
                                        0, // MSB
                                        0);
 
-                    if (not midiTrack->PutEvent( m ))
+                    if (not sink->putEvent( m ))
                     {
                         std::cerr << "Error adding midi event!" << std::endl;
                     }
@@ -1811,7 +1880,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
                                        32, // for bank select, force writing the LSB
                                        127 - (int)round(m_control_events[control_evt_id].getValue()) );
 
-                    if (not midiTrack->PutEvent( m ))
+                    if (not sink->putEvent( m ))
                     {
                         std::cerr << "Error adding midi event!" << std::endl;
                     }
@@ -1835,7 +1904,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
                                        controllerID,
                                        127 - (int)round(m_control_events[control_evt_id].getValue()) );
 
-                    if (not midiTrack->PutEvent( m ))
+                    if (not sink->putEvent( m ))
                     {
                         std::cerr << "Error adding midi event!" << std::endl;
                     }
@@ -1867,7 +1936,7 @@ int Track::addMidiEvents(jdksmidi::MIDITrack* midiTrack,
 #pragma mark Serialization
 #endif
 
-void Track::saveToFile(wxFileOutputStream& fileout)
+void Track::saveToFile(wxFileOutputStream& fileout, ITrackView* view)
 {
     reorderNoteVector();
     reorderNoteOffVector();
@@ -1917,7 +1986,8 @@ void Track::saveToFile(wxFileOutputStream& fileout)
             break;
     }
 
-    getGraphics()->saveToFile(fileout);
+    if (view != NULL) view->saveToFile(fileout);
+    else              saveViewlessData(fileout);
 
     // notes
     const int noteCount = m_notes.size();
@@ -1940,11 +2010,43 @@ void Track::saveToFile(wxFileOutputStream& fileout)
 
 // ----------------------------------------------------------------------------------------------------------
 
-// FIXME(DESIGN): remove references to GraphicalSequence from model classes
-bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
+void Track::saveViewlessData(wxFileOutputStream& fileout)
 {
+    // Same layout as GraphicalTrack::saveToFile, minus what only the editors know about
+    static const char* editorNames[] = { "score", "keyboard", "guitar", "drum", "controller" };
+    static const NotationType editorTypes[] = { SCORE, KEYBOARD, GUITAR, DRUM, CONTROLLER };
+    
+    writeData(wxT("  <editors>\n"), fileout);
+    for (int n=0; n<5; n++)
+    {
+        writeData(wxT("    <") + wxString(editorNames[n], wxConvUTF8) + wxT(" enabled=\"") +
+                  wxString(isNotationTypeEnabled(editorTypes[n]) ? wxT("true") : wxT("false")) +
+                  wxT("\"/>\n"), fileout);
+    }
+    writeData(wxT("  </editors>\n"), fileout );
+    
+    m_magnetic_grid->saveToFile( fileout );
+    
+    writeData( wxT("  <instrument id=\"") + to_wxString( getInstrument() ) + wxT("\"/>\n"), fileout);
+    writeData( wxT("  <drumkit id=\"") + to_wxString( getDrumKit() ) + wxT("\"/>\n"), fileout);
+    
+    writeData( wxT("  <guitartuning "), fileout);
+    const int stringCount = m_tuning->tuning.size();
+    for (int n=0; n<stringCount; n++)
+    {
+        writeData(wxT(" string")+ to_wxString((int)n) + wxT("=\"") +
+                  to_wxString((int)m_tuning->tuning[n]) + wxT("\""), fileout );
+    }
+    writeData( wxT("/>\n\n"), fileout);
+}
+
+// ----------------------------------------------------------------------------------------------------------
 
+bool Track::readFromFile(irr::io::IrrXMLReader* xml, ITrackView* view)
+{
+    // 'view' is NULL when loading without a GUI; view data is then skipped
     m_notes.clearAndDeleteAll();
+    notesChanged();
     m_note_off.clearWithoutDeleting(); // have already been deleted by previous command
     m_control_events.clearAndDeleteAll();
 
@@ -1998,23 +2100,13 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                     }
                     
                     
-                    const char* track_id_c = xml->getAttributeValue("id");
-                    if (track_id_c != NULL)
-                    {
-                        m_track_id = atoi(track_id_c);
-                    }
-                    
-                    
-                    const char* volume_c = xml->getAttributeValue("volume");
-                    if (volume_c != NULL)
-                    {
-                        m_volume = atoi(volume_c);
-                    }
+                    xml->getAttributeValueAsInt("id", m_track_id);
+                    xml->getAttributeValueAsInt("volume", m_volume);
 
-                    const char* default_volume_c = xml->getAttributeValue("default_volume");
-                    if (default_volume_c != NULL)
+                    int default_volume;
+                    if (xml->getAttributeValueAsInt("default_volume", default_volume))
                     {
-                        m_default_volume = atoi(default_volume_c);
+                        m_default_volume = default_volume;
                     }
 
                     const char* name = xml->getAttributeValue("name");
@@ -2028,10 +2120,9 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                         setName( wxString(_("Untitled")) );
                     }
 
-                    const char* channel_c = xml->getAttributeValue("channel");
-                    if (channel_c != NULL)
+                    int loaded_channel;
+                    if (xml->getAttributeValueAsInt("channel", loaded_channel))
                     {
-                        int loaded_channel = atoi(channel_c);
                         if (loaded_channel >=-0 and loaded_channel<16)
                         {
                             m_channel = loaded_channel;
@@ -2049,11 +2140,11 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                 }
                 else if (strcmp("instrument", xml->getNodeName()) == 0)
                 {
-                    const char* id = xml->getAttributeValue("id");
-                    if (id != NULL)
+                    int id;
+                    if (xml->getAttributeValueAsInt("id", id))
                     {
                         // FIXME: remove this abuse of the 'recursive' parameter
-                        doSetInstrument(atoi(id), true);
+                        doSetInstrument(id, true);
                     }
                     else
                     {
@@ -2108,7 +2199,7 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                         setNotationType(KEYBOARD, true);
                     }
 
-                    getGraphics()->readFromFile(xml);
+                    if (view != NULL) view->readFromFile(xml);
                 }
                 else if (strcmp("editors", xml->getNodeName()) == 0)
                 {
@@ -2117,7 +2208,8 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                     setNotationType(DRUM, false);
                     setNotationType(GUITAR, false);
                     setNotationType(CONTROLLER, false);
-                    getGraphics()->readFromFile(xml);
+                    if (view != NULL) view->readFromFile(xml);
+                    else              readViewlessEditors(xml);
                 }
                 else if (strcmp("guitartuning", xml->getNodeName()) == 0)
                 {
@@ -2126,15 +2218,16 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                     std::vector<int> newTuning;
 
                     int n=0;
-                    char* string_v = (char*)xml->getAttributeValue("string0");
+                    int string_v;
+                    char attribute_name[16];
+                    sprintf(attribute_name, "string%i", n);
 
-                    while (string_v != NULL)
+                    while (xml->getAttributeValueAsInt(attribute_name, string_v))
                     {
-                        newTuning.push_back( atoi(string_v) );
+                        newTuning.push_back( string_v );
 
                         n++;
-                        wxString tmp = wxT("string") + to_wxString(n);
-                        string_v = (char*)xml->getAttributeValue( tmp.mb_str() );
+                        sprintf(attribute_name, "string%i", n);
                     }
 
                     if (newTuning.size() < 3)
@@ -2147,35 +2240,26 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
                         tuning->setTuning(newTuning, false);
                     }
                 }
-                // FIXME: this is SAVED in GraphicalTrack but LOADED here. wtf.
+                // FIXME: this is SAVED in GraphicalTrack but LOADED here (and in the view). wtf.
                 else if (strcmp("drumkit", xml->getNodeName()) == 0)
                 {
-                    const char* id = xml->getAttributeValue("id");
-                    if (id != NULL)
+                    int id;
+                    if (xml->getAttributeValueAsInt("id", id))
                     {
                         // FIXME: remove this abuse of the 'recursive' parameter
-                        doSetDrumKit(atoi(id), true);
+                        doSetDrumKit(id, true);
                     }
                     else
                     {
                         std::cerr << "Missing info from file: drum ID" << std::endl;
                     }
 
-                    const char* collapse = xml->getAttributeValue("collapseView");
-                    if (collapse != NULL && strcmp(collapse, "true") == 0)
-                    {
-                        getGraphics()->getDrumEditor()->setShowOnlyUsedDrums(true);
-                    }
+                    if (view != NULL) view->readFromFile(xml);
                 }
                 // TODO: for backwards compatibility only, eventually remove
                 else if (strcmp("controller", xml->getNodeName()) == 0)
                 {
-                    const char* id = xml->getAttributeValue("id");
-                    if (id != NULL)
-                    {
-                        // FIXME: remove GUI calls from here
-                        getGraphics()->getControllerEditor()->setController(atoi(id));
-                    }
+                    if (view != NULL) view->readFromFile(xml);
                 }
                 else if (strcmp("key", xml->getNodeName()) == 0)
                 {
@@ -2333,12 +2417,7 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
 
                     ASSERT(invariant());
 
-                    // now that we have the set of notes, we can collapse the view if needed
-                    GraphicalTrack* gtrack = getGraphics();
-                    if (gtrack->getDrumEditor()->showOnlyUsedDrums())
-                    {
-                        gtrack->getDrumEditor()->useCustomDrumSet();
-                    }
+                    if (view != NULL) view->onTrackLoaded();
 
                     return true;
                 }
@@ -2358,6 +2437,35 @@ bool Track::readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq)
 
 }
 
+// ----------------------------------------------------------------------------------------------------------
+
+void Track::readViewlessEditors(irr::io::IrrXMLReader* xml)
+{
+    static const char* editorNames[] = { "score", "keyboard", "guitar", "drum", "controller" };
+    static const NotationType editorTypes[] = { SCORE, KEYBOARD, GUITAR, DRUM, CONTROLLER };
+    
+    while (xml != NULL and xml->read())
+    {
+        if (xml->getNodeType() == irr::io::EXN_ELEMENT)
+        {
+            const char* enabled_c = xml->getAttributeValue("enabled");
+            const bool enabled = (enabled_c != NULL and strcmp(enabled_c, "true") == 0);
+            
+            for (int n=0; n<5; n++)
+            {
+                if (strcmp(editorNames[n], xml->getNodeName()) == 0) setNotationType(editorTypes[n], enabled);
+            }
+        }
+        else if (xml->getNodeType() == irr::io::EXN_ELEMENT_END and
+                 strcmp("editors", xml->getNodeName()) == 0)
+        {
+            break;
+        }
+    }
+    
+    if (getEnabledEditorCount() == 0) setNotationType(KEYBOARD, true);
+}
+
 
 // Gets note volume
 // Applies track volume
@@ -2407,3 +2515,30 @@ bool Track::invariant()
     
     return true;
 }
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( TrackAddNote )
+{
+    // 1000 notes added at random locations in a track that already holds the song's notes
+    while (bench.next())
+    {
+        bench.pause();
+        BenchmarkSong song(bench);
+        Track* track = song->getTrack(0);
+        const int songLength = song->getMeasureData()->getTotalTickAmount();
+        unsigned int random = 4321;
+        bench.resume();
+        
+        for (int n=0; n<1000; n++)
+        {
+            random = random*1103515245 + 12345;
+            const int tick = (random >> 8) % songLength;
+            
+            Note* note = new Note(track, 40 + (random >> 20) % 50, tick, tick + 96, 80);
+            if (not track->addNote(note)) delete note;
+        }
+        
+        bench.pause(); // don't time the deletion of the sequence
+    }
+}
@@ -24,8 +24,6 @@ namespace irr { namespace io {
     template<class char_type, class super_class> class IIrrXMLReader;
     typedef IIrrXMLReader<char, IXMLBase> IrrXMLReader; } }
 
-namespace jdksmidi { class MIDITrack; }
-
 #include "Midi/ControllerEvent.h"
 #include "Midi/DrumChoice.h"
 #include "Midi/GuitarTuning.h"
@@ -40,11 +38,13 @@ namespace AriaMaestosa
     
     class Sequence; // forward
     class GraphicalTrack;
+    class GraphicalSequence;
     class MainFrame;
     class ControllerEvent;
     class FullTrackUndo;
     class NoteRelocator;
     class SequenceVisitor;
+    class IMidiEventSink;
     
     namespace Action
     {
@@ -96,6 +96,29 @@ namespace AriaMaestosa
         LEAK_CHECK();
     };
     
+    /**
+      * @brief Interface for the view of a track, so that its settings can be saved and read along with the
+      *        track in .aria files
+      */
+    class ITrackView
+    {
+    public:
+        
+        virtual ~ITrackView() {}
+        
+        /** @brief write the view settings of the track (editors, grid, ...) */
+        virtual void saveToFile(wxFileOutputStream& fileout) = 0;
+        
+        /**
+          * @brief read an element of the track that (also) holds view settings : 'editor', 'editors',
+          *        'drumkit' or the obsolete 'controller'
+          */
+        virtual bool readFromFile(irr::io::IrrXMLReader* xml) = 0;
+        
+        /** @brief called once all the notes of the track were read */
+        virtual void onTrackLoaded() = 0;
+    };
+    
     /**
       * @brief represents a track within a sequence.
       *
@@ -112,6 +135,12 @@ namespace AriaMaestosa
         
         /** Holds all controller events from this track */
         ptr_vector<ControllerEvent> m_control_events;
+
+        /**
+          * Incremented each time the notes of this track may have changed (edit, undo, tuning change),
+          * so that editors caching data computed from the notes know when to compute it again
+          */
+        int m_notes_revision;
         
         int m_track_id;
         
@@ -164,6 +193,18 @@ namespace AriaMaestosa
     
         int computeNoteVolume(int noteId);
         
+        /**
+         * @brief Write the per-track view data that is normally saved by GraphicalTrack, for when
+         *        the sequence has no graphical representation (headless batch conversion)
+         */
+        void saveViewlessData(wxFileOutputStream& fileout);
+        
+        /**
+         * @brief Consume an \<editors\> element when there is no GraphicalTrack to parse it,
+         *        keeping only the notation types (which are part of the model)
+         */
+        void readViewlessEditors(irr::io::IrrXMLReader* xml);
+        
         
         /** The sequence this track is part of */
         Sequence* m_sequence;
@@ -248,7 +289,33 @@ namespace AriaMaestosa
         
         /** @brief place events in time order */
         void reorderControlVector();
-        
+
+        /**
+          * @brief moves all notes and controller events that start after 'afterTick' by 'amountInTicks'
+          *        (which may be negative, as long as no event is moved to 'afterTick' or before)
+          *
+          * Only the moved events are visited and nothing needs to be sorted again, which is what makes
+          * inserting and removing measures in large songs fast.
+          * @note not to be called during editing, as it does not generate an action in the action stack.
+          */
+        void shiftEventsAfter(const int afterTick, const int amountInTicks);
+
+        /**
+          * @brief takes out all notes and controller events that start after 'fromTick' and before
+          *        'toTick'; they are appended to 'notes' and 'controlEvents', which now own them
+          * @note not to be called during editing, as it does not generate an action in the action stack.
+          */
+        void extractEventsInRange(const int fromTick, const int toTick, ptr_vector<Note>& notes,
+                                  ptr_vector<ControllerEvent>& controlEvents);
+
+        /**
+          * @brief puts back events that were taken out with 'extractEventsInRange' : notes (in time order)
+          *        are merged back in one pass, control events (in any order) with one sort. The track
+          *        takes back ownership and the vectors are emptied.
+          * @note not to be called during editing, as it does not generate an action in the action stack.
+          */
+        void insertEventBlock(ptr_vector<Note>& notes, ptr_vector<ControllerEvent>& controlEvents);
+
         void removeNote(const int id);
         
         void setId(const int id);
@@ -279,7 +346,11 @@ namespace AriaMaestosa
                 
         void setName(wxString name);
         
-        void selectNote(const int id, const bool selected, bool ignoreModifiers=false);
+        /**
+          * @brief select or deselect a note (or all of them with ALL_NOTES)
+          * @note  the +/- selection key modifiers are handled by GraphicalTrack::selectNote
+          */
+        void selectNote(const int id, const bool selected);
 
         const wxString    getName     () const { return m_track_name->getValue(); }
         Model<wxString>*  getNameModel()       { return m_track_name;             }
@@ -333,9 +404,21 @@ namespace AriaMaestosa
         void setCustomKey(const KeyInclusionType key_notes[131]);
         
         // ---- get info on notes
+        /** @return a number that changes each time the notes of this track may have changed */
+        int   getNotesRevision        ()             const { return m_notes_revision; }
+        /** @brief to be called after modifying the notes of this track without going through its methods */
+        void  notesChanged            ()                   { m_notes_revision++; }
+
         int   getNoteAmount           ()             const;
         int   getNoteStartInMidiTicks (const int id) const;
         int   getNoteEndInMidiTicks   (const int id) const;
+
+        /**
+          * @brief copies the start and end ticks of notes [firstNote, firstNote + count) into
+          *        'startTicks' and 'endTicks', which must have room for 'count' values
+          */
+        void  getNoteTicks            (const int firstNote, const int count, int* startTicks,
+                                       int* endTicks) const;
         int   getNotePitchID          (const int id) const;
         bool  isNoteSelected          (const int id) const;
         int   getNoteVolume           (const int id) const;
@@ -357,6 +440,7 @@ namespace AriaMaestosa
         void markNoteToBeRemoved(const int id);
         void removeMarkedNotes();
         
+        /** @note defined along with the GUI (in GraphicalTrack.cpp), only available when there is one */
         GraphicalTrack* getGraphics();
         const GraphicalTrack* getGraphics() const;
 
@@ -502,17 +586,16 @@ namespace AriaMaestosa
         /** @return the selected drum kit (if this track is not a drum track, this value is ignored */
         int  getDrumKit() const { return m_drum_kit->getSelectedDrumkit(); }
         
-        void copy();
-        
         /** @return an array of bools, for each note (one entry per pitch ID), that indicates
          *         which notes are part of the current key */
         const KeyInclusionType* getKeyNotes() const { return m_key_notes; }
     
         /**
-         * @brief Add Midi Events to JDKMidi track object
+         * @brief Compile this track into Midi events, given in time order to 'sink'
+         *        (e.g. a JDKMidi track, or a midi file being written)
          * @param channel in manual channel mode, this argument is NOT considered
          */
-        int addMidiEvents(jdksmidi::MIDITrack* track, int channel, int firstMeasure,
+        int addMidiEvents(IMidiEventSink* sink, int channel, int firstMeasure,
                           bool selectionOnly, int& startTick); // returns length
 
         /**
@@ -588,9 +671,9 @@ namespace AriaMaestosa
         
         bool invariant();
         
-        // serialization
-        void saveToFile(wxFileOutputStream& fileout);
-        bool readFromFile(irr::io::IrrXMLReader* xml, GraphicalSequence* gseq);
+        // serialization; 'view' may be NULL when the track has no graphical representation
+        void saveToFile(wxFileOutputStream& fileout, ITrackView* view);
+        bool readFromFile(irr::io::IrrXMLReader* xml, ITrackView* view);
     };
     
 }
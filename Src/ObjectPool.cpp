@@ -0,0 +1,72 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "ObjectPool.h"
+
+#if wxCHECK_VERSION(2,9,0)
+#include <wx/tls.h>
+#endif
+
+using namespace AriaMaestosa;
+
+namespace ObjectPoolCachesData
+{
+    struct ThreadCaches
+    {
+        ObjectPoolCaches::Cache m_caches[ObjectPoolCaches::MAX_CACHES_PER_THREAD];
+    };
+
+#if wxCHECK_VERSION(2,9,0)
+    wxTLS_TYPE(ThreadCaches) g_thread_caches;
+#define THREAD_CACHES wxTLS_VALUE(ObjectPoolCachesData::g_thread_caches)
+#else
+    __thread ThreadCaches g_thread_caches;
+#define THREAD_CACHES ObjectPoolCachesData::g_thread_caches
+#endif
+
+    int g_last_pool_id = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int ObjectPoolCaches::newPoolId()
+{
+    return __atomic_add_fetch(&ObjectPoolCachesData::g_last_pool_id, 1, __ATOMIC_RELAXED);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+ObjectPoolCaches::Cache* ObjectPoolCaches::getCache(const int poolId)
+{
+    // thread-local storage starts zeroed, so all entries start unused
+    Cache* caches = THREAD_CACHES.m_caches;
+    Cache* unused = NULL;
+
+    for (int n=0; n<MAX_CACHES_PER_THREAD; n++)
+    {
+        if (caches[n].m_pool_id == poolId) return &caches[n];
+        if (caches[n].m_pool_id == 0 and unused == NULL) unused = &caches[n];
+    }
+
+    if (unused != NULL)
+    {
+        unused->m_pool_id = poolId;
+        unused->m_free    = NULL;
+        unused->m_count   = 0;
+    }
+    return unused;
+}
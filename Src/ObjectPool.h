@@ -0,0 +1,278 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJECT_POOL_H__
+#define __OBJECT_POOL_H__
+
+#include <wx/thread.h>
+
+#include <cstddef>
+
+namespace AriaMaestosa
+{
+
+    /**
+      * @brief the free slots each thread keeps for itself, per pool; only used by ObjectPool
+      */
+    namespace ObjectPoolCaches
+    {
+        struct Cache
+        {
+            /** ID of the pool the slots come from; 0 if this entry is unused */
+            int   m_pool_id;
+            void* m_free;
+            int   m_count;
+        };
+
+        /** How many pools a thread can keep slots for; further pools are only used through their lock */
+        const int MAX_CACHES_PER_THREAD = 8;
+
+        /** @return a new pool ID, never 0 and never handed out twice */
+        int newPoolId();
+
+        /**
+          * @return the calling thread's cache for the given pool (created empty on first use), or NULL
+          *         if the thread already keeps slots for MAX_CACHES_PER_THREAD pools
+          */
+        Cache* getCache(const int poolId);
+    }
+
+    /**
+      * @brief allocator for small objects of one size that are created and deleted by the hundred
+      *        thousand (notes, controller events); meant to back the 'operator new' and 'operator delete'
+      *        of such classes
+      *
+      * Memory is taken from the system in slabs of many objects, and deleted objects go to a free list
+      * to be reused, so creating or deleting one object never goes through malloc. Objects created in a
+      * row (e.g. the notes of a track being imported or loaded) sit next to each other in memory.
+      *
+      * The pool is thread-safe without taking a lock per object : every thread keeps a few free slots
+      * of its own, and only goes to the shared free list (under the pool's lock) to take or give back
+      * BATCH_SIZE slots at once. Once all slots are back on the shared list (which requires threads to
+      * give their slots back with 'releaseThreadCache'), all slabs but one are given back at once.
+      */
+    template<int OBJECT_SIZE, int SLAB_CAPACITY = 1024>
+    class ObjectPool
+    {
+        union Slot
+        {
+            Slot*     m_next_free;
+            char      m_storage[OBJECT_SIZE];
+
+            // only there to give slots the strictest alignment any pooled object may need
+            double    m_align_double;
+            long long m_align_long;
+            void*     m_align_pointer;
+        };
+
+        struct Slab
+        {
+            Slab* m_next;
+            Slot  m_slots[SLAB_CAPACITY];
+        };
+
+        /** How many slots a thread takes from (or gives back to) the shared free list at once */
+        enum { BATCH_SIZE = (SLAB_CAPACITY < 64 ? SLAB_CAPACITY : 64) };
+
+        const int m_id;
+
+        /** Guards everything below */
+        wxMutex m_mutex;
+        Slab*   m_slabs;
+        Slot*   m_free;
+        int     m_slab_count;
+
+        /** Slots that are not on the shared free list : in use, or kept by a thread */
+        int     m_live;
+
+        /** @brief puts all slots of 'slab' on the free list */
+        void addToFreeList(Slab* slab)
+        {
+            // in reverse, so that slots are handed out in address order
+            for (int n=SLAB_CAPACITY-1; n>=0; n--)
+            {
+                slab->m_slots[n].m_next_free = m_free;
+                m_free = &slab->m_slots[n];
+            }
+        }
+
+        /** @return a list of 'count' slots taken from the shared free list, in address order */
+        Slot* takeSlots(const int count)
+        {
+            wxMutexLocker lock(m_mutex);
+
+            Slot* first = NULL;
+            Slot* last  = NULL;
+            for (int n=0; n<count; n++)
+            {
+                if (m_free == NULL)
+                {
+                    Slab* slab   = new Slab();
+                    slab->m_next = m_slabs;
+                    m_slabs      = slab;
+                    m_slab_count++;
+                    addToFreeList(slab);
+                }
+
+                Slot* slot = m_free;
+                m_free = slot->m_next_free;
+
+                if (last == NULL) first = slot;
+                else              last->m_next_free = slot;
+                last = slot;
+            }
+            last->m_next_free = NULL;
+
+            m_live += count;
+            return first;
+        }
+
+        /** @brief puts the list of 'count' slots from 'first' to 'last' back on the shared free list */
+        void giveSlots(Slot* first, Slot* last, const int count)
+        {
+            wxMutexLocker lock(m_mutex);
+
+            last->m_next_free = m_free;
+            m_free = first;
+            m_live -= count;
+
+            if (m_live == 0 and m_slab_count > 1)
+            {
+                // everything was deleted (e.g. the last sequence was closed) : keep one slab, in case
+                // objects are created again, and give the rest back
+                Slab* kept = m_slabs;
+                Slab* slab = kept->m_next;
+                while (slab != NULL)
+                {
+                    Slab* next = slab->m_next;
+                    delete slab;
+                    slab = next;
+                }
+                kept->m_next = NULL;
+                m_slab_count = 1;
+
+                m_free = NULL;
+                addToFreeList(kept);
+            }
+        }
+
+    public:
+
+        ObjectPool() : m_id(ObjectPoolCaches::newPoolId()), m_slabs(NULL), m_free(NULL), m_slab_count(0),
+                       m_live(0)
+        {
+        }
+
+        ~ObjectPool()
+        {
+            // slots other threads still keep are simply never used again, since pool IDs are unique
+            releaseThreadCache();
+
+            while (m_slabs != NULL)
+            {
+                Slab* next = m_slabs->m_next;
+                delete m_slabs;
+                m_slabs = next;
+            }
+        }
+
+        void* allocate()
+        {
+            ObjectPoolCaches::Cache* cache = ObjectPoolCaches::getCache(m_id);
+            if (cache == NULL) return takeSlots(1);
+
+            if (cache->m_count == 0)
+            {
+                cache->m_free  = takeSlots(BATCH_SIZE);
+                cache->m_count = BATCH_SIZE;
+            }
+
+            Slot* slot = (Slot*)cache->m_free;
+            cache->m_free = slot->m_next_free;
+            cache->m_count--;
+            return slot;
+        }
+
+        void release(void* object)
+        {
+            if (object == NULL) return;
+
+            Slot* slot = (Slot*)object;
+
+            ObjectPoolCaches::Cache* cache = ObjectPoolCaches::getCache(m_id);
+            if (cache == NULL)
+            {
+                giveSlots(slot, slot, 1);
+                return;
+            }
+
+            slot->m_next_free = (Slot*)cache->m_free;
+            cache->m_free = slot;
+            cache->m_count++;
+
+            if (cache->m_count == BATCH_SIZE*2)
+            {
+                // keep the slots released last (they are the most likely to still be in the CPU cache),
+                // and give the older half back so that other threads can use them
+                Slot* lastKept = slot;
+                for (int n=1; n<BATCH_SIZE; n++) lastKept = lastKept->m_next_free;
+
+                Slot* first = lastKept->m_next_free;
+                Slot* last  = first;
+                while (last->m_next_free != NULL) last = last->m_next_free;
+
+                lastKept->m_next_free = NULL;
+                cache->m_count = BATCH_SIZE;
+                giveSlots(first, last, BATCH_SIZE);
+            }
+        }
+
+        /**
+          * @brief gives the free slots the calling thread keeps for this pool back to the shared free list
+          *        (e.g. before the thread ends)
+          */
+        void releaseThreadCache()
+        {
+            ObjectPoolCaches::Cache* cache = ObjectPoolCaches::getCache(m_id);
+            if (cache == NULL) return;
+
+            if (cache->m_count > 0)
+            {
+                Slot* first = (Slot*)cache->m_free;
+                Slot* last  = first;
+                while (last->m_next_free != NULL) last = last->m_next_free;
+                giveSlots(first, last, cache->m_count);
+            }
+
+            // free the entry for another pool
+            cache->m_pool_id = 0;
+            cache->m_free    = NULL;
+            cache->m_count   = 0;
+        }
+
+        /**
+          * @return how many slots are currently taken from this pool : allocated objects, plus the free
+          *         slots threads keep for themselves
+          */
+        int getLiveCount() const { return m_live; }
+
+        /** @return how many slabs this pool currently holds */
+        int getSlabCount() const { return m_slab_count; }
+    };
+
+}
+
+#endif
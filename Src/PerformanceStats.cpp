@@ -0,0 +1,313 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "PerformanceStats.h"
+#include "UnitTest.h"
+
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
+
+#include <cstring>
+
+using namespace AriaMaestosa;
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int LatencyHistogram::bucketFor(const long long microseconds)
+{
+    if (microseconds < SUB_BUCKETS) return (int)microseconds;
+
+    // position of the highest bit, then the 3 bits after it select the sub-bucket
+    int exponent = 0;
+    while ((microseconds >> (exponent + 1)) != 0) exponent++;
+
+    const int shift = exponent - 3;
+    const int sub   = (int)((microseconds >> shift) & (SUB_BUCKETS - 1));
+    const int bucket = SUB_BUCKETS + shift*SUB_BUCKETS + sub;
+    return (bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+long long LatencyHistogram::bucketUpperBound(const int bucket)
+{
+    if (bucket < SUB_BUCKETS) return bucket;
+
+    const int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    const int sub   = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((long long)(SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void LatencyHistogram::add(long long microseconds)
+{
+    if (microseconds < 0) microseconds = 0;
+
+    m_buckets[bucketFor(microseconds)]++;
+    m_count++;
+    m_sum += microseconds;
+    if (microseconds > m_max) m_max = microseconds;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void LatencyHistogram::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sum   = 0;
+    m_max   = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+long long LatencyHistogram::getPercentile(const float percent) const
+{
+    if (m_count == 0) return 0;
+
+    long long rank = (long long)(percent / 100.0f * m_count + 0.5f);
+    if (rank < 1)       rank = 1;
+    if (rank > m_count) rank = m_count;
+
+    long long seen = 0;
+    for (int b=0; b<BUCKET_COUNT; b++)
+    {
+        seen += m_buckets[b];
+        if (seen >= rank)
+        {
+            const long long bound = bucketUpperBound(b);
+            return (bound < m_max ? bound : m_max);
+        }
+    }
+    return m_max;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+namespace AriaMaestosa
+{
+    namespace PerformanceStats
+    {
+        volatile bool g_enabled = false;
+    }
+}
+
+namespace PerformanceStatsData
+{
+    const long long WINDOW_LENGTH = 1000000;
+
+    /** Guards g_current and g_session, which the sequencer and MIDI input threads add to */
+    wxMutex          g_mutex;
+    LatencyHistogram g_current[PerformanceStats::METRIC_COUNT];
+    LatencyHistogram g_session[PerformanceStats::METRIC_COUNT];
+
+    /** Only used by the GUI thread */
+    LatencyHistogram g_last_window[PerformanceStats::METRIC_COUNT];
+
+    wxStopWatch* g_clock = NULL;
+    long long    g_window_start = 0;
+
+    int g_frames           = 0;
+    int g_frames_last      = 0;
+    int g_notes_drawn      = 0;
+    int g_notes_total      = 0;
+    int g_notes_drawn_last = 0;
+    int g_notes_culled_last = 0;
+}
+
+using namespace PerformanceStatsData;
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PerformanceStats::setEnabled(const bool enabled)
+{
+    if (g_clock == NULL)
+    {
+        g_clock = new wxStopWatch();
+        g_clock->Start();
+    }
+    g_window_start = now();
+    g_enabled = enabled;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+long long PerformanceStats::now()
+{
+#if wxCHECK_VERSION(2,9,3)
+    return g_clock->TimeInMicro().GetValue();
+#else
+    return (long long)g_clock->Time() * 1000;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PerformanceStats::add(const Metric metric, const long long microseconds)
+{
+    if (not g_enabled) return;
+
+    wxMutexLocker lock(g_mutex);
+    g_current[metric].add(microseconds);
+    g_session[metric].add(microseconds);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PerformanceStats::countNotes(const int drawn, const int total)
+{
+    if (not g_enabled) return;
+
+    g_notes_drawn += drawn;
+    g_notes_total += total;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PerformanceStats::endFrame()
+{
+    if (not g_enabled) return;
+
+    g_frames++;
+    g_notes_drawn_last  = g_notes_drawn;
+    g_notes_culled_last = g_notes_total - g_notes_drawn;
+    g_notes_drawn = 0;
+    g_notes_total = 0;
+
+    const long long time = now();
+    if (time - g_window_start < WINDOW_LENGTH) return;
+
+    {
+        wxMutexLocker lock(g_mutex);
+        for (int n=0; n<METRIC_COUNT; n++)
+        {
+            g_last_window[n] = g_current[n];
+            g_current[n].reset();
+        }
+    }
+    g_frames_last  = (int)(g_frames * WINDOW_LENGTH / (time - g_window_start));
+    g_frames       = 0;
+    g_window_start = time;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const LatencyHistogram& PerformanceStats::getLastWindow(const Metric metric)
+{
+    return g_last_window[metric];
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+LatencyHistogram PerformanceStats::getSession(const Metric metric)
+{
+    wxMutexLocker lock(g_mutex);
+    return g_session[metric];
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int PerformanceStats::getFramesPerSecond()
+{
+    return g_frames_last;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int PerformanceStats::getNotesDrawn()
+{
+    return g_notes_drawn_last;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+int PerformanceStats::getNotesCulled()
+{
+    return g_notes_culled_last;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const char* PerformanceStats::getName(const Metric metric)
+{
+    switch (metric)
+    {
+        case FRAME_TIME:        return "frame";
+        case KEYBOARD_RENDER:   return "keyboard editor";
+        case SCORE_RENDER:      return "score editor";
+        case GUITAR_RENDER:     return "guitar editor";
+        case DRUM_RENDER:       return "drum editor";
+        case CONTROLLER_RENDER: return "controller editor";
+        case PLAYBACK_LATENCY:  return "playback latency";
+        case RECORD_LATENCY:    return "record latency";
+        case METRIC_COUNT:      break;
+    }
+    return "?";
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PerformanceStats::writeReport(FILE* output)
+{
+    fprintf(output, "%-20s %8s %10s %10s %10s %10s %10s\n", "[Stats]", "count", "p50 (ms)", "p95 (ms)",
+            "p99 (ms)", "max (ms)", "mean (ms)");
+
+    for (int n=0; n<METRIC_COUNT; n++)
+    {
+        const LatencyHistogram histogram = getSession((Metric)n);
+        if (histogram.getCount() == 0) continue;
+
+        fprintf(output, "%-20s %8i %10.2f %10.2f %10.2f %10.2f %10.2f\n", getName((Metric)n),
+                histogram.getCount(), histogram.getPercentile(50)/1000.0, histogram.getPercentile(95)/1000.0,
+                histogram.getPercentile(99)/1000.0, histogram.getMax()/1000.0, histogram.getMean()/1000.0);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+namespace TestLatencyHistogram
+{
+    using namespace AriaMaestosa;
+
+    UNIT_TEST(TestLatencyHistogramPercentiles)
+    {
+        LatencyHistogram histogram;
+        require(histogram.getPercentile(50) == 0, "An empty histogram has no percentiles");
+
+        // 1 .. 1000 µs, once each
+        for (int n=1; n<=1000; n++) histogram.add(n);
+
+        require_e(histogram.getCount(), ==, 1000, "All values were counted");
+        require_e(histogram.getMax(),   ==, 1000, "The maximum is exact");
+        require_e(histogram.getMean(),  ==, 500,  "The mean is exact");
+
+        const long long p50 = histogram.getPercentile(50);
+        const long long p99 = histogram.getPercentile(99);
+        require(p50 >= 500 and p50 <= 500*1.125, "The median is within one bucket of the real value");
+        require(p99 >= 990 and p99 <= 1000,      "Percentiles never exceed the maximum");
+
+        histogram.reset();
+        histogram.add(3);
+        require_e(histogram.getPercentile(50), ==, 3, "Small values are exact");
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __PERFORMANCE_STATS_H__
+#define __PERFORMANCE_STATS_H__
+
+#include <stdio.h>
+
+namespace AriaMaestosa
+{
+
+    /**
+      * @brief distribution of durations, kept in a fixed amount of buckets so that recording a value
+      *        never allocates
+      *
+      * Buckets are logarithmic (8 per power of two), so percentiles are exact below 8 µs and within
+      * 12.5% above that, from microseconds up to hours.
+      */
+    class LatencyHistogram
+    {
+    public:
+        static const int SUB_BUCKETS  = 8;
+        static const int BUCKET_COUNT = SUB_BUCKETS + 33*SUB_BUCKETS;
+
+    private:
+        int       m_buckets[BUCKET_COUNT];
+        int       m_count;
+        long long m_sum;
+        long long m_max;
+
+        static int       bucketFor(const long long microseconds);
+        static long long bucketUpperBound(const int bucket);
+
+    public:
+        LatencyHistogram();
+
+        void add(long long microseconds);
+        void reset();
+
+        int       getCount() const { return m_count; }
+        long long getMax()   const { return m_max;   }
+        long long getMean()  const { return (m_count == 0 ? 0 : m_sum / m_count); }
+
+        /**
+          * @param percent in range [0 .. 100]
+          * @return the duration (in microseconds) under which 'percent' % of the values fall, or 0
+          *         if the histogram is empty
+          */
+        long long getPercentile(const float percent) const;
+    };
+
+    /**
+      * @brief where the time goes : render times, playback and recording latency, collected while
+      *        Aria runs so they can be shown in an overlay on top of the editors ('--stats' on the
+      *        command line) and summed up when it quits
+      *
+      * Values are kept per 1-second window (what the overlay shows) and for the whole session. Values
+      * are added from the GUI, sequencer and MIDI input threads, so the histograms being filled are
+      * guarded by a mutex; it is held for one bucket increment at a time (or one copy per second when
+      * the window rolls over), so threads hardly ever wait on it. Frame and note counters are only
+      * used by the GUI thread.
+      */
+    namespace PerformanceStats
+    {
+        enum Metric
+        {
+            FRAME_TIME,
+            KEYBOARD_RENDER,
+            SCORE_RENDER,
+            GUITAR_RENDER,
+            DRUM_RENDER,
+            CONTROLLER_RENDER,
+            /** Actual minus scheduled time at which the sequencer sent out an event */
+            PLAYBACK_LATENCY,
+            /** Time between a MIDI input message being received and it being added to the track */
+            RECORD_LATENCY,
+            METRIC_COUNT
+        };
+
+        extern volatile bool g_enabled;
+
+        inline bool isEnabled() { return g_enabled; }
+        void setEnabled(const bool enabled);
+
+        /** @return microseconds since the statistics were enabled */
+        long long now();
+
+        void add(const Metric metric, const long long microseconds);
+
+        /** @brief to be called by editors with how many of their notes were drawn, out of how many */
+        void countNotes(const int drawn, const int total);
+
+        /** @brief to be called at the end of each frame; rolls the 1-second window over when due */
+        void endFrame();
+
+        /** @return the values of the last complete 1-second window; only call this from the GUI thread */
+        const LatencyHistogram& getLastWindow(const Metric metric);
+
+        /**
+          * @return the values of the whole session so far (a copy, since other threads may still be
+          *         adding to it)
+          */
+        LatencyHistogram getSession(const Metric metric);
+
+        /** @return frames rendered during the last complete 1-second window */
+        int getFramesPerSecond();
+
+        /** @return how many notes were drawn during the last frame */
+        int getNotesDrawn();
+
+        /** @return how many notes were skipped during the last frame because they were out of view */
+        int getNotesCulled();
+
+        /** @return a short name for the metric, as used in the overlay and the report */
+        const char* getName(const Metric metric);
+
+        /** @brief writes a summary of the session (percentiles of each metric) */
+        void writeReport(FILE* output);
+
+        /** @brief adds the time spent in the enclosing block to a metric (if statistics are enabled) */
+        class ScopedTimer
+        {
+            Metric    m_metric;
+            long long m_start;
+
+        public:
+            ScopedTimer(const Metric metric)
+            {
+                m_metric = metric;
+                m_start  = (isEnabled() ? now() : -1);
+            }
+
+            ~ScopedTimer()
+            {
+                if (m_start != -1) add(m_metric, now() - m_start);
+            }
+        };
+    }
+
+}
+
+#endif
@@ -180,7 +180,7 @@ void InstrumentPicker::buildNewPicker()
 {
     deleteCurrentPicker();
 
-    m_current_classification_id = PreferencesData::getInstance()->getIntValue(SETTING_ID_INSTRUMENT_CLASSIFICATION);
+    m_current_classification_id = PreferencesData::getInstance()->getIntValue(SETTING_KEY_INSTRUMENT_CLASSIFICATION);
 
     switch (m_current_classification_id)
     {
@@ -21,8 +21,6 @@
 #include "languages.h"
 #include <wx/config.h>
 #include <wx/intl.h>
-#include <wx/font.h>
-#include <wx/settings.h>
 #include <wx/stdpaths.h>
 #include <wx/wfstream.h>
 #include <wx/filename.h>
@@ -50,6 +48,7 @@ Setting::Setting(wxString name, wxString user_name, SettingType type,
     m_subtype   = subtype;
     m_value     = default_value;
     m_category  = category;
+    m_key       = SETTING_KEY_NONE;
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -104,6 +103,8 @@ PreferencesData::PreferencesData()
     wxConfig::Set(new wxFileConfig(fis));
     
     
+    for (int n=0; n<SETTING_KEY_COUNT; n++) m_cached_values[n] = 0;
+    
     m_inited = false;
 }
 
@@ -141,7 +142,47 @@ void PreferencesData::readValues()
         {
             //m_settings[i].m_value = value;
         }
-    }    
+    }
+    
+    refreshCachedValues();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PreferencesData::addSetting(Setting* setting, const SettingKey key)
+{
+    setting->m_key = key;
+    m_settings.push_back( setting );
+    updateCachedValue( *setting );
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PreferencesData::updateCachedValue(const Setting& setting)
+{
+    if (setting.m_key == SETTING_KEY_NONE) return;
+    
+    long asInt = 0;
+    if      (setting.m_value == wxT("true"))  asInt = 1;
+    else if (setting.m_value == wxT("false")) asInt = 0;
+    else if (not setting.m_value.ToLong(&asInt))
+    {
+        fprintf(stderr, "[PreferencesData] Invalid value '%s' for setting '%s'\n",
+                (const char*)setting.m_value.utf8_str(), (const char*)setting.m_name.utf8_str());
+        asInt = 0;
+    }
+    m_cached_values[setting.m_key] = asInt;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void PreferencesData::refreshCachedValues()
+{
+    const int settingAmount = m_settings.size();
+    for (int i=0; i<settingAmount; i++)
+    {
+        updateCachedValue( m_settings[i] );
+    }
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -152,7 +193,7 @@ void PreferencesData::prepareLanguageEntry()
     Setting* languages = new Setting(fromCString(SETTING_ID_LANGUAGE), _("Language"), SETTING_ENUM,
                                      SETTING_CATEGORY_UI, to_wxString(getDefaultLanguageAriaID()) );
     languages->setChoices( getLanguageList() );
-    m_settings.push_back( languages );
+    addSetting( languages, SETTING_KEY_LANGUAGE );
 }
 
 // ----------------------------------------------------------------------------------------------------------
@@ -183,7 +224,7 @@ void PreferencesData::fillSettingsVector()
     {
         midiDriver->addChoice(midiDrivers[n]);
     }
-    m_settings.push_back( midiDriver );
+    addSetting( midiDriver );
 
     // ---- play during edit
     //I18N: In preferences
@@ -192,7 +233,7 @@ void PreferencesData::fillSettingsVector()
     play->addChoice(_("Always"));        // PLAY_ALWAYS = 0,
     play->addChoice(_("On note change"));// PLAY_ON_CHANGE = 1,
     play->addChoice(_("Never"));         // PLAY_NEVER = 2
-    m_settings.push_back( play );
+    addSetting( play, SETTING_KEY_PLAY_DURING_EDIT );
     
     // ---- score view
     //I18N: In preferences
@@ -201,7 +242,7 @@ void PreferencesData::fillSettingsVector()
     scoreview->addChoice(_("Both Musical and Linear"));
     scoreview->addChoice(_("Musical Only"));
     scoreview->addChoice(_("Linear Only"));
-    m_settings.push_back( scoreview );
+    addSetting( scoreview, SETTING_KEY_SCORE_VIEW );
     
     // ---- default editor
     //I18N: In preferences
@@ -210,7 +251,7 @@ void PreferencesData::fillSettingsVector()
     defaultEditor->addChoice(_("Keyboard"));  // 0
     defaultEditor->addChoice(_("Score"));     // 1
     defaultEditor->addChoice(_("Tablature")); // 2
-    m_settings.push_back( defaultEditor );
+    addSetting( defaultEditor, SETTING_KEY_DEFAULT_EDITOR );
 
 
     // ---- instrument classification
@@ -220,7 +261,7 @@ void PreferencesData::fillSettingsVector()
     instrumentClassification->addChoice(_("MIDI Standard"));  // 0
     instrumentClassification->addChoice(wxT("Aria"));     // 1
     instrumentClassification->addChoice(wxT("Buzzwood"));     // 2
-    m_settings.push_back( instrumentClassification );
+    addSetting( instrumentClassification, SETTING_KEY_INSTRUMENT_CLASSIFICATION );
 
 
 
@@ -230,44 +271,44 @@ void PreferencesData::fillSettingsVector()
     Setting* soundbank = new Setting(fromCString(SETTING_ID_SOUNDBANK), _("Soundfont"),
                                      SETTING_STRING, SETTING_CATEGORY_AUDIO, SYSTEM_BANK,
                                      SETTING_SUBTYPE_FILE_OR_DEFAULT);
-    m_settings.push_back( soundbank );
+    addSetting( soundbank );
 #endif
     
     // ---- follow playback
     Setting* followp = new Setting(fromCString(SETTING_ID_FOLLOW_PLAYBACK), _("Follow playback by default"),
                                    SETTING_BOOL, SETTING_CATEGORY_EDITION, wxT("0") );
-    m_settings.push_back( followp );
+    addSetting( followp, SETTING_KEY_FOLLOW_PLAYBACK );
     
     // ---- playthrough
     Setting* playthrough = new Setting(fromCString(SETTING_ID_PLAYTHROUGH), _("Enable playthrough when recording by default"),
                                        SETTING_BOOL, SETTING_CATEGORY_AUDIO, wxT("1") );
-    m_settings.push_back( playthrough );
+    addSetting( playthrough, SETTING_KEY_PLAYTHROUGH );
 
     // ---- check for new version
     Setting* newversion = new Setting(fromCString(SETTING_ID_CHECK_NEW_VERSION), _("Check online for new versions"),
                                        SETTING_BOOL, SETTING_CATEGORY_UI, wxT("1") );
-    m_settings.push_back( newversion );
+    addSetting( newversion, SETTING_KEY_CHECK_NEW_VERSION );
     
     // ---- Remember window location
     Setting* windowloc = new Setting(fromCString(SETTING_ID_REMEMBER_WINDOW_POS), _("Remember window location"),
                                      SETTING_BOOL, SETTING_CATEGORY_UI, wxT("0") );
-    m_settings.push_back( windowloc );
+    addSetting( windowloc, SETTING_KEY_REMEMBER_WINDOW_POS );
     
     Setting* window_x = new Setting(fromCString(SETTING_ID_WINDOW_X), wxT("Window X"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("0") );
-    m_settings.push_back( window_x );
+    addSetting( window_x, SETTING_KEY_WINDOW_X );
     
     Setting* window_y = new Setting(fromCString(SETTING_ID_WINDOW_Y), wxT("Window Y"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("0") );
-    m_settings.push_back( window_y );
+    addSetting( window_y, SETTING_KEY_WINDOW_Y );
     
     Setting* window_w = new Setting(fromCString(SETTING_ID_WINDOW_W), wxT("Window W"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("800") );
-    m_settings.push_back( window_w );
+    addSetting( window_w, SETTING_KEY_WINDOW_W );
     
     Setting* window_h = new Setting(fromCString(SETTING_ID_WINDOW_H), wxT("Window H"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("600") );
-    m_settings.push_back( window_h );
+    addSetting( window_h, SETTING_KEY_WINDOW_H );
     
 #ifdef __WXGTK__
     /*
@@ -283,78 +324,78 @@ void PreferencesData::fillSettingsVector()
     Setting* launchFluidSynth = new Setting(fromCString(SETTING_ID_LAUNCH_FLUIDSYNTH),
                                      _("Automatically launch FluidSynth if needed"),
                                      SETTING_BOOL, SETTING_CATEGORY_AUDIO, wxT("1") );
-    m_settings.push_back(launchFluidSynth);
+    addSetting( launchFluidSynth, SETTING_KEY_LAUNCH_FLUIDSYNTH );
 #endif
 
 #ifndef __WXMAC__
     Setting* singleInstance = new Setting(fromCString(SETTING_ID_SINGLE_INSTANCE_APPLICATION),
                                      _("Single-instance application"),
                                      SETTING_BOOL, SETTING_CATEGORY_UI, wxT("1") );
-    m_settings.push_back( singleInstance );
+    addSetting( singleInstance, SETTING_KEY_SINGLE_INSTANCE_APPLICATION );
 #endif
 
     Setting* showNoteNames = new Setting(fromCString(SETTING_ID_SHOW_NOTE_NAMES),
                                      _("Show note names in piano-roll"),
                                      SETTING_BOOL, SETTING_CATEGORY_EDITION, wxT("1") );
-    m_settings.push_back(showNoteNames);
+    addSetting( showNoteNames, SETTING_KEY_SHOW_NOTE_NAMES );
     
     
     Setting* loadLastSession = new Setting(fromCString(SETTING_ID_LOAD_LAST_SESSION),
                                      _("Restore open files from previous session"),
                                      SETTING_BOOL, SETTING_CATEGORY_UI, wxT("0") );
-    m_settings.push_back(loadLastSession); 
+    addSetting( loadLastSession, SETTING_KEY_LOAD_LAST_SESSION );
     
     
     Setting* lastSessionFiles = new Setting(fromCString(SETTING_ID_LAST_SESSION_FILES),
                                      wxT("Last session files"),
                                      SETTING_STRING, SETTING_CATEGORY_HIDDEN, wxT("") );
-    m_settings.push_back(lastSessionFiles); 
+    addSetting( lastSessionFiles );
     
     
     Setting* lastCurrentSequence = new Setting(fromCString(SETTING_ID_LAST_CURRENT_SEQUENCE),
                                      wxT("Last Current Sequence"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("0"));
-    m_settings.push_back(lastCurrentSequence); 
+    addSetting( lastCurrentSequence, SETTING_KEY_LAST_CURRENT_SEQUENCE );
     
     
     
     Setting* recentFiles = new Setting(fromCString(SETTING_ID_RECENT_FILES),
                                      wxT("Recent files"),
                                      SETTING_STRING, SETTING_CATEGORY_HIDDEN, wxT("") );
-    m_settings.push_back(recentFiles); 
+    addSetting( recentFiles );
     
     
 
     Setting* output = new Setting(fromCString(SETTING_ID_MIDI_OUTPUT), wxT(""),
                                   SETTING_STRING, SETTING_CATEGORY_HIDDEN, DEFAULT_PORT );
-    m_settings.push_back( output );
+    addSetting( output );
     
     Setting* input = new Setting(fromCString(SETTING_ID_MIDI_INPUT), wxT(""),
                                  // NOTE: there is an identical string in MainFrameMenuBar that must be changed too if changed here
                                  SETTING_STRING, SETTING_CATEGORY_HIDDEN, _("No MIDI input") );
-    m_settings.push_back( input );
+    addSetting( input );
     
     // ---- printing
     Setting* marginLeft = new Setting(fromCString(SETTING_ID_MARGIN_LEFT), wxT(""),
                                       SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("12") );
-    m_settings.push_back( marginLeft );
+    addSetting( marginLeft, SETTING_KEY_MARGIN_LEFT );
     
     Setting* marginRight = new Setting(fromCString(SETTING_ID_MARGIN_RIGHT), wxT(""),
                                       SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("12") );
-    m_settings.push_back( marginRight );
+    addSetting( marginRight, SETTING_KEY_MARGIN_RIGHT );
     
     Setting* marginTop = new Setting(fromCString(SETTING_ID_MARGIN_TOP), wxT(""),
                                       SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("12") );
-    m_settings.push_back( marginTop );
+    addSetting( marginTop, SETTING_KEY_MARGIN_TOP );
     
     Setting* marginBottom = new Setting(fromCString(SETTING_ID_MARGIN_BOTTOM), wxT(""),
                                       SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("16") );
-    m_settings.push_back( marginBottom );
+    addSetting( marginBottom, SETTING_KEY_MARGIN_BOTTOM );
     
     //FIXME: hope wx enum values don't change...
     Setting* paperType = new Setting(fromCString(SETTING_ID_PAPER_TYPE), wxT(""),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, to_wxString(wxPAPER_LETTER) );
-    m_settings.push_back( paperType );
+    addSetting( paperType, SETTING_KEY_PAPER_TYPE );
     
     
 #ifdef __WXGTK__
@@ -362,12 +403,12 @@ void PreferencesData::fillSettingsVector()
     Setting* audioExportEngine = new Setting(fromCString(SETTING_ID_AUDIO_EXPORT_ENGINE),
                                      wxT("Audio Export Engine"),
                                      SETTING_INT, SETTING_CATEGORY_HIDDEN, wxT("0"));
-    m_settings.push_back( audioExportEngine );
+    addSetting( audioExportEngine, SETTING_KEY_AUDIO_EXPORT_ENGINE );
                          
     Setting* fluidsynthSoundfontPath = new Setting(fromCString(SETTING_ID_FLUIDSYNTH_SOUNDFONT_PATH),
                                      wxT("Fluidsynth Soundfont Path"),
                                      SETTING_STRING, SETTING_CATEGORY_HIDDEN, DEFAULT_SOUNDFONT_PATH );
-    m_settings.push_back( fluidsynthSoundfontPath );
+    addSetting( fluidsynthSoundfontPath );
 #endif
 }
 
@@ -427,40 +468,6 @@ wxString PreferencesData::getValue(wxString entryName) const
 
 // ----------------------------------------------------------------------------------------------------------
 
-long PreferencesData::getIntValue(wxString entryName) const
-{
-    wxString asString = getValue(entryName);
-    ASSERT(not asString.IsEmpty());
-    
-    long asInt = -1;
-    if (not asString.ToLong(&asInt))
-    {
-        ASSERT(false);
-    }
-    return asInt;
-}
-
-// ----------------------------------------------------------------------------------------------------------
-
-bool PreferencesData::getBoolValue(const char* entryName, bool defaultVal) const
-{
-    wxString asString = getValue(entryName);
-    if (asString.IsEmpty()) return defaultVal;
-    
-    if (asString == wxT("true")) return true;
-    else if (asString == wxT("false")) return false;
-    
-    // otherwise try 0/1
-    long asInt = -1;
-    if (not asString.ToLong(&asInt))
-    {
-        ASSERT(false);
-    }
-    return asInt;
-}
-
-// ----------------------------------------------------------------------------------------------------------
-
 void PreferencesData::setValue(wxString entryName, wxString newValue)
 {
     const int settingAmount = m_settings.size();
@@ -469,6 +476,7 @@ void PreferencesData::setValue(wxString entryName, wxString newValue)
         if ( m_settings[i].m_name == entryName )
         {
             m_settings[i].m_value = newValue;
+            updateCachedValue( m_settings[i] );
             return;
         }
     }
@@ -476,210 +484,3 @@ void PreferencesData::setValue(wxString entryName, wxString newValue)
 }
 
 // ----------------------------------------------------------------------------------------------------------
-// ----------------------------------------------------------------------------------------------------------
-
-#if 0
-#pragma mark -
-#pragma mark Fonts
-#endif
-
-// For now fonts are not configurable and do not appear in the config file but eventually this could be done
-
-// FIXME: find why fonts are so different on OSX
-
-wxFont AriaMaestosa::getDrumNamesFont()
-{
-#ifdef __WXMAC__
-    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMSW__)
-    return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(7, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-
-wxFont AriaMaestosa::getNoteNamesFont()
-{
-#ifdef LARGE_FONTS
-    #ifdef __WXMAC__
-        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#else
-    #ifdef __WXMAC__
-        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(7, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#endif
-}
-
-
-
-wxFont AriaMaestosa::getInstrumentNameFont()
-{
-#ifdef __WXMAC__
-    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMSW__)
-    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(9,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getSequenceFilenameFont()
-{
-#ifdef __WXMAC__
-    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getTrackNameFont()
-{
-#ifdef __WXMAC__
-    return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMSW__)
-    return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getControllerFont()
-{
-#ifdef LARGE_FONTS
-    #ifdef __WXMAC__
-        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#else
-    #ifdef __WXMAC__
-        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#endif
-}
-
-wxFont AriaMaestosa::getStringNameFont()
-{
-#ifdef LARGE_FONTS
-    #ifdef __WXMAC__
-        return wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(9, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#else
-    #ifdef __WXMAC__
-        return wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #elif defined(__WXMSW__)
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#endif
-}
-
-
-wxFont AriaMaestosa::getTimeSigPrintFont()
-{
-#ifdef __WXMSW__
-    // FIXME: See http://trac.wxwidgets.org/ticket/14136
-    // fonts are too small on Windows
-    return wxFont(17,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-#elif defined(__WXMAC__)
-    return wxFont(150,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-#else
-    return wxFont(100,wxFONTFAMILY_ROMAN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-#endif
-}
-
-wxFont AriaMaestosa::getPrintTabHeaderFont()
-{
-#ifdef __WXMSW__
-    // FIXME: See http://trac.wxwidgets.org/ticket/14136
-    // fonts are too small on Windows
-    return wxFont(18, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMAC__)
-    return wxFont(85, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(65,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getPrintFont()
-{
-#ifdef __WXMSW__
-    // FIXME: See http://trac.wxwidgets.org/ticket/14136
-    // fonts are too small on Windows
-    return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMAC__)
-    return wxFont(75, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont(50,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getPrintTitleFont()
-{
-#ifdef __WXMSW__
-    // FIXME: See http://trac.wxwidgets.org/ticket/14136
-    // fonts are too small on Windows
-    return wxFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD  );
-#else
-    return wxFont(130, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD  );
-#endif
-}
-
-wxFont AriaMaestosa::getPrintSubtitleFont()
-{
-#ifdef __WXMSW__
-    // FIXME: See http://trac.wxwidgets.org/ticket/14136
-    // fonts are too small on Windows
-    return wxFont(13, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#elif defined(__WXMAC__)
-    return wxFont (90,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont (60,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
-wxFont AriaMaestosa::getNumberFont()
-{
-#ifdef LARGE_FONTS
-    return wxFont(11, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    #if defined(__WXMAC__)
-        return wxSystemSettings::GetFont(wxSYS_SYSTEM_FONT);
-    #elif defined(__WXGTK__)
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #else
-        return wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    #endif
-#endif
-}
-
-wxFont AriaMaestosa::getWelcomeMenuFont()
-{
-#ifdef __WXMAC__
-    return wxFont (18,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#else
-    return wxFont (17,  wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-#endif
-}
-
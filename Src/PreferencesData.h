@@ -51,6 +51,44 @@ namespace AriaMaestosa
         SETTING_SUBTYPE_FILE_OR_DEFAULT
     };
     
+    /**
+      * Keys of the bool, int and enum settings. Their values are kept parsed in a flat array, so that
+      * reading them (even from render or playback code) is a plain array access, without looking up
+      * or parsing strings. Settings that only exist on some platforms still get a key; reading them
+      * on other platforms yields 0.
+      */
+    enum SettingKey
+    {
+        SETTING_KEY_NONE = -1,
+        
+        SETTING_KEY_LANGUAGE,
+        SETTING_KEY_PLAY_DURING_EDIT,
+        SETTING_KEY_SCORE_VIEW,
+        SETTING_KEY_DEFAULT_EDITOR,
+        SETTING_KEY_INSTRUMENT_CLASSIFICATION,
+        SETTING_KEY_FOLLOW_PLAYBACK,
+        SETTING_KEY_PLAYTHROUGH,
+        SETTING_KEY_CHECK_NEW_VERSION,
+        SETTING_KEY_REMEMBER_WINDOW_POS,
+        SETTING_KEY_WINDOW_X,
+        SETTING_KEY_WINDOW_Y,
+        SETTING_KEY_WINDOW_W,
+        SETTING_KEY_WINDOW_H,
+        SETTING_KEY_LAUNCH_FLUIDSYNTH,
+        SETTING_KEY_SINGLE_INSTANCE_APPLICATION,
+        SETTING_KEY_SHOW_NOTE_NAMES,
+        SETTING_KEY_LOAD_LAST_SESSION,
+        SETTING_KEY_LAST_CURRENT_SEQUENCE,
+        SETTING_KEY_MARGIN_LEFT,
+        SETTING_KEY_MARGIN_RIGHT,
+        SETTING_KEY_MARGIN_TOP,
+        SETTING_KEY_MARGIN_BOTTOM,
+        SETTING_KEY_PAPER_TYPE,
+        SETTING_KEY_AUDIO_EXPORT_ENGINE,
+        
+        SETTING_KEY_COUNT
+    };
+    
 #ifdef DEFINE_SETTING_NAMES
 #define EXTERN
 #define DEFAULT(X) = X
@@ -132,6 +170,9 @@ static const wxString SYSTEM_BANK = _("System soundbank");
         wxString        m_value;
         SettingCategory m_category;
         
+        /** SETTING_KEY_NONE for string settings, which are not cached */
+        SettingKey      m_key;
+        
         Setting(wxString name, wxString user_name, SettingType type, SettingCategory category,
                 wxString default_value = wxEmptyString, SettingSubType subtype = SETTING_SUBTYPE_NONE);
         void addChoice(wxString choice);
@@ -144,9 +185,18 @@ static const wxString SYSTEM_BANK = _("System soundbank");
         
         ptr_vector<Setting> m_settings;
         
+        /** Parsed values of the settings that have a key, indexed by key */
+        long m_cached_values[SETTING_KEY_COUNT];
+        
         /** Add and init preferences values */
         void fillSettingsVector();
         
+        /** @brief adds a setting to the list; settings with a key also get their value cached */
+        void addSetting(Setting* setting, const SettingKey key = SETTING_KEY_NONE);
+        
+        /** @brief parses the value of the setting into the cache, if it has a key */
+        void updateCachedValue(const Setting& setting);
+        
         void prepareLanguageEntry();
         
         /** Private constructor */
@@ -162,11 +212,8 @@ static const wxString SYSTEM_BANK = _("System soundbank");
         /** call early */
         void init();
         
-        long getIntValue(const char* entryName) const { return getIntValue(wxString(entryName, wxConvUTF8)); }
-        bool getBoolValue(const char* entryName, bool defaultValue) const;
         wxString getValue(const char* entryName) const { return getValue(wxString(entryName, wxConvUTF8)); }
         wxString getValue(wxString entryName) const;
-        long getIntValue(wxString entryName) const;
 
         void setValue(const char* entryName, wxString newValue)
         {
@@ -174,6 +221,28 @@ static const wxString SYSTEM_BANK = _("System soundbank");
         }
         void setValue(wxString entryName, wxString newValue);
         
+        /** @return the value of a bool setting, from the cache (no lookup or parsing) */
+        bool getBoolValue(const SettingKey key) const
+        {
+            ASSERT_E(key, >=, 0);
+            ASSERT_E(key, <, SETTING_KEY_COUNT);
+            return m_cached_values[key] != 0;
+        }
+        
+        /** @return the value of an int or enum setting, from the cache (no lookup or parsing) */
+        long getIntValue(const SettingKey key) const
+        {
+            ASSERT_E(key, >=, 0);
+            ASSERT_E(key, <, SETTING_KEY_COUNT);
+            return m_cached_values[key];
+        }
+        
+        /**
+          * @brief to be called after changing the 'm_value' of settings directly (as the preferences
+          *        dialog does), so that the cached values follow
+          */
+        void refreshCachedValues();
+        
         /** write config file */
         void save();
 
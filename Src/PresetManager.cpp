@@ -15,12 +15,11 @@
  */
 
 #include "PresetManager.h"
+#include "AriaCore.h"
 #include <wx/txtstrm.h>
 #include <wx/wfstream.h>
 #include <wx/stdpaths.h>
-#include <wx/msgdlg.h>
 #include <wx/filename.h>
-#include <wx/msgdlg.h>
 
 #include "UnitTest.h"
 
@@ -131,7 +130,7 @@ void PresetGroup::write()
         #endif
         if (not success and not wxDirExists(prefix))
         {
-            wxMessageBox(wxString::Format(_("Sorry, an error occurred : could not create %s"), (const char*)prefix.mb_str()));
+            showMessage(wxString::Format(_("Sorry, an error occurred : could not create %s"), (const char*)prefix.mb_str()));
             return;
         }
     }
@@ -0,0 +1,307 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "Printing/ScoreExporter.h"
+
+#include "Batch/BatchConverter.h"
+#include "GUI/GraphicalSequence.h"
+#include "GUI/GraphicalTrack.h"
+#include "IO/AriaFileWriter.h"
+#include "IO/MidiFileReader.h"
+#include "Midi/Sequence.h"
+#include "Midi/Track.h"
+#include "Printing/AriaPrintable.h"
+#include "Printing/SymbolPrinter/SymbolPrintableSequence.h"
+#include "Tracer.h"
+
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+
+#if wxCHECK_VERSION(2,9,0)
+#include <wx/dcsvg.h>
+#endif
+
+#include <cstdio>
+#include <set>
+
+using namespace AriaMaestosa;
+
+// ----------------------------------------------------------------------------------------------------------
+
+ScoreExporter::Job::Job(const wxString& input) : m_input(input)
+{
+    m_sequence   = NULL;
+    m_success    = false;
+    m_page_count = 0;
+    
+    for (int n=0; n<PHASE_COUNT; n++) m_phase_time[n] = -1;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+ScoreExporter::Job::~Job()
+{
+    delete m_sequence;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------------
+
+ScoreExporter::ScoreExporter()
+{
+    m_total_time = 0;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+const char* ScoreExporter::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case PHASE_LOAD:   return "load";
+        case PHASE_LAYOUT: return "layout";
+        case PHASE_RENDER: return "render";
+        default:           return "?";
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool ScoreExporter::addInput(const wxString& path)
+{
+    if (BatchConverter::getFormatOf(path) == BatchConverter::FORMAT_UNKNOWN)
+    {
+        fprintf(stderr, "[ScoreExporter] Don't know how to open '%s' (expected .aria, .mid or .midi)\n",
+                (const char*)path.utf8_str());
+        return false;
+    }
+    
+    m_jobs.push_back(new Job(path));
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ScoreExporter::load(const int jobId)
+{
+    TRACE_ZONE("ScoreExporter::load");
+    Job* job = m_jobs.get(jobId);
+    
+    wxStopWatch timer;
+    
+    Sequence* sequence = new Sequence(NULL, NULL, NULL, NULL, false);
+    
+    bool success;
+    if (BatchConverter::getFormatOf(job->m_input) == BatchConverter::FORMAT_ARIA)
+    {
+        success = loadAriaFile(sequence, job->m_input);
+    }
+    else
+    {
+        std::set<wxString> warnings;
+        success = loadMidiFile(sequence, job->m_input, warnings);
+    }
+    job->m_phase_time[PHASE_LOAD] = timer.Time();
+    
+    if (not success)
+    {
+        fprintf(stderr, "[ScoreExporter] Failed to load '%s'\n", (const char*)job->m_input.utf8_str());
+        delete sequence;
+        return;
+    }
+    
+    sequence->setSequenceFilename( wxFileName(job->m_input).GetName() );
+    job->m_sequence = sequence;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool ScoreExporter::exportJob(Job* job)
+{
+    TRACE_ZONE("ScoreExporter::exportJob");
+    
+    // the graphical sequence takes ownership of the sequence
+    GraphicalSequence gseq(job->m_sequence);
+    job->m_sequence = NULL;
+    gseq.createViewForTracks(-1 /* all */);
+    
+    Sequence* sequence = gseq.getModel();
+    
+    wxStopWatch timer;
+    
+    // ---- layout
+    bool success = false;
+    AriaPrintable printable(AbstractPrintableSequence::getTitle(sequence), &success);
+    if (not success)
+    {
+        fprintf(stderr, "[ScoreExporter] Page setup failed\n");
+        return false;
+    }
+    
+    SymbolPrintableSequence printableSeq(sequence);
+    printable.setSequence(&printableSeq);
+    
+    bool anyTrack = false;
+    const int trackAmount = sequence->getTrackAmount();
+    for (int n=0; n<trackAmount; n++)
+    {
+        Track* track = sequence->getTrack(n);
+        GraphicalTrack* gtrack = gseq.getGraphicsFor(track);
+        
+        // keyroll printing cannot be mixed with score/tablature, and has no use for bulk engraving
+        if (track->isNotationTypeEnabled(SCORE))
+        {
+            if (not printableSeq.addTrack(gtrack, SCORE)) return false;
+            anyTrack = true;
+        }
+        if (track->isNotationTypeEnabled(GUITAR))
+        {
+            if (not printableSeq.addTrack(gtrack, GUITAR)) return false;
+            anyTrack = true;
+        }
+    }
+    
+    if (not anyTrack)
+    {
+        fprintf(stderr, "[ScoreExporter] '%s' has no score or tablature track\n",
+                (const char*)job->m_input.utf8_str());
+        return false;
+    }
+    
+    {
+        TRACE_ZONE("ScoreExporter layout");
+        timer.Start();
+        printableSeq.calculateLayout();
+        job->m_phase_time[PHASE_LAYOUT] = timer.Time();
+    }
+    
+    // ---- render, one SVG file per page
+#if wxCHECK_VERSION(2,9,0)
+    timer.Start();
+    
+    wxFileName output(job->m_input);
+    if (not m_output_dir.IsEmpty()) output.SetPath(m_output_dir);
+    const wxString baseName = output.GetName();
+    
+    const int width  = printable.getUnitWidth();
+    const int height = printable.getUnitHeight();
+    
+    job->m_page_count = printableSeq.getPageAmount();
+    for (int page=1; page<=job->m_page_count; page++)
+    {
+        TRACE_ZONE("ScoreExporter page");
+        
+        output.SetName( wxString::Format(wxT("%s-%i"), baseName.c_str(), page) );
+        output.SetExt( wxT("svg") );
+        
+        // print units are 1/315 cm; tell the SVG so, so that pages come out at the right physical size
+        wxSVGFileDC dc(output.GetFullPath(), width, height, UNITS_PER_CM * 2.54f);
+        if (not dc.IsOk())
+        {
+            fprintf(stderr, "[ScoreExporter] Cannot write '%s'\n", (const char*)output.GetFullPath().utf8_str());
+            return false;
+        }
+        
+        printable.printPage(page, dc, NULL, 0, 0, width, height);
+    }
+    
+    job->m_phase_time[PHASE_RENDER] = timer.Time();
+    return true;
+#else
+    fprintf(stderr, "[ScoreExporter] SVG export requires wxWidgets 2.9 or later\n");
+    return false;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool ScoreExporter::run()
+{
+    const int count = m_jobs.size();
+    
+    wxStopWatch timer;
+    
+    // one file at a time : the readers are not reentrant (see g_load_mutex), and layout and rendering
+    // must stay on the main thread; loading a file just before exporting it also means that only one
+    // sequence is in memory at a time
+    for (int n=0; n<count; n++)
+    {
+        load(n);
+        
+        Job* job = m_jobs.get(n);
+        if (job->m_sequence == NULL) continue;
+        
+        job->m_success = exportJob(job);
+        
+        if (not job->m_success)
+        {
+            fprintf(stderr, "[ScoreExporter] Failed to export '%s'\n", (const char*)job->m_input.utf8_str());
+        }
+    }
+    
+    m_total_time = timer.Time();
+    
+    bool success = true;
+    for (int n=0; n<count; n++)
+    {
+        if (not m_jobs[n].m_success) success = false;
+    }
+    return success;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ScoreExporter::printReport() const
+{
+    const int count = m_jobs.size();
+    
+    long totals[PHASE_COUNT] = { 0 };
+    int  pageTotal = 0;
+    int  failures  = 0;
+    
+    printf("%-40s %8s %8s %8s %8s\n", "file", getPhaseName(PHASE_LOAD), getPhaseName(PHASE_LAYOUT),
+           getPhaseName(PHASE_RENDER), "pages");
+    
+    for (int n=0; n<count; n++)
+    {
+        const Job& job = m_jobs[n];
+        
+        printf("%-40s", (const char*)wxFileName(job.m_input).GetFullName().utf8_str());
+        for (int p=0; p<PHASE_COUNT; p++)
+        {
+            if (job.m_phase_time[p] < 0)
+            {
+                printf(" %8s", "-");
+            }
+            else
+            {
+                printf(" %8ld", job.m_phase_time[p]);
+                totals[p] += job.m_phase_time[p];
+            }
+        }
+        printf(" %8i%s\n", job.m_page_count, job.m_success ? "" : "  FAILED");
+        
+        pageTotal += job.m_page_count;
+        if (not job.m_success) failures++;
+    }
+    
+    printf("%-40s", "total (ms, summed over files)");
+    for (int p=0; p<PHASE_COUNT; p++) printf(" %8ld", totals[p]);
+    printf(" %8i\n", pageTotal);
+    
+    printf("%i file(s), %i failed, %ld ms wall time\n", count, failures, m_total_time);
+}
@@ -0,0 +1,113 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef __SCORE_EXPORTER_H__
+#define __SCORE_EXPORTER_H__
+
+#include "ptr_vector.h"
+#include "Utils.h"
+
+#include <wx/string.h>
+
+namespace AriaMaestosa
+{
+    class Sequence;
+    
+    /**
+      * @brief engraves score and tablature tracks of several files to SVG, without showing any window
+      *        or print dialog.
+      *
+      * Used by 'Aria --export-svg' (see main.cpp). Files are handled one after the other : each one
+      * is loaded, laid out once (PrintLayoutAbstract/PrintLayoutNumeric) and every page is written to
+      * its own SVG file, 'name-1.svg', 'name-2.svg', etc. Nothing runs in parallel : the file readers
+      * are not reentrant (see g_load_mutex), font metrics and DCs are not thread-safe in wxWidgets, and
+      * the EditorPrintable objects keep per-line state while drawing.
+      * @ingroup printing
+      */
+    class ScoreExporter
+    {
+    public:
+        
+        enum Phase
+        {
+            PHASE_LOAD,
+            PHASE_LAYOUT,
+            PHASE_RENDER,
+            
+            PHASE_COUNT
+        };
+        
+        /** @brief one input file, with its export results */
+        struct Job
+        {
+            wxString m_input;
+            
+            /** Loaded sequence, owned by the job until it is handed over for export */
+            Sequence* m_sequence;
+            
+            bool m_success;
+            int  m_page_count;
+            
+            /** Time spent in each phase, in milliseconds; -1 if the phase was not run */
+            long m_phase_time[PHASE_COUNT];
+            
+            Job(const wxString& input);
+            ~Job();
+        };
+        
+    private:
+        
+        ptr_vector<Job, HOLD> m_jobs;
+        
+        /** Where output files go; empty means next to the input file */
+        wxString m_output_dir;
+        
+        long m_total_time;
+        
+        /** @brief lays out the given (loaded) file and writes its pages; must run on the main thread */
+        bool exportJob(Job* job);
+        
+    public:
+        
+        ScoreExporter();
+        
+        static const char* getPhaseName(Phase phase);
+        
+        void setOutputDirectory(const wxString& dir) { m_output_dir = dir; }
+        
+        /** @return false if the file is of a format that cannot be opened */
+        bool addInput(const wxString& path);
+        
+        int getJobCount() const               { return m_jobs.size(); }
+        const Job& getJob(const int id) const { return m_jobs[id];    }
+        
+        /** @brief loads a single file; called for each job by 'run', on the main thread */
+        void load(const int jobId);
+        
+        /**
+          * @brief export all files that were added
+          * @return whether all exports succeeded
+          */
+        bool run();
+        
+        /** @brief print per-file and per-phase timings to stdout */
+        void printReport() const;
+    };
+    
+}
+
+#endif
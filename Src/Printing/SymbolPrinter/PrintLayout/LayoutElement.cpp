@@ -29,5 +29,24 @@ LayoutElement::LayoutElement(LayoutElementType type_arg, int measure_arg)
     m_render_start_bar = true;
     
     m_tempo_change = -1;
+    
+    width_in_print_units = 0;
+    num           = -1;
+    denom         = -1;
+    amountOfTimes = 0;
+    firstMeasure         = -1;
+    lastMeasure          = -1;
+    firstMeasureToRepeat = -1;
+    lastMeasureToRepeat  = -1;
+}
+
+// -------------------------------------------------------------------------------------------
+
+bool LayoutElement::hasSameLayoutAs(const LayoutElement& other) const
+{
+    return m_type == other.m_type and m_measure == other.m_measure and
+           width_in_print_units == other.width_in_print_units and m_tempo_change == other.m_tempo_change and
+           m_render_start_bar == other.m_render_start_bar and m_render_end_bar == other.m_render_end_bar and
+           num == other.num and denom == other.denom and amountOfTimes == other.amountOfTimes;
 }
 
@@ -52,6 +52,12 @@ namespace AriaMaestosa
 
         LayoutElementType getType() const { return m_type; }
         
+        /**
+          * @return whether both elements take the same room and show the same thing (x coordinates,
+          *         which are only set when printing, are not compared)
+          */
+        bool hasSameLayoutAs(const LayoutElement& other) const;
+        
         int m_measure;
          /** 
            * @brief whether to draw a vertical divider line at the start of this element 
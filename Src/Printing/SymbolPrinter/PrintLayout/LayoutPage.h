@@ -60,6 +60,17 @@ namespace AriaMaestosa
             m_layout_lines.push_back(line);
         }
         
+        /** @brief deletes the line 'lineID' and all lines after it */
+        void eraseLinesFrom(const int lineID)
+        {
+            ASSERT( MAGIC_NUMBER_OK() );
+            
+            for (int n=m_layout_lines.size()-1; n>=lineID; n--)
+            {
+                m_layout_lines.erase(n);
+            }
+        }
+        
         void moveYourLastLineTo( LayoutPage& otherPage )
         {
             ASSERT( &otherPage != this );
@@ -18,7 +18,9 @@
 
 #include "Dialogs/WaitWindow.h"
 #include "Editors/GuitarEditor.h"
+#include "Editors/ScoreEditor.h"
 #include "GUI/GraphicalTrack.h"
+#include "Midi/GuitarTuning.h"
 #include "Midi/Track.h"
 #include "Midi/Sequence.h"
 #include "Midi/MeasureData.h"
@@ -31,6 +33,7 @@
 
 #include "AriaCore.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <map>
@@ -78,6 +81,23 @@ namespace AriaMaestosa
     }
 }
 
+/**
+  * Symbol placements of the last layout, kept across print jobs : printing the same song again (or
+  * after a small edit) only places the symbols of measures that changed. Only the last laid out
+  * sequence is remembered.
+  */
+namespace PrintLayoutCache
+{
+    /** The sequence the cached measures belong to; only compared, never dereferenced */
+    const Sequence* g_sequence = NULL;
+    
+    /** See PrintLayoutAbstract::calculateLayoutContext */
+    unsigned int g_context = 0;
+    
+    /** One entry per measure of the last layout */
+    std::vector<CachedMeasureLayout> g_measures;
+}
+
     
 // -----------------------------------------------------------------------------------------------------
 // -----------------------------------------------------------------------------------------------------
@@ -96,17 +116,20 @@ void PrintLayoutAbstract::generateMeasures(ptr_vector<GraphicalTrack, REF>& trac
     const int trackAmount = tracks.size();
     const int measureAmount = seq->getMeasureData()->getMeasureAmount();
     
+    ASSERT(trackAmount > 0);
+    
+    // measures of a previous layout pass are replaced; lines kept from it will be pointed to the new ones
+    m_measures.clearAndDeleteAll();
+    for (int measure=0; measure<measureAmount; measure++)
+    {
+        m_measures.push_back( new PrintLayoutMeasure(measure, tracks.get(0)->getTrack()->getSequence()) );
+    }
+    
     for (int tr=0; tr<trackAmount; tr++)
     {
         GraphicalTrack* gtrack = tracks.get(tr);
         Track* track = gtrack->getTrack();
         
-        // add m_measures
-        for (int measure=0; measure<measureAmount; measure++)
-        {
-            m_measures.push_back( new PrintLayoutMeasure(measure, track->getSequence()) );
-        }
-        
         if (track->getNoteAmount() == 0) continue; //empty track
         
         int note=0;
@@ -125,12 +148,138 @@ void PrintLayoutAbstract::generateMeasures(ptr_vector<GraphicalTrack, REF>& trac
         WaitWindow::setProgress( tr*10/trackAmount );
         
     } // next track
+    
+    for (int measure=0; measure<measureAmount; measure++)
+    {
+        m_measures[measure].calculateFingerprint(m_sequence);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+unsigned int PrintLayoutAbstract::calculateLayoutContext(ptr_vector<GraphicalTrack, REF>& tracks)
+{
+    AriaPrintable* printable = AriaPrintable::getCurrentPrintable();
+    
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    #define HASH_INT( VALUE ) hash = (hash ^ (unsigned int)(VALUE)) * 16777619u
+    
+    HASH_INT(printable->getUnitWidth());
+    HASH_INT(printable->getUsableAreaHeight(1));
+    HASH_INT(printable->getUsableAreaHeight(2));
+    HASH_INT(printable->getCharacterWidth());
+    HASH_INT(printable->hideEmptyTracks());
+    
+    const int trackAmount = tracks.size();
+    HASH_INT(trackAmount);
+    for (int n=0; n<trackAmount; n++)
+    {
+        GraphicalTrack* gtrack = tracks.get(n);
+        Track* track = gtrack->getTrack();
+        
+        HASH_INT(track->getId());
+        
+        if (dynamic_cast<ScorePrintable*>(m_sequence->getEditorPrintable(n)) != NULL)
+        {
+            const ScoreEditor* scoreEditor = gtrack->getScoreEditor();
+            HASH_INT(1);
+            HASH_INT(scoreEditor->isGClefEnabled());
+            HASH_INT(scoreEditor->isFClefEnabled());
+            HASH_INT(scoreEditor->getOctaveShift());
+            
+            // accidentals depend on the key
+            const KeyInclusionType* keyNotes = track->getKeyNotes();
+            for (int note=0; note<131; note++) HASH_INT(keyNotes[note]);
+        }
+        else
+        {
+            const std::vector<int>& tuning = track->getGuitarTuning()->tuning;
+            HASH_INT(2);
+            HASH_INT(tuning.size());
+            for (unsigned int string=0; string<tuning.size(); string++) HASH_INT(tuning[string]);
+        }
+    }
+    
+    #undef HASH_INT
+    return hash;
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+void PrintLayoutAbstract::reuseCachedMeasures(const unsigned int context)
+{
+    using namespace PrintLayoutCache;
+    
+    if (g_sequence != m_sequence->getSequence() or g_context != context) return;
+    
+    const int measureAmount = m_measures.size();
+    const int cachedAmount  = g_measures.size();
+    
+    // a measure also depends on notes that reach into it from earlier measures (rests are placed around
+    // them), and analysing a measure looks at its neighbours; so a change also invalidates the measures
+    // its notes (before or after the edit) reach into, and the measure right before it
+    std::vector<bool> contentChanged(measureAmount);
+    std::vector<bool> invalidated(measureAmount);
+    int changedUntilTick = -1;
+    
+    for (int m=0; m<measureAmount; m++)
+    {
+        PrintLayoutMeasure& measure = m_measures[m];
+        
+        contentChanged[m] = (m >= cachedAmount or not measure.hasSameContentAs(g_measures[m]));
+        if (contentChanged[m])
+        {
+            changedUntilTick = std::max(changedUntilTick, measure.getLastNoteEnd());
+            if (m < cachedAmount) changedUntilTick = std::max(changedUntilTick, g_measures[m].m_last_note_end);
+        }
+        
+        invalidated[m] = contentChanged[m] or measure.getFirstTick() < changedUntilTick;
+    }
+    
+    for (int m=0; m<measureAmount; m++)
+    {
+        if (invalidated[m]) continue;
+        if (m+1 < measureAmount and contentChanged[m+1]) continue;
+        if (not g_measures[m].m_placement_done) continue;
+        
+        m_measures[m].reuseLayout(g_measures[m]);
+    }
+    
+#if BE_VERBOSE
+    int reusedAmount = 0;
+    for (int m=0; m<measureAmount; m++)
+    {
+        if (m_measures[m].isLayoutReused()) reusedAmount++;
+    }
+    std::cout << "[PrintLayoutAbstract] Reusing the symbol placement of " << reusedAmount << " out of "
+              << measureAmount << " measures" << std::endl;
+#endif
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+void PrintLayoutAbstract::saveMeasuresToCache(const unsigned int context)
+{
+    using namespace PrintLayoutCache;
+    
+    g_sequence = m_sequence->getSequence();
+    g_context  = context;
+    
+    const int measureAmount = m_measures.size();
+    g_measures.clear();
+    g_measures.reserve(measureAmount);
+    for (int m=0; m<measureAmount; m++)
+    {
+        g_measures.push_back( CachedMeasureLayout(m_measures[m]) );
+    }
 }
 
 // -----------------------------------------------------------------------------------------------------
 
 void PrintLayoutAbstract::calculateLayoutElements (ptr_vector<GraphicalTrack, REF>& tracks,
-                                                   ptr_vector<LayoutPage>& layoutPages)
+                                                   ptr_vector<LayoutPage>& layoutPages,
+                                                   const bool sameContext)
 {
     ASSERT(m_measures.size() > 0); // generating m_measures must have been done first
     std::vector<LayoutElement> layoutElements;
@@ -149,8 +298,38 @@ void PrintLayoutAbstract::calculateLayoutElements (ptr_vector<GraphicalTrack, RE
     createLayoutElements(layoutElements);
     calculateRelativeLengths(layoutElements);
     
+    const int firstChangedElement = findFirstChangedElement(layoutElements, sameContext);
+    
     // this will also move the layoutElements to their corresponding LayoutLine object
-    layInLinesAndPages(layoutElements, layoutPages);
+    layInLinesAndPages(layoutElements, layoutPages, firstChangedElement);
+    
+    m_previous_elements = layoutElements;
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+int PrintLayoutAbstract::findFirstChangedElement(const std::vector<LayoutElement>& layoutElements,
+                                                 const bool sameContext) const
+{
+    if (not sameContext) return 0;
+    
+    const int amount         = layoutElements.size();
+    const int previousAmount = m_previous_elements.size();
+    
+    for (int n=0; n<amount; n++)
+    {
+        if (n >= previousAmount) return n;
+        if (not layoutElements[n].hasSameLayoutAs(m_previous_elements[n])) return n;
+        
+        // lines also keep data about the notes they show, so same-sized measures may still differ
+        const int measure = layoutElements[n].m_measure;
+        if (layoutElements[n].getType() == SINGLE_MEASURE and not m_measures[measure].isLayoutReused())
+        {
+            return n;
+        }
+    }
+    
+    return amount;
 }
 
 // -----------------------------------------------------------------------------------------------------
@@ -333,23 +512,28 @@ void PrintLayoutAbstract::calculateRelativeLengths(std::vector<LayoutElement>& l
             PrintLayoutMeasure& meas = m_measures[layoutElements[n].m_measure];
             RelativePlacementManager& ticks_relative_position = meas.getTicksPlacementManager();
             
-            const int trackAmount = meas.getTrackRefAmount();
-            
+            // unchanged since the previous layout, so the placement is already known
+            if (not meas.isPlacementDone())
+            {
+                const int trackAmount = meas.getTrackRefAmount();
+                
 #if BE_VERBOSE
-            std::cout << "  -> collecting ticks from " << trackAmount << " tracks\n";
+                std::cout << "  -> collecting ticks from " << trackAmount << " tracks\n";
 #endif
-            
-            for (int i=0; i<trackAmount; i++)
-            {
-                MeasureTrackReference& track_ref = meas.getWritableTrackRef(i);
-                EditorPrintable* editorPrintable = m_sequence->getEditorPrintableFor( track_ref.getTrack()->getTrack() );
-                ASSERT( editorPrintable != NULL );
                 
-                editorPrintable->addUsedTicks(meas, i, track_ref, ticks_relative_position);
+                for (int i=0; i<trackAmount; i++)
+                {
+                    MeasureTrackReference& track_ref = meas.getWritableTrackRef(i);
+                    EditorPrintable* editorPrintable = m_sequence->getEditorPrintableFor( track_ref.getTrack()->getTrack() );
+                    ASSERT( editorPrintable != NULL );
+                    
+                    editorPrintable->addUsedTicks(meas, i, track_ref, ticks_relative_position);
+                }
+                
+                ticks_relative_position.calculateRelativePlacement();
+                meas.setPlacementDone();
             }
             
-            ticks_relative_position.calculateRelativePlacement();
-            
             /*
             layoutElements[n].width_in_units = ticks_relative_position.getUnitCount();
             if (layoutElements[n].width_in_units < MIN_UNIT_WIDTH)
@@ -383,7 +567,7 @@ void PrintLayoutAbstract::calculateRelativeLengths(std::vector<LayoutElement>& l
 
 void PrintLayoutAbstract::terminateLine(LayoutLine* currentLine, ptr_vector<LayoutPage>& layoutPages,
                                         const int maxLevelHeight, bool hideEmptyTracks,
-                                        int& current_height, int& current_page)
+                                        int& current_height, int& current_page, const int nextElement)
 {
     const int line_height = currentLine->calculateHeight(hideEmptyTracks);
     current_height += line_height;
@@ -406,7 +590,14 @@ void PrintLayoutAbstract::terminateLine(LayoutLine* currentLine, ptr_vector<Layo
         // move
         current_page++;
         layoutPages[current_page-1].moveYourLastLineTo(layoutPages[current_page]);
-    }    
+    }
+    
+    LineBreak lineBreak;
+    lineBreak.m_next_element = nextElement;
+    lineBreak.m_page         = current_page;
+    lineBreak.m_line_in_page = layoutPages[current_page].getLineCount() - 1;
+    lineBreak.m_height_after = current_height;
+    m_line_breaks.push_back(lineBreak);
 }
 
 // -----------------------------------------------------------------------------------------------------
@@ -433,7 +624,8 @@ LayoutElement PrintLayoutAbstract::generateLineHeaderElement() const
 // -----------------------------------------------------------------------------------------------------
 
 void PrintLayoutAbstract::layInLinesAndPages(std::vector<LayoutElement>& layoutElements,
-                                             ptr_vector<LayoutPage>& layoutPages)
+                                             ptr_vector<LayoutPage>& layoutPages,
+                                             const int firstChangedElement)
 {
     std::cout << "\n====\nlayInLinesAndPages\n====\n";
     
@@ -459,27 +651,76 @@ void PrintLayoutAbstract::layInLinesAndPages(std::vector<LayoutElement>& layoutE
 
     ptr_vector<PrintLayoutMeasure, REF> measures_ref = m_measures.getWeakView();
 
-    // create a first page
-    int current_page = 0;
-    layoutPages.push_back( new LayoutPage() );
-    
-    // create a first line
-    LayoutLine* currentLine = new LayoutLine(m_sequence, measures_ref);
-    layoutPages[current_page].addLine( currentLine );
-    currentLine->setLevelFrom(current_height);
-
-    // add line header
+    // ---- keep the lines of the previous pass that are not affected by any change : a line can be
+    //      kept if neither its elements, nor the ones that decided where it ends, changed
+    int keptLines = 0;
+    while (keptLines < (int)m_line_breaks.size() and
+           m_line_breaks[keptLines].m_next_element + 1 < firstChangedElement)
     {
-    LayoutElement el = generateLineHeaderElement();
-    current_width += el.width_in_print_units;
-    currentLine->addLayoutElement( el );
+        keptLines++;
     }
     
+    int current_page = 0;
+    LayoutLine* currentLine = NULL;
     bool first_line = true;
+    int firstElement = 0;
+    
+    if (keptLines > 0)
+    {
+        const LineBreak lastKept = m_line_breaks[keptLines - 1];
+#if BE_VERBOSE
+        std::cout << "[PrintLayoutAbstract] Keeping the first " << keptLines << " lines out of "
+                  << m_line_breaks.size() << std::endl;
+#endif
+        
+        while (layoutPages.size() > lastKept.m_page + 1) layoutPages.erase(layoutPages.size() - 1);
+        layoutPages[lastKept.m_page].eraseLinesFrom(lastKept.m_line_in_page + 1);
+        m_line_breaks.resize(keptLines);
+        
+        for (int p=0; p<layoutPages.size(); p++)
+        {
+            for (int l=0; l<layoutPages[p].getLineCount(); l++) layoutPages[p].getLine(l).setMeasures(measures_ref);
+        }
+        
+        // resume as if the last kept line had just been terminated
+        current_page   = lastKept.m_page;
+        current_height = lastKept.m_height_after;
+        first_line     = false;
+        firstElement   = lastKept.m_next_element;
+        
+        currentLine = new LayoutLine(m_sequence, measures_ref);
+        layoutPages[current_page].addLine( currentLine );
+        currentLine->setLevelFrom(current_height);
+        
+        if (HEADER_ON_EVERY_LINE)
+        {
+            LayoutElement el = generateLineHeaderElement();
+            current_width += el.width_in_print_units;
+            currentLine->addLayoutElement( el );
+        }
+    }
+    else
+    {
+        layoutPages.clearAndDeleteAll();
+        m_line_breaks.clear();
+        
+        // create a first page
+        layoutPages.push_back( new LayoutPage() );
+        
+        // create a first line
+        currentLine = new LayoutLine(m_sequence, measures_ref);
+        layoutPages[current_page].addLine( currentLine );
+        currentLine->setLevelFrom(current_height);
+        
+        // add line header
+        LayoutElement el = generateLineHeaderElement();
+        current_width += el.width_in_print_units;
+        currentLine->addLayoutElement( el );
+    }
     
     // add layout elements one by one, switching to the next line when there's too many
     // elements on the current one
-    for (int n=0; n<layoutElementsAmount; n++)
+    for (int n=firstElement; n<layoutElementsAmount; n++)
     {
         if ((n & 3) == 0) // only update progress one element out of 4
         {
@@ -512,7 +753,7 @@ void PrintLayoutAbstract::layInLinesAndPages(std::vector<LayoutElement>& layoutE
             const int maxLevelHeight = (current_page == 1 ? maxLevelsOnPage1 : maxLevelsOnOtherPages);
             terminateLine( currentLine, layoutPages, maxLevelHeight,
                            AriaPrintable::getCurrentPrintable()->hideEmptyTracks() and not first_line,
-                           current_height, current_page );
+                           current_height, current_page, n );
             first_line = false;
             
             ASSERT(current_height <= (current_page == 1 ? maxLevelsOnPage1 : maxLevelsOnOtherPages));
@@ -541,7 +782,7 @@ void PrintLayoutAbstract::layInLinesAndPages(std::vector<LayoutElement>& layoutE
     const int maxLevelHeight = (current_page == 1 ? maxLevelsOnPage1 : maxLevelsOnOtherPages);
     terminateLine( currentLine, layoutPages, maxLevelHeight,
                    AriaPrintable::getCurrentPrintable()->hideEmptyTracks() and not first_line,
-                   current_height, current_page );
+                   current_height, current_page, layoutElementsAmount );
     
     ASSERT(current_height <= (current_page == 1 ? maxLevelsOnPage1 : maxLevelsOnOtherPages));
     
@@ -590,6 +831,7 @@ void PrintLayoutAbstract::layInLinesAndPages(std::vector<LayoutElement>& layoutE
 PrintLayoutAbstract::PrintLayoutAbstract(SymbolPrintableSequence* sequence)
 {
     m_sequence = sequence;
+    m_previous_context = 0;
 }
 
 // -----------------------------------------------------------------------------------------------------
@@ -599,9 +841,16 @@ void PrintLayoutAbstract::addLayoutInformation(ptr_vector<GraphicalTrack, REF>&
 {    
     ASSERT( MAGIC_NUMBER_OK_FOR(tracks) );
 
+    const unsigned int context = calculateLayoutContext(tracks);
+    const bool sameContext = (layoutPages.size() > 0 and context == m_previous_context);
+    
     generateMeasures(tracks);
+    reuseCachedMeasures(context);
+    
+    calculateLayoutElements(tracks, layoutPages, sameContext);
     
-    calculateLayoutElements(tracks, layoutPages);
+    saveMeasuresToCache(context);
+    m_previous_context = context;
 }
 
 // -----------------------------------------------------------------------------------------------------
@@ -54,14 +54,61 @@ namespace AriaMaestosa
           */
         ptr_vector<PrintLayoutMeasure> m_measures; 
         
+        /** Where a line of the previous layout pass ended, so that line breaking can resume after it */
+        struct LineBreak
+        {
+            /** Index (within all layout elements) of the first element after this line */
+            int m_next_element;
+            
+            int m_page;
+            int m_line_in_page;
+            
+            /** Vertical position (in levels) on the page right after this line */
+            int m_height_after;
+        };
+        
+        /** Layout elements of the previous layout pass, to find out what changed in the next one */
+        std::vector<LayoutElement> m_previous_elements;
+        
+        /** One entry per line of the previous layout pass */
+        std::vector<LineBreak> m_line_breaks;
+        
+        /** What 'calculateLayoutContext' returned in the previous layout pass */
+        unsigned int m_previous_context;
+        
+        /**
+          * @return a hash of everything besides notes that the layout depends on (printed tracks and
+          *         how they are shown, page size, ...); a layout can only be partly reused when its
+          *         context did not change
+          */
+        unsigned int calculateLayoutContext(ptr_vector<GraphicalTrack, REF>& tracks);
+        
+        /**
+          * @brief takes over symbol placements from the last layout of this sequence (possibly from a
+          *        previous print job) for measures that did not change
+          */
+        void reuseCachedMeasures(const unsigned int context);
+        
+        /** @brief keeps symbol placements of this layout for the next one (see 'reuseCachedMeasures') */
+        void saveMeasuresToCache(const unsigned int context);
+        
+        /**
+          * @return the index of the first element that differs from the previous layout pass of this
+          *         object, or 0 if it must be laid out from scratch
+          */
+        int findFirstChangedElement(const std::vector<LayoutElement>& layoutElements,
+                                    const bool sameContext) const;
+        
 
         /**
           * @brief Builds the Page/Line layout tree from the full list of layout elements
           *
           * Creates LayoutPage and LayoutLine objects, add the created layout elements to their
-          * corresponding line
+          * corresponding line. Lines of the previous layout pass that end before 'firstChangedElement'
+          * are kept as they are, and line breaking resumes after them.
           */
-        void layInLinesAndPages(std::vector<LayoutElement>& layoutElements, ptr_vector<LayoutPage>& layoutPages);
+        void layInLinesAndPages(std::vector<LayoutElement>& layoutElements, ptr_vector<LayoutPage>& layoutPages,
+                                const int firstChangedElement);
         
         /** The main goal of this method is to set the 'width_in_print_units' member of each LayoutElement */
         void calculateRelativeLengths(std::vector<LayoutElement>& layoutElements);
@@ -78,7 +125,8 @@ namespace AriaMaestosa
         
         /** utility method invoked by 'layInLinesAndPages' when a line is complete */
         void terminateLine(LayoutLine* line, ptr_vector<LayoutPage>& layoutPages, const int maxLevelHeight,
-                           bool hideEmptyTracks, int& current_height, int& current_page);
+                           bool hideEmptyTracks, int& current_height, int& current_page,
+                           const int nextElement);
 
         /** generates measures. needs to be called before "calculateLayoutElements" */
         void generateMeasures(ptr_vector<GraphicalTrack, REF>& tracks);
@@ -89,7 +137,7 @@ namespace AriaMaestosa
           * @param[out] layoutPages
           */
         void calculateLayoutElements(ptr_vector<GraphicalTrack, REF>& tracks,
-                                     ptr_vector<LayoutPage>& layoutPages);
+                                     ptr_vector<LayoutPage>& layoutPages, const bool sameContext);
         
         /**
           * Small factory function to generate line ehader elements
@@ -105,11 +153,13 @@ namespace AriaMaestosa
         
         /**
           * @brief                  main function called from other classes
-          * @pre           measures must have been generated.
+          *
+          * May be called again on the same object after the sequence was edited; only measures
+          * that changed are placed again, and only lines from the first one that changed are
+          * broken again (the pages from the previous call are updated in place).
+          *
           * @param tracks           a list of all tracks to be printed.
-          * @param[out] layoutPages the vector of pages that is filled by this call
-          * @param findReps         whether to use the feature to automatically attempt to detect
-          *                         repeated song sections
+          * @param[in,out] layoutPages the vector of pages that is filled by this call
           */
         void addLayoutInformation(ptr_vector<GraphicalTrack, REF>& tracks, ptr_vector<LayoutPage>& layoutPages);
     };
@@ -172,6 +172,12 @@ namespace AriaMaestosa
         
         void addLayoutElement( const LayoutElement& newElem );
         
+        /**
+          * @brief points this line to the measures of a new layout pass, when the line itself is kept
+          *        because nothing it shows changed
+          */
+        void setMeasures(ptr_vector<PrintLayoutMeasure, REF>& measures) { m_measures = measures; }
+        
         int getTrackAmount() const;
         const LineTrackRef& getLineTrackRef(const int trackID) const
         {
@@ -22,6 +22,10 @@
 #include "PrintLayoutMeasure.h"
 
 #include "Printing/SymbolPrinter/PrintLayout/PrintLayoutAbstract.h"
+#include "Printing/SymbolPrinter/SymbolPrintableSequence.h"
+#include "Printing/SymbolPrinter/TabPrint.h"
+
+#include <algorithm>
 
 namespace AriaMaestosa
 {
@@ -42,6 +46,9 @@ PrintLayoutMeasure::PrintLayoutMeasure(const int measID, Sequence* seq) :
     //cutApart             = false;
     m_measure_id         = measID;
     m_contains_something = false;
+    m_fingerprint        = 0;
+    m_placement_done     = false;
+    m_layout_reused      = false;
     
     if (measID != -1)
     {
@@ -51,6 +58,86 @@ PrintLayoutMeasure::PrintLayoutMeasure(const int measID, Sequence* seq) :
 }
 
 // -------------------------------------------------------------------------------------------
+bool MeasureNote::operator<(const MeasureNote& other) const
+{
+    if (m_track_ref != other.m_track_ref) return m_track_ref < other.m_track_ref;
+    if (m_start     != other.m_start)     return m_start     < other.m_start;
+    if (m_pitch     != other.m_pitch)     return m_pitch     < other.m_pitch;
+    if (m_end       != other.m_end)       return m_end       < other.m_end;
+    if (m_sign      != other.m_sign)      return m_sign      < other.m_sign;
+    if (m_string    != other.m_string)    return m_string    < other.m_string;
+    return m_fret < other.m_fret;
+}
+
+// -------------------------------------------------------------------------------------------
+
+bool MeasureNote::operator==(const MeasureNote& other) const
+{
+    return m_track_ref == other.m_track_ref and m_start == other.m_start and m_end == other.m_end and
+           m_pitch == other.m_pitch and m_sign == other.m_sign and m_string == other.m_string and
+           m_fret == other.m_fret;
+}
+
+// -------------------------------------------------------------------------------------------
+
+void PrintLayoutMeasure::calculateFingerprint(SymbolPrintableSequence* printableSequence)
+{
+    m_content.clear();
+    
+    const int trackRefAmount = m_track_refs.size();
+    for (int tref=0; tref<trackRefAmount; tref++)
+    {
+        const int first_note = m_track_refs[tref].getFirstNote();
+        const int last_note  = m_track_refs[tref].getLastNote();
+        if (first_note == -1) continue;
+        
+        Track* track = m_track_refs[tref].getTrack()->getTrack();
+        const bool tablature = (dynamic_cast<TablaturePrintable*>(printableSequence->getEditorPrintableFor(track)) != NULL);
+        
+        for (int note=first_note; note<=last_note; note++)
+        {
+            const int start_tick = track->getNoteStartInMidiTicks(note);
+            if (start_tick < m_first_tick or start_tick >= m_last_tick) continue;
+            
+            MeasureNote measureNote;
+            measureNote.m_track_ref      = tref;
+            measureNote.m_start          = start_tick - m_first_tick;
+            measureNote.m_end            = track->getNoteEndInMidiTicks(note) - m_first_tick;
+            measureNote.m_pitch          = track->getNotePitchID(note);
+            measureNote.m_sign           = track->getNote(note)->getPreferredAccidentalSign();
+            measureNote.m_string         = (tablature ? track->getNoteStringConst(note) : -1);
+            measureNote.m_fret           = (tablature ? track->getNoteFretConst(note)   : -1);
+            
+            m_content.push_back(measureNote);
+        }
+    }
+    
+    // notes that start together may be stored in any order
+    std::sort(m_content.begin(), m_content.end());
+    
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    #define HASH_INT( VALUE ) hash = (hash ^ (unsigned int)(VALUE)) * 16777619u
+    
+    HASH_INT(m_last_tick - m_first_tick);
+    const int noteAmount = m_content.size();
+    for (int n=0; n<noteAmount; n++)
+    {
+        HASH_INT(m_content[n].m_track_ref);
+        HASH_INT(m_content[n].m_start);
+        HASH_INT(m_content[n].m_end);
+        HASH_INT(m_content[n].m_pitch);
+        HASH_INT(m_content[n].m_sign);
+        HASH_INT(m_content[n].m_string);
+        HASH_INT(m_content[n].m_fret);
+    }
+    
+    #undef HASH_INT
+    m_fingerprint = hash;
+}
+
+// -------------------------------------------------------------------------------------------
+
 #if 0
 bool PrintLayoutMeasure::calculateIfMeasureIsSameAs(PrintLayoutMeasure& checkMeasure)
 {
@@ -155,6 +242,54 @@ bool PrintLayoutMeasure::calculateIfMeasureIsSameAs(PrintLayoutMeasure& checkMea
 }
 #endif
 
+// -------------------------------------------------------------------------------------------
+
+bool PrintLayoutMeasure::hasSameContentAs(const CachedMeasureLayout& cached) const
+{
+    return m_fingerprint == cached.m_fingerprint and m_first_tick == cached.m_first_tick and
+           m_last_tick == cached.m_last_tick and m_contains_something == cached.m_contains_something and
+           m_content == cached.m_content;
+}
+
+// -------------------------------------------------------------------------------------------
+
+int PrintLayoutMeasure::getLastNoteEnd() const
+{
+    int lastEnd = m_last_tick;
+    const int noteAmount = m_content.size();
+    for (int n=0; n<noteAmount; n++)
+    {
+        lastEnd = std::max(lastEnd, m_first_tick + m_content[n].m_end);
+    }
+    return lastEnd;
+}
+
+// -------------------------------------------------------------------------------------------
+
+void PrintLayoutMeasure::reuseLayout(const CachedMeasureLayout& cached)
+{
+    ASSERT( hasSameContentAs(cached) );
+    ASSERT( cached.m_placement_done );
+    
+    m_ticks_placement_manager = cached.m_ticks_placement_manager;
+    m_placement_done = true;
+    m_layout_reused  = true;
+}
+
+// -------------------------------------------------------------------------------------------
+
+CachedMeasureLayout::CachedMeasureLayout(const PrintLayoutMeasure& measure) :
+    m_ticks_placement_manager(measure.m_ticks_placement_manager)
+{
+    m_first_tick         = measure.m_first_tick;
+    m_last_tick          = measure.m_last_tick;
+    m_contains_something = measure.m_contains_something;
+    m_placement_done     = measure.m_placement_done;
+    m_fingerprint        = measure.m_fingerprint;
+    m_content            = measure.m_content;
+    m_last_note_end      = measure.getLastNoteEnd();
+}
+
 // -------------------------------------------------------------------------------------------
     
 // TODO: this method should be tested with unit tests
@@ -389,4 +524,5 @@ bool PrintLayoutMeasure::findConsecutiveRepetition(ptr_vector<PrintLayoutMeasure
     }
 }
 #endif
+
     
@@ -22,11 +22,14 @@
 #include "Printing/SymbolPrinter/PrintLayout/RelativePlacementManager.h"
 #include "ptr_vector.h"
 
+#include <vector>
+
 namespace AriaMaestosa
 {
     class PrintLayoutMeasure;
     class GraphicalTrack;
     class Sequence;
+    class SymbolPrintableSequence;
 
     extern const PrintLayoutMeasure NULL_MEASURE;
 
@@ -59,6 +62,49 @@ namespace AriaMaestosa
 
     };
 
+    /**
+      * A note of a measure, reduced to what the placement of its symbols depends on (ticks are relative
+      * to the start of the measure)
+      */
+    struct MeasureNote
+    {
+        int m_track_ref;
+        int m_start;
+        int m_end;
+        int m_pitch;
+        
+        /** The preferred accidental sign of the note (see Note::getPreferredAccidentalSign) */
+        int m_sign;
+        
+        /** Where the note is played on tablatures; -1 for tracks not printed as tablature */
+        int m_string;
+        int m_fret;
+        
+        bool operator<(const MeasureNote& other) const;
+        bool operator==(const MeasureNote& other) const;
+    };
+    
+    /**
+      * What the placement of the symbols of a measure was calculated from, along with the result; kept
+      * from one layout to the next so that measures which did not change need not be placed again
+      */
+    struct CachedMeasureLayout
+    {
+        int m_first_tick;
+        int m_last_tick;
+        bool m_contains_something;
+        bool m_placement_done;
+        unsigned int m_fingerprint;
+        std::vector<MeasureNote> m_content;
+        RelativePlacementManager m_ticks_placement_manager;
+        
+        /** What PrintLayoutMeasure::getLastNoteEnd returned for the measure */
+        int m_last_note_end;
+        
+        /** @pre 'calculateFingerprint' was called on the measure and its symbols were placed */
+        CachedMeasureLayout(const PrintLayoutMeasure& measure);
+    };
+    
     class PrintLayoutMeasure
     {
         /** first and last tick in this measure */
@@ -82,6 +128,23 @@ namespace AriaMaestosa
         
         Sequence* m_sequence;
         
+        /** Notes of all track references, sorted; filled by 'calculateFingerprint' */
+        std::vector<MeasureNote> m_content;
+        
+        /** Hash of 'm_content' and of the measure length */
+        unsigned int m_fingerprint;
+        
+        /**
+          * Whether the symbols of this measure were placed in 'm_ticks_placement_manager' (or the
+          * placement was taken over from a previous layout, see 'reuseLayout')
+          */
+        bool m_placement_done;
+        
+        /** Whether the placement was taken over from a previous layout rather than calculated */
+        bool m_layout_reused;
+        
+        friend struct CachedMeasureLayout;
+        
     public:
         
         PrintLayoutMeasure(const int measID, Sequence* seq);
@@ -122,6 +185,40 @@ namespace AriaMaestosa
           */
         int  getMeasureID() const { return m_measure_id;              }
         
+        /**
+          * @brief reduces the notes of all track references to a canonical list and hashes it, so that
+          *        measures can be compared with those of a previous layout without going back to the tracks.
+          * @param printableSequence tells how each track is printed (score or tablature)
+          * @pre all track references were added
+          */
+        void calculateFingerprint(SymbolPrintableSequence* printableSequence);
+        
+        /**
+          * @return whether this measure spans the same ticks and holds the same notes as a measure of
+          *         a previous layout
+          * @pre 'calculateFingerprint' was called
+          */
+        bool hasSameContentAs(const CachedMeasureLayout& cached) const;
+        
+        /** @return the last tick covered by notes of this measure (notes may end in a later measure) */
+        int getLastNoteEnd() const;
+        
+        /**
+          * @brief takes over the symbol placement calculated for this measure by a previous layout
+          * @pre   'hasSameContentAs(cached)' is true, symbols were placed in 'cached', and nothing around the measure changed in a way
+          *        that affects its symbols (see PrintLayoutAbstract::reuseCachedMeasures)
+          */
+        void reuseLayout(const CachedMeasureLayout& cached);
+        
+        /** @return whether 'reuseLayout' was called */
+        bool isLayoutReused() const { return m_layout_reused; }
+        
+        /** @return whether symbols were placed already, in which case they need not be placed again */
+        bool isPlacementDone() const { return m_placement_done; }
+        
+        /** @brief to be called once all symbols were added to the placement manager and placed */
+        void setPlacementDone() { m_placement_done = true; }
+        
         bool operator==  (const PrintLayoutMeasure& meas) const { return meas.m_measure_id == m_measure_id; }
     };
 
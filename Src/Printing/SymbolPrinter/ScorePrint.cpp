@@ -1084,12 +1084,12 @@ namespace AriaMaestosa
         // ---- Build score analyzers
         if (m_g_clef)
         {
-            g_clef_analyser = new ScoreAnalyser(scoreEditor, middle_c_level-5);
+            g_clef_analyser = new ScoreAnalyser(scoreEditor->getSequence(), middle_c_level-5);
             g_clef_analyser->setStemPivot(middle_c_level-5);
         }
         if (m_f_clef)
         {
-            f_clef_analyser = new ScoreAnalyser(scoreEditor, middle_c_level-5);
+            f_clef_analyser = new ScoreAnalyser(scoreEditor->getSequence(), middle_c_level-5);
             f_clef_analyser->setStemPivot(middle_c_level+6);
         }
         
@@ -1164,6 +1164,7 @@ namespace AriaMaestosa
         
         // ---- Silences
         if (LOGGING) std::cout << "[ScorePrintable] early setup : gathering silences\n";
+        m_silences_ticks.clear();
         if (m_f_clef)
         {
             m_silences_ticks = SilenceAnalyser::findSilences(track->getSequence(),
@@ -82,11 +82,12 @@ void SymbolPrintableSequence::calculateLayout()
 {
     ASSERT( MAGIC_NUMBER_OK_FOR(m_tracks) );
     
-    m_abstract_layout_manager = new PrintLayoutAbstract(this);
-    m_abstract_layout_manager->addLayoutInformation(m_tracks, layoutPages /* out */);
+    // when called again, the abstract layout manager updates the previous layout in place
+    if (m_abstract_layout_manager == NULL) m_abstract_layout_manager = new PrintLayoutAbstract(this);
+    m_abstract_layout_manager->addLayoutInformation(m_tracks, layoutPages /* in, out */);
     
     // prepare it for when we're ready to print
-    m_numeric_layout_manager = new PrintLayoutNumeric();
+    if (m_numeric_layout_manager == NULL) m_numeric_layout_manager = new PrintLayoutNumeric();
     
     AbstractPrintableSequence::calculateLayout();
 }
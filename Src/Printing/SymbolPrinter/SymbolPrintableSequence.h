@@ -79,7 +79,8 @@ namespace AriaMaestosa
         /**
           * @brief Prepare the abstract layout for this sequence.
           * Divides sequence in pages, decides contents of each line, etc.
-          * Must be called before actually printing.
+          * Must be called before actually printing. May be called again after the sequence was
+          * edited, to update the layout; only the parts affected by the edit are laid out again.
           */
         virtual void calculateLayout();
         
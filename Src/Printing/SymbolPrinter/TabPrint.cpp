@@ -56,7 +56,7 @@ TablaturePrintable::~TablaturePrintable()
 
 void TablaturePrintable::earlySetup(const int trackID, GraphicalTrack* gtrack)
 {
-    m_analyser = new ScoreAnalyser(m_editor, -1);
+    m_analyser = new ScoreAnalyser(m_editor->getSequence(), -1);
     
     Track* track = gtrack->getTrack();
     
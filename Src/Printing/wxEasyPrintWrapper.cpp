@@ -45,7 +45,7 @@ wxEasyPrintWrapper::wxEasyPrintWrapper(wxString title, IPrintCallback* printCall
     m_page_amount    = -1; // unknown yet
     m_orient         = wxPORTRAIT;
     
-    long paperTypeInt = prefs->getIntValue(SETTING_ID_PAPER_TYPE);
+    long paperTypeInt = prefs->getIntValue(SETTING_KEY_PAPER_TYPE);
     
     // wxPAPER_PENV_10_ROTATED is currently the last of the enum (FIXME)
     wxPaperSize paperType = (paperTypeInt > wxPAPER_NONE and paperTypeInt <= wxPAPER_PENV_10_ROTATED ?
@@ -54,10 +54,10 @@ wxEasyPrintWrapper::wxEasyPrintWrapper(wxString title, IPrintCallback* printCall
     
     m_units_per_cm   = units_per_cm;
     
-    m_left_margin    = prefs->getIntValue(SETTING_ID_MARGIN_LEFT);
-    m_top_margin     = prefs->getIntValue(SETTING_ID_MARGIN_TOP);
-    m_right_margin   = prefs->getIntValue(SETTING_ID_MARGIN_RIGHT);
-    m_bottom_margin  = prefs->getIntValue(SETTING_ID_MARGIN_BOTTOM);
+    m_left_margin    = prefs->getIntValue(SETTING_KEY_MARGIN_LEFT);
+    m_top_margin     = prefs->getIntValue(SETTING_KEY_MARGIN_TOP);
+    m_right_margin   = prefs->getIntValue(SETTING_KEY_MARGIN_RIGHT);
+    m_bottom_margin  = prefs->getIntValue(SETTING_KEY_MARGIN_BOTTOM);
     
     m_unit_width     = -1.0f;
     m_unit_height    = -1.0f;
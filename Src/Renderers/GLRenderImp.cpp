@@ -325,6 +325,20 @@ void renderNumber(const char* number, const int x, const int y)
     singleton->renderNumber(number, x, y-1);
 }
 
+void renderNumbers(const int* numbers, const int* x, const int* y, const int count)
+{
+    if (count == 0) return;
+
+    NumberRendererSingleton* singleton = NumberRendererSingleton::getInstance();
+    singleton->bind();
+
+    // same offset as 'renderNumber'
+    glPushMatrix();
+    glTranslatef(0, -10, 0);
+    singleton->renderNumbers(numbers, x, y, count);
+    glPopMatrix();
+}
+
 
 void renderString(const wxString& string, const int x, const int y, const int maxWidth)
 {
@@ -349,6 +363,65 @@ void endScissors()
     glDisable(GL_SCISSOR_TEST);
 }
 
+/** Texture holding the frame cache, or 0 if none was saved yet */
+GLuint g_frame_cache = 0;
+int    g_frame_cache_width  = -1;
+int    g_frame_cache_height = -1;
+int    g_frame_cache_texture_width  = 0;
+int    g_frame_cache_texture_height = 0;
+
+void saveFrameCache()
+{
+    const int width  = Display::getWidth();
+    const int height = Display::getHeight();
+    
+    if (g_frame_cache == 0) glGenTextures(1, &g_frame_cache);
+    glBindTexture(GL_TEXTURE_2D, g_frame_cache);
+    
+    if (width != g_frame_cache_width or height != g_frame_cache_height)
+    {
+        // power-of-two sizes, older OpenGL implementations don't support any other
+        g_frame_cache_texture_width  = 1;
+        g_frame_cache_texture_height = 1;
+        while (g_frame_cache_texture_width  < width)  g_frame_cache_texture_width  *= 2;
+        while (g_frame_cache_texture_height < height) g_frame_cache_texture_height *= 2;
+        
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, g_frame_cache_texture_width, g_frame_cache_texture_height, 0,
+                     GL_RGB, GL_UNSIGNED_BYTE, NULL);
+        
+        g_frame_cache_width  = width;
+        g_frame_cache_height = height;
+    }
+    
+    glReadBuffer(GL_BACK);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+}
+
+bool restoreFrameCache()
+{
+    if (g_frame_cache == 0) return false;
+    if (Display::getWidth() != g_frame_cache_width or Display::getHeight() != g_frame_cache_height) return false;
+    
+    const float u = (float)g_frame_cache_width  / g_frame_cache_texture_width;
+    const float v = (float)g_frame_cache_height / g_frame_cache_texture_height;
+    
+    images();
+    glBindTexture(GL_TEXTURE_2D, g_frame_cache);
+    color(1, 1, 1);
+    
+    // the texture was copied from the framebuffer, whose rows go upwards, unlike our coordinates
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, v); glVertex2f(0,                          0);
+    glTexCoord2f(u, v); glVertex2f(g_frame_cache_width*10.0,   0);
+    glTexCoord2f(u, 0); glVertex2f(g_frame_cache_width*10.0,   g_frame_cache_height*10.0);
+    glTexCoord2f(0, 0); glVertex2f(0,                          g_frame_cache_height*10.0);
+    glEnd();
+    
+    return true;
+}
+
 }
 
 DEFINE_SINGLETON( AriaRender::NumberRendererSingleton );
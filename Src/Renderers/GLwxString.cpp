@@ -463,8 +463,7 @@ void wxGLNumberRenderer::renderNumber(const char* s, int x, int y)
 {
     // TODO: this can be sped a lot by using a single glBegin +  a single glEnd, the profiler shows
     //       we get quite a hit from repeatedly calling glBegin here (through TextGLDrawable::render).
-    //       Since in tab mode we render a lot of single digits, it'd be even better to draw all digits
-    //       within the same glBegin...glEnd
+    //       When many numbers are drawn at once (e.g. in tab mode), use 'renderNumbers' instead
     ASSERT_E(space_w, >=, 0);
     ASSERT_E(space_w, <, 90000);
 
@@ -512,6 +511,49 @@ void wxGLNumberRenderer::renderNumber(const char* s, int x, int y)
    // TextGLDrawable::w = full_string_w;
 }
 
+void wxGLNumberRenderer::renderNumbers(const int* numbers, const int* x, const int* y, const int count)
+{
+    ASSERT_E(space_w, >=, 0);
+    ASSERT_E(space_w, <, 90000);
+
+    const float full_string_w = (float)TextGLDrawable::texw;
+    const int   h = m_h*10;
+
+    glBegin(GL_QUADS);
+    for (int n=0; n<count; n++)
+    {
+        // characters, last one first
+        int digits[12];
+        int digitCount = 0;
+        int value = (numbers[n] < 0 ? -numbers[n] : numbers[n]);
+        do
+        {
+            digits[digitCount++] = value % 10;
+            value /= 10;
+        } while (value > 0 and digitCount < 11);
+        if (numbers[n] < 0) digits[digitCount++] = 11; // '-'
+
+        int char_x = x[n]*10;
+        const int char_y = (y[n] - m_h - y_offset)*10;
+
+        for (int d=digitCount-1; d>=0; d--)
+        {
+            const int charid = digits[d];
+            const float tex_x1 = (float)number_location[charid] / full_string_w;
+            const float tex_x2 = (float)(number_location[charid+1]-space_w) / full_string_w;
+            const int char_width = (number_location[charid+1] - number_location[charid] - space_w)*10;
+
+            glTexCoord2f(tex_x1, tex_coord_y1); glVertex2f(char_x,              char_y);
+            glTexCoord2f(tex_x2, tex_coord_y1); glVertex2f(char_x + char_width, char_y);
+            glTexCoord2f(tex_x2, tex_coord_y2); glVertex2f(char_x + char_width, char_y + h);
+            glTexCoord2f(tex_x1, tex_coord_y2); glVertex2f(char_x,              char_y + h);
+
+            char_x += char_width;
+        }
+    }
+    glEnd();
+}
+
 #if 0
 #pragma mark -
 #pragma mark wxGLStringArray implementation
@@ -216,6 +216,11 @@ namespace AriaMaestosa
         /** render this number at coordinates (x,y), where wxString s contains the string
          representation of a number. Must be called after bind(). */
         void renderNumber(const char* s, int x, int y);
+
+        /** render 'count' integers, number n at coordinates (x[n], y[n]), all within a single
+         glBegin...glEnd. Must be called after bind(). */
+        void renderNumbers(const int* numbers, const int* x, const int* y, const int count);
+
         /** render this number at coordinates (x,y). Must be called after bind(). */
         //void renderNumber(int i, int x, int y);
         /** render this number at coordinates (x,y). Must be called after bind(). */
@@ -74,6 +74,19 @@ namespace AriaMaestosa
           */
         void endScissors();
         
+        /**
+          * @brief keeps a copy of everything rendered so far in the current frame, so that later
+          *        frames where only overlays (like the playback line) change can start from it
+          *        instead of rendering everything again
+          */
+        void saveFrameCache();
+        
+        /**
+          * @brief draws the copy made by saveFrameCache over the whole frame
+          * @return false (and draws nothing) if there is no copy, or the window was resized since
+          */
+        bool restoreFrameCache();
+        
         /**
           * @brief set the drawing color for primitives and text
           */
@@ -151,6 +164,13 @@ namespace AriaMaestosa
          * @brief renders a stringized number at the given coordinate
          */
         void renderNumber(const char* number, const int x, const int y);
+
+        /**
+         * @brief renders 'count' integers, number n at coordinate {x[n], y[n]}, in one go;
+         *        much faster than as many calls to 'renderNumber' when there are many small numbers
+         *        (e.g. the fret numbers of the tablature editor)
+         */
+        void renderNumbers(const int* numbers, const int* x, const int* y, const int count);
         
         /**
          * @brief renders a string at the given coordinates {x,y} 
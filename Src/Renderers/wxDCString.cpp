@@ -175,6 +175,34 @@ namespace AriaMaestosa
     {
         renderNumber( to_wxString(f), x, y );
     }
+
+    void wxDCNumberRenderer::renderNumbers(const int* numbers, const int* x, const int* y, const int count)
+    {
+        ASSERT_E(m_h, >, -1);
+        ASSERT_E(m_h, <, 90000);
+
+        // fret numbers are small, keep their strings around instead of formatting them each time
+        static wxString commonNumbers[32];
+        static bool commonNumbersReady = false;
+        if (not commonNumbersReady)
+        {
+            for (int n=0; n<32; n++) commonNumbers[n] = to_wxString(n);
+            commonNumbersReady = true;
+        }
+
+        Display::renderDC->SetFont( getNumberFont() );
+        for (int n=0; n<count; n++)
+        {
+            if (numbers[n] >= 0 and numbers[n] < 32)
+            {
+                Display::renderDC->DrawText(commonNumbers[numbers[n]], x[n], y[n] - m_h);
+            }
+            else
+            {
+                Display::renderDC->DrawText(to_wxString(numbers[n]), x[n], y[n] - m_h);
+            }
+        }
+    }
     
     
 #if 0
@@ -91,6 +91,9 @@ namespace AriaMaestosa
         void renderNumber(const wxString& s, int x, int y);
         void renderNumber(int i, int x, int y);
         void renderNumber(float f, int x, int y);
+
+        /** renders 'count' integers, number n at coordinates (x[n], y[n]) */
+        void renderNumbers(const int* numbers, const int* x, const int* y, const int count);
     };
     
     /**
@@ -101,6 +101,15 @@ void renderNumber(const char* number, const int x, const int y)
     renderer->renderNumber(wxString(number, wxConvUTF8), x, y);
 }
 
+void renderNumbers(const int* numbers, const int* x, const int* y, const int count)
+{
+    if (count == 0) return;
+
+    wxDCNumberRenderer* renderer = wxDCNumberRenderer::getInstance();
+    renderer->bind();
+    renderer->renderNumbers(numbers, x, y, count);
+}
+
 void renderString(const wxString& string, const int x, const int y, const int maxWidth)
 {
     Model<wxString> model(string);
@@ -304,6 +313,37 @@ void endScissors()
     Display::renderDC -> DestroyClippingRegion();
 }
 
+wxBitmap* g_frame_cache = NULL;
+
+void saveFrameCache()
+{
+    const int width  = Display::getWidth();
+    const int height = Display::getHeight();
+    
+    if (g_frame_cache == NULL or g_frame_cache->GetWidth() != width or g_frame_cache->GetHeight() != height)
+    {
+        delete g_frame_cache;
+        g_frame_cache = new wxBitmap(width, height);
+    }
+    
+    wxMemoryDC cacheDC(*g_frame_cache);
+    cacheDC.Blit(0, 0, width, height, Display::renderDC, 0, 0);
+    cacheDC.SelectObject(wxNullBitmap);
+}
+
+bool restoreFrameCache()
+{
+    if (g_frame_cache == NULL) return false;
+    if (g_frame_cache->GetWidth()  != Display::getWidth() or
+        g_frame_cache->GetHeight() != Display::getHeight())
+    {
+        return false;
+    }
+    
+    Display::renderDC -> DrawBitmap(*g_frame_cache, 0, 0, false);
+    return true;
+}
+
 }
 }
 #endif
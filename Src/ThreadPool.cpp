@@ -0,0 +1,167 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace AriaMaestosa;
+
+DEFINE_SINGLETON(ThreadPool);
+
+/** There is rarely enough independent work to keep more threads than this busy */
+static const int MAX_WORKER_THREADS = 15;
+
+// ----------------------------------------------------------------------------------------------------------
+
+class ThreadPool::WorkerThread : public wxThread
+{
+    ThreadPool* m_pool;
+    
+public:
+    
+    WorkerThread(ThreadPool* pool) : wxThread(wxTHREAD_JOINABLE)
+    {
+        m_pool = pool;
+    }
+    
+    virtual ExitCode Entry()
+    {
+        m_pool->workerLoop();
+        return 0;
+    }
+};
+
+// ----------------------------------------------------------------------------------------------------------
+
+ThreadPool::ThreadPool() : m_work_available(m_mutex), m_work_done(m_mutex)
+{
+    m_task     = NULL;
+    m_count    = 0;
+    m_next     = 0;
+    m_pending  = 0;
+    m_quitting = false;
+    m_enabled  = true;
+    
+    const int workerCount = std::min(MAX_WORKER_THREADS, wxThread::GetCPUCount() - 1);
+    for (int n=0; n<workerCount; n++)
+    {
+        WorkerThread* thread = new WorkerThread(this);
+        if (thread->Create() != wxTHREAD_NO_ERROR or thread->Run() != wxTHREAD_NO_ERROR)
+        {
+            fprintf(stderr, "[ThreadPool] WARNING: could not start worker thread, using %i threads\n",
+                    n + 1);
+            delete thread;
+            break;
+        }
+        m_workers.push_back(thread);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool()
+{
+    m_mutex.Lock();
+    m_quitting = true;
+    m_work_available.Broadcast();
+    m_mutex.Unlock();
+    
+    for (int n=0; n<m_workers.size(); n++)
+    {
+        m_workers[n].Wait();
+    }
+    m_workers.clearAndDeleteAll();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ThreadPool::processItems()
+{
+    IParallelTask* task = m_task;
+    
+    while (m_next < m_count)
+    {
+        const int index = m_next++;
+        
+        m_mutex.Unlock();
+        task->execute(index);
+        m_mutex.Lock();
+        
+        m_pending--;
+        if (m_pending == 0) m_work_done.Broadcast();
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ThreadPool::workerLoop()
+{
+    m_mutex.Lock();
+    while (true)
+    {
+        while (not m_quitting and (m_task == NULL or m_next >= m_count))
+        {
+            m_work_available.Wait();
+        }
+        
+        if (m_quitting) break;
+        
+        // named here rather than on thread start, since tracing may have been enabled since
+        TRACE_THREAD_NAME("thread pool worker");
+        processItems();
+    }
+    m_mutex.Unlock();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void ThreadPool::parallelFor(const int count, IParallelTask* task)
+{
+    if (not m_enabled or m_workers.size() == 0 or count < 2)
+    {
+        for (int n=0; n<count; n++) task->execute(n);
+        return;
+    }
+    
+    m_mutex.Lock();
+    if (m_task != NULL)
+    {
+        // already busy (e.g. called from within a task); don't wait on ourselves
+        m_mutex.Unlock();
+        for (int n=0; n<count; n++) task->execute(n);
+        return;
+    }
+    
+    m_task    = task;
+    m_count   = count;
+    m_next    = 0;
+    m_pending = count;
+    m_work_available.Broadcast();
+    
+    // the calling thread does its share of the work instead of idling
+    processItems();
+    
+    while (m_pending > 0) m_work_done.Wait();
+    
+    m_task  = NULL;
+    m_count = 0;
+    m_next  = 0;
+    m_mutex.Unlock();
+}
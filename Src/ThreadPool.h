@@ -0,0 +1,114 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include "Singleton.h"
+#include "ptr_vector.h"
+
+#include <wx/thread.h>
+
+namespace AriaMaestosa
+{
+    
+    /**
+      * @brief a piece of work that can be split into independent items, see ThreadPool::parallelFor
+      */
+    class IParallelTask
+    {
+    public:
+        virtual ~IParallelTask() {}
+        
+        /**
+          * @brief process one item of the task
+          * @param index ID of the item to process, in range [0 .. count-1]. May be called from any
+          *              thread, and concurrently with other items.
+          */
+        virtual void execute(const int index) = 0;
+    };
+    
+    /**
+      * @brief a small set of worker threads, kept alive for the whole session, to which work that is
+      *        independent per track (or per anything else) can be fanned out.
+      */
+    class ThreadPool : public Singleton<ThreadPool>
+    {
+        friend class Singleton<ThreadPool>;
+        
+        class WorkerThread;
+        
+        /** Joinable threads, stopped and deleted by the destructor */
+        ptr_vector<WorkerThread, REF> m_workers;
+        
+        wxMutex     m_mutex;
+        wxCondition m_work_available;
+        wxCondition m_work_done;
+        
+        /** The task currently being processed, or NULL when the pool is idle */
+        IParallelTask* m_task;
+        
+        /** Number of items in the current task */
+        int m_count;
+        
+        /** Next item of the current task that has not yet been picked by any thread */
+        int m_next;
+        
+        /** Number of items of the current task that have not yet completed */
+        int m_pending;
+        
+        bool m_quitting;
+        bool m_enabled;
+        
+        ThreadPool();
+        
+        /** @brief main loop of the worker threads */
+        void workerLoop();
+        
+        /** 
+          * @brief pick and process items of the current task until none are left to pick
+          * @pre   m_mutex is locked
+          */
+        void processItems();
+        
+    public:
+        
+        virtual ~ThreadPool();
+        
+        /** @return the number of threads (including the calling thread) work is split across */
+        int getThreadCount() const { return m_workers.size() + 1; }
+        
+        /**
+          * @brief whether parallelFor actually runs items concurrently. When disabled, items are
+          *        run in order on the calling thread (useful to compare results and timings).
+          */
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+        bool isEnabled() const        { return m_enabled;    }
+        
+        /**
+          * @brief calls task->execute(i) for every i in [0 .. count-1], spread over the worker threads
+          *        and the calling thread, and returns once all items have completed.
+          *
+          * Items run in no particular order. If the pool is already busy (e.g. parallelFor is called
+          * from within a task), the items are simply run in order on the calling thread.
+          */
+        void parallelFor(const int count, IParallelTask* task);
+    };
+    
+}
+
+#endif
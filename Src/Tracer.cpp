@@ -0,0 +1,294 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "Tracer.h"
+
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
+#include <wx/utils.h>
+
+#if wxCHECK_VERSION(2,9,0)
+#include <wx/tls.h>
+#endif
+
+#include <stdio.h>
+
+using namespace AriaMaestosa;
+
+namespace AriaMaestosa
+{
+    namespace Tracer
+    {
+        bool g_enabled = false;
+    }
+}
+
+namespace TracerBuffers
+{
+    struct Zone
+    {
+        const char* m_name;
+        long long   m_start;
+        long long   m_end;
+    };
+
+    /**
+      * A thread appends to its own buffer while 'stop' may read it from another thread. The owning thread
+      * fills a zone (or a new chunk) in first, then publishes it with a release store; 'stop' reads counts
+      * and links with acquire loads, so it only ever sees zones and chunks that are completely written.
+      */
+    template<typename T> inline T    loadAcquire(T* from)              { return __atomic_load_n(from, __ATOMIC_ACQUIRE); }
+    template<typename T> inline void storeRelease(T* to, const T value) { __atomic_store_n(to, value, __ATOMIC_RELEASE); }
+
+    /** Zones are stored in fixed-size chunks, so recording never moves what was recorded before */
+    const int CHUNK_SIZE = 4096;
+
+    /** Past this many chunks (about 25 MB) per thread, further zones are dropped */
+    const int MAX_CHUNKS = 256;
+
+    struct Chunk
+    {
+        Zone m_zones[CHUNK_SIZE];
+
+        /** Written by the owning thread only, with 'storeRelease', after the zone itself is filled in */
+        int    m_count;
+        Chunk* m_next;
+
+        Chunk() : m_count(0), m_next(NULL) {}
+    };
+
+    /**
+      * Zones recorded by one thread. Only that thread ever appends to it, so no lock is needed to
+      * record; the global mutex is only taken once per thread, to register the buffer, and when the
+      * trace is written.
+      */
+    struct ThreadBuffer
+    {
+        int         m_id;
+
+        /** Written by the owning thread only, with 'storeRelease', and read by 'stop' with 'loadAcquire' */
+        const char* m_name;
+        Chunk*      m_first;
+        int         m_dropped;
+
+        /** Only used by the owning thread */
+        Chunk* m_last;
+        int    m_chunk_count;
+
+        /** Next registered buffer, guarded by g_mutex */
+        ThreadBuffer* m_next;
+    };
+
+    wxMutex*      g_mutex   = NULL;
+    ThreadBuffer* g_buffers = NULL;
+    int           g_next_id = 1;
+
+    wxStopWatch*  g_clock = NULL;
+    std::string   g_path;
+
+#if wxCHECK_VERSION(2,9,0)
+    wxTLS_TYPE(ThreadBuffer*) g_current;
+#define CURRENT_BUFFER wxTLS_VALUE(TracerBuffers::g_current)
+#else
+    __thread ThreadBuffer* g_current = NULL;
+#define CURRENT_BUFFER TracerBuffers::g_current
+#endif
+
+    /** @return the buffer of the calling thread, created on first use */
+    ThreadBuffer* getThreadBuffer()
+    {
+        ThreadBuffer* buffer = CURRENT_BUFFER;
+        if (buffer != NULL) return buffer;
+
+        buffer = new ThreadBuffer();
+        buffer->m_name        = NULL;
+        buffer->m_first       = NULL;
+        buffer->m_last        = NULL;
+        buffer->m_chunk_count = 0;
+        buffer->m_dropped     = 0;
+
+        {
+            wxMutexLocker lock(*g_mutex);
+            buffer->m_id   = g_next_id++;
+            buffer->m_next = g_buffers;
+            g_buffers      = buffer;
+        }
+
+        CURRENT_BUFFER = buffer;
+        return buffer;
+    }
+
+    /** @brief writes 'text' as a JSON string, quotes included */
+    void writeJsonString(FILE* file, const char* text)
+    {
+        fputc('"', file);
+        for (const char* c = text; *c != '\0'; c++)
+        {
+            if (*c == '"' or *c == '\\') fputc('\\', file);
+            if ((unsigned char)*c >= 0x20) fputc(*c, file);
+        }
+        fputc('"', file);
+    }
+}
+
+using namespace TracerBuffers;
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Tracer::start(const std::string& outputPath)
+{
+    if (isEnabled()) return;
+
+    if (g_mutex == NULL) g_mutex = new wxMutex();
+    if (g_clock == NULL)
+    {
+        g_clock = new wxStopWatch();
+        g_clock->Start();
+    }
+
+    g_path = outputPath;
+    printf("[Tracer] Recording trace to '%s'\n", g_path.c_str());
+
+    // publishes g_mutex and g_clock to the threads that see tracing on (see 'isEnabled')
+    storeRelease(&g_enabled, true);
+    TRACE_THREAD_NAME("main");
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Tracer::startFromEnvironment()
+{
+    wxString path;
+    if (wxGetEnv(wxT("ARIA_TRACE"), &path) and not path.IsEmpty())
+    {
+        start( std::string(path.mb_str()) );
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+bool Tracer::stop()
+{
+    if (g_mutex == NULL) return false;
+
+    // threads still inside a zone may record it after this point; 'record' ignores them
+    storeRelease(&g_enabled, false);
+
+    FILE* file = fopen(g_path.c_str(), "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "[Tracer] Cannot write trace to '%s'\n", g_path.c_str());
+        return false;
+    }
+
+    const unsigned long pid = wxGetProcessId();
+    int zoneCount = 0;
+
+    wxMutexLocker lock(*g_mutex);
+
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    for (ThreadBuffer* buffer = g_buffers; buffer != NULL; buffer = buffer->m_next)
+    {
+        fprintf(file, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": %lu, \"tid\": %i, \"args\": {\"name\": ",
+                (first ? "" : ",\n"), pid, buffer->m_id);
+        const char* name = loadAcquire(&buffer->m_name);
+        if (name != NULL) writeJsonString(file, name);
+        else                        fprintf(file, "\"thread %i\"", buffer->m_id);
+        fprintf(file, "}}");
+        first = false;
+
+        for (Chunk* chunk = loadAcquire(&buffer->m_first); chunk != NULL; chunk = loadAcquire(&chunk->m_next))
+        {
+            const int count = loadAcquire(&chunk->m_count);
+            for (int n=0; n<count; n++)
+            {
+                const Zone& zone = chunk->m_zones[n];
+                fprintf(file, ",\n{\"ph\": \"X\", \"name\": ");
+                writeJsonString(file, zone.m_name);
+                fprintf(file, ", \"pid\": %lu, \"tid\": %i, \"ts\": %lld, \"dur\": %lld}",
+                        pid, buffer->m_id, zone.m_start, zone.m_end - zone.m_start);
+            }
+            zoneCount += count;
+        }
+
+        const int dropped = loadAcquire(&buffer->m_dropped);
+        if (dropped > 0)
+        {
+            fprintf(stderr, "[Tracer] Buffer of thread %i was full, %i zones were dropped\n", buffer->m_id,
+                    dropped);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    printf("[Tracer] Wrote %i zones to '%s'\n", zoneCount, g_path.c_str());
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+long long Tracer::now()
+{
+#if wxCHECK_VERSION(2,9,3)
+    return g_clock->TimeInMicro().GetValue();
+#else
+    return (long long)g_clock->Time() * 1000;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Tracer::record(const char* name, const long long start, const long long end)
+{
+    if (not isEnabled()) return;
+
+    ThreadBuffer* buffer = getThreadBuffer();
+    Chunk* chunk = buffer->m_last;
+
+    if (chunk == NULL or chunk->m_count == CHUNK_SIZE)
+    {
+        if (buffer->m_chunk_count == MAX_CHUNKS)
+        {
+            storeRelease(&buffer->m_dropped, buffer->m_dropped + 1);
+            return;
+        }
+
+        Chunk* newChunk = new Chunk();
+        if (chunk == NULL) storeRelease(&buffer->m_first, newChunk);
+        else               storeRelease(&chunk->m_next,   newChunk);
+        buffer->m_last = newChunk;
+        buffer->m_chunk_count++;
+        chunk = newChunk;
+    }
+
+    // only this thread writes m_count, so reading it back needs no barrier
+    Zone& zone = chunk->m_zones[chunk->m_count];
+    zone.m_name  = name;
+    zone.m_start = start;
+    zone.m_end   = end;
+    storeRelease(&chunk->m_count, chunk->m_count + 1);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void Tracer::setThreadName(const char* name)
+{
+    // buffers are only created once tracing started, so untraced sessions never allocate any
+    if (not isEnabled()) return;
+
+    storeRelease(&getThreadBuffer()->m_name, name);
+}
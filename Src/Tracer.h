@@ -0,0 +1,118 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <string>
+
+namespace AriaMaestosa
+{
+
+    /**
+      * @brief lightweight scoped-zone tracer, writing Chrome 'trace_event' JSON files (open them in
+      *        chrome://tracing or https://ui.perfetto.dev)
+      *
+      * Zones are declared with TRACE_ZONE("name") at the top of a block and last until the end of it.
+      * When tracing is off, a zone costs one test of a global flag. Each thread records into its own
+      * buffer, so threads never wait on each other while tracing; the buffers are only gathered when
+      * the trace is written. Tracing is started with '--trace <file>' on the command line (Aria and
+      * AriaBatch) or by setting the ARIA_TRACE environment variable to the output path.
+      *
+      * Build with 'scons tracing=0' to compile all zones out entirely.
+      */
+    namespace Tracer
+    {
+        /** Whether zones are currently being recorded; only read this through 'isEnabled' */
+        extern bool g_enabled;
+
+        /**
+          * @return whether zones are being recorded. This is an acquire load (paired with the release store
+          *         in 'start'), so a thread that sees tracing on also sees the clock and lock 'start' created.
+          */
+        inline bool isEnabled() { return __atomic_load_n(&g_enabled, __ATOMIC_ACQUIRE); }
+
+        /**
+          * @brief starts recording zones
+          * @param outputPath where the trace is written when 'stop' is called
+          */
+        void start(const std::string& outputPath);
+
+        /** @brief starts recording if the ARIA_TRACE environment variable is set; does nothing otherwise */
+        void startFromEnvironment();
+
+        /**
+          * @brief stops recording and writes everything recorded so far to the output path
+          * @return false if the trace could not be written (or tracing was not started)
+          */
+        bool stop();
+
+        /** @return microseconds since tracing was started */
+        long long now();
+
+        /**
+          * @brief records one complete zone for the calling thread
+          * @param name must remain valid until the trace is written (use string literals)
+          */
+        void record(const char* name, const long long start, const long long end);
+
+        /**
+          * @brief names the calling thread in the trace (otherwise it shows up as "thread N")
+          * @param name must remain valid until the trace is written (use string literals)
+          */
+        void setThreadName(const char* name);
+
+        /** @brief records the enclosing block as a zone; use through TRACE_ZONE */
+        class ScopedZone
+        {
+            const char* m_name;
+            long long   m_start;
+
+        public:
+            ScopedZone(const char* name)
+            {
+                if (isEnabled())
+                {
+                    m_name  = name;
+                    m_start = now();
+                }
+                else
+                {
+                    m_name = NULL;
+                }
+            }
+
+            ~ScopedZone()
+            {
+                if (m_name != NULL) record(m_name, m_start, now());
+            }
+        };
+    }
+
+}
+
+#define TRACE_CONCAT_IMPL( A, B ) A ## B
+#define TRACE_CONCAT( A, B ) TRACE_CONCAT_IMPL( A, B )
+
+#ifdef ARIA_NO_TRACING
+#define TRACE_ZONE( NAME )
+#define TRACE_THREAD_NAME( NAME )
+#else
+#define TRACE_ZONE( NAME ) ::AriaMaestosa::Tracer::ScopedZone TRACE_CONCAT(trace_zone_, __LINE__)( NAME )
+#define TRACE_THREAD_NAME( NAME ) ::AriaMaestosa::Tracer::setThreadName( NAME )
+#endif
+
+#endif
@@ -1,2 +1,145 @@
 #include "UnitTestUtils.h"
 
+#include "Analysers/ScoreAnalyser.h"
+#include "Benchmark.h"
+#include "Midi/CommonMidiUtils.h"
+#include "Midi/MeasureData.h"
+#include "Midi/Sequence.h"
+#include "Midi/Track.h"
+#include "UnitTest.h"
+
+#include "jdksmidi/world.h"
+#include "jdksmidi/track.h"
+#include "jdksmidi/multitrack.h"
+#include "jdksmidi/msg.h"
+
+#include <cstdio>
+
+using namespace AriaMaestosa;
+
+Sequence* AriaMaestosa::makeSyntheticSequence(const int trackAmount, const int notesPerTrack)
+{
+    Sequence* seq = new Sequence(NULL, NULL, NULL, NULL, false);
+    
+    const int beatLen = seq->ticksPerQuarterNote();
+    const int step    = beatLen/4;
+    
+    // small linear congruential generator, so that every run produces the same song
+    unsigned int random = 12345;
+    
+    int lastTick = 0;
+    {
+        OwnerPtr<Sequence::Import> import(seq->startImport());
+        
+        for (int t=0; t<trackAmount; t++)
+        {
+            Track* track = new Track(seq);
+            
+            for (int n=0; n<notesPerTrack; n++)
+            {
+                random = random*1103515245 + 12345;
+                
+                const int pitch  = 40 + (random >> 16) % 50;
+                const int start  = n*step;
+                const int end    = start + step*(1 + (random >> 8) % 4) - 1;
+                const int volume = 40 + (random >> 4) % 88;
+                
+                track->addNote_import(pitch, start, end, volume, -1);
+                if (end > lastTick) lastTick = end;
+                
+                if (n % 16 == 0)
+                {
+                    track->addControlEvent_import(start, (random >> 12) % 128, 7 /* volume */);
+                }
+            }
+            track->reorderNoteOffVector();
+            
+            seq->addTrack(track);
+        }
+    }
+    
+    MeasureData* md = seq->getMeasureData();
+    {
+        ScopedMeasureTransaction tr(md->startTransaction());
+        tr->setMeasureAmount(lastTick/md->measureLengthInTicks() + 1);
+    }
+    
+    return seq;
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BenchmarkSong::BenchmarkSong(const BenchmarkContext& bench, const int trackAmount)
+{
+    m_sequence = makeSyntheticSequence(trackAmount, bench.getSize()/trackAmount);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BenchmarkSong::~BenchmarkSong()
+{
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void AriaMaestosa::fillScoreAnalyser(ScoreAnalyser* analyser, Track* track)
+{
+    MeasureData* md = track->getSequence()->getMeasureData();
+    
+    analyser->clearAndPrepare();
+    
+    const int noteAmount = track->getNoteAmount();
+    for (int n=0; n<noteAmount; n++)
+    {
+        const int pitch = track->getNotePitchID(n);
+        const int tick  = track->getNoteStartInMidiTicks(n);
+        
+        // 7 staff levels per octave
+        NoteRenderInfo info = NoteRenderInfo::factory(tick, pitch*7/12, track->getNoteEndInMidiTicks(n) - tick,
+                                                      PITCH_SIGN_NONE, false, pitch, md);
+        analyser->addToVector(info);
+    }
+    
+    analyser->doneAdding();
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void AriaMaestosa::requireSameMidiTracks(const jdksmidi::MIDIMultiTrack& expected,
+                                         const jdksmidi::MIDIMultiTrack& actual, const int trackAmount)
+{
+    for (int t=0; t<trackAmount; t++)
+    {
+        const jdksmidi::MIDITrack* expectedTrack = expected.GetTrack(t);
+        const jdksmidi::MIDITrack* actualTrack   = actual.GetTrack(t);
+        
+        require_e(actualTrack->GetNumEvents(), ==, expectedTrack->GetNumEvents(),
+                  "Each track has the same amount of events");
+        
+        for (int e=0; e<expectedTrack->GetNumEvents(); e++)
+        {
+            require(*actualTrack->GetEvent(e) == *expectedTrack->GetEvent(e), "Each track has the same events");
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+void AriaMaestosa::requireSameMidiSong(Sequence* expected, Sequence* actual)
+{
+    jdksmidi::MIDIMultiTrack expectedTracks, actualTracks;
+    int expectedLength = -1, expectedStart = -1, expectedNumTracks = -1;
+    int actualLength   = -1, actualStart   = -1, actualNumTracks   = -1;
+    
+    const bool expectedOK = makeJDKMidiSequence(expected, expectedTracks, false, &expectedLength,
+                                                &expectedStart, &expectedNumTracks, false);
+    const bool actualOK   = makeJDKMidiSequence(actual, actualTracks, false, &actualLength,
+                                                &actualStart, &actualNumTracks, false);
+    
+    require(expectedOK and actualOK, "Both songs could be compiled");
+    require_e(actualLength,    ==, expectedLength,    "Song length is the same");
+    require_e(actualStart,     ==, expectedStart,     "Start tick is the same");
+    require_e(actualNumTracks, ==, expectedNumTracks, "MIDI track amount is the same");
+    
+    requireSameMidiTracks(expectedTracks, actualTracks, expectedNumTracks);
+}
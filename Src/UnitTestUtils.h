@@ -2,10 +2,20 @@
 #define __UNIT_TEST_UTIL_H__
 
 #include "AriaCore.h"
+#include "Utils.h"
+
+class BenchmarkContext;
+
+namespace jdksmidi
+{
+    class MIDIMultiTrack;
+}
 
 namespace AriaMaestosa
 {
     class Sequence;
+    class ScoreAnalyser;
+    class Track;
     
     /**
       * A simple implementation of ICurrentSequenceProvider that is useful for unit tests
@@ -31,6 +41,52 @@ namespace AriaMaestosa
             return NULL;
         }
     };
+    
+    /**
+      * @brief Builds a sequence filled with generated (but deterministic) notes and controller events,
+      *        to exercise code paths on songs of a given size.
+      *
+      * @param trackAmount   number of tracks to create
+      * @param notesPerTrack number of notes in each track
+      * @return a new sequence, that the caller owns; the measure amount is set to fit all notes
+      */
+    Sequence* makeSyntheticSequence(const int trackAmount, const int notesPerTrack);
+    
+    /**
+      * @brief The song benchmarks work on : a synthetic sequence (see makeSyntheticSequence) whose tracks
+      *        hold 'bench.getSize()' notes altogether
+      */
+    class BenchmarkSong
+    {
+        OwnerPtr<Sequence> m_sequence;
+        
+    public:
+        
+        BenchmarkSong(const BenchmarkContext& bench, const int trackAmount = 1);
+        ~BenchmarkSong();
+        
+        Sequence* operator->() { return m_sequence; }
+        operator Sequence*()   { return m_sequence; }
+    };
+    
+    /**
+      * @brief Feeds all notes of a track to a score analyser, the way the score editor does for
+      *        visible notes (but with an approximate staff level, since there is no editor).
+      */
+    void fillScoreAnalyser(ScoreAnalyser* analyser, Track* track);
+    
+    /**
+      * @brief Requires that the first 'trackAmount' tracks of both multitracks hold exactly the same events
+      *        (the calling unit test fails otherwise)
+      */
+    void requireSameMidiTracks(const jdksmidi::MIDIMultiTrack& expected, const jdksmidi::MIDIMultiTrack& actual,
+                               const int trackAmount);
+    
+    /**
+      * @brief Compiles both sequences to MIDI, like they would be exported, and requires that they produce
+      *        the same song (the calling unit test fails otherwise)
+      */
+    void requireSameMidiSong(Sequence* expected, Sequence* actual);
         
 }
 
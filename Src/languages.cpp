@@ -124,7 +124,7 @@ namespace AriaMaestosa
         if (languages.size() == 0) buildLanguageList();
         
         // read language from preferences
-        language_aria_id = PreferencesData::getInstance()->getIntValue("lang");
+        language_aria_id = PreferencesData::getInstance()->getIntValue(SETTING_KEY_LANGUAGE);
         if (language_aria_id == -1)
         {
             // couldn't read from prefs, use default
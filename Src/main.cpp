@@ -23,11 +23,15 @@
 #include <wx/filename.h>
 #include <wx/tokenzr.h>
 
+#include "Dialogs/WaitWindow.h"
 #include "GUI/MainFrame.h"
 #include "GUI/MainPane.h"
 #include "Midi/Players/PlatformMidiManager.h"
 #include "Midi/KeyPresets.h"
+#include "PerformanceStats.h"
 #include "PreferencesData.h"
+#include "Printing/ScoreExporter.h"
+#include "Tracer.h"
 #include "languages.h"
 #include "UnitTest.h"
 #include "Utils.h"
@@ -195,6 +199,8 @@ bool wxWidgetApp::OnInit()
     m_render_loop_on = false;
     appName = GetAppName();
     
+    int exportArg = -1;
+    
     for (int n=0; n<argc; n++)
     {
         if (wxString(argv[n]) == wxT("--utest"))
@@ -212,8 +218,38 @@ bool wxWidgetApp::OnInit()
             wxLog::SetLogLevel(wxLOG_Info);
             wxLog::SetVerbose(true);
         }
+        else if (wxString(argv[n]) == wxT("--trace") and n+1 < argc)
+        {
+            Tracer::start( std::string(wxString(argv[n+1]).mb_str()) );
+        }
+        else if (wxString(argv[n]) == wxT("--stats"))
+        {
+            PerformanceStats::setEnabled(true);
+        }
+        else if (wxString(argv[n]) == wxT("--export-svg") and n+1 < argc)
+        {
+            exportArg = n+1;
+            break;
+        }
     }
     
+    if (not Tracer::isEnabled()) Tracer::startFromEnvironment();
+    
+    if (exportArg != -1)
+    {
+        okToLog = false;
+        Core::setPlayDuringEdit(PLAY_NEVER);
+        prefs = PreferencesData::getInstance();
+        prefs->init();
+        
+        const int exitCode = runScoreExport(exportArg);
+        if (Tracer::isEnabled()) Tracer::stop();
+        exit(exitCode);
+    }
+    
+    // from now on, messages are for the user rather than the console
+    setMessageDisplay(this);
+    
     wxLogVerbose( wxT("[main] init preferences") );
     prefs = PreferencesData::getInstance();
     prefs->init();
@@ -223,7 +259,7 @@ bool wxWidgetApp::OnInit()
 #ifndef __WXMAC__
     m_single_instance_checker = new wxSingleInstanceChecker(appName + wxGetUserId(), wxT("/tmp/"));
     
-    if ( prefs->getBoolValue(SETTING_ID_SINGLE_INSTANCE_APPLICATION, true) &&
+    if ( prefs->getBoolValue(SETTING_KEY_SINGLE_INSTANCE_APPLICATION) &&
         m_single_instance_checker->IsAnotherRunning() )
     {
         std::cout << "[main] detected another Aria instance" << std::endl;
@@ -247,12 +283,12 @@ bool wxWidgetApp::OnInit()
     }
 #endif
 
-    if (prefs->getBoolValue(SETTING_ID_CHECK_NEW_VERSION, true))
+    if (prefs->getBoolValue(SETTING_KEY_CHECK_NEW_VERSION))
     {
         checkVersionOnline();
     }
 
-    Core::setPlayDuringEdit((PlayDuringEditMode)PreferencesData::getInstance()->getIntValue("playDuringEdit"));
+    Core::setPlayDuringEdit((PlayDuringEditMode)PreferencesData::getInstance()->getIntValue(SETTING_KEY_PLAY_DURING_EDIT));
     
     //read presets
     KeyPresetGroup::getInstance();
@@ -271,6 +307,16 @@ bool wxWidgetApp::OnInit()
     // check if filenames to open were given on the command-line
     for (int n=1 ; n<argc ; n++)
     {
+        if (wxString(argv[n]) == wxT("--trace"))
+        {
+            n++; // skip the trace file as well
+            continue;
+        }
+        else if (wxString(argv[n]) == wxT("--stats") or wxString(argv[n]) == wxT("--verbose"))
+        {
+            continue;
+        }
+        
         wxString fileName = cleanPath(wxString(argv[n]));
         if (fileName!=RELOAD_PARAM)
         {
@@ -296,15 +342,43 @@ bool wxWidgetApp::OnInit()
     
 // ------------------------------------------------------------------------------------------------------
 
+int wxWidgetApp::runScoreExport(const int firstArg)
+{
+    ScoreExporter exporter;
+    exporter.setOutputDirectory( wxString(argv[firstArg]) );
+    
+    for (int n=firstArg+1; n<argc; n++)
+    {
+        if (not exporter.addInput( cleanPath(wxString(argv[n])) )) return 1;
+    }
+    
+    if (exporter.getJobCount() == 0)
+    {
+        fprintf(stderr, "Usage: Aria --export-svg <output directory> file1 [file2 ...]\n");
+        return 1;
+    }
+    
+    const bool success = exporter.run();
+    exporter.printReport();
+    return (success ? 0 : 2);
+}
+
+// ------------------------------------------------------------------------------------------------------
+
 int wxWidgetApp::OnExit()
 {
     wxLogVerbose( wxT("wxWidgetsApp::OnExit") );
+    
+    setMessageDisplay(NULL);
 
 #ifndef __WXMAC__
     wxDELETE(m_single_instance_checker);
     delete m_IPC_server;
 #endif
 
+    if (Tracer::isEnabled()) Tracer::stop();
+    if (PerformanceStats::isEnabled()) PerformanceStats::writeReport(stdout);
+
 #ifdef _MORE_DEBUG_CHECKS
     MemoryLeaks::checkForLeaks();
 #endif
@@ -361,6 +435,14 @@ void wxWidgetApp::OnUnhandledException()
     wxMessageBox(_("Sorry an internal error occurred : an exception was caught unhandled : ") + what);
 }
 
+// ------------------------------------------------------------------------------------------------------
+
+void wxWidgetApp::showMessage(const wxString& message)
+{
+    if (WaitWindow::isShown()) WaitWindow::hide();
+    wxMessageBox(message);
+}
+
 
 bool wxWidgetApp::handleSingleInstance()
 {
@@ -410,7 +492,7 @@ void wxWidgetApp::loadFile(const wxString& fileName)
 
 void wxWidgetApp::addLastSessionFiles(PreferencesData* prefs, wxArrayString& filesToOpen)
 {
-    if ( prefs->getBoolValue(SETTING_ID_LOAD_LAST_SESSION, false) )
+    if ( prefs->getBoolValue(SETTING_KEY_LOAD_LAST_SESSION) )
     {
         wxStringTokenizer tokenizer(prefs->getValue(SETTING_ID_LAST_SESSION_FILES), FILE_SEPARATOR);
         
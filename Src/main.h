@@ -19,6 +19,7 @@
 
 
 #include <wx/app.h>
+#include "AriaCore.h"
 #include "Utils.h"
 
 class wxString;
@@ -35,13 +36,21 @@ namespace AriaMaestosa
     class PreferencesData;
     
     
-    class wxWidgetApp : public wxApp
+    class wxWidgetApp : public wxApp, public IMessageDisplay
     {
         
     private:
         void addLastSessionFiles(PreferencesData* prefs,
                                   wxArrayString& filesToOpen);
         
+        /**
+          * @brief handles 'Aria --export-svg <dir> file1 [file2 ...]' : engraves the files to SVG
+          *        without opening any window
+          * @param firstArg index in argv of the output directory
+          * @return the process exit code
+          */
+        int runScoreExport(const int firstArg);
+        
     public:
         MainFrame* frame;
         PreferencesData*  prefs;
@@ -76,6 +85,9 @@ namespace AriaMaestosa
         /** callback from wxApp */
         virtual void OnUnhandledException();
         
+        /** implement callback from IMessageDisplay */
+        virtual void showMessage(const wxString& message);
+        
         void loadFile(const wxString& fileName);
         
         static wxString cleanPath(const wxString& input);
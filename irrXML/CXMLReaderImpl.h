@@ -34,6 +34,8 @@ public:
 		: TextData(0), P(0), TextSize(0), TextBegin(0), CurrentNodeType(EXN_NONE),
 		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII)
 	{
+		setNodeName(0, 0, false);
+
 		if (!callback)
 			return;
 
@@ -55,6 +57,34 @@ public:
 		// set pointer to text begin
 		P = TextBegin;
 	}
+
+
+	//! Constructor parsing text in place, without copying it.
+	//! The text is not modified; it must stay valid as long as the reader exists
+	//! and must be followed by a 0 character (at text[size]).
+	CXMLReaderImpl(const char_type* text, int size)
+		: TextData(0), P(0), TextSize(0), TextBegin(0), CurrentNodeType(EXN_NONE),
+		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII)
+	{
+		setNodeName(0, 0, false);
+		storeTargetFormat();
+
+		TextBegin = const_cast<char_type*>(text);
+		TextSize = size + 1;
+
+		// skip the UTF-8 byte order mark
+		if (sizeof(char_type) == 1 && size >= 3 && (unsigned char)text[0] == 0xEF &&
+			(unsigned char)text[1] == 0xBB && (unsigned char)text[2] == 0xBF)
+		{
+			SourceFormat = ETF_UTF8;
+			TextBegin += 3;
+			TextSize -= 3;
+		}
+
+		createSpecialCharacterList();
+
+		P = TextBegin;
+	}
     	
 
 	//! Destructor
@@ -100,7 +130,7 @@ public:
 		if (idx < 0 || idx >= (int)Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return getText(Attributes[idx].Name, Attributes[idx].NameLength, Attributes[idx].NameText, false);
 	}
 
 
@@ -110,7 +140,7 @@ public:
 		if (idx < 0 || idx >= (int)Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return getValue(Attributes[idx]);
 	}
 
 
@@ -121,7 +151,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return getValue(*attr);
 	}
 
 
@@ -132,7 +162,7 @@ public:
 		if (!attr)
 			return EmptyString.c_str();
 
-		return attr->Value.c_str();
+		return getValue(*attr);
 	}
 
 
@@ -140,14 +170,31 @@ public:
 	//! Returns the value of an attribute as integer. 
 	int getAttributeValueAsInt(const char_type* name) const
 	{
-		return (int)getAttributeValueAsFloat(name);
+		int value = 0;
+		getAttributeValueAsInt(name, value);
+		return value;
 	}
 
 
 	//! Returns the value of an attribute as integer. 
 	int getAttributeValueAsInt(int idx) const
 	{
-		return (int)getAttributeValueAsFloat(idx);
+		if (idx < 0 || idx >= (int)Attributes.size())
+			return 0;
+
+		return parseInt(Attributes[idx].Value, Attributes[idx].ValueLength);
+	}
+
+
+	//! Reads the value of an attribute as integer, straight from the text.
+	virtual bool getAttributeValueAsInt(const char_type* name, int& out) const
+	{
+		const SAttribute* attr = getAttributeByName(name);
+		if (!attr)
+			return false;
+
+		out = parseInt(attr->Value, attr->ValueLength);
+		return true;
 	}
 
 
@@ -158,7 +205,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c = attr->Value.c_str();
+		core::stringc c = getValue(*attr);
 		return core::fast_atof(c.c_str());
 	}
 
@@ -178,14 +225,14 @@ public:
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const
 	{
-		return NodeName.c_str();
+		return NodeName.const_pointer();
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const
 	{
-		return NodeName.c_str();
+		return NodeName.const_pointer();
 	}
 
 
@@ -267,8 +314,7 @@ private:
 		}
 
 		// set current text to the parsed text, and replace xml special characters
-		core::string<char_type> s(start, (int)(end - start));
-		NodeName = replaceSpecialCharacters(s);
+		setNodeName(start, (int)(end - start), true);
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -314,7 +360,7 @@ private:
 		}
 
 		P -= 3;
-		NodeName = core::string<char_type>(pCommentBegin+2, (int)(P - pCommentBegin-2));
+		setNodeName(pCommentBegin+2, (int)(P - pCommentBegin-2), false);
 		P += 3;
 	}
 
@@ -324,7 +370,9 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
+		AttributeText.set_used(0);
+		int attributeTextSize = 0;
 
 		// find name
 		const char_type* startName = P;
@@ -377,15 +425,17 @@ private:
 					const char_type* attributeValueEnd = P;
 					++P;
 
+					// only remember where the attribute is, it is copied out of the text when asked for
 					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin, 
-						(int)(attributeNameEnd - attributeNameBegin));
-
-					core::string<char_type> s(attributeValueBegin, 
-						(int)(attributeValueEnd - attributeValueBegin));
-
-					attr.Value = replaceSpecialCharacters(s);
+					attr.Name = attributeNameBegin;
+					attr.NameLength = (int)(attributeNameEnd - attributeNameBegin);
+					attr.NameText = -1;
+					attr.Value = attributeValueBegin;
+					attr.ValueLength = (int)(attributeValueEnd - attributeValueBegin);
+					attr.ValueText = -1;
 					Attributes.push_back(attr);
+
+					attributeTextSize += attr.NameLength + attr.ValueLength + 2;
 				}
 				else
 				{
@@ -405,7 +455,12 @@ private:
 			endName--;
 		}
 		
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
+		setNodeName(startName, (int)(endName - startName), false);
+
+		// reserve room for all names and values now, so that copying them out later never
+		// reallocates (and invalidates what was returned before)
+		if ((int)AttributeText.allocated_size() < attributeTextSize)
+			AttributeText.reallocate(attributeTextSize);
 
 		++P;
 	}
@@ -416,7 +471,7 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		++P;
 		const char_type* pBeginClose = P;
@@ -424,7 +479,7 @@ private:
 		while(*P != L'>')
 			++P;
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
+		setNodeName(pBeginClose, (int)(P - pBeginClose), false);
 		++P;
 	}
 
@@ -464,19 +519,25 @@ private:
 		}
 
 		if ( cDataEnd )
-			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
+			setNodeName(cDataBegin, (int)(cDataEnd - cDataBegin), false);
 		else
-			NodeName = "";
+			setNodeName(cDataBegin, 0, false);
 
 		return true;
 	}
 
 
-	// structure for storing attribute-name pairs
+	// structure for storing attribute-name pairs. Names and values point into the text;
+	// NameText and ValueText are their offsets in AttributeText once copied out, or -1
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		const char_type* Name;
+		int NameLength;
+		mutable int NameText;
+
+		const char_type* Value;
+		int ValueLength;
+		mutable int ValueText;
 	};
 
 	// finds a current attribute by name, returns 0 if not found
@@ -485,64 +546,109 @@ private:
 		if (!name)
 			return 0;
 
-		core::string<char_type> n = name;
-
 		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
-				return &Attributes[i];
+		{
+			const SAttribute& attr = Attributes[i];
+
+			int n = 0;
+			while (n < attr.NameLength && name[n] == attr.Name[n])
+				++n;
+
+			if (n == attr.NameLength && name[n] == 0)
+				return &attr;
+		}
 
 		return 0;
 	}
 
-	// replaces xml special characters in a string and creates a new one
-	core::string<char_type> replaceSpecialCharacters(
-		core::string<char_type>& origstr)
+	// returns the value of an attribute, with xml special characters replaced
+	const char_type* getValue(const SAttribute& attr) const
 	{
-		int pos = origstr.findFirst(L'&');
-		int oldPos = 0;
+		return getText(attr.Value, attr.ValueLength, attr.ValueText, true);
+	}
 
-		if (pos == -1)
-			return origstr;
+	// returns a 0-terminated copy of a piece of the text of the current element, kept in
+	// AttributeText. Room for it was reserved when the element was parsed.
+	const char_type* getText(const char_type* begin, int length, int& offset, bool decode) const
+	{
+		if (offset == -1)
+		{
+			offset = (int)AttributeText.size();
+			if (decode)
+				appendDecoded(AttributeText, begin, length);
+			else
+				for (int i=0; i<length; ++i)
+					AttributeText.push_back(begin[i]);
+			AttributeText.push_back(0);
+		}
+
+		return AttributeText.const_pointer() + offset;
+	}
+
+	// sets the name (or data) of the current node
+	void setNodeName(const char_type* begin, int length, bool decode)
+	{
+		NodeName.set_used(0);
+		if (decode)
+			appendDecoded(NodeName, begin, length);
+		else
+			for (int i=0; i<length; ++i)
+				NodeName.push_back(begin[i]);
+		NodeName.push_back(0);
+	}
 
-		core::string<char_type> newstr;
+	// parses an integer like atoi does, without needing the text to be 0-terminated
+	static int parseInt(const char_type* text, int length)
+	{
+		int i = 0;
+		while (i < length && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r'))
+			++i;
 
-		while(pos != -1 && pos < origstr.size()-2)
+		bool negative = false;
+		if (i < length && (text[i] == '-' || text[i] == '+'))
 		{
-			// check if it is one of the special characters
+			negative = (text[i] == '-');
+			++i;
+		}
 
-			int specialChar = -1;
-			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
-			{
-				const char_type* p = &origstr.c_str()[pos]+1;
+		int value = 0;
+		for (; i < length && text[i] >= '0' && text[i] <= '9'; ++i)
+			value = value*10 + (int)(text[i] - '0');
 
-				if (equalsn(&SpecialCharacters[i][1], p, SpecialCharacters[i].size()-1))
+		return negative ? -value : value;
+	}
+
+	// appends a piece of text to 'out', replacing xml special characters. The result is
+	// never longer than the source.
+	void appendDecoded(core::array<char_type>& out, const char_type* begin, int length) const
+	{
+		for (int i=0; i<length; ++i)
+		{
+			if (begin[i] == L'&')
+			{
+				// check if it is one of the special characters
+				int specialChar = -1;
+				for (int j=0; j<(int)SpecialCharacters.size(); ++j)
 				{
-					specialChar = i;
-					break;
+					const int symbolLength = SpecialCharacters[j].size()-1;
+					if (i + symbolLength < length &&
+						equalsn(&SpecialCharacters[j][1], begin+i+1, symbolLength))
+					{
+						specialChar = j;
+						break;
+					}
 				}
-			}
 
-			if (specialChar != -1)
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos));
-				newstr.append(SpecialCharacters[specialChar][0]);
-				pos += SpecialCharacters[specialChar].size();
-			}
-			else
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos + 1));
-				pos += 1;
+				if (specialChar != -1)
+				{
+					out.push_back(SpecialCharacters[specialChar][0]);
+					i += SpecialCharacters[specialChar].size()-1;
+					continue;
+				}
 			}
 
-			// find next &
-			oldPos = pos;
-			pos = origstr.findNext(L'&', pos);		
+			out.push_back(begin[i]);
 		}
-
-		if (oldPos < origstr.size()-1)
-			newstr.append(origstr.subString(oldPos, origstr.size()-oldPos));
-
-		return newstr;
 	}
 
 
@@ -732,10 +838,10 @@ private:
 
 
 	//! compares the first n characters of the strings
-	bool equalsn(const char_type* str1, const char_type* str2, int len)
+	bool equalsn(const char_type* str1, const char_type* str2, int len) const
 	{
 		int i;
-		for(i=0; str1[i] && str2[i] && i < len; ++i)
+		for(i=0; i < len && str1[i] && str2[i]; ++i)
 			if (str1[i] != str2[i])
 				return false;
 
@@ -779,7 +885,7 @@ private:
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in
+	core::array<char_type> NodeName;     // name (or data) of the node currently in, 0-terminated
 	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
@@ -787,6 +893,7 @@ private:
 	core::array< core::string<char_type> > SpecialCharacters; // see createSpecialCharacterList()
 
 	core::array<SAttribute> Attributes; // attributes of current element
+	mutable core::array<char_type> AttributeText; // names and values of the current element, once asked for
 	
 }; // end CXMLReaderImpl
 
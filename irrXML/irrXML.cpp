@@ -8,6 +8,12 @@
 #include "fast_atof.h"
 #include "CXMLReaderImpl.h"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace irr
 {
 namespace io
@@ -76,6 +82,34 @@ private:
 }; // end class CFileReadCallBack
 
 
+#if !defined(_WIN32)
+
+//! UTF-8 or ASCII parser working directly on a memory-mapped file
+class CMappedXMLReader : public CXMLReaderImpl<char, IXMLBase>
+{
+public:
+
+	CMappedXMLReader(void* mapping, size_t size)
+		: CXMLReaderImpl<char, IXMLBase>((const char*)mapping, (int)size),
+		Mapping(mapping), MappingSize(size)
+	{
+	}
+
+	virtual ~CMappedXMLReader()
+	{
+		munmap(Mapping, MappingSize);
+	}
+
+private:
+
+	void* Mapping;
+	size_t MappingSize;
+
+}; // end class CMappedXMLReader
+
+#endif
+
+
 
 // FACTORY FUNCTIONS:
 
@@ -103,6 +137,49 @@ IrrXMLReader* createIrrXMLReader(IFileReadCallBack* callback)
 }
 
 
+//! Creates an instance of an UFT-8 or ASCII character xml parser reading a memory-mapped file.
+IrrXMLReader* createIrrXMLReaderMapped(FILE* file)
+{
+#if !defined(_WIN32)
+	if (!file)
+		return 0;
+
+	struct stat info;
+	if (fstat(fileno(file), &info) != 0 || info.st_size <= 0 || info.st_size >= 0x7FFFFFFF)
+		return createIrrXMLReader(file);
+
+	// the parser needs a 0 after the text. The rest of the last page of a mapping is zeroed,
+	// so there is one unless the file fills its last page exactly.
+	const size_t size = (size_t)info.st_size;
+	if (size % (size_t)sysconf(_SC_PAGESIZE) == 0)
+		return createIrrXMLReader(file);
+
+	void* mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+	if (mapping == MAP_FAILED)
+		return createIrrXMLReader(file);
+
+	madvise(mapping, size, MADV_SEQUENTIAL);
+
+	// UTF-16 and UTF-32 files need converting, which only the copying parser does
+	const unsigned char* bytes = (const unsigned char*)mapping;
+	if (size >= 2 && ((bytes[0] == 0xFF && bytes[1] == 0xFE) || (bytes[0] == 0xFE && bytes[1] == 0xFF)))
+	{
+		munmap(mapping, size);
+		return createIrrXMLReader(file);
+	}
+	if (size >= 4 && bytes[0] == 0 && bytes[1] == 0 && bytes[2] == 0xFE && bytes[3] == 0xFF)
+	{
+		munmap(mapping, size);
+		return createIrrXMLReader(file);
+	}
+
+	return new CMappedXMLReader(mapping, size);
+#else
+	return createIrrXMLReader(file);
+#endif
+}
+
+
 //! Creates an instance of an UTF-16 xml parser. 
 IrrXMLReaderUTF16* createIrrXMLReaderUTF16(const char* filename)
 {
@@ -324,6 +324,14 @@ namespace io
 		the value could not be interpreted as integer. */
 		virtual int getAttributeValueAsInt(int idx) const = 0;
 
+		//! Reads the value of an attribute as integer.
+		/** The value is parsed straight from the xml text, like atoi() would, without being
+		copied to a string first.
+		\param name: Name of the attribute.
+		\param out: Receives the value of the attribute. Left unchanged if the attribute does not exist.
+		\return Returns false if an attribute with this name does not exist. */
+		virtual bool getAttributeValueAsInt(const char_type* name, int& out) const = 0;
+
 		//! Returns the value of an attribute as float. 
 		/** \param name: Name of the attribute.
 		\return Value of the attribute as float, and 0 if an attribute with this name does not exist or
@@ -436,6 +444,17 @@ namespace io
 	 and the file could not be opened. */
 	IrrXMLReader* createIrrXMLReader(IFileReadCallBack* callback);
 
+	//! Creates an instance of an UFT-8 or ASCII character xml parser reading a memory-mapped file.
+	/** Unlike createIrrXMLReader(), the file is not read into memory first: the parser works
+	directly on the mapped file, which saves a copy of the whole file. Where files cannot be
+	mapped (or need converting, like UTF-16 and UTF-32 files), this is the same as createIrrXMLReader().
+	\param file: Pointer to opened file, must have been opened in binary mode. The file may be
+	closed once the parser is created.
+	\return Returns a pointer to the created xml parser. This pointer should be 
+	deleted using 'delete' after no longer needed. Returns 0 if an error occured
+	and the file could not be read. */
+	IrrXMLReader* createIrrXMLReaderMapped(FILE* file);
+
 	//! Creates an instance of an UFT-16 xml parser. 
 	/** This means that
 	all character data will be returned in UTF-16. The file to read can 
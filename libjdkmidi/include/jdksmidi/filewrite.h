@@ -58,6 +58,10 @@ public:
 
     virtual long Seek ( long pos, int whence = SEEK_SET ) = 0;
     virtual int WriteChar ( int c ) = 0;
+
+    // write 'len' bytes at once; returns 0, or -1 on error.
+    // the default implementation calls WriteChar() for each byte
+    virtual int WriteBytes ( const unsigned char *buf, int len );
 };
 
 class MIDIFileWriteStreamFile : public MIDIFileWriteStream
@@ -68,6 +72,7 @@ public:
 
     long Seek ( long pos, int whence = SEEK_SET );
     int WriteChar ( int c );
+    int WriteBytes ( const unsigned char *buf, int len );
 protected:
     FILE *f;
 };
@@ -148,6 +153,10 @@ public:
 
     void WriteEndOfTrack ( unsigned long time );
     virtual void RewriteTrackLength();
+
+    // hand the bytes written so far over to the stream
+    void Flush();
+
     // false argument disable use running status in midi file (true on default)
     void UseRunningStatus( bool use )
     {
@@ -157,14 +166,20 @@ public:
 protected:
     virtual void Error ( const char *s );
 
+    // bytes are gathered in out_buffer and given to the stream in blocks, so that writing
+    // a byte does not cost a virtual call
     void WriteCharacter ( uchar c )
     {
-        if ( out_stream->WriteChar ( c ) < 0 )
-            error = true;
+        if ( out_buffered == OUT_BUFFER_SIZE )
+            Flush();
+
+        out_buffer[out_buffered++] = c;
     }
 
     void Seek ( long pos )
     {
+        Flush();
+
         if ( out_stream->Seek ( pos ) < 0 )
             error = true;
     }
@@ -175,6 +190,7 @@ protected:
         file_length += c;
     }
 
+    void WriteBytes ( const uchar *buf, long len );
     void WriteShort ( unsigned short c );
     void Write3Char ( long c );
     void WriteLong ( unsigned long c );
@@ -192,6 +208,10 @@ private:
     uchar running_status;
 
     MIDIFileWriteStream *out_stream;
+
+    enum { OUT_BUFFER_SIZE = 1024 };
+    uchar out_buffer[OUT_BUFFER_SIZE];
+    int out_buffered;
 };
 }
 
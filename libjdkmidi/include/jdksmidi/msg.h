@@ -574,7 +574,7 @@ protected:
 /// The MIDIBigMessage inherits from a MIDIMessage and adds the capability of storing
 /// a dynamically allocated MIDISystemExclusive message inside in case the the message needs to
 /// store a sysex.  If it does not need to store a sysex, typically the MIDISysexExclusive is not
-/// allocated
+/// allocated. The sysex may also come from a MIDISysExPool (that of a MIDITrack, for its events).
 ///
 
 class MIDIBigMessage : public MIDIMessage
@@ -601,7 +601,14 @@ public:
 
     void Copy ( const MIDIMessage &m );
 
-    void CopySysEx ( const MIDISystemExclusive *e );
+    /// Copy e into this message; the copy comes from 'pool' when given, otherwise it is
+    /// dynamically allocated.
+    void CopySysEx ( const MIDISystemExclusive *e, MIDISysExPool *pool = 0 );
+
+    /// Copy m into this message, taking over its sysex instead of copying it when it was
+    /// dynamically allocated or comes from 'pool'; otherwise it is copied as in CopySysEx().
+    /// m is left without sysex.
+    void MoveFrom ( MIDIBigMessage &m, MIDISysExPool *pool = 0 );
 
     //@}
 
@@ -775,6 +782,9 @@ public:
 
     void Copy ( const MIDITimedMessage &m );
 
+    /// Same as MIDIBigMessage::MoveFrom(), also copying the time
+    void MoveFrom ( MIDITimedBigMessage &m, MIDISysExPool *pool = 0 );
+
     //
     // operator =
     //
@@ -151,13 +151,43 @@ public:
     }
 
     void Reset();
+
+    // rebuild the merge heap from next_event_number[] and next_event_time[] (after setting them
+    // directly) and make the earliest event current; O(num_tracks)
     int FindTrackOfFirstEvent();
 
+    // make the earliest event current, the heap being up to date; O(1)
+    int GetTrackOfFirstEvent();
+
+    // to be called after the next event of track_num changed, or the track reached its end
+    // (next_event_number[track_num] < 0); O(log num_tracks)
+    void UpdateTrack ( int track_num );
+
     MIDIClockTime cur_time;
     int cur_event_track;
     int num_tracks;
     int *next_event_number;
     MIDIClockTime *next_event_time;
+
+protected:
+
+    // binary min-heap of the tracks that have events left, ordered by the time of their next
+    // event, then by track number (so events at the same time come in track order)
+    int *heap;
+    // position of each track in heap[], -1 for tracks not in it
+    int *heap_position;
+    int heap_size;
+
+    bool IsBefore ( int track_a, int track_b ) const
+    {
+        return next_event_time[track_a] < next_event_time[track_b] ||
+               ( next_event_time[track_a] == next_event_time[track_b] && track_a < track_b );
+    }
+
+    void HeapSwap ( int pos_a, int pos_b );
+    void HeapSiftUp ( int pos );
+    void HeapSiftDown ( int pos );
+    void HeapRemove ( int pos );
 };
 
 class MIDIMultiTrackIterator
@@ -35,6 +35,8 @@
 #include "jdksmidi/matrix.h"
 #include "jdksmidi/process.h"
 
+#include <vector>
+
 namespace jdksmidi
 {
 
@@ -270,6 +272,7 @@ public:
     int cur_beat;
     int cur_measure;
     MIDIClockTime next_beat_time;
+    int cur_event_count; // events (including beat markers) given out since time zero
 };
 
 class MIDISequencer
@@ -320,6 +323,18 @@ public:
     bool GoToTimeMs ( float time_ms );
     bool GoToMeasure ( int measure, int beat = 0 );
 
+    // play the whole multitrack once and save the states that speed up GoToTime(),
+    // GoToTimeMs() and GoToMeasure(); the current position is kept. This allocates
+    // and takes as long as going through all events, so call it before playback
+    // starts and not from a realtime thread. Without it, seeks replay from time zero
+    void BuildCheckpoints();
+
+    // forget the saved states. Must be called (and BuildCheckpoints() called again)
+    // after changing a track processor returned by GetTrackProcessor() (mute,
+    // transpose, ...) or the multitrack, since the saved states were computed
+    // with the old ones
+    void ClearCheckpoints();
+
     bool GetNextEventTimeMs ( float *t );
     bool GetNextEventTimeMs ( double *t );
     bool GetNextEventTime ( MIDIClockTime *t );
@@ -341,6 +356,23 @@ protected:
     MIDISequencerTrackProcessor *track_processors[64];
 
     MIDISequencerState state;
+
+    // seeking used to replay all events from time zero each time the target was
+    // behind the current position. Instead, BuildCheckpoints() saves a copy of the
+    // state each 'checkpoint_interval' events, and seeks start from the last
+    // checkpoint before their target : they are found by binary search, so at most
+    // 'checkpoint_interval' events are replayed. Playback itself never records
+    // checkpoints, so GetNextEvent() and seeks don't allocate.
+    std::vector< MIDISequencerState * > checkpoints;
+    int checkpoint_interval;
+
+    // go back to checkpoint 'n', or to time zero if 'n' is -1
+    void RestoreCheckpoint ( int n );
+
+    // index of the last checkpoint before the given position, or -1
+    int FindCheckpointBeforeTime ( MIDIClockTime time_clk ) const;
+    int FindCheckpointBeforeTimeMs ( float time_ms ) const;
+    int FindCheckpointBeforeMeasure ( int measure, int beat ) const;
 } ;
 
 }
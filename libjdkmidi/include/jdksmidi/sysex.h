@@ -40,9 +40,13 @@
 
 #include "jdksmidi/midi.h"
 
+#include <vector>
+
 namespace jdksmidi
 {
 
+class MIDISysExPool;
+
 class  MIDISystemExclusive
 {
 public:
@@ -63,6 +67,7 @@ public:
         cur_len = cur_len_;
         chk_sum = 0;
         deletable = deletable_;
+        pool = 0;
     }
 
     virtual ~MIDISystemExclusive();
@@ -154,14 +159,75 @@ public:
         return buf;
     }
 
+    ///
+    /// The pool this object comes from, or 0 if it was allocated on its own
+    ///
+    const MIDISysExPool *GetPool() const
+    {
+        return pool;
+    }
+
 private:
 
+    friend class MIDISysExPool;
+
     unsigned char *buf;
     int max_len;
     int cur_len;
     unsigned char  chk_sum;
     bool deletable;
+    MIDISysExPool *pool;
+};
+
+///
+/// MIDISysExPool hands out MIDISystemExclusive objects for data of up to SMALL_SYSEX_SIZE bytes (which
+/// covers nearly all text events, such as track names and lyrics). They are kept, with their data,
+/// in blocks that the pool allocates a chunk at a time and reuses, so that they don't cost two
+/// allocations each. Larger data gets a MIDISystemExclusive of its own.
+/// Each MIDITrack has a pool for the sysex of its events. A pool is not thread safe, and must
+/// outlive the objects it hands out.
+///
+
+class MIDISysExPool
+{
+public:
+
+    enum { SMALL_SYSEX_SIZE = 32, BLOCKS_PER_CHUNK = 64 };
+
+    MIDISysExPool();
+
+    ~MIDISysExPool();
+
+    ///
+    /// @return a copy of e, from this pool if it is small enough, otherwise allocated with new
+    ///
+    MIDISystemExclusive *Create ( const MIDISystemExclusive &e );
+
+    ///
+    /// Destroy e, which comes from Create() of any pool or was allocated with new
+    ///
+    static void Destroy ( MIDISystemExclusive *e );
+
+private:
+
+    struct Block
+    {
+        MIDISystemExclusive sysex;
+        unsigned char data[SMALL_SYSEX_SIZE];
+
+        Block() : sysex ( data, SMALL_SYSEX_SIZE, 0, false )
+        {
+        }
+    };
+
+    std::vector< Block * > chunks;
+    std::vector< MIDISystemExclusive * > free_sysex;
+
+    // not copyable : the objects handed out point back to their pool
+    MIDISysExPool ( const MIDISysExPool & );
+    const MIDISysExPool &operator = ( const MIDISysExPool & );
 };
+
 }
 
 #endif
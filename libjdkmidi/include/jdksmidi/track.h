@@ -46,57 +46,20 @@ namespace jdksmidi
 {
 
 ///
-/// MIDITrackChunkSize is a constant which specifies how many events are in one MIDITrackChunk.
+/// MIDITrackChunkSize is a constant which specifies by how many events, at least, a MIDITrack
+/// grows when it is full.
 ///
 
 const int MIDITrackChunkSize = 512;
 
 
 ///
-/// A MIDITrack's events are allocated in these chunks in order to avoid memory fragmentation
-/// in embedded systems or other systems lacking an MMU. Every item within a MIDITrackChunk
-/// object is a MIDITimedBigMessage. To avoid unnecessary copied of big events, access
-/// to these events is only done via the GetEventAddress() method.
-///
-
-class  MIDITrackChunk
-{
-public:
-    ///
-    /// GetEventAddress() const returns the address of the MIDITimedBigMessage referred to by event_num
-    /// @param event_num an integer specifying an event number in the range 0 to MIDITrackChunkSize
-    /// @returns The const pointer to the requested event.
-    ///
-    const MIDITimedBigMessage * GetEventAddress ( int event_num ) const;
-
-    ///
-    /// GetEventAddress()  returns the address of the MIDITimedBigMessage referred to by event_num
-    /// @param event_num an integer specifying an event number in the range 0 to MIDITrackChunkSize
-    /// @returns The non-const pointer to the requested event.
-    ///
-
-    MIDITimedBigMessage * GetEventAddress ( int event_num );
-
-protected:
-
-private:
-    MIDITimedBigMessage buf[MIDITrackChunkSize];
-};
-
-///
-/// The MIDIChunksPerTrack constant specifies the maximum number of MIDITrackChunks that can be in one track.
-/// The value MIDIChunksPerTrack * MIDITrackChunkSize is the total number of events.
-/// This is a constant in order to avoid memory fragmentation in embedded systems or systems without an MMU
-///
-
-const int MIDIChunksPerTrack = 512;
-
-
-///
-/// The MIDITrack class is a container that manages an array of MIDIChunk objects and provides an
-/// interface to the user that is useful for managing a list of MIDITimedBigMessages. It internally
-/// stores MIDITimedBigMessage objects. There is a fixed maximum number of events that it can store,
-/// which is defined by MIDIChunksPerTrack * MIDITrackChunkSize.
+/// The MIDITrack class is a container that provides an interface to the user that is useful for
+/// managing a list of MIDITimedBigMessages. It internally stores MIDITimedBigMessage objects in one
+/// contiguous array, so that going through the events in order is a plain sequential memory scan.
+/// To avoid unnecessary copies of big events, access to these events is done via the
+/// GetEventAddress() method. Like with a std::vector, adding events may move the array, which
+/// invalidates the addresses obtained before.
 ///
 
 class  MIDITrack
@@ -116,18 +79,18 @@ public:
     MIDITrack ( const MIDITrack &t );
 
     ///
-    /// The MIDITrack Destructor, frees all chunks and referenced MIDITimedBigMessage's
+    /// The MIDITrack Destructor, frees all MIDITimedBigMessage's
     ///
     ~MIDITrack();
 
     ///
     /// Clear() sets the number of active events in the track to 0. It does NOT
-    /// free any events. See the Shrink() method.
+    /// free the storage of the events. See the Shrink() method.
     ///
     void Clear();
 
     ///
-    /// Shrink() frees any unused MIDITrackChunk objects and associated MIDITimedBigMessage events.
+    /// Shrink() frees any unused MIDITimedBigMessage events.
     ///
     void Shrink();
 
@@ -147,9 +110,21 @@ public:
 
     bool Expand ( int increase_amount = ( MIDITrackChunkSize ) );
 
-    MIDITimedBigMessage * GetEventAddress ( int event_num );
+    ///
+    /// Reserve() makes room for 'event_amount' events in all, so that filling the track up to that
+    /// many events moves the array only once (or not at all)
+    ///
+    bool Reserve ( int event_amount );
 
-    const MIDITimedBigMessage * GetEventAddress ( int event_num ) const;
+    MIDITimedBigMessage * GetEventAddress ( int event_num )
+    {
+        return &buf[event_num];
+    }
+
+    const MIDITimedBigMessage * GetEventAddress ( int event_num ) const
+    {
+        return &buf[event_num];
+    }
 
     const MIDITimedBigMessage *GetEvent ( int event_num ) const;
     MIDITimedBigMessage *GetEvent ( int event_num );
@@ -218,7 +193,16 @@ private:
 
 // void  QSort( int left, int right );
 
-    MIDITrackChunk * chunk[MIDIChunksPerTrack];
+    /// move the events to a new array of new_size events
+    bool Reallocate ( int new_size );
+
+    /// copy msg into the event at ev, with its sysex from sysex_pool
+    void CopyEvent ( MIDITimedBigMessage *ev, const MIDITimedBigMessage &msg );
+
+    /// the sysex of the events (texts, mostly); events moved within the track keep theirs
+    MIDISysExPool sysex_pool;
+
+    MIDITimedBigMessage *buf;
 
     int buf_size;
     int num_events;
@@ -173,12 +173,8 @@ bool MIDIFileReadMultiTrack::mf_text ( MIDIClockTime time, int type, int len, un
     msg.SetMetaType ( ( uchar ) type ); // remember - MF_META_* id codes match META_* codes
     msg.SetTime ( time );
 
-    MIDISystemExclusive sysex( len );
-
-    for ( int i = 0; i < len; ++i )
-    {
-        sysex.PutSysByte ( s[i] );
-    }
+    // only a view on 's', the event keeps a copy of it
+    MIDISystemExclusive sysex( s, len, len, false );
 
     msg.SetDataLength( 0 ); // variable data length don't saved to data_length
     return AddEventToMultiTrack ( msg, &sysex, cur_track );
@@ -206,12 +202,9 @@ bool MIDIFileReadMultiTrack::mf_sysex ( MIDIClockTime time, int type, int len, u
         msg.SetByte6( s[4] );
 
     msg.SetTime ( time );
-    MIDISystemExclusive sysex( len );
 
-    for ( int i = 0; i < len; ++i )
-    {
-        sysex.PutSysByte ( s[i] );
-    }
+    // only a view on 's', the event keeps a copy of it
+    MIDISystemExclusive sysex( s, len, len, false );
 
    msg.SetDataLength( num );
    return AddEventToMultiTrack ( msg, &sysex, cur_track );
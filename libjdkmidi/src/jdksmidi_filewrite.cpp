@@ -58,6 +58,17 @@ MIDIFileWriteStream::~MIDIFileWriteStream()
 {
 }
 
+int MIDIFileWriteStream::WriteBytes ( const unsigned char *buf, int len )
+{
+    for ( int i = 0; i < len; ++i )
+    {
+        if ( WriteChar ( buf[i] ) < 0 )
+            return -1;
+    }
+
+    return 0;
+}
+
 MIDIFileWriteStreamFile::MIDIFileWriteStreamFile ( FILE *f_ )
     : f ( f_ )
 {
@@ -85,6 +96,20 @@ int MIDIFileWriteStreamFile::WriteChar ( int c )
     }
 }
 
+int MIDIFileWriteStreamFile::WriteBytes ( const unsigned char *buf, int len )
+{
+    // stdio does the buffering
+    if ( fwrite ( buf, 1, len, f ) != ( size_t ) len )
+    {
+        return -1;
+    }
+
+    else
+    {
+        return 0;
+    }
+}
+
 
 MIDIFileWrite::MIDIFileWrite ( MIDIFileWriteStream *out_stream_ )
     : out_stream ( out_stream_ )
@@ -97,11 +122,26 @@ MIDIFileWrite::MIDIFileWrite ( MIDIFileWriteStream *out_stream_ )
     running_status = 0;
     track_position = 0;
     use_running_status = true;
+    out_buffered = 0;
 }
 
 MIDIFileWrite::~MIDIFileWrite()
 {
     ENTER ( "MIDIFileWrite::~MIDIFileWrite()" );
+    Flush();
+}
+
+void MIDIFileWrite::Flush()
+{
+    ENTER ( "void MIDIFileWrite::Flush()" );
+
+    if ( out_buffered > 0 )
+    {
+        if ( out_stream->WriteBytes ( out_buffer, out_buffered ) < 0 )
+            error = true;
+
+        out_buffered = 0;
+    }
 }
 
 void MIDIFileWrite::Error ( const char *s )
@@ -111,6 +151,27 @@ void MIDIFileWrite::Error ( const char *s )
     error = true;
 }
 
+void MIDIFileWrite::WriteBytes ( const uchar *buf, long len )
+{
+    ENTER ( "void MIDIFileWrite::WriteBytes()" );
+
+    if ( out_buffered + len > OUT_BUFFER_SIZE )
+        Flush();
+
+    if ( len < OUT_BUFFER_SIZE )
+    {
+        memcpy ( out_buffer + out_buffered, buf, len );
+        out_buffered += len;
+    }
+
+    else
+    {
+        // too big for the buffer, give it to the stream directly
+        if ( out_stream->WriteBytes ( buf, len ) < 0 )
+            error = true;
+    }
+}
+
 void MIDIFileWrite::WriteShort ( unsigned short c )
 {
     ENTER ( "void MIDIFileWrite::WriteShort()" );
@@ -307,10 +368,7 @@ void MIDIFileWrite::WriteSystemExclusiveEvent ( const MIDITimedBigMessage &m )
     int len = m.GetSysEx()->GetLengthSE();
     IncrementCounters ( WriteVariableNum ( len ) );
 
-    for ( int i = 0; i < len; i++ )
-    {
-        WriteCharacter ( m.GetSysEx()->GetData ( i ) );
-    }
+    WriteBytes ( m.GetSysEx()->GetBuf(), len );
     IncrementCounters ( len );
 
     running_status = 0;
@@ -328,10 +386,7 @@ void MIDIFileWrite::WriteTextEvent ( unsigned long time, unsigned char type, con
     int len = strlen ( text );
     IncrementCounters ( WriteVariableNum ( len ) );
 
-    while ( *text )
-    {
-        WriteCharacter ( ( unsigned char ) *text++ );
-    }
+    WriteBytes ( ( const unsigned char * ) text, len );
     IncrementCounters ( len );
 
     running_status = 0;
@@ -348,11 +403,7 @@ void MIDIFileWrite::WriteMetaEvent ( unsigned long time, unsigned char type, con
 
     IncrementCounters ( WriteVariableNum ( length ) );
 
-    for ( int i = 0; i < length; i++ )
-    {
-        WriteCharacter ( data[i] );
-    }
-
+    WriteBytes ( data, length );
     IncrementCounters ( length );
     running_status = 0;
 }
@@ -114,6 +114,15 @@ bool MIDIFileWriteMultiTrack::Write ( int num_tracks, int division )
         writer.RewriteTrackLength();
     }
 
+    // errors of the stream only show once the last bytes are handed over
+    writer.Flush();
+
+    if ( writer.ErrorOccurred() )
+    {
+        fprintf(stderr, "[MidiExport] ErrorOccurred\n");
+        return false;
+    }
+
     if ( !PostWrite() )
     {
         fprintf(stderr, "[MidiExport] PostWrite failed\n");
@@ -752,10 +752,7 @@ MIDIBigMessage::MIDIBigMessage ( const MIDIBigMessage &m )
     MIDIMessage ( m ),
     sysex ( 0 )
 {
-    if ( m.sysex )
-    {
-        sysex = new MIDISystemExclusive ( *m.sysex );
-    }
+    CopySysEx( m.sysex );
 }
 
 MIDIBigMessage::MIDIBigMessage ( const MIDIMessage &m )
@@ -794,10 +791,10 @@ MIDIBigMessage::~MIDIBigMessage()
 
 const MIDIBigMessage &MIDIBigMessage::operator = ( const MIDIBigMessage &m )
 {
-    delete sysex;
-    sysex = 0;
-    if ( m.sysex )
-        sysex = new MIDISystemExclusive ( *m.sysex );
+    if ( &m == this )
+        return *this;
+
+    CopySysEx( m.sysex );
 
     MIDIMessage::operator = ( m );
     return *this;
@@ -805,8 +802,7 @@ const MIDIBigMessage &MIDIBigMessage::operator = ( const MIDIBigMessage &m )
 
 const MIDIBigMessage &MIDIBigMessage::operator = ( const MIDIMessage &m )
 {
-    delete sysex;
-    sysex = 0;
+    ClearSysEx();
     MIDIMessage::operator = ( m );
     return *this;
 }
@@ -821,6 +817,28 @@ void MIDIBigMessage::Copy ( const MIDIBigMessage &m )
     *this = m;
 }
 
+void MIDIBigMessage::MoveFrom ( MIDIBigMessage &m, MIDISysExPool *pool )
+{
+    if ( &m == this )
+        return;
+
+    if ( m.sysex && ( m.sysex->GetPool() == 0 || m.sysex->GetPool() == pool ) )
+    {
+        ClearSysEx();
+        sysex = m.sysex;
+        m.sysex = 0;
+    }
+
+    else
+    {
+        // a sysex from another pool must not outlive it
+        CopySysEx( m.sysex, pool );
+        m.ClearSysEx();
+    }
+
+    MIDIMessage::operator = ( m );
+}
+
 //
 // 'Get' methods
 //
@@ -839,26 +857,27 @@ const MIDISystemExclusive *MIDIBigMessage::GetSysEx() const
 // 'Set' methods
 //
 
-void MIDIBigMessage::CopySysEx ( const MIDISystemExclusive *e )
+void MIDIBigMessage::CopySysEx ( const MIDISystemExclusive *e, MIDISysExPool *pool )
 {
-    ClearSysEx();
+    MIDISystemExclusive *copy = 0;
+
     if ( e )
     {
-        sysex = new MIDISystemExclusive ( *e );
+        if ( pool )
+            copy = pool->Create( *e );
+        else
+            copy = new MIDISystemExclusive ( *e );
     }
-}
 
-#if 0
-void MIDIBigMessage::SetSysEx ( MIDISystemExclusive *e )
-{
-    delete sysex;
-    sysex = e;
+    // e may be the current sysex
+    ClearSysEx();
+    sysex = copy;
 }
-#endif
 
 void MIDIBigMessage::ClearSysEx()
 {
-    jdks_safe_delete_object( sysex );
+    MIDISysExPool::Destroy( sysex );
+    sysex = 0;
 }
 
 
@@ -1094,6 +1113,12 @@ void MIDITimedBigMessage::Copy ( const MIDITimedMessage &m )
     *this = m;
 }
 
+void MIDITimedBigMessage::MoveFrom ( MIDITimedBigMessage &m, MIDISysExPool *pool )
+{
+    time = m.GetTime();
+    MIDIBigMessage::MoveFrom( m, pool );
+}
+
 //
 // operator =
 //
@@ -172,6 +172,8 @@ MIDIMultiTrackIteratorState::MIDIMultiTrackIteratorState ( int num_tracks_ )
     cur_event_track = 0;
     next_event_number = new int [num_tracks];
     next_event_time = new MIDIClockTime [num_tracks];
+    heap = new int [num_tracks];
+    heap_position = new int [num_tracks];
     Reset();
 }
 
@@ -181,12 +183,17 @@ MIDIMultiTrackIteratorState::MIDIMultiTrackIteratorState ( const MIDIMultiTrackI
     cur_event_track = m.cur_event_track;
     next_event_number = new int [num_tracks];
     next_event_time = new MIDIClockTime [num_tracks];
+    heap = new int [num_tracks];
+    heap_position = new int [num_tracks];
     cur_time = m.cur_time;
+    heap_size = m.heap_size;
 
     for ( int i = 0; i < num_tracks; ++i )
     {
         next_event_number[i] = m.next_event_number[i];
         next_event_time[i] = m.next_event_time[i];
+        heap[i] = m.heap[i];
+        heap_position[i] = m.heap_position[i];
     }
 }
 
@@ -194,6 +201,8 @@ MIDIMultiTrackIteratorState::~MIDIMultiTrackIteratorState()
 {
     jdks_safe_delete_array( next_event_number );
     jdks_safe_delete_array( next_event_time );
+    jdks_safe_delete_array( heap );
+    jdks_safe_delete_array( heap_position );
 }
 
 const MIDIMultiTrackIteratorState & MIDIMultiTrackIteratorState::operator = ( const MIDIMultiTrackIteratorState &m )
@@ -202,18 +211,25 @@ const MIDIMultiTrackIteratorState & MIDIMultiTrackIteratorState::operator = ( co
     {
         delete [] next_event_number;
         delete [] next_event_time;
+        delete [] heap;
+        delete [] heap_position;
         num_tracks = m.num_tracks;
         next_event_number = new int [num_tracks];
         next_event_time = new MIDIClockTime [num_tracks];
+        heap = new int [num_tracks];
+        heap_position = new int [num_tracks];
     }
 
     cur_time = m.cur_time;
     cur_event_track = m.cur_event_track;
+    heap_size = m.heap_size;
 
     for ( int i = 0; i < num_tracks; ++i )
     {
         next_event_number[i] = m.next_event_number[i];
         next_event_time[i] = m.next_event_time[i];
+        heap[i] = m.heap[i];
+        heap_position[i] = m.heap_position[i];
     }
 
     return *this;
@@ -223,40 +239,155 @@ void MIDIMultiTrackIteratorState::Reset()
 {
     cur_time = 0;
     cur_event_track = 0;
+    heap_size = 0;
 
     for ( int i = 0; i < num_tracks; ++i )
     {
         next_event_number[i] = 0;
         next_event_time[i] = 0xffffffff;
+        heap_position[i] = -1;
     }
 }
 
 int MIDIMultiTrackIteratorState::FindTrackOfFirstEvent()
 {
-    MIDIClockTime minimum_time = 0xffffffff;
-    int minimum_time_track = -1;
-    // go through all tracks and find the track with the smallest
-    // event time.
+    // put all tracks that are not finished yet (current event number >= 0) in the heap
+    heap_size = 0;
 
-    for ( int j = 0; j < num_tracks; ++j )
+    for ( int i = 0; i < num_tracks; ++i )
     {
-        int i = ( j + cur_event_track + 1 ) % num_tracks;
-        // skip any tracks that have a current event number less than 0 - these are
-        // finished already
+        if ( next_event_number[i] >= 0 )
+        {
+            heap[heap_size] = i;
+            heap_position[i] = heap_size;
+            heap_size++;
+        }
 
-        if ( next_event_number[i] >= 0 && next_event_time[i] < minimum_time )
+        else
         {
-            minimum_time = next_event_time[i];
-            minimum_time_track = i;
+            heap_position[i] = -1;
         }
     }
 
+    for ( int pos = heap_size / 2 - 1; pos >= 0; --pos )
+    {
+        HeapSiftDown( pos );
+    }
+
+    return GetTrackOfFirstEvent();
+}
+
+int MIDIMultiTrackIteratorState::GetTrackOfFirstEvent()
+{
     // set cur_event_track to -1 if there are no more events left
-    cur_event_track = minimum_time_track;
-    cur_time = minimum_time;
+    if ( heap_size == 0 )
+    {
+        cur_event_track = -1;
+        cur_time = 0xffffffff;
+    }
+
+    else
+    {
+        cur_event_track = heap[0];
+        cur_time = next_event_time[ heap[0] ];
+    }
+
     return cur_event_track;
 }
 
+void MIDIMultiTrackIteratorState::UpdateTrack ( int track_num )
+{
+    const int pos = heap_position[track_num];
+
+    if ( pos < 0 )
+    {
+        return; // track was already finished
+    }
+
+    if ( next_event_number[track_num] < 0 )
+    {
+        HeapRemove( pos );
+    }
+
+    else
+    {
+        // times in a sorted track never go back, so the track usually moves down the heap; but tracks
+        // are not required to be sorted, and an earlier event must move the track up instead
+        HeapSiftDown( pos );
+        HeapSiftUp( heap_position[track_num] );
+    }
+}
+
+void MIDIMultiTrackIteratorState::HeapSwap ( int pos_a, int pos_b )
+{
+    const int track_a = heap[pos_a];
+    heap[pos_a] = heap[pos_b];
+    heap[pos_b] = track_a;
+    heap_position[ heap[pos_a] ] = pos_a;
+    heap_position[ heap[pos_b] ] = pos_b;
+}
+
+void MIDIMultiTrackIteratorState::HeapSiftUp ( int pos )
+{
+    while ( pos > 0 )
+    {
+        const int parent = ( pos - 1 ) / 2;
+
+        if ( !IsBefore( heap[pos], heap[parent] ) )
+        {
+            break;
+        }
+
+        HeapSwap( pos, parent );
+        pos = parent;
+    }
+}
+
+void MIDIMultiTrackIteratorState::HeapSiftDown ( int pos )
+{
+    while ( true )
+    {
+        const int left = 2 * pos + 1;
+        const int right = left + 1;
+        int first = pos;
+
+        if ( left < heap_size && IsBefore( heap[left], heap[first] ) )
+        {
+            first = left;
+        }
+
+        if ( right < heap_size && IsBefore( heap[right], heap[first] ) )
+        {
+            first = right;
+        }
+
+        if ( first == pos )
+        {
+            break;
+        }
+
+        HeapSwap( pos, first );
+        pos = first;
+    }
+}
+
+void MIDIMultiTrackIteratorState::HeapRemove ( int pos )
+{
+    heap_position[ heap[pos] ] = -1;
+    heap_size--;
+
+    if ( pos == heap_size )
+    {
+        return;
+    }
+
+    // move the last track into the hole, then restore the heap order around it
+    heap[pos] = heap[heap_size];
+    heap_position[ heap[pos] ] = pos;
+    HeapSiftDown( pos );
+    HeapSiftUp( pos );
+}
+
 
 
 
@@ -395,9 +526,10 @@ bool MIDIMultiTrackIterator::GoToNextEvent()
     // update the current event for the current track to the
     // next event on the same track.
     GoToNextEventOnTrack ( state.cur_event_track );
-    // now find out which track now has the earliest event
+    // now find out which track now has the earliest event (GoToNextEventOnTrack
+    // kept the heap of tracks in order)
 
-    if ( state.FindTrackOfFirstEvent() == -1 )
+    if ( state.GetTrackOfFirstEvent() == -1 )
     {
         // No tracks do. all tracks are at the end. return false.
         return false;
@@ -428,6 +560,7 @@ bool MIDIMultiTrackIterator::GoToNextEventOnTrack ( int track_num )
     {
         // yes, set *event_num to -1
         *event_num = -1;
+        state.UpdateTrack ( track_num );
         return false; // at end of track
     }
 
@@ -437,6 +570,7 @@ bool MIDIMultiTrackIterator::GoToNextEventOnTrack ( int track_num )
         const MIDITimedBigMessage *msg;
         msg = track->GetEventAddress ( *event_num );
         state.next_event_time[ track_num ] = msg->GetTime();
+        state.UpdateTrack ( track_num );
     }
 
     return true;
@@ -484,7 +484,8 @@ MIDISequencerState::MIDISequencerState (
     cur_time_ms ( 0 ),
     cur_beat ( 0 ),
     cur_measure ( 0 ),
-    next_beat_time ( 0 )
+    next_beat_time ( 0 ),
+    cur_event_count ( 0 )
 {
     for ( int i = 0; i < num_tracks; ++i )
     {
@@ -502,7 +503,8 @@ MIDISequencerState::MIDISequencerState ( const MIDISequencerState &s )
     cur_time_ms ( s.cur_time_ms ),
     cur_beat ( s.cur_beat ),
     cur_measure ( s.cur_measure ),
-    next_beat_time ( s.next_beat_time )
+    next_beat_time ( s.next_beat_time ),
+    cur_event_count ( s.cur_event_count )
 {
     for ( int i = 0; i < num_tracks; ++i )
     {
@@ -538,12 +540,21 @@ const MIDISequencerState & MIDISequencerState::operator = ( const MIDISequencerS
         }
     }
 
+    else
+    {
+        for ( int i = 0; i < num_tracks; ++i )
+        {
+            *track_state[i] = *s.track_state[i];
+        }
+    }
+
     iterator = s.iterator;
     cur_clock = s.cur_clock;
     cur_time_ms = s.cur_time_ms;
     cur_beat = s.cur_beat;
     cur_measure = s.cur_measure;
     next_beat_time = s.next_beat_time;
+    cur_event_count = s.cur_event_count;
     return *this;
 }
 
@@ -565,11 +576,22 @@ MIDISequencer::MIDISequencer (
     {
         track_processors[i] = new MIDISequencerTrackProcessor;
     }
+
+    // about 64 checkpoints over the whole multitrack, but not so many that
+    // copying the state costs more than replaying the events in between
+    checkpoint_interval = m->GetNumEvents() / 64;
+
+    if ( checkpoint_interval < 4096 )
+    {
+        checkpoint_interval = 4096;
+    }
 }
 
 
 MIDISequencer::~MIDISequencer()
 {
+    ClearCheckpoints();
+
     for ( int i = 0; i < num_tracks; ++i )
     {
         jdks_safe_delete_object( track_processors[i] );
@@ -580,6 +602,7 @@ void MIDISequencer::ResetTrack ( int trk )
 {
     state.track_state[trk]->Reset();
     track_processors[trk]->Reset();
+    ClearCheckpoints();
 }
 
 void MIDISequencer::ResetAllTracks()
@@ -589,6 +612,8 @@ void MIDISequencer::ResetAllTracks()
         state.track_state[i]->Reset();
         track_processors[i]->Reset();
     }
+
+    ClearCheckpoints();
 }
 
 MIDISequencerState *MIDISequencer::GetState()
@@ -665,6 +690,8 @@ bool MIDISequencer::GetSoloMode() const
 void MIDISequencer::SetCurrentTempoScale ( float scale )
 {
     tempo_scale = ( int ) ( scale * 100 );
+    // the time in ms of the saved states is no longer right
+    ClearCheckpoints();
 }
 
 void MIDISequencer::SetSoloMode ( bool m, int trk )
@@ -684,42 +711,29 @@ void MIDISequencer::SetSoloMode ( bool m, int trk )
             track_processors[i]->solo = false;
         }
     }
+
+    ClearCheckpoints();
 }
 
-void MIDISequencer::GoToZero()
+void MIDISequencer::ClearCheckpoints()
 {
-    // go to time zero
-    for ( int i = 0; i < num_tracks; ++i )
+    for ( size_t i = 0; i < checkpoints.size(); ++i )
     {
-        state.track_state[i]->GoToZero();
+        jdks_safe_delete_object( checkpoints[i] );
     }
 
-    state.iterator.GoToTime ( 0 );
-    state.cur_time_ms = 0.0;
-    state.cur_clock = 0;
-// state.next_beat_time = state.multitrack->GetClksPerBeat();
-    state.next_beat_time =
-        state.multitrack->GetClksPerBeat()
-        * 4 / ( state.track_state[0]->timesig_denominator );
-    // examine all the events at this specific time
-    // and update the track states to reflect this time
-    ScanEventsAtThisTime();
+    checkpoints.clear();
 }
 
-bool MIDISequencer::GoToTime ( MIDIClockTime time_clk )
+void MIDISequencer::RestoreCheckpoint ( int n )
 {
-    // temporarily disable the gui notifier
-    bool notifier_mode = false;
-
-    if ( state.notifier )
+    if ( n >= 0 )
     {
-        notifier_mode = state.notifier->GetEnable();
-        state.notifier->SetEnable ( false );
+        state = *checkpoints[n];
     }
 
-    if ( time_clk < state.cur_clock || time_clk == 0 )
+    else
     {
-        // start from zero if desired time is before where we are
         for ( int i = 0; i < state.num_tracks; ++i )
         {
             state.track_state[i]->GoToZero();
@@ -734,6 +748,148 @@ bool MIDISequencer::GoToTime ( MIDIClockTime time_clk )
             * 4 / ( state.track_state[0]->timesig_denominator );
         state.cur_beat = 0;
         state.cur_measure = 0;
+        state.cur_event_count = 0;
+    }
+}
+
+void MIDISequencer::BuildCheckpoints()
+{
+    // temporarily disable the gui notifier
+    bool notifier_mode = false;
+
+    if ( state.notifier )
+    {
+        notifier_mode = state.notifier->GetEnable();
+        state.notifier->SetEnable ( false );
+    }
+
+    MIDISequencerState orig_state ( state );
+    ClearCheckpoints();
+
+    // play the whole multitrack once from time zero;
+    // checkpoint n holds the state after (n + 1) * checkpoint_interval events
+    RestoreCheckpoint ( -1 );
+    int trk;
+    MIDITimedBigMessage ev;
+
+    while ( GetNextEvent ( &trk, &ev ) )
+    {
+        if ( state.cur_event_count == ( int ) ( checkpoints.size() + 1 ) * checkpoint_interval )
+        {
+            checkpoints.push_back ( new MIDISequencerState ( state ) );
+        }
+    }
+
+    state = orig_state;
+
+    if ( state.notifier )
+    {
+        state.notifier->SetEnable ( notifier_mode );
+    }
+}
+int MIDISequencer::FindCheckpointBeforeTime ( MIDIClockTime time_clk ) const
+{
+    int lo = 0;
+    int hi = ( int ) checkpoints.size();
+
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+
+        if ( checkpoints[mid]->cur_clock < time_clk )
+        {
+            lo = mid + 1;
+        }
+
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo - 1;
+}
+
+int MIDISequencer::FindCheckpointBeforeTimeMs ( float time_ms ) const
+{
+    int lo = 0;
+    int hi = ( int ) checkpoints.size();
+
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+
+        if ( checkpoints[mid]->cur_time_ms < time_ms )
+        {
+            lo = mid + 1;
+        }
+
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo - 1;
+}
+
+int MIDISequencer::FindCheckpointBeforeMeasure ( int measure, int beat ) const
+{
+    int lo = 0;
+    int hi = ( int ) checkpoints.size();
+
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+        const MIDISequencerState *c = checkpoints[mid];
+
+        if ( c->cur_measure < measure
+             || ( c->cur_measure == measure && c->cur_beat < beat ) )
+        {
+            lo = mid + 1;
+        }
+
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo - 1;
+}
+
+void MIDISequencer::GoToZero()
+{
+    // go to time zero
+    RestoreCheckpoint ( -1 );
+    // examine all the events at this specific time
+    // and update the track states to reflect this time
+    ScanEventsAtThisTime();
+}
+
+bool MIDISequencer::GoToTime ( MIDIClockTime time_clk )
+{
+    // temporarily disable the gui notifier
+    bool notifier_mode = false;
+
+    if ( state.notifier )
+    {
+        notifier_mode = state.notifier->GetEnable();
+        state.notifier->SetEnable ( false );
+    }
+
+    int n = FindCheckpointBeforeTime ( time_clk );
+
+    if ( time_clk < state.cur_clock || time_clk == 0 )
+    {
+        // start from the last checkpoint (or from zero) if desired time is before where we are
+        RestoreCheckpoint ( n );
+    }
+
+    else if ( n >= 0 && checkpoints[n]->cur_event_count > state.cur_event_count )
+    {
+        // or jump forward if there is a checkpoint between here and there
+        RestoreCheckpoint ( n );
     }
 
     MIDIClockTime t = 0;
@@ -775,23 +931,18 @@ bool MIDISequencer::GoToTimeMs ( float time_ms )
         state.notifier->SetEnable ( false );
     }
 
+    int n = FindCheckpointBeforeTimeMs ( time_ms );
+
     if ( time_ms < state.cur_time_ms || time_ms == 0.0 )
     {
-        // start from zero if desired time is before where we are
-        for ( int i = 0; i < state.num_tracks; ++i )
-        {
-            state.track_state[i]->GoToZero();
-        }
+        // start from the last checkpoint (or from zero) if desired time is before where we are
+        RestoreCheckpoint ( n );
+    }
 
-        state.iterator.GoToTime ( 0 );
-        state.cur_time_ms = 0.0;
-        state.cur_clock = 0;
-//  state.next_beat_time = state.multitrack->GetClksPerBeat();
-        state.next_beat_time =
-            state.multitrack->GetClksPerBeat()
-            * 4 / ( state.track_state[0]->timesig_denominator );
-        state.cur_beat = 0;
-        state.cur_measure = 0;
+    else if ( n >= 0 && checkpoints[n]->cur_event_count > state.cur_event_count )
+    {
+        // or jump forward if there is a checkpoint between here and there
+        RestoreCheckpoint ( n );
     }
 
     float t = 0;
@@ -833,22 +984,16 @@ bool MIDISequencer::GoToMeasure ( int measure, int beat )
         state.notifier->SetEnable ( false );
     }
 
+    int n = FindCheckpointBeforeMeasure ( measure, beat );
+
     if ( measure < state.cur_measure || measure == 0 )
     {
-        for ( int i = 0; i < state.num_tracks; ++i )
-        {
-            state.track_state[i]->GoToZero();
-        }
+        RestoreCheckpoint ( n );
+    }
 
-        state.iterator.GoToTime ( 0 );
-        state.cur_time_ms = 0.0;
-        state.cur_clock = 0;
-        state.cur_beat = 0;
-        state.cur_measure = 0;
-//  state.next_beat_time = state.multitrack->GetClksPerBeat();
-        state.next_beat_time =
-            state.multitrack->GetClksPerBeat()
-            * 4 / ( state.track_state[0]->timesig_denominator );
+    else if ( n >= 0 && checkpoints[n]->cur_event_count > state.cur_event_count )
+    {
+        RestoreCheckpoint ( n );
     }
 
     MIDIClockTime t = 0;
@@ -1023,6 +1168,7 @@ bool MIDISequencer::GetNextEvent ( int *tracknum, MIDITimedBigMessage *msg )
 
             // give the beat marker event to the conductor track to process
             state.track_state[*tracknum]->Process ( msg );
+            ++state.cur_event_count;
             return true;
         }
 
@@ -1066,6 +1212,7 @@ bool MIDISequencer::GetNextEvent ( int *tracknum, MIDITimedBigMessage *msg )
 
                 // go to the next event on the multitrack
                 state.iterator.GoToNextEvent();
+                ++state.cur_event_count;
                 return true;
             }
         }
@@ -1083,6 +1230,7 @@ void MIDISequencer::ScanEventsAtThisTime()
     // process all messages up to and including this time only
     MIDIClockTime orig_clock = state.cur_clock;
     double orig_time_ms = state.cur_time_ms;
+    int orig_event_count = state.cur_event_count;
     MIDIClockTime t = 0;
     int trk;
     MIDITimedBigMessage ev;
@@ -1096,6 +1244,8 @@ void MIDISequencer::ScanEventsAtThisTime()
         ;
     }
 
+    state.cur_event_count = orig_event_count;
+
     // restore the iterator state
     state.iterator.SetState ( istate );
     // and current time
@@ -64,6 +64,7 @@ MIDISystemExclusive::MIDISystemExclusive ( int size_ )
     cur_len = 0;
     chk_sum = 0;
     deletable = true;
+    pool = 0;
 }
 
 MIDISystemExclusive::MIDISystemExclusive ( const MIDISystemExclusive &e )
@@ -73,6 +74,7 @@ MIDISystemExclusive::MIDISystemExclusive ( const MIDISystemExclusive &e )
     cur_len = e.cur_len;
     chk_sum = e.chk_sum;
     deletable = true;
+    pool = 0;
 
     for ( int i = 0; i < cur_len; ++i )
     {
@@ -90,6 +92,71 @@ MIDISystemExclusive::~MIDISystemExclusive()
     }
 }
 
+MIDISysExPool::MIDISysExPool()
+{
+}
+
+MIDISysExPool::~MIDISysExPool()
+{
+    // all objects handed out must have been given back by now
+    assert( free_sysex.size() == chunks.size() * BLOCKS_PER_CHUNK );
+
+    for ( size_t i = 0; i < chunks.size(); ++i )
+    {
+        delete [] chunks[i];
+    }
+}
+
+MIDISystemExclusive *MIDISysExPool::Create ( const MIDISystemExclusive &e )
+{
+    if ( e.cur_len > SMALL_SYSEX_SIZE )
+    {
+        return new MIDISystemExclusive ( e );
+    }
+
+    if ( free_sysex.empty() )
+    {
+        Block *chunk = new Block [BLOCKS_PER_CHUNK];
+        chunks.push_back( chunk );
+        free_sysex.reserve( chunks.size() * BLOCKS_PER_CHUNK );
+
+        for ( int i = BLOCKS_PER_CHUNK - 1; i >= 0; --i )
+        {
+            chunk[i].sysex.pool = this;
+            free_sysex.push_back( &chunk[i].sysex );
+        }
+    }
+
+    MIDISystemExclusive *sysex = free_sysex.back();
+    free_sysex.pop_back();
+
+    sysex->cur_len = e.cur_len;
+    sysex->chk_sum = e.chk_sum;
+
+    if ( e.cur_len > 0 )
+    {
+        memcpy( sysex->buf, e.buf, e.cur_len );
+    }
+
+    return sysex;
+}
+
+void MIDISysExPool::Destroy ( MIDISystemExclusive *e )
+{
+    if ( e == 0 )
+        return;
+
+    if ( e->pool )
+    {
+        e->pool->free_sysex.push_back( e );
+    }
+
+    else
+    {
+        delete e;
+    }
+}
+
 bool operator == ( const MIDISystemExclusive &e1, const MIDISystemExclusive &e2 )
 {
     if ( e1.cur_len != e2.cur_len )
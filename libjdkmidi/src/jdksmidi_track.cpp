@@ -38,6 +38,8 @@
 #include "jdksmidi/world.h"
 #include "jdksmidi/track.h"
 
+#include <new>
+
 #ifndef DEBUG_MDTRACK
 # define DEBUG_MDTRACK 0
 #endif
@@ -50,28 +52,12 @@
 namespace jdksmidi
 {
 
-const MIDITimedBigMessage * MIDITrackChunk::GetEventAddress ( int event_num ) const
-{
-    return &buf[event_num];
-}
-
-MIDITimedBigMessage * MIDITrackChunk::GetEventAddress ( int event_num )
-{
-    return &buf[event_num];
-}
-
-
-
-
-
 MIDITrack::MIDITrack ( int size )
 {
+    buf = 0;
     buf_size = 0;
     num_events = 0;
 
-    for ( int i = 0; i < MIDIChunksPerTrack; ++i )
-        chunk[i] = 0;
-
     if ( size )
     {
         Expand ( size );
@@ -80,27 +66,36 @@ MIDITrack::MIDITrack ( int size )
 
 MIDITrack::MIDITrack ( const MIDITrack &t )
 {
+    buf = 0;
     buf_size = 0;
     num_events = 0;
 
+    if ( t.GetNumEvents() > 0 )
+    {
+        Expand ( t.GetNumEvents() );
+    }
+
     for ( int i = 0; i < t.GetNumEvents(); ++i )
     {
         const MIDITimedBigMessage *src;
         src = t.GetEventAddress ( i );
-        PutEvent ( *src ); // it execute Expand()
+        PutEvent ( *src );
     }
 }
 
 MIDITrack::~MIDITrack()
 {
-    for ( int i = 0; i < buf_size / MIDITrackChunkSize; ++i )
-    {
-        jdks_safe_delete_object( chunk[i] );
-    }
+    Clear();
+    ::operator delete ( buf );
 }
 
 void MIDITrack::Clear()
 {
+    for ( int i = 0; i < num_events; ++i )
+    {
+        buf[i].~MIDITimedBigMessage();
+    }
+
     num_events = 0;
 }
 
@@ -129,9 +124,22 @@ bool MIDITrack::EventsOrderOK() const
 
 void MIDITrack::SortEventsOrder()
 {
+    // most tracks are already in order (e.g. everything written by a sequencer), leave them untouched
+    // (not using EventsOrderOK() since that one reports out-of-order events)
+    int n;
+    for ( n = 1; n < num_events; ++n )
+    {
+        if ( GetEventAddress(n - 1)->GetTime() > GetEventAddress(n)->GetTime() )
+            break;
+    }
+
+    if ( n >= num_events )
+        return;
+
+    // stable sort of the event numbers by time : afterwards, et[n].event_number is the event that
+    // goes to position n
     std::vector< Event_time > et( num_events );
 
-    int n;
     for ( n = 0; n < num_events; ++n )
     {
         et[n].event_number = n;
@@ -140,17 +148,33 @@ void MIDITrack::SortEventsOrder()
 
     std::stable_sort( et.begin(), et.end(), Event_time::less );
 
-    MIDITrack trk( num_events );
+    // apply this permutation in place, one cycle at a time : every event is moved once (the first
+    // event of each cycle twice, through 'held'), and sysex buffers change hands without being copied
+    MIDITimedBigMessage held;
 
     for ( n = 0; n < num_events; ++n )
     {
-        int event_num = et[n].event_number;
-        const MIDITimedBigMessage *src;
-        src = GetEventAddress( event_num );
-        trk.PutEvent( *src ); // add src event to trk
-    }
+        if ( et[n].event_number == n )
+            continue; // already in place, or already moved as part of an earlier cycle
+
+        held.MoveFrom( *GetEventAddress( n ), &sysex_pool );
+
+        int dest = n;
+        for (;;)
+        {
+            const int src = et[dest].event_number;
+            et[dest].event_number = dest; // mark as done
 
-    *this = trk;
+            if ( src == n )
+            {
+                GetEventAddress( dest )->MoveFrom( held, &sysex_pool );
+                break;
+            }
+
+            GetEventAddress( dest )->MoveFrom( *GetEventAddress( src ), &sysex_pool );
+            dest = src;
+        }
+    }
 }
 
 int MIDITrack::RemoveIdenticalEvents( int max_distance_between_identical_events )
@@ -191,15 +215,17 @@ const MIDITrack & MIDITrack::operator = ( const MIDITrack & src )
     }
     else
     {
-        this->~MIDITrack();
+        Clear();
 
-        buf_size = 0;
-        num_events = 0;
+        if ( buf_size < src.GetNumEvents() )
+        {
+            Expand ( src.GetNumEvents() - buf_size );
+        }
 
         for ( int i = 0; i < src.GetNumEvents(); ++i )
         {
             const MIDITimedBigMessage *msg = src.GetEventAddress ( i );
-            PutEvent ( *msg ); // it execute Expand()
+            PutEvent ( *msg );
         }
     }
 
@@ -451,70 +477,89 @@ void MIDITrack::Sort()
 
 void MIDITrack::Shrink()
 {
-    int num_chunks_used = ( int ) ( ( num_events / MIDITrackChunkSize ) + 1 );
-    int num_chunks_alloced = ( int ) ( buf_size / MIDITrackChunkSize );
+    if ( num_events == buf_size )
+        return;
 
-    if ( num_chunks_used < num_chunks_alloced )
+    if ( num_events == 0 )
     {
-        for ( int i = num_chunks_used; i < num_chunks_alloced; ++i )
-        {
-            jdks_safe_delete_object( chunk[i] );
-        }
-
-        buf_size = num_chunks_used * MIDITrackChunkSize;
+        ::operator delete ( buf );
+        buf = 0;
+        buf_size = 0;
+        return;
     }
+
+    Reallocate ( num_events );
 }
 
 bool MIDITrack::Expand ( int increase_amount )
 {
-    int num_chunks_to_expand = ( int ) ( ( increase_amount / MIDITrackChunkSize ) + 1 );
-    int num_chunks_alloced = ( int ) ( buf_size / MIDITrackChunkSize );
-    int new_last_chunk_num = ( int ) ( num_chunks_to_expand + num_chunks_alloced );
-
-    if ( new_last_chunk_num >= MIDIChunksPerTrack )
-    {
-        return false;
-    }
+    // at least double the size, so that adding events one by one stays linear
+    int new_size = buf_size + increase_amount;
 
-    for ( int i = num_chunks_alloced; i < new_last_chunk_num; ++i )
-    {
-        chunk[i] = new MIDITrackChunk;
+    if ( new_size < buf_size * 2 )
+        new_size = buf_size * 2;
 
-        if ( !chunk[i] )
-        {
-            buf_size = ( i - 1 ) * MIDITrackChunkSize;
-            return false;
-        }
-    }
-
-    buf_size = new_last_chunk_num * MIDITrackChunkSize;
-    return true;
+    return Reallocate ( new_size );
 }
 
-MIDITimedBigMessage * MIDITrack::GetEventAddress ( int event_num )
+bool MIDITrack::Reserve ( int event_amount )
 {
-    return chunk[ event_num/ ( MIDITrackChunkSize ) ]->GetEventAddress (
-               ( event_num % MIDITrackChunkSize ) );
+    if ( event_amount <= buf_size )
+        return true;
+
+    return Reallocate ( event_amount );
 }
 
-const MIDITimedBigMessage * MIDITrack::GetEventAddress ( int event_num ) const
+bool MIDITrack::Reallocate ( int new_size )
 {
-    return chunk[ event_num/ ( MIDITrackChunkSize ) ]->GetEventAddress (
-               ( event_num % MIDITrackChunkSize ) );
+    // only the used events are constructed, the rest of the array is raw memory
+    MIDITimedBigMessage *new_buf =
+        static_cast<MIDITimedBigMessage *> ( ::operator new ( new_size * sizeof ( MIDITimedBigMessage ) ) );
+
+    // moving the events hands their sysex buffers over
+    for ( int i = 0; i < num_events; ++i )
+    {
+        new ( &new_buf[i] ) MIDITimedBigMessage;
+        new_buf[i].MoveFrom ( buf[i], &sysex_pool );
+        buf[i].~MIDITimedBigMessage();
+    }
+
+    ::operator delete ( buf );
+    buf = new_buf;
+    buf_size = new_size;
+    return true;
 }
 
 bool MIDITrack::PutEvent ( const MIDITimedBigMessage &msg )
 {
     if ( num_events >= buf_size )
     {
+        // 'msg' could be one of the events of this track, that Expand() is about to move
+        MIDITimedBigMessage copy ( msg );
+
         if ( !Expand() )
             return false;
+
+        new ( &buf[num_events] ) MIDITimedBigMessage;
+        CopyEvent ( &buf[num_events++], copy );
+        return true;
     }
 
-    GetEventAddress ( num_events++ )->Copy ( msg );
+    new ( &buf[num_events] ) MIDITimedBigMessage;
+    CopyEvent ( &buf[num_events++], msg );
     return true;
 }
 
+void MIDITrack::CopyEvent ( MIDITimedBigMessage *ev, const MIDITimedBigMessage &msg )
+{
+    if ( ev == &msg )
+        return;
+
+    *ev = ( const MIDIMessage & ) msg;
+    ev->SetTime ( msg.GetTime() );
+    ev->CopySysEx ( msg.GetSysEx(), &sysex_pool );
+}
+
 bool MIDITrack::PutEvent ( const MIDIDeltaTimedBigMessage &msg )
 {
     const MIDIBigMessage msg2( msg );
@@ -526,20 +571,31 @@ bool MIDITrack::PutEvent ( const MIDIDeltaTimedBigMessage &msg )
 
 bool MIDITrack::PutEvent2 ( MIDITimedBigMessage &msg )
 {
-    if ( PutEvent ( msg ) )
+    if ( num_events >= buf_size )
     {
-        MIDIClockTime t = msg.GetTime();
-        msg.Clear();
-        msg.SetTime( t );
-        return true;
+        if ( !Expand() )
+            return false;
     }
-    return false;
+
+    new ( &buf[num_events] ) MIDITimedBigMessage;
+    buf[num_events++].MoveFrom ( msg, &sysex_pool );
+
+    MIDIClockTime t = msg.GetTime();
+    msg.Clear();
+    msg.SetTime( t );
+    return true;
 }
 
 bool MIDITrack::PutEvent ( const MIDITimedMessage &msg, const MIDISystemExclusive *sysex )
 {
-    MIDITimedBigMessage m ( msg, sysex );
-    return PutEvent ( m );
+    // the sysex is copied only once, straight to the pool
+    MIDITimedBigMessage m ( msg );
+
+    if ( !PutEvent ( m ) )
+        return false;
+
+    GetEventAddress ( num_events - 1 )->CopySysEx ( sysex, &sysex_pool );
+    return true;
 }
 
 bool MIDITrack::PutTextEvent ( MIDIClockTime time, int meta_event_type, const char *text, int length )
@@ -551,10 +607,8 @@ bool MIDITrack::PutTextEvent ( MIDIClockTime time, int meta_event_type, const ch
     if ( length == 0 )
         length = (int) strlen( text );
 
-    MIDISystemExclusive sysex( length );
-
-    for ( int i = 0; i < length; ++i )
-        sysex.PutSysByte ( text[i] );
+    // only a view on 'text', the event keeps a copy of it
+    MIDISystemExclusive sysex( ( unsigned char * ) text, length, length, false );
 
     return PutEvent( msg, &sysex );
 }
@@ -580,7 +634,7 @@ bool MIDITrack::SetEvent ( int event_num, const MIDITimedBigMessage &msg )
     }
     else
     {
-        GetEventAddress ( event_num )->Copy ( msg );
+        CopyEvent ( GetEventAddress ( event_num ), msg );
         return true;
     }
 }
@@ -0,0 +1,444 @@
+/*
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+  * Unit tests and benchmarks of the parts of libjdkmidi that Aria changed (multitrack iteration,
+  * sequencer seeking, event storage and sorting). They use Aria's UNIT_TEST and BENCHMARK harness,
+  * so this file is built with Aria rather than with the library's own makefiles (which only look
+  * at 'src').
+  */
+
+#include "Benchmark.h"
+#include "IO/MidiToMemoryStream.h"
+#include "UnitTest.h"
+
+#include "jdksmidi/world.h"
+#include "jdksmidi/track.h"
+#include "jdksmidi/multitrack.h"
+#include "jdksmidi/filewritemultitrack.h"
+#include "jdksmidi/msg.h"
+#include "jdksmidi/sysex.h"
+#include "jdksmidi/sequencer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace AriaMaestosa;
+
+namespace TestJDKMidi
+{
+    /**
+      * @brief fills 'tracks' with a song : a tempo change each measure in the first track, and
+      *        'noteAmount' notes (note on and note off) in each of the others
+      */
+    void makeSong(jdksmidi::MIDIMultiTrack& tracks, const int noteAmount)
+    {
+        tracks.SetClksPerBeat(960);
+
+        jdksmidi::MIDIClockTime time = 0;
+        for (int m=0; m<noteAmount/8; m++)
+        {
+            jdksmidi::MIDITimedBigMessage message;
+            message.SetTime(time);
+            message.SetTempo32((60 + m % 80)*32);
+            tracks.GetTrack(0)->PutEvent(message);
+            time += 960*4;
+        }
+
+        unsigned int random = 1234;
+        for (int t=1; t<tracks.GetNumTracks(); t++)
+        {
+            jdksmidi::MIDITrack* track = tracks.GetTrack(t);
+            time = 0;
+            for (int n=0; n<noteAmount; n++)
+            {
+                random = random*1103515245 + 12345;
+                time += (random >> 16) % 960;
+
+                jdksmidi::MIDITimedBigMessage message;
+                message.SetTime(time);
+                message.SetNoteOn(t % 16, 40 + n % 50, 80);
+                track->PutEvent(message);
+                message.SetTime(time + 240);
+                message.SetNoteOff(t % 16, 40 + n % 50, 0);
+                track->PutEvent(message);
+            }
+            track->SortEventsOrder();
+        }
+    }
+
+    /** @brief fills each track of 'tracks' with 'eventsPerTrack' note on events, in time order */
+    void makeNoteOns(jdksmidi::MIDIMultiTrack& tracks, const int eventsPerTrack)
+    {
+        unsigned int random = 4321;
+        for (int t=0; t<tracks.GetNumTracks(); t++)
+        {
+            jdksmidi::MIDITrack* track = tracks.GetTrack(t);
+            jdksmidi::MIDIClockTime time = 0;
+            for (int e=0; e<eventsPerTrack; e++)
+            {
+                random = random*1103515245 + 12345;
+                time += (random >> 16) % 48;
+
+                jdksmidi::MIDITimedBigMessage message;
+                message.SetTime(time);
+                message.SetNoteOn(t % 16, 40 + (random >> 20) % 50, 80);
+                track->PutEvent(message);
+            }
+        }
+    }
+
+    /** @brief fills 'track' with 'amount' lyrics in shuffled order; every 16th one is too long for the sysex pool */
+    void makeLyrics(jdksmidi::MIDITrack& track, const int amount)
+    {
+        unsigned int random = 1234;
+        for (int n=0; n<amount; n++)
+        {
+            random = random*1103515245 + 12345;
+
+            char text[128];
+            int length = sprintf(text, "la %i", n);
+            if (n % 16 == 0)
+            {
+                while (length < 100)
+                {
+                    text[length] = 'a' + length % 26;
+                    length++;
+                }
+            }
+
+            track.PutTextEvent((random >> 16) % 100000, jdksmidi::META_LYRIC_TEXT, text, length);
+        }
+    }
+}
+
+using namespace TestJDKMidi;
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( MultiTrackIteratorOrderTest )
+{
+    // tracks need not be sorted; the iterator must then still give out, at each step, the next event of
+    // the track whose next event comes first (the lowest track first on ties), like a plain linear search.
+    // Events of other tracks are skipped now and then, which moves those tracks around in the iterator
+    const int trackAmount = 24;
+    jdksmidi::MIDIMultiTrack tracks(trackAmount);
+    makeNoteOns(tracks, 200);
+
+    unsigned int random = 99;
+    for (int t=0; t<trackAmount; t += 3)
+    {
+        jdksmidi::MIDITrack* track = tracks.GetTrack(t);
+        for (int e=0; e<track->GetNumEvents(); e += 7)
+        {
+            random = random*1103515245 + 12345;
+            track->GetEvent(e)->SetTime((random >> 16) % 5000);
+        }
+    }
+
+    std::vector<int> next(trackAmount, 0);
+
+    jdksmidi::MIDIMultiTrackIterator iterator(&tracks);
+    iterator.GoToTime(0);
+
+    int track;
+    const jdksmidi::MIDITimedBigMessage* message;
+    int eventAmount = 0;
+    while (iterator.GetCurEvent(&track, &message))
+    {
+        int expected = -1;
+        for (int t=0; t<trackAmount; t++)
+        {
+            if (next[t] >= tracks.GetTrack(t)->GetNumEvents()) continue;
+            if (expected == -1 or tracks.GetTrack(t)->GetEvent(next[t])->GetTime() <
+                                  tracks.GetTrack(expected)->GetEvent(next[expected])->GetTime())
+            {
+                expected = t;
+            }
+        }
+
+        require_e(track, ==, expected, "The iterator picks the track whose next event comes first");
+        require(message == tracks.GetTrack(track)->GetEvent(next[track]), "Events of a track come in their order");
+        next[track]++;
+        eventAmount++;
+
+        random = random*1103515245 + 12345;
+        const int skipped = (random >> 16) % trackAmount;
+        if (skipped != track and (random >> 8) % 4 == 0 and next[skipped] < tracks.GetTrack(skipped)->GetNumEvents())
+        {
+            iterator.GoToNextEventOnTrack(skipped);
+            next[skipped]++;
+            eventAmount++;
+        }
+
+        if (not iterator.GoToNextEvent()) break;
+    }
+
+    require_e(eventAmount, ==, trackAmount*200, "All events were iterated or skipped");
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( IterateJDKMultiTrack )
+{
+    // what the sequencer does to play a song : go through all events of all tracks in time order ;
+    // 128 tracks, with 10 events per note of the song (so 1M events for the largest size)
+    const int trackAmount = 128;
+    jdksmidi::MIDIMultiTrack tracks(trackAmount);
+    makeNoteOns(tracks, bench.getSize()*10 / trackAmount);
+
+    jdksmidi::MIDIMultiTrackIterator iterator(&tracks);
+
+    while (bench.next())
+    {
+        iterator.GoToTime(0);
+
+        int checksum = 0;
+        int track;
+        const jdksmidi::MIDITimedBigMessage* message;
+        while (iterator.GetCurEvent(&track, &message))
+        {
+            checksum += track;
+            if (not iterator.GoToNextEvent()) break;
+        }
+        bench.keep(checksum);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( SequencerSeekTest )
+{
+    // seeking from a checkpoint must land on the same state as replaying the song from the start
+    jdksmidi::MIDIMultiTrack tracks(16);
+    makeSong(tracks, 4000);
+
+    jdksmidi::MIDISequencer sequencer(&tracks);
+    sequencer.BuildCheckpoints();
+    sequencer.GoToTimeMs(0);
+
+    int track;
+    jdksmidi::MIDITimedBigMessage message;
+    while (sequencer.GetNextEvent(&track, &message)) {}
+    const double songLength = sequencer.GetCurrentTimeInMs();
+
+    for (int n=0; n<40; n++)
+    {
+        // jump around, backwards more often than not
+        const float time = (float)(songLength * ((n*7919) % 1000) / 1000.0);
+
+        jdksmidi::MIDISequencer reference(&tracks);
+        reference.GoToTimeMs(0);
+        reference.GoToTimeMs(time);
+        sequencer.GoToTimeMs(time);
+
+        require_e(sequencer.GetCurrentMIDIClockTime(), ==, reference.GetCurrentMIDIClockTime(),
+                  "Seeking lands on the same tick as replaying from the start");
+        require_e(sequencer.GetCurrentTimeInMs(), ==, reference.GetCurrentTimeInMs(),
+                  "Seeking lands on the same time as replaying from the start");
+        require_e(sequencer.GetCurrentMeasure(), ==, reference.GetCurrentMeasure(),
+                  "Seeking lands on the same measure as replaying from the start");
+        require_e(sequencer.GetCurrentTempo(), ==, reference.GetCurrentTempo(),
+                  "Seeking restores the tempo");
+
+        for (int e=0; e<20; e++)
+        {
+            int referenceTrack;
+            jdksmidi::MIDITimedBigMessage referenceMessage;
+            const bool more = reference.GetNextEvent(&referenceTrack, &referenceMessage);
+            require(sequencer.GetNextEvent(&track, &message) == more, "Both sequencers end together");
+            if (not more) break;
+
+            require(track == referenceTrack and message == referenceMessage,
+                    "Both sequencers give out the same events after seeking");
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( SeekJDKSequencer )
+{
+    // what happens when the user clicks here and there in the song while it plays
+    jdksmidi::MIDIMultiTrack tracks(16);
+    makeSong(tracks, bench.getSize()/10);
+
+    jdksmidi::MIDISequencer sequencer(&tracks);
+    sequencer.BuildCheckpoints();
+    sequencer.GoToTimeMs(0);
+
+    int track;
+    jdksmidi::MIDITimedBigMessage message;
+    while (sequencer.GetNextEvent(&track, &message)) {}
+    const double songLength = sequencer.GetCurrentTimeInMs();
+
+    int n = 0;
+    while (bench.next())
+    {
+        sequencer.GoToTimeMs((float)(songLength * ((n*7919) % 1000) / 1000.0));
+        bench.keep(sequencer.GetCurrentMeasure());
+        n++;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( TextEventStorageTest )
+{
+    jdksmidi::MIDITrack track;
+    makeLyrics(track, 1000);
+
+    std::vector<std::string> texts;
+    for (int n=0; n<track.GetNumEvents(); n++) texts.push_back(track.GetEvent(n)->GetSysExString());
+
+    jdksmidi::MIDITrack copy(track);
+    copy.SortEventsOrder();
+    require(copy.EventsOrderOK(), "Events were sorted");
+
+    std::vector<std::string> sortedTexts;
+    for (int n=0; n<copy.GetNumEvents(); n++) sortedTexts.push_back(copy.GetEvent(n)->GetSysExString());
+
+    std::sort(texts.begin(), texts.end());
+    std::sort(sortedTexts.begin(), sortedTexts.end());
+    require(texts == sortedTexts, "Short and long texts survive copying and sorting");
+
+    jdksmidi::MIDITimedBigMessage moved;
+    moved.MoveFrom(*track.GetEvent(0));
+    require(track.GetEvent(0)->GetSysEx() == NULL, "A moved-from message has no sysex left");
+    require_e(moved.GetSysExString().size(), ==, 100, "The long text was moved");
+
+    jdksmidi::MIDITimedBigMessage movedShort;
+    {
+        jdksmidi::MIDITrack temporary;
+        temporary.PutTextEvent(0, jdksmidi::META_LYRIC_TEXT, "la", 2);
+        require(temporary.GetEvent(0)->GetSysEx()->GetPool() != NULL, "Short texts come from the track's pool");
+
+        movedShort.MoveFrom(*temporary.GetEvent(0));
+        require(movedShort.GetSysEx()->GetPool() == NULL, "A text moved out of its track leaves the pool");
+    }
+    require(movedShort.GetSysExString() == "la", "A short text moved out of a track outlives it");
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+UNIT_TEST( TrackReserveTest )
+{
+    jdksmidi::MIDITrack track;
+    makeLyrics(track, 10);
+
+    require(track.Reserve(1000), "Room was made");
+    require_e(track.GetBufferSize(), >=, 1000, "Room was made");
+    require_e(track.GetNumEvents(), ==, 10, "Reserving keeps the events");
+    require(track.GetEvent(0)->GetSysExString().size() == 100, "Reserving keeps the texts");
+
+    const jdksmidi::MIDITimedBigMessage* first = track.GetEventAddress(0);
+    makeLyrics(track, 990);
+    require(track.GetEventAddress(0) == first, "Filling up to the reserved size does not move the events");
+
+    require(track.Reserve(10), "Reserving less than the size is fine");
+    require(track.GetEventAddress(0) == first, "Reserving less than the size does nothing");
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( FillReservedJDKTracks )
+{
+    // what exporting does for each track : room for the events is reserved, then events are put one by one
+    const int trackAmount = 64;
+    const int eventsPerTrack = bench.getSize()*2 / trackAmount;
+
+    while (bench.next())
+    {
+        jdksmidi::MIDIMultiTrack tracks(trackAmount);
+        for (int t=0; t<trackAmount; t++) tracks.GetTrack(t)->Reserve(eventsPerTrack);
+        makeNoteOns(tracks, eventsPerTrack);
+
+        bench.keep(tracks.GetTrack(trackAmount - 1)->GetNumEvents());
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( SortLyricsTrack )
+{
+    // lyric-heavy songs : every event carries text
+    jdksmidi::MIDITrack track;
+    makeLyrics(track, bench.getSize());
+
+    while (bench.next())
+    {
+        track.SortEventsOrder();
+        bench.keep(track.GetEvent(0)->GetTime());
+
+        // unsort the song again for the next run
+        track.GetEvent(0)->SetTime(100000);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( SortShuffledJDKTracks )
+{
+    // tracks as they come out of a MIDI file whose events are not in time order (some programs write
+    // such files); times are swapped around between events before each run, which is not timed
+    jdksmidi::MIDIMultiTrack tracks(16);
+    makeSong(tracks, bench.getSize()/15);
+
+    unsigned int random = 1234;
+    while (bench.next())
+    {
+        bench.pause();
+        for (int t=0; t<tracks.GetNumTracks(); t++)
+        {
+            jdksmidi::MIDITrack* track = tracks.GetTrack(t);
+            const int eventAmount = track->GetNumEvents();
+            for (int e=0; e<eventAmount; e++)
+            {
+                random = random*1103515245 + 12345;
+                jdksmidi::MIDITimedBigMessage* a = track->GetEvent(e);
+                jdksmidi::MIDITimedBigMessage* b = track->GetEvent((random >> 8) % eventAmount);
+                const jdksmidi::MIDIClockTime time = a->GetTime();
+                a->SetTime(b->GetTime());
+                b->SetTime(time);
+            }
+        }
+        bench.resume();
+
+        tracks.SortEventsOrder();
+        bench.keep(tracks.GetTrack(1)->GetEvent(0)->GetTime());
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------
+
+BENCHMARK( WriteJDKMultiTrackToMemory )
+{
+    jdksmidi::MIDIMultiTrack tracks(16);
+    makeSong(tracks, bench.getSize()/15);
+
+    while (bench.next())
+    {
+        MidiToMemoryStream stream;
+        jdksmidi::MIDIFileWriteMultiTrack writer(&tracks, &stream);
+        writer.Write(tracks.GetNumTracks(), tracks.GetClksPerBeat());
+
+        bench.keep(stream.getDataLength());
+        free(stream.releaseMidiData());
+    }
+}